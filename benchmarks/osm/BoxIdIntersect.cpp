@@ -0,0 +1,192 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+
+// Intersection of box id lists with the different skip kernels: a single
+// node against a country sized area, and a smaller area inside a large one
+// with short and with longer skips.
+
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "osm2rdf/osm/BoxIdIntersect.h"
+
+using osm2rdf::osm::BoxIdIntersect;
+using osm2rdf::osm::BoxIdList;
+
+namespace {
+
+const size_t NUM_QUERIES = 1024;
+
+// Alternating full runs and partially covered ids without gaps, like the box
+// ids of a large area.
+BoxIdList makeArea(size_t runs, std::mt19937* rng) {
+  BoxIdList ids{{0, 0}};
+  int32_t next = 1;
+  for (size_t i = 0; i < runs; ++i) {
+    const bool full = i % 2 == 0;
+    const auto extra = full ? static_cast<uint32_t>((*rng)() % 64) : 0U;
+    ids.push_back({full ? next : -next, extra});
+    next += static_cast<int32_t>(extra) + 1;
+  }
+  ids[0].first = next - 1;
+  return ids;
+}
+
+// Every stride-th id of area as single runs, inside the area.
+BoxIdList makeContained(const BoxIdList& area, int32_t stride) {
+  BoxIdList ids{{0, 0}};
+  for (int32_t id = 1; id <= area[0].first; id += stride) {
+    ids.push_back({id, 0});
+    ids[0].first++;
+  }
+  return ids;
+}
+
+void nodeInArea(benchmark::State& state, const BoxIdIntersect::Kernel* kernel,
+                bool anyFull) {
+  std::mt19937 rng(42);
+  const BoxIdList area = makeArea(static_cast<size_t>(state.range(0)), &rng);
+  std::vector<BoxIdList> nodes;
+  for (size_t i = 0; i < NUM_QUERIES; ++i) {
+    nodes.push_back(
+        {{1, 0}, {static_cast<int32_t>(rng() % area[0].first) + 1, 0}});
+  }
+  std::vector<int32_t> toCheck;
+  for (auto _ : state) {
+    for (const auto& node : nodes) {
+      toCheck.clear();
+      if (anyFull) {
+        benchmark::DoNotOptimize(
+            kernel ? BoxIdIntersect::anyFull(node, area, *kernel)
+                   : BoxIdIntersect::anyFull(node, area));
+      } else {
+        benchmark::DoNotOptimize(
+            kernel ? BoxIdIntersect::isect(node, area, &toCheck, *kernel)
+                   : BoxIdIntersect::isect(node, area, &toCheck));
+      }
+    }
+  }
+  state.counters["queries/s"] = benchmark::Counter(
+      NUM_QUERIES, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+void areaInArea(benchmark::State& state, const BoxIdIntersect::Kernel* kernel,
+                bool anyFull, int32_t stride) {
+  std::mt19937 rng(42);
+  const BoxIdList area = makeArea(static_cast<size_t>(state.range(0)), &rng);
+  const BoxIdList other = makeContained(area, stride);
+  std::vector<int32_t> toCheck;
+  for (auto _ : state) {
+    toCheck.clear();
+    if (anyFull) {
+      benchmark::DoNotOptimize(
+          kernel ? BoxIdIntersect::anyFull(other, area, *kernel)
+                 : BoxIdIntersect::anyFull(other, area));
+    } else {
+      benchmark::DoNotOptimize(
+          kernel ? BoxIdIntersect::isect(other, area, &toCheck, *kernel)
+                 : BoxIdIntersect::isect(other, area, &toCheck));
+    }
+  }
+  state.counters["runs/s"] =
+      benchmark::Counter(static_cast<double>(area.size() + other.size()),
+                         benchmark::Counter::kIsIterationInvariantRate);
+}
+
+const BoxIdIntersect::Kernel SCALAR = BoxIdIntersect::Kernel::SCALAR;
+const BoxIdIntersect::Kernel AVX2 = BoxIdIntersect::Kernel::AVX2;
+const BoxIdIntersect::Kernel GALLOP = BoxIdIntersect::Kernel::GALLOP;
+
+void requireAvx2(benchmark::State& state) {
+  if (!BoxIdIntersect::supported(AVX2)) {
+    state.SkipWithError("AVX2 not supported");
+  }
+}
+
+}  // namespace
+
+// ____________________________________________________________________________
+static void BoxIdIntersect_Node_Scalar(benchmark::State& state) {
+  nodeInArea(state, &SCALAR, false);
+}
+BENCHMARK(BoxIdIntersect_Node_Scalar)->Range(1U << 10U, 1U << 16U);
+
+// ____________________________________________________________________________
+static void BoxIdIntersect_Node_Avx2(benchmark::State& state) {
+  requireAvx2(state);
+  nodeInArea(state, &AVX2, false);
+}
+BENCHMARK(BoxIdIntersect_Node_Avx2)->Range(1U << 10U, 1U << 16U);
+
+// ____________________________________________________________________________
+static void BoxIdIntersect_Node_Gallop(benchmark::State& state) {
+  nodeInArea(state, &GALLOP, false);
+}
+BENCHMARK(BoxIdIntersect_Node_Gallop)->Range(1U << 10U, 1U << 16U);
+
+// ____________________________________________________________________________
+static void BoxIdIntersect_Node_AnyFull(benchmark::State& state) {
+  nodeInArea(state, nullptr, true);
+}
+BENCHMARK(BoxIdIntersect_Node_AnyFull)->Range(1U << 10U, 1U << 16U);
+
+// ____________________________________________________________________________
+static void BoxIdIntersect_Area_Scalar(benchmark::State& state) {
+  areaInArea(state, &SCALAR, false, 10);
+}
+BENCHMARK(BoxIdIntersect_Area_Scalar)->Range(1U << 10U, 1U << 16U);
+
+// ____________________________________________________________________________
+static void BoxIdIntersect_Area_Avx2(benchmark::State& state) {
+  requireAvx2(state);
+  areaInArea(state, &AVX2, false, 10);
+}
+BENCHMARK(BoxIdIntersect_Area_Avx2)->Range(1U << 10U, 1U << 16U);
+
+// ____________________________________________________________________________
+static void BoxIdIntersect_Area_Gallop(benchmark::State& state) {
+  areaInArea(state, &GALLOP, false, 10);
+}
+BENCHMARK(BoxIdIntersect_Area_Gallop)->Range(1U << 10U, 1U << 16U);
+
+// ____________________________________________________________________________
+static void BoxIdIntersect_Area_AnyFull(benchmark::State& state) {
+  areaInArea(state, nullptr, true, 10);
+}
+BENCHMARK(BoxIdIntersect_Area_AnyFull)->Range(1U << 10U, 1U << 16U);
+
+// ____________________________________________________________________________
+static void BoxIdIntersect_SparseArea_Scalar(benchmark::State& state) {
+  areaInArea(state, &SCALAR, false, 200);
+}
+BENCHMARK(BoxIdIntersect_SparseArea_Scalar)->Range(1U << 10U, 1U << 16U);
+
+// ____________________________________________________________________________
+static void BoxIdIntersect_SparseArea_Avx2(benchmark::State& state) {
+  requireAvx2(state);
+  areaInArea(state, &AVX2, false, 200);
+}
+BENCHMARK(BoxIdIntersect_SparseArea_Avx2)->Range(1U << 10U, 1U << 16U);
+
+// ____________________________________________________________________________
+static void BoxIdIntersect_SparseArea_Gallop(benchmark::State& state) {
+  areaInArea(state, &GALLOP, false, 200);
+}
+BENCHMARK(BoxIdIntersect_SparseArea_Gallop)->Range(1U << 10U, 1U << 16U);
@@ -0,0 +1,214 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+
+// Queries of the area index: the boost r-tree used by default against the
+// static osm2rdf::osm::FlatRTree with each child test kernel. Area envelopes
+// are read from the file named by OSM2RDF_AREA_ENVELOPES, one
+// "minX minY maxX maxY" line in degrees per area, for example dumped from a
+// real extract. Without it, clustered areas of varying size are generated.
+
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "boost/geometry.hpp"
+#include "boost/geometry/index/rtree.hpp"
+#include "osm2rdf/osm/FlatRTree.h"
+
+using osm2rdf::osm::FlatRTree;
+
+namespace {
+
+const size_t NUM_QUERIES = 4096;
+
+osm2rdf::geometry::Box makeBox(double minX, double minY, double maxX,
+                               double maxY) {
+  return {{minX, minY}, {maxX, maxY}};
+}
+
+// Many small areas around cities, like buildings and land use, and few
+// large ones, like administrative boundaries.
+std::vector<FlatRTree::Value> generateEnvelopes(size_t n) {
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> x(-170, 170);
+  std::uniform_real_distribution<double> y(-60, 70);
+  std::normal_distribution<double> offset(0, 0.3);
+  std::lognormal_distribution<double> size(-7, 2);
+  std::vector<std::pair<double, double>> cities;
+  for (size_t i = 0; i < 500; ++i) {
+    cities.emplace_back(x(rng), y(rng));
+  }
+  std::vector<FlatRTree::Value> values;
+  for (size_t i = 0; i < n; ++i) {
+    const auto& [cityX, cityY] = cities[rng() % cities.size()];
+    const double minX = cityX + offset(rng);
+    const double minY = cityY + offset(rng);
+    const double width = std::min(size(rng), 20.0);
+    const double height = std::min(size(rng), 20.0);
+    values.emplace_back(makeBox(minX, minY, minX + width, minY + height), i);
+  }
+  return values;
+}
+
+std::vector<FlatRTree::Value> loadEnvelopes(size_t n) {
+  const char* path = std::getenv("OSM2RDF_AREA_ENVELOPES");
+  if (path == nullptr) {
+    return generateEnvelopes(n);
+  }
+  std::vector<FlatRTree::Value> values;
+  std::ifstream file{path};
+  double minX;
+  double minY;
+  double maxX;
+  double maxY;
+  while (values.size() < n && file >> minX >> minY >> maxX >> maxY) {
+    values.emplace_back(makeBox(minX, minY, maxX, maxY), values.size());
+  }
+  return values;
+}
+
+// Points close to the centers of random areas, and envelopes of random
+// areas.
+std::vector<osm2rdf::geometry::Box> makeQueries(
+    const std::vector<FlatRTree::Value>& values, bool points) {
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<double> jitter(-0.01, 0.01);
+  std::vector<osm2rdf::geometry::Box> queries;
+  for (size_t i = 0; i < NUM_QUERIES && !values.empty(); ++i) {
+    const auto& box = values[rng() % values.size()].first;
+    if (!points) {
+      queries.push_back(box);
+      continue;
+    }
+    const double px =
+        box.min_corner().get<0>() / 2 + box.max_corner().get<0>() / 2 +
+        jitter(rng);
+    const double py =
+        box.min_corner().get<1>() / 2 + box.max_corner().get<1>() / 2 +
+        jitter(rng);
+    queries.push_back(makeBox(px, py, px, py));
+  }
+  return queries;
+}
+
+void boostRTree(benchmark::State& state, bool points) {
+  const auto values = loadEnvelopes(static_cast<size_t>(state.range(0)));
+  const auto queries = makeQueries(values, points);
+  const boost::geometry::index::rtree<FlatRTree::Value,
+                                      boost::geometry::index::quadratic<32>>
+      rtree{values.begin(), values.end()};
+  std::vector<FlatRTree::Value> result;
+  size_t found = 0;
+  for (auto _ : state) {
+    for (const auto& query : queries) {
+      result.clear();
+      if (points) {
+        rtree.query(boost::geometry::index::covers(query),
+                    std::back_inserter(result));
+      } else {
+        rtree.query(boost::geometry::index::intersects(query),
+                    std::back_inserter(result));
+      }
+      found += result.size();
+    }
+  }
+  benchmark::DoNotOptimize(found);
+  state.counters["queries/s"] = benchmark::Counter(
+      static_cast<double>(queries.size()),
+      benchmark::Counter::kIsIterationInvariantRate);
+}
+
+void flatRTree(benchmark::State& state, FlatRTree::Kernel kernel,
+               bool points) {
+  if (!FlatRTree::supported(kernel)) {
+    state.SkipWithError("kernel not supported");
+    return;
+  }
+  const auto values = loadEnvelopes(static_cast<size_t>(state.range(0)));
+  const auto queries = makeQueries(values, points);
+  const FlatRTree tree{values, kernel};
+  size_t found = 0;
+  const auto count = [&found](const osm2rdf::geometry::Box& /*unused*/,
+                              size_t /*unused*/) { found++; };
+  for (auto _ : state) {
+    for (const auto& query : queries) {
+      if (points) {
+        tree.queryCovers(query, count);
+      } else {
+        tree.queryIntersects(query, count);
+      }
+    }
+  }
+  benchmark::DoNotOptimize(found);
+  state.counters["queries/s"] = benchmark::Counter(
+      static_cast<double>(queries.size()),
+      benchmark::Counter::kIsIterationInvariantRate);
+}
+
+}  // namespace
+
+// ____________________________________________________________________________
+static void FlatRTree_Points_Boost(benchmark::State& state) {
+  boostRTree(state, true);
+}
+BENCHMARK(FlatRTree_Points_Boost)->Range(1U << 12U, 1U << 20U);
+
+// ____________________________________________________________________________
+static void FlatRTree_Points_Scalar(benchmark::State& state) {
+  flatRTree(state, FlatRTree::Kernel::SCALAR, true);
+}
+BENCHMARK(FlatRTree_Points_Scalar)->Range(1U << 12U, 1U << 20U);
+
+// ____________________________________________________________________________
+static void FlatRTree_Points_Avx2(benchmark::State& state) {
+  flatRTree(state, FlatRTree::Kernel::AVX2, true);
+}
+BENCHMARK(FlatRTree_Points_Avx2)->Range(1U << 12U, 1U << 20U);
+
+// ____________________________________________________________________________
+static void FlatRTree_Points_Avx512(benchmark::State& state) {
+  flatRTree(state, FlatRTree::Kernel::AVX512, true);
+}
+BENCHMARK(FlatRTree_Points_Avx512)->Range(1U << 12U, 1U << 20U);
+
+// ____________________________________________________________________________
+static void FlatRTree_Areas_Boost(benchmark::State& state) {
+  boostRTree(state, false);
+}
+BENCHMARK(FlatRTree_Areas_Boost)->Range(1U << 12U, 1U << 20U);
+
+// ____________________________________________________________________________
+static void FlatRTree_Areas_Scalar(benchmark::State& state) {
+  flatRTree(state, FlatRTree::Kernel::SCALAR, false);
+}
+BENCHMARK(FlatRTree_Areas_Scalar)->Range(1U << 12U, 1U << 20U);
+
+// ____________________________________________________________________________
+static void FlatRTree_Areas_Avx2(benchmark::State& state) {
+  flatRTree(state, FlatRTree::Kernel::AVX2, false);
+}
+BENCHMARK(FlatRTree_Areas_Avx2)->Range(1U << 12U, 1U << 20U);
+
+// ____________________________________________________________________________
+static void FlatRTree_Areas_Avx512(benchmark::State& state) {
+  flatRTree(state, FlatRTree::Kernel::AVX512, false);
+}
+BENCHMARK(FlatRTree_Areas_Avx512)->Range(1U << 12U, 1U << 20U);
@@ -0,0 +1,218 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+// Throughput of the single stages of OSM Pass 2 (see
+// osm2rdf::osm::OsmiumHandler::handle) in entities per second.
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "osm2rdf/config/Config.h"
+#include "osm2rdf/osm/LocationHandler.h"
+#include "osm2rdf/osm/Node.h"
+#include "osm2rdf/osm/Way.h"
+#include "osmium/builder/attr.hpp"
+#include "osmium/builder/osm_object_builder.hpp"
+#include "osmium/handler.hpp"
+#include "osmium/io/any_input.hpp"
+#include "osmium/io/any_output.hpp"
+#include "osmium/visitor.hpp"
+
+namespace {
+
+const size_t NODES_PER_WAY = 10;
+
+// Converts each entity like osm2rdf::osm::OsmiumHandler does and counts them.
+struct ConvertHandler : public osmium::handler::Handler {
+  void node(const osmium::Node& node) {
+    const auto& osmNode = osm2rdf::osm::Node(node);
+    benchmark::DoNotOptimize(osmNode.id());
+    count++;
+  }
+  void way(const osmium::Way& way) {
+    const auto& osmWay = osm2rdf::osm::Way(way);
+    benchmark::DoNotOptimize(osmWay.id());
+    count++;
+  }
+  size_t count = 0;
+};
+
+// Counts all entities.
+struct CountHandler : public osmium::handler::Handler {
+  void osm_object(const osmium::OSMObject& /*unused*/) { count++; }
+  size_t count = 0;
+};
+
+// Writes a pbf file containing a grid of n tagged nodes and ways connecting
+// each NODES_PER_WAY consecutive nodes.
+std::filesystem::path createInput(const osm2rdf::config::Config& config,
+                                  size_t n) {
+  std::filesystem::path path{config.getTempPath(
+      "OsmiumHandlerBenchmark", std::to_string(n) + ".osm.pbf")};
+  if (std::filesystem::exists(path)) {
+    return path;
+  }
+  const size_t initial_buffer_size = 10000;
+  osmium::memory::Buffer buffer{initial_buffer_size,
+                                osmium::memory::Buffer::auto_grow::yes};
+  for (size_t i = 1; i <= n; ++i) {
+    osmium::builder::add_node(
+        buffer, osmium::builder::attr::_id(i),
+        osmium::builder::attr::_location(
+            osmium::Location(7.5 + static_cast<double>(i % 1000) * 0.0001,
+                             48.0 + static_cast<double>(i / 1000) * 0.0001)),
+        osmium::builder::attr::_tag("name", "node" + std::to_string(i)),
+        osmium::builder::attr::_tag("amenity", "bench"));
+  }
+  for (size_t i = 1; i + NODES_PER_WAY <= n; i += NODES_PER_WAY) {
+    std::vector<osmium::object_id_type> nodes;
+    for (size_t j = 0; j < NODES_PER_WAY; ++j) {
+      nodes.push_back(static_cast<osmium::object_id_type>(i + j));
+    }
+    osmium::builder::add_way(buffer, osmium::builder::attr::_id(i),
+                             osmium::builder::attr::_nodes(nodes),
+                             osmium::builder::attr::_tag("highway", "path"));
+  }
+  osmium::io::Writer writer{path.string()};
+  writer(std::move(buffer));
+  writer.close();
+  return path;
+}
+
+// Reads all buffers of the given file and resolves node locations in file
+// order.
+std::vector<osmium::memory::Buffer> readWithLocations(
+    const osm2rdf::config::Config& config, const std::filesystem::path& path) {
+  std::vector<osmium::memory::Buffer> buffers;
+  std::unique_ptr<osm2rdf::osm::LocationHandler> locationHandler{
+      osm2rdf::osm::LocationHandler::create(config)};
+  osmium::io::Reader reader{path.string(), osmium::osm_entity_bits::object};
+  while (auto buf = reader.read()) {
+    osmium::apply(buf, *locationHandler);
+    buffers.push_back(std::move(buf));
+  }
+  reader.close();
+  return buffers;
+}
+
+}  // namespace
+
+// ____________________________________________________________________________
+static void OsmiumHandler_Pass2_Decode(benchmark::State& state) {
+  osm2rdf::config::Config config;
+  const auto path = createInput(config, state.range(0));
+  size_t entities = 0;
+  for (auto _ : state) {
+    CountHandler counter;
+    osmium::io::Reader reader{path.string(), osmium::osm_entity_bits::object};
+    while (auto buf = reader.read()) {
+      osmium::apply(buf, counter);
+    }
+    reader.close();
+    entities = counter.count;
+  }
+  state.counters["entities/s"] = benchmark::Counter(
+      entities, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(OsmiumHandler_Pass2_Decode)
+    ->RangeMultiplier(10)
+    ->Range(1U << 10U, 1U << 20U)
+    ->Unit(benchmark::kMillisecond);
+
+// ____________________________________________________________________________
+static void OsmiumHandler_Pass2_Locations(benchmark::State& state) {
+  osm2rdf::config::Config config;
+  const auto path = createInput(config, state.range(0));
+  std::vector<osmium::memory::Buffer> buffers;
+  {
+    osmium::io::Reader reader{path.string(), osmium::osm_entity_bits::object};
+    while (auto buf = reader.read()) {
+      buffers.push_back(std::move(buf));
+    }
+    reader.close();
+  }
+  size_t entities = 0;
+  for (auto _ : state) {
+    CountHandler counter;
+    std::unique_ptr<osm2rdf::osm::LocationHandler> locationHandler{
+        osm2rdf::osm::LocationHandler::create(config)};
+    for (auto& buf : buffers) {
+      osmium::apply(buf, *locationHandler, counter);
+    }
+    entities = counter.count;
+  }
+  state.counters["entities/s"] = benchmark::Counter(
+      entities, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(OsmiumHandler_Pass2_Locations)
+    ->RangeMultiplier(10)
+    ->Range(1U << 10U, 1U << 20U)
+    ->Unit(benchmark::kMillisecond);
+
+// ____________________________________________________________________________
+static void OsmiumHandler_Pass2_ConvertSequential(benchmark::State& state) {
+  osm2rdf::config::Config config;
+  auto buffers = readWithLocations(config, createInput(config, state.range(0)));
+  size_t entities = 0;
+  for (auto _ : state) {
+    ConvertHandler converter;
+    for (auto& buf : buffers) {
+      osmium::apply(buf, converter);
+    }
+    entities = converter.count;
+  }
+  state.counters["entities/s"] = benchmark::Counter(
+      entities, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(OsmiumHandler_Pass2_ConvertSequential)
+    ->RangeMultiplier(10)
+    ->Range(1U << 10U, 1U << 20U)
+    ->Unit(benchmark::kMillisecond);
+
+// ____________________________________________________________________________
+static void OsmiumHandler_Pass2_ConvertPipeline(benchmark::State& state) {
+  osm2rdf::config::Config config;
+  auto buffers = readWithLocations(config, createInput(config, state.range(0)));
+  size_t entities = 0;
+  for (auto _ : state) {
+    std::vector<ConvertHandler> converters(buffers.size());
+#pragma omp parallel
+    {
+#pragma omp single
+      {
+        for (size_t i = 0; i < buffers.size(); ++i) {
+#pragma omp task
+          osmium::apply(buffers[i], converters[i]);
+        }
+      }
+    }
+    entities = 0;
+    for (const auto& converter : converters) {
+      entities += converter.count;
+    }
+  }
+  state.counters["entities/s"] = benchmark::Counter(
+      entities, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(OsmiumHandler_Pass2_ConvertPipeline)
+    ->RangeMultiplier(10)
+    ->Range(1U << 10U, 1U << 20U)
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,199 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+
+// Deduplication of area index results as done by the GeometryHandler
+// queries: a fresh vector per query with a sort by area index, std::unique
+// and a sort by area size, against the reused per-thread
+// osm2rdf::osm::SpatialQueryBuffer with its seen bitmap and a single sort.
+// Point queries stand for the node phase, queries with the polygon
+// envelopes of an area for the area and way phases.
+
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "boost/geometry.hpp"
+#include "boost/geometry/index/rtree.hpp"
+#include "osm2rdf/osm/SpatialQueryBuffer.h"
+
+using osm2rdf::osm::SpatialAreaRefValue;
+using osm2rdf::osm::SpatialQueryBuffer;
+
+namespace {
+
+const size_t NUM_QUERIES = 4096;
+
+typedef boost::geometry::index::rtree<SpatialAreaRefValue,
+                                      boost::geometry::index::quadratic<16>>
+    AreaIndex;
+
+struct Areas {
+  // Polygon envelopes per area, areas sorted big -> small as after
+  // GeometryHandler::prepareRTree().
+  std::vector<std::vector<osm2rdf::geometry::Box>> envelopes;
+  std::vector<double> size;
+  AreaIndex index;
+};
+
+osm2rdf::geometry::Box makeBox(double minX, double minY, double maxX,
+                               double maxY) {
+  return {{minX, minY}, {maxX, maxY}};
+}
+
+// Nested areas of varying size around a few cities, every fourth one a
+// multipolygon with several nearby polygons.
+Areas generateAreas(size_t n) {
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> x(-170, 170);
+  std::uniform_real_distribution<double> y(-60, 70);
+  std::normal_distribution<double> offset(0, 0.3);
+  std::lognormal_distribution<double> extent(-5, 2);
+  std::vector<std::pair<double, double>> cities;
+  for (size_t i = 0; i < 50; ++i) {
+    cities.emplace_back(x(rng), y(rng));
+  }
+  std::vector<std::pair<double, std::vector<osm2rdf::geometry::Box>>> areas;
+  for (size_t i = 0; i < n; ++i) {
+    const auto& [cityX, cityY] = cities[rng() % cities.size()];
+    const double width = std::min(extent(rng), 20.0);
+    const size_t numPolygons = i % 4 == 0 ? 2 + rng() % 6 : 1;
+    std::vector<osm2rdf::geometry::Box> polygons;
+    for (size_t j = 0; j < numPolygons; ++j) {
+      const double minX = cityX + offset(rng);
+      const double minY = cityY + offset(rng);
+      polygons.push_back(makeBox(minX, minY, minX + width, minY + width));
+    }
+    areas.emplace_back(width * width * numPolygons, std::move(polygons));
+  }
+  std::sort(areas.begin(), areas.end(), [](const auto& a, const auto& b) {
+    return a.first > b.first;
+  });
+
+  Areas result;
+  std::vector<SpatialAreaRefValue> values;
+  for (size_t i = 0; i < areas.size(); ++i) {
+    for (const auto& polygon : areas[i].second) {
+      values.emplace_back(polygon, i);
+    }
+    result.size.push_back(areas[i].first);
+    result.envelopes.push_back(std::move(areas[i].second));
+  }
+  result.index = AreaIndex{values.begin(), values.end()};
+  return result;
+}
+
+// Query envelopes: a point inside a random polygon, or all polygon
+// envelopes of a random area.
+std::vector<std::vector<osm2rdf::geometry::Box>> makeQueries(
+    const Areas& areas, bool points) {
+  std::mt19937 rng(7);
+  std::vector<std::vector<osm2rdf::geometry::Box>> queries;
+  for (size_t i = 0; i < NUM_QUERIES; ++i) {
+    const auto& envelopes = areas.envelopes[rng() % areas.envelopes.size()];
+    if (!points) {
+      queries.push_back(envelopes);
+      continue;
+    }
+    const auto& box = envelopes[rng() % envelopes.size()];
+    osm2rdf::geometry::Location center;
+    boost::geometry::centroid(box, center);
+    queries.push_back({{center, center}});
+  }
+  return queries;
+}
+
+void vectorUnique(benchmark::State& state, bool points) {
+  const auto areas = generateAreas(static_cast<size_t>(state.range(0)));
+  const auto queries = makeQueries(areas, points);
+  size_t found = 0;
+  for (auto _ : state) {
+    for (const auto& query : queries) {
+      std::vector<SpatialAreaRefValue> refs;
+      for (const auto& envelope : query) {
+        areas.index.query(boost::geometry::index::intersects(envelope),
+                          std::back_inserter(refs));
+      }
+      std::sort(refs.begin(), refs.end(), [](const auto& a, const auto& b) {
+        return a.second < b.second;
+      });
+      refs.erase(std::unique(refs.begin(), refs.end(),
+                             [](const auto& a, const auto& b) {
+                               return a.second == b.second;
+                             }),
+                 refs.end());
+      std::sort(refs.begin(), refs.end(),
+                [&areas](const auto& a, const auto& b) {
+                  return areas.size[a.second] < areas.size[b.second];
+                });
+      found += refs.size();
+    }
+  }
+  benchmark::DoNotOptimize(found);
+  state.counters["queries/s"] = benchmark::Counter(
+      static_cast<double>(queries.size()),
+      benchmark::Counter::kIsIterationInvariantRate);
+}
+
+void bufferUnique(benchmark::State& state, bool points) {
+  const auto areas = generateAreas(static_cast<size_t>(state.range(0)));
+  const auto queries = makeQueries(areas, points);
+  SpatialQueryBuffer buffer;
+  size_t found = 0;
+  for (auto _ : state) {
+    for (const auto& query : queries) {
+      buffer.clear(areas.size.size());
+      for (const auto& envelope : query) {
+        areas.index.query(boost::geometry::index::intersects(envelope),
+                          std::back_inserter(buffer.refs));
+      }
+      buffer.unique();
+      found += buffer.refs.size();
+    }
+  }
+  benchmark::DoNotOptimize(found);
+  state.counters["queries/s"] = benchmark::Counter(
+      static_cast<double>(queries.size()),
+      benchmark::Counter::kIsIterationInvariantRate);
+}
+
+}  // namespace
+
+// ____________________________________________________________________________
+static void SpatialQueryBuffer_Points_Vector(benchmark::State& state) {
+  vectorUnique(state, true);
+}
+BENCHMARK(SpatialQueryBuffer_Points_Vector)->Range(1U << 12U, 1U << 18U);
+
+// ____________________________________________________________________________
+static void SpatialQueryBuffer_Points_Buffer(benchmark::State& state) {
+  bufferUnique(state, true);
+}
+BENCHMARK(SpatialQueryBuffer_Points_Buffer)->Range(1U << 12U, 1U << 18U);
+
+// ____________________________________________________________________________
+static void SpatialQueryBuffer_Areas_Vector(benchmark::State& state) {
+  vectorUnique(state, false);
+}
+BENCHMARK(SpatialQueryBuffer_Areas_Vector)->Range(1U << 12U, 1U << 18U);
+
+// ____________________________________________________________________________
+static void SpatialQueryBuffer_Areas_Buffer(benchmark::State& state) {
+  bufferUnique(state, false);
+}
+BENCHMARK(SpatialQueryBuffer_Areas_Buffer)->Range(1U << 12U, 1U << 18U);
@@ -0,0 +1,152 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+// Write and read throughput of spilled nodes and ways, comparing
+// osm2rdf::osm::SegmentedSpill with the boost binary archives it replaced.
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "boost/archive/binary_iarchive.hpp"
+#include "boost/archive/binary_oarchive.hpp"
+#include "osm2rdf/config/Config.h"
+#include "osm2rdf/osm/GeometryHandler.h"
+#include "osm2rdf/osm/SegmentedSpill.h"
+
+namespace {
+
+const size_t NODES_PER_WAY = 10;
+
+osm2rdf::osm::SpatialNodeValue makeNode(size_t i) {
+  return {i, osm2rdf::geometry::Node{
+                 7.5 + static_cast<double>(i % 1000) * 0.0001,
+                 48.0 + static_cast<double>(i / 1000) * 0.0001}};
+}
+
+osm2rdf::osm::SpatialWayValue makeWay(size_t i) {
+  osm2rdf::osm::SpatialWayValue way;
+  auto& [envelope, id, geom, nodeIds, boxes, boxIds, convexHull, obb] = way;
+  id = static_cast<osm2rdf::osm::Way::id_t>(i);
+  for (size_t j = 0; j < NODES_PER_WAY; ++j) {
+    nodeIds.push_back(i * NODES_PER_WAY + j);
+    geom.push_back(std::get<1>(makeNode(i * NODES_PER_WAY + j)));
+  }
+  envelope = osm2rdf::geometry::Box{geom.front(), geom.back()};
+  boxes.push_back(envelope);
+  boxIds = {{static_cast<int32_t>(i), 1}, {static_cast<int32_t>(i) + 1, 0}};
+  convexHull.outer().assign(geom.begin(), geom.end());
+  convexHull.outer().push_back(geom.front());
+  obb.outer() = {envelope.min_corner(), envelope.max_corner(),
+                 envelope.min_corner()};
+  return way;
+}
+
+template <typename T>
+void spillBoostArchive(benchmark::State& state, T (*make)(size_t)) {
+  osm2rdf::config::Config config;
+  const auto path = config.getTempPath("SpillFormatBenchmark", "archive");
+  const auto n = static_cast<size_t>(state.range(0));
+  size_t bytes = 0;
+  for (auto _ : state) {
+    std::fstream stream{path, std::ios::in | std::ios::out | std::ios::trunc |
+                                  std::ios::binary};
+    {
+      boost::archive::binary_oarchive out{stream};
+      for (size_t i = 0; i < n; ++i) {
+        out << make(i);
+      }
+    }
+    stream.flush();
+    bytes = static_cast<size_t>(stream.tellp());
+    stream.seekg(0, std::ios::beg);
+    boost::archive::binary_iarchive in{stream};
+    T value;
+    for (size_t i = 0; i < n; ++i) {
+      in >> value;
+      benchmark::DoNotOptimize(value);
+    }
+  }
+  std::filesystem::remove(path);
+  state.counters["entities/s"] =
+      benchmark::Counter(n, benchmark::Counter::kIsIterationInvariantRate);
+  state.counters["bytes/entity"] = static_cast<double>(bytes) / n;
+}
+
+template <typename T>
+void spillSegmented(benchmark::State& state, T (*make)(size_t)) {
+  osm2rdf::config::Config config;
+  const auto n = static_cast<size_t>(state.range(0));
+  size_t bytes = 0;
+  for (auto _ : state) {
+    osm2rdf::osm::SegmentedSpill<T> spill{
+        config.getTempPath("SpillFormatBenchmark", "segmented")};
+    for (size_t i = 0; i < n; ++i) {
+      spill.write(make(i));
+    }
+    spill.flush();
+    bytes = spill.bytes();
+    T value;
+    for (size_t i = 0; i < n; ++i) {
+      spill.get(i, &value);
+      benchmark::DoNotOptimize(value);
+    }
+  }
+  state.counters["entities/s"] =
+      benchmark::Counter(n, benchmark::Counter::kIsIterationInvariantRate);
+  state.counters["bytes/entity"] = static_cast<double>(bytes) / n;
+}
+
+}  // namespace
+
+// ____________________________________________________________________________
+static void SpillFormat_Nodes_BoostArchive(benchmark::State& state) {
+  spillBoostArchive(state, &makeNode);
+}
+BENCHMARK(SpillFormat_Nodes_BoostArchive)
+    ->RangeMultiplier(10)
+    ->Range(1U << 10U, 1U << 20U)
+    ->Unit(benchmark::kMillisecond);
+
+// ____________________________________________________________________________
+static void SpillFormat_Nodes_SegmentedSpill(benchmark::State& state) {
+  spillSegmented(state, &makeNode);
+}
+BENCHMARK(SpillFormat_Nodes_SegmentedSpill)
+    ->RangeMultiplier(10)
+    ->Range(1U << 10U, 1U << 20U)
+    ->Unit(benchmark::kMillisecond);
+
+// ____________________________________________________________________________
+static void SpillFormat_Ways_BoostArchive(benchmark::State& state) {
+  spillBoostArchive(state, &makeWay);
+}
+BENCHMARK(SpillFormat_Ways_BoostArchive)
+    ->RangeMultiplier(10)
+    ->Range(1U << 10U, 1U << 18U)
+    ->Unit(benchmark::kMillisecond);
+
+// ____________________________________________________________________________
+static void SpillFormat_Ways_SegmentedSpill(benchmark::State& state) {
+  spillSegmented(state, &makeWay);
+}
+BENCHMARK(SpillFormat_Ways_SegmentedSpill)
+    ->RangeMultiplier(10)
+    ->Range(1U << 10U, 1U << 18U)
+    ->Unit(benchmark::kMillisecond);
@@ -23,6 +23,7 @@
 #include <filesystem>
 #include <string>
 #include <unordered_set>
+#include <vector>
 
 #include "osm2rdf/config/Constants.h"
 #include "osm2rdf/ttl/Format.h"
@@ -33,6 +34,10 @@ namespace osm2rdf::config {
 struct Config {
   // Select what to do
   std::string storeLocationsOnDisk;
+  bool storeNeededLocationsOnly = false;
+  bool storeWayNodesOnDisk = false;
+  bool relationCache = false;
+  size_t maxInFlightMB = 1024;
 
   bool noFacts = false;
   bool noAreaFacts = false;
@@ -55,6 +60,12 @@ struct Config {
   double simplifyGeometriesInnerOuter = 1 / (3.14 * 20);
   bool dontUseInnerOuterGeoms = false;
   bool approximateSpatialRels = false;
+  // Levels of the quadtree of grid cells used for box ids, the finest level
+  // has 2^n x 2^n cells.
+  uint16_t boxIdGridLevels = 13;
+  // Levels of the grid used to look up the candidate areas of nodes, 0 to
+  // query the r-tree instead.
+  uint16_t nodeGridLevels = 0;
 
   // Select amount to dump
   bool addAreaConvexHull = false;
@@ -76,6 +87,8 @@ struct Config {
   bool addWayNodeSpatialMetadata = false;
   bool addWayOrientedBoundingBox = false;
   bool adminRelationsOnly = false;
+  std::vector<std::string> includeTags;
+  std::vector<std::string> excludeTags;
   bool hasGeometryAsWkt = false;
   bool skipWikiLinks = false;
 
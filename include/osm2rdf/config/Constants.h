@@ -87,7 +87,44 @@ const static inline std::string STORE_LOCATIONS_ON_DISK_SHORT = "";
 const static inline std::string STORE_LOCATIONS_ON_DISK_LONG =
     "store-locations-on-disk";
 const static inline std::string STORE_LOCATIONS_ON_DISK_HELP =
-    "Store locations on disk, optional valid values: sparse (default), dense";
+    "Store locations on disk, optional valid values: sparse (default), "
+    "dense, compressed (requires nodes sorted by id)";
+
+const static inline std::string STORE_NEEDED_LOCATIONS_ONLY_INFO =
+    "Storing only locations of nodes referenced by ways and relations";
+const static inline std::string STORE_NEEDED_LOCATIONS_ONLY_OPTION_SHORT = "";
+const static inline std::string STORE_NEEDED_LOCATIONS_ONLY_OPTION_LONG =
+    "store-needed-locations-only";
+const static inline std::string STORE_NEEDED_LOCATIONS_ONLY_OPTION_HELP =
+    "Collect referenced nodes in OSM Pass 1 and store only their locations, "
+    "indexed by rank in a bitmap, not combinable with "
+    "--store-locations-on-disk";
+
+const static inline std::string STORE_WAY_NODES_ON_DISK_INFO =
+    "Storing node ids of relation member ways on disk";
+const static inline std::string STORE_WAY_NODES_ON_DISK_OPTION_SHORT = "";
+const static inline std::string STORE_WAY_NODES_ON_DISK_OPTION_LONG =
+    "store-way-nodes-on-disk";
+const static inline std::string STORE_WAY_NODES_ON_DISK_OPTION_HELP =
+    "Write node ids of ways referenced by relations to a file in the cache "
+    "directory instead of keeping them in memory";
+
+const static inline std::string MAX_IN_FLIGHT_MB_INFO =
+    "Maximal size of buffers converted in parallel (MB): ";
+const static inline std::string MAX_IN_FLIGHT_MB_OPTION_SHORT = "";
+const static inline std::string MAX_IN_FLIGHT_MB_OPTION_LONG =
+    "max-in-flight-mb";
+const static inline std::string MAX_IN_FLIGHT_MB_OPTION_HELP =
+    "Maximal size of osmium buffers waiting for or in conversion in MB, "
+    "reading pauses while the limit is reached";
+
+const static inline std::string RELATION_CACHE_INFO =
+    "Reusing relations from previous runs";
+const static inline std::string RELATION_CACHE_OPTION_SHORT = "";
+const static inline std::string RELATION_CACHE_OPTION_LONG = "relation-cache";
+const static inline std::string RELATION_CACHE_OPTION_HELP =
+    "Keep the relations read in OSM Pass 1 in the cache directory and reuse "
+    "them in later runs on the same input";
 
 const static inline std::string NO_FACTS_INFO = "Not dumping facts";
 const static inline std::string NO_FACTS_OPTION_SHORT = "";
@@ -326,6 +363,22 @@ const static inline std::string ADMIN_RELATIONS_ONLY_OPTION_LONG =
 const static inline std::string ADMIN_RELATIONS_ONLY_OPTION_HELP =
     "Only handle nodes and relations with \"admin-level\" tag";
 
+const static inline std::string INCLUDE_TAGS_INFO =
+    "Only handling objects matching: ";
+const static inline std::string INCLUDE_TAGS_OPTION_SHORT = "";
+const static inline std::string INCLUDE_TAGS_OPTION_LONG = "include-tag";
+const static inline std::string INCLUDE_TAGS_OPTION_HELP =
+    "Only handle objects with a matching tag, format: [type/]key[=value] "
+    "with type one of node, way, relation, area";
+
+const static inline std::string EXCLUDE_TAGS_INFO =
+    "Not handling objects matching: ";
+const static inline std::string EXCLUDE_TAGS_OPTION_SHORT = "";
+const static inline std::string EXCLUDE_TAGS_OPTION_LONG = "exclude-tag";
+const static inline std::string EXCLUDE_TAGS_OPTION_HELP =
+    "Do not handle objects with a matching tag, format: [type/]key[=value] "
+    "with type one of node, way, relation, area";
+
 const static inline std::string MINIMAL_AREA_ENVELOPE_RATIO_INFO =
     "Minimal area/envelope ratio: ";
 const static inline std::string MINIMAL_AREA_ENVELOPE_RATIO_OPTION_SHORT = "";
@@ -377,6 +430,26 @@ const static inline std::string APPROX_SPATIAL_REL_OPTION_HELP = "Use "
   "simplified inner/outer geometries for approximate calcuation of spatial "
   "relations";
 
+const static inline std::string BOX_ID_GRID_LEVELS_INFO =
+    "Levels of the box id grid: ";
+const static inline std::string BOX_ID_GRID_LEVELS_OPTION_SHORT = "";
+const static inline std::string BOX_ID_GRID_LEVELS_OPTION_LONG =
+    "box-id-grid-levels";
+const static inline std::string BOX_ID_GRID_LEVELS_OPTION_HELP =
+    "Number of levels of the quadtree of grid cells used to decide spatial "
+    "relations without geometric checks, the finest level has 2^n x 2^n "
+    "cells (1 to 15)";
+
+const static inline std::string NODE_GRID_LEVELS_INFO =
+    "Levels of the node grid: ";
+const static inline std::string NODE_GRID_LEVELS_OPTION_SHORT = "";
+const static inline std::string NODE_GRID_LEVELS_OPTION_LONG =
+    "node-grid-levels";
+const static inline std::string NODE_GRID_LEVELS_OPTION_HELP =
+    "Look up the candidate areas of nodes in a precomputed grid of "
+    "2^n x 2^n cells instead of the r-tree, 0 disables the grid (at most "
+    "12 and at most the box id grid levels, 12 levels use 128 MiB)";
+
 const static inline std::string SIMPLIFY_WKT_INFO = "Simplifying WKT";
 const static inline std::string SIMPLIFY_WKT_OPTION_SHORT = "s";
 const static inline std::string SIMPLIFY_WKT_OPTION_LONG = "simplify-wkt";
@@ -0,0 +1,85 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef OSM2RDF_GEOMETRY_BOXCLIPPER_H_
+#define OSM2RDF_GEOMETRY_BOXCLIPPER_H_
+
+#include <vector>
+
+#include "osm2rdf/geometry/Area.h"
+#include "osm2rdf/geometry/Box.h"
+#include "osm2rdf/geometry/Location.h"
+#include "osm2rdf/geometry/Polygon.h"
+#include "osm2rdf/geometry/Ring.h"
+
+namespace osm2rdf::geometry {
+
+// Clips areas to an axis-aligned box in time linear in the number of points.
+// The parts of the rings inside the box are joined along the box boundary,
+// so areas falling apart inside the box become separate polygons. Expects
+// valid areas with closed, clockwise outer rings as produced by
+// boost::geometry::correct. Like boost::geometry::intersection, parts of the
+// result with zero area are dropped.
+class BoxClipper {
+ public:
+  explicit BoxClipper(const osm2rdf::geometry::Box& box);
+
+  [[nodiscard]] osm2rdf::geometry::Area clip(
+      const osm2rdf::geometry::Area& area) const;
+  void clip(const osm2rdf::geometry::Polygon& polygon,
+            osm2rdf::geometry::Area* out) const;
+
+ protected:
+  enum class RingClip { INSIDE, OUTSIDE, CROSSING };
+
+  // Part of a ring inside the box which starts and ends on the boundary.
+  struct Chain {
+    std::vector<osm2rdf::geometry::Location> points;
+    double start;
+    double end;
+  };
+
+  // Add the parts of the ring inside the box to chains.
+  RingClip clipRing(const osm2rdf::geometry::Ring& ring,
+                    std::vector<Chain>* chains) const;
+  // Clip the segment from a to b, false if at most a point is left.
+  bool clipSegment(osm2rdf::geometry::Location* a,
+                   osm2rdf::geometry::Location* b) const;
+  // Whether the clipped segment from a to b has the inside of the box on its
+  // right, i.e. it does not run counter-clockwise along the boundary.
+  [[nodiscard]] bool insideRight(const osm2rdf::geometry::Location& a,
+                                 const osm2rdf::geometry::Location& b) const;
+  [[nodiscard]] bool onBoundary(const osm2rdf::geometry::Location& a,
+                                const osm2rdf::geometry::Location& b) const;
+  // Position of a point on the boundary, clockwise from the lower left.
+  [[nodiscard]] double position(const osm2rdf::geometry::Location& p) const;
+  // Connect chains to rings, each chain's end to the next start clockwise.
+  [[nodiscard]] std::vector<osm2rdf::geometry::Ring> join(
+      std::vector<Chain>* chains) const;
+  [[nodiscard]] bool containsCenter(const osm2rdf::geometry::Ring& ring) const;
+  [[nodiscard]] osm2rdf::geometry::Ring boxRing() const;
+
+  double _minX;
+  double _minY;
+  double _maxX;
+  double _maxY;
+};
+
+}  // namespace osm2rdf::geometry
+
+#endif  // OSM2RDF_GEOMETRY_BOXCLIPPER_H_
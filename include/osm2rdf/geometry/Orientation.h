@@ -0,0 +1,54 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef OSM2RDF_GEOMETRY_ORIENTATION_H_
+#define OSM2RDF_GEOMETRY_ORIENTATION_H_
+
+#include "osm2rdf/geometry/Location.h"
+#include "osm2rdf/geometry/Ring.h"
+
+namespace osm2rdf::geometry {
+
+// Twice the signed area of the triangle abc, positive if c lies left of the
+// directed line from a to b.
+inline double cross(const Location& a, const Location& b, const Location& c) {
+  return (b.x() - a.x()) * (c.y() - a.y()) - (b.y() - a.y()) * (c.x() - a.x());
+}
+
+// Sign of cross(a, b, c): 1 if c lies left of the directed line from a to b,
+// -1 if right and 0 if the points are collinear. Computed in plain double
+// precision, so points very close to the line may get the wrong sign.
+inline int orientation(const Location& a, const Location& b,
+                       const Location& c) {
+  const auto value = cross(a, b, c);
+  return value > 0 ? 1 : value < 0 ? -1 : 0;
+}
+
+// 1 if the ring is counter-clockwise, -1 if clockwise and 0 if degenerated,
+// see https://de.wikipedia.org/wiki/Gau%C3%9Fsche_Trapezformel
+inline int ringOrientation(const Ring& ring) {
+  double sum = 0;
+  for (size_t i = 0; i + 1 < ring.size(); i++) {
+    sum += (ring[i].x() - ring[i + 1].x()) * (ring[i].y() + ring[i + 1].y());
+  }
+  return sum < 0 ? -1 : sum > 0 ? 1 : 0;
+}
+
+}  // namespace osm2rdf::geometry
+
+#endif  // OSM2RDF_GEOMETRY_ORIENTATION_H_
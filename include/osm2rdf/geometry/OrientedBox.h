@@ -0,0 +1,58 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef OSM2RDF_GEOMETRY_ORIENTEDBOX_H_
+#define OSM2RDF_GEOMETRY_ORIENTEDBOX_H_
+
+#include <algorithm>
+#include <array>
+
+#include "boost/geometry/geometries/register/ring.hpp"
+#include "boost/serialization/array.hpp"
+#include "osm2rdf/geometry/Box.h"
+#include "osm2rdf/geometry/Location.h"
+#include "osm2rdf/geometry/Polygon.h"
+
+namespace osm2rdf::geometry {
+
+// Oriented bounding box as a closed clockwise ring, stored inline.
+typedef std::array<osm2rdf::geometry::Location, 5> OrientedBox;
+
+// The outer ring of obb, or the corners of envelope if obb is not a box.
+inline OrientedBox orientedBox(const osm2rdf::geometry::Polygon& obb,
+                               const osm2rdf::geometry::Box& envelope) {
+  OrientedBox result;
+  if (obb.outer().size() == result.size()) {
+    std::copy(obb.outer().begin(), obb.outer().end(), result.begin());
+    return result;
+  }
+  const auto& min = envelope.min_corner();
+  const auto& max = envelope.max_corner();
+  result = {{{min.x(), min.y()},
+             {min.x(), max.y()},
+             {max.x(), max.y()},
+             {max.x(), min.y()},
+             {min.x(), min.y()}}};
+  return result;
+}
+
+}  // namespace osm2rdf::geometry
+
+BOOST_GEOMETRY_REGISTER_RING(osm2rdf::geometry::OrientedBox)
+
+#endif  // OSM2RDF_GEOMETRY_ORIENTEDBOX_H_
@@ -0,0 +1,82 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef OSM2RDF_OSM_BOXIDINTERSECT_H_
+#define OSM2RDF_OSM_BOXIDINTERSECT_H_
+
+#include <cstdint>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+#include "osm2rdf/util/Span.h"
+
+namespace osm2rdf::osm {
+
+// Run of grid cell ids, ordered along a Hilbert curve such that each
+// quadtree node is a single run: the first id, negative if the cells are
+// only partially covered, and the number of further ids.
+typedef std::pair<int32_t, uint32_t> BoxId;
+
+struct BoxIdCmp {
+  bool operator()(const BoxId& left, const BoxId& right) {
+    return abs(left.first) < abs(right.first);
+  }
+  bool operator()(const BoxId& left, int32_t right) {
+    return abs(left.first) < abs(right);
+  }
+};
+
+// Sorted, disjoint runs. The first entry holds the number of ids in its
+// first member.
+typedef std::vector<BoxId> BoxIdList;
+// Box id list stored elsewhere, e.g. in a pool shared by many areas.
+typedef osm2rdf::util::Span<BoxId> BoxIdSpan;
+
+// Intersection of two box id lists. Both lists are merged run by run, runs
+// of one list ending before the current position in the other are skipped
+// by a kernel: a linear scan, a linear scan over four runs at once, or a
+// galloping search for lists much longer than the other one.
+class BoxIdIntersect {
+ public:
+  // Implementations of the skip, all return the same results.
+  enum class Kernel { SCALAR, AVX2, GALLOP };
+
+  // Add the ids of a in partially covered runs of b to toCheck and return
+  // the number of ids of a in fully covered runs of b. Returns early once a
+  // is known to intersect b, but not to be contained in it. Picks the kernel
+  // for each list from the list sizes.
+  static int isect(BoxIdSpan a, BoxIdSpan b, std::vector<int32_t>* toCheck);
+  static int isect(BoxIdSpan a, BoxIdSpan b, std::vector<int32_t>* toCheck,
+                   Kernel kernel);
+
+  // Whether any id of a lies in a fully covered run of b, returns at the
+  // first such id.
+  static bool anyFull(BoxIdSpan a, BoxIdSpan b);
+  static bool anyFull(BoxIdSpan a, BoxIdSpan b, Kernel kernel);
+
+  // Whether the CPU running this supports the kernel.
+  static bool supported(Kernel kernel);
+  // Fastest linear kernel supported by the CPU running this.
+  static Kernel bestKernel();
+};
+
+}  // namespace osm2rdf::osm
+
+#endif  // OSM2RDF_OSM_BOXIDINTERSECT_H_
@@ -0,0 +1,88 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef OSM2RDF_OSM_COMPRESSEDLOCATIONSTORE_H_
+#define OSM2RDF_OSM_COMPRESSEDLOCATIONSTORE_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <vector>
+
+#include "osm2rdf/util/CacheFile.h"
+#include "osmium/osm/location.hpp"
+
+namespace osm2rdf::osm {
+
+// Node locations stored on disk in blocks of NODES_PER_BLOCK consecutive ids.
+// Each block stores its nodes as id offset and delta/varint encoded
+// coordinates, a directory in memory holds the file offset of each block.
+// The file is mapped after all nodes are stored, lookups decode whole blocks
+// into a small per-thread cache.
+class CompressedLocationStore {
+ public:
+  static const uint64_t NODES_PER_BLOCK = 256;
+
+  explicit CompressedLocationStore(const std::filesystem::path& path);
+  ~CompressedLocationStore();
+  CompressedLocationStore(const CompressedLocationStore&) = delete;
+  CompressedLocationStore& operator=(const CompressedLocationStore&) = delete;
+
+  // Store the location of a node. Ids have to be sorted by block, as they
+  // are in osm files.
+  void set(uint64_t id, const osmium::Location& location);
+  // Write remaining data and map the file. Can be called multiple times and
+  // from multiple threads.
+  void finalize();
+  // Return the location of a node or an undefined location, requires
+  // finalize().
+  [[nodiscard]] osmium::Location get(uint64_t id) const;
+  // Advise the kernel to read the blocks of the given ids ahead, requires
+  // finalize().
+  void prefetch(const uint64_t* ids, size_t count) const;
+  // Number of bytes written to disk.
+  [[nodiscard]] uint64_t fileSize() const noexcept;
+
+ protected:
+  // Append the current block to the write buffer.
+  void flushBlock();
+  // Write the write buffer to the file.
+  void flushWriteBuffer();
+  void doFinalize();
+
+  osm2rdf::util::CacheFile _cacheFile;
+  // Identifies this store in the per-thread block cache.
+  const uint64_t _storeId;
+  // File offset of each block, followed by the end of the last block.
+  std::vector<uint64_t> _blockOffsets;
+  uint64_t _fileSize = 0;
+  // Block currently written.
+  uint64_t _currentBlock = 0;
+  bool _hasCurrentBlock = false;
+  std::vector<uint8_t> _currentData;
+  int64_t _lastX = 0;
+  int64_t _lastY = 0;
+  std::vector<uint8_t> _writeBuffer;
+  std::once_flag _finalized;
+  bool _isFinalized = false;
+  const uint8_t* _mapped = nullptr;
+};
+
+}  // namespace osm2rdf::osm
+
+#endif  // OSM2RDF_OSM_COMPRESSEDLOCATIONSTORE_H_
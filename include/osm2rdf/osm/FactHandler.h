@@ -20,11 +20,19 @@
 #ifndef OSM2RDF_OSM_FACTHANDLER_H_
 #define OSM2RDF_OSM_FACTHANDLER_H_
 
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <ostream>
 
 #include "gtest/gtest_prod.h"
 #include "osm2rdf/config/Config.h"
+#include "osm2rdf/osm/NodeView.h"
+#include "osm2rdf/osm/TagKeyDictionary.h"
+#include "osm2rdf/osm/TagList.h"
+#include "osm2rdf/osm/WayView.h"
 #include "osm2rdf/ttl/Writer.h"
+#include "osmium/tags/taglist.hpp"
 
 namespace osm2rdf::osm {
 
@@ -33,11 +41,13 @@ class FactHandler {
  public:
   FactHandler(const osm2rdf::config::Config& config,
               osm2rdf::ttl::Writer<W>* writer);
+  FactHandler(FactHandler&& other) = default;
+  ~FactHandler();
   // Add data
   void area(const osm2rdf::osm::Area& area);
-  void node(const osm2rdf::osm::Node& node);
+  void node(const osm2rdf::osm::NodeView& node);
   void relation(const osm2rdf::osm::Relation& relation);
-  void way(const osm2rdf::osm::Way& way);
+  void way(const osm2rdf::osm::WayView& way);
 
   template <typename G>
   void writeBoostGeometry(const std::string& s, const std::string& p,
@@ -55,6 +65,8 @@ class FactHandler {
   FRIEND_TEST(OSM_FactHandler, writeBoxPrecision2);
 
   void writeTag(const std::string& s, const osm2rdf::osm::Tag& tag);
+  void writeTag(const std::string& s, osm2rdf::osm::TagKeyId keyId,
+                const std::string& value);
   FRIEND_TEST(OSM_FactHandler, writeTag_AdminLevel);
   FRIEND_TEST(OSM_FactHandler, writeTag_AdminLevel_nonInteger);
   FRIEND_TEST(OSM_FactHandler, writeTag_AdminLevel_nonInteger2);
@@ -68,6 +80,7 @@ class FactHandler {
   FRIEND_TEST(OSM_FactHandler, writeTag_KeyNotIRI);
 
   void writeTagList(const std::string& s, const osm2rdf::osm::TagList& tags);
+  void writeTagList(const std::string& s, const osmium::TagList& tags);
   FRIEND_TEST(OSM_FactHandler, writeTagList);
   FRIEND_TEST(OSM_FactHandler, writeTagListWikidata);
   FRIEND_TEST(OSM_FactHandler, writeTagListRefSingle);
@@ -76,11 +89,23 @@ class FactHandler {
   FRIEND_TEST(OSM_FactHandler, writeTagListWikipediaWithLang);
   FRIEND_TEST(OSM_FactHandler, writeTagListWikipediaWithoutLang);
   FRIEND_TEST(OSM_FactHandler, writeTagListSkipWikiLinks);
+  FRIEND_TEST(OSM_FactHandler, writeTagListOsmium);
+  // Write the triples for a single tag, return their number.
+  size_t writeTagListEntry(const std::string& s, osm2rdf::osm::TagKeyId keyId,
+                           const std::string& value);
 
   bool hasSuffix(const std::string& s, const std::string& suffix) const;
 
+  // Return the IRI for a tag key, generated once per key. Keys in the
+  // overflow of the TagKeyDictionary are not cached, their IRI is valid
+  // until the next call on the same thread.
+  const std::string& tagKeyIRI(osm2rdf::osm::TagKeyId keyId);
+
   const osm2rdf::config::Config _config;
   osm2rdf::ttl::Writer<W>* _writer;
+  // IRIs indexed by tag key id, allocated and filled on first use.
+  std::unique_ptr<std::atomic<const std::string*>[]> _tagKeyIRIs;
+  std::once_flag _tagKeyIRIsAllocated;
 };
 
 }  // namespace osm2rdf::osm
@@ -0,0 +1,140 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef OSM2RDF_OSM_FLATRTREE_H_
+#define OSM2RDF_OSM_FLATRTREE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "osm2rdf/geometry/Box.h"
+
+namespace osm2rdf::osm {
+
+// Static R-tree over boxes, packed bottom up in Hilbert order of the box
+// centers. Each node stores the boxes of its NODE_SIZE children as one float
+// array per coordinate, rounded outwards, such that all children of a node are
+// tested at once with vector instructions where the CPU supports them.
+// Candidates at the leaves are confirmed with the exact box, so queries return
+// the same values as a boost::geometry::index::rtree with the same predicate.
+// Immutable after construction and thus safe to share between threads.
+class FlatRTree {
+ public:
+  typedef std::pair<osm2rdf::geometry::Box, size_t> Value;
+  // Implementations of the child test, all return the same results.
+  enum class Kernel { SCALAR, AVX2, AVX512 };
+
+  static const size_t NODE_SIZE = 16;
+
+  FlatRTree() = default;
+  explicit FlatRTree(const std::vector<Value>& values);
+  FlatRTree(const std::vector<Value>& values, Kernel kernel);
+
+  // Call visitor(box, value) for each value whose box intersects box, like
+  // boost::geometry::index::intersects. Does not allocate.
+  template <typename Visitor>
+  void queryIntersects(const osm2rdf::geometry::Box& box,
+                       Visitor&& visitor) const {
+    query<false>(box, visitor);
+  }
+  // Call visitor(box, value) for each value whose box covers box, like
+  // boost::geometry::index::covers. Does not allocate.
+  template <typename Visitor>
+  void queryCovers(const osm2rdf::geometry::Box& box,
+                   Visitor&& visitor) const {
+    query<true>(box, visitor);
+  }
+
+  [[nodiscard]] size_t size() const noexcept { return _values.size(); }
+  [[nodiscard]] size_t numLevels() const noexcept { return _levels.size(); }
+
+  // Whether the CPU running this supports the kernel.
+  static bool supported(Kernel kernel);
+  // Fastest kernel supported by the CPU running this.
+  static Kernel bestKernel();
+
+ protected:
+  // Child boxes of a node: min x, min y, max x, max y. Unused children have
+  // an empty box of finite sentinels outside of all other bounds.
+  struct alignas(64) Node {
+    float coords[4][NODE_SIZE];
+  };
+
+  // A child matches if min x <= bounds[0], min y <= bounds[1],
+  // max x >= bounds[2] and max y >= bounds[3]. Returns a bit per child.
+  typedef uint32_t (*MaskKernel)(const float* node, const float* bounds);
+
+  template <bool COVERS, typename Visitor>
+  void query(const osm2rdf::geometry::Box& box, Visitor& visitor) const {
+    if (_levels.empty()) {
+      return;
+    }
+    float bounds[4];
+    queryBounds(box, COVERS, bounds);
+    visit<COVERS>(_levels.size() - 1, 0, box, bounds, visitor);
+  }
+
+  template <bool COVERS, typename Visitor>
+  void visit(size_t level, size_t node, const osm2rdf::geometry::Box& box,
+             const float* bounds, Visitor& visitor) const {
+    for (uint32_t mask = _mask(_levels[level][node].coords[0], bounds);
+         mask != 0; mask &= mask - 1) {
+      const size_t child = node * NODE_SIZE + __builtin_ctz(mask);
+      if (level > 0) {
+        visit<COVERS>(level - 1, child, box, bounds, visitor);
+      } else if (child < _boxes.size() &&
+                 (COVERS ? covers(_boxes[child], box)
+                         : intersects(_boxes[child], box))) {
+        visitor(_boxes[child], _values[child]);
+      }
+    }
+  }
+
+  // Float bounds for the child test, rounded such that no match is lost.
+  static void queryBounds(const osm2rdf::geometry::Box& box, bool covers,
+                          float* bounds);
+  static bool intersects(const osm2rdf::geometry::Box& a,
+                         const osm2rdf::geometry::Box& b) {
+    return a.min_corner().get<0>() <= b.max_corner().get<0>() &&
+           a.min_corner().get<1>() <= b.max_corner().get<1>() &&
+           a.max_corner().get<0>() >= b.min_corner().get<0>() &&
+           a.max_corner().get<1>() >= b.min_corner().get<1>();
+  }
+  static bool covers(const osm2rdf::geometry::Box& a,
+                     const osm2rdf::geometry::Box& b) {
+    return a.min_corner().get<0>() <= b.min_corner().get<0>() &&
+           a.min_corner().get<1>() <= b.min_corner().get<1>() &&
+           a.max_corner().get<0>() >= b.max_corner().get<0>() &&
+           a.max_corner().get<1>() >= b.max_corner().get<1>();
+  }
+
+  MaskKernel _mask = nullptr;
+  // Boxes and values in Hilbert order, child i of node j on level 0.
+  std::vector<osm2rdf::geometry::Box> _boxes;
+  std::vector<size_t> _values;
+  // Level 0 holds the boxes of the values, level i + 1 the bounding boxes of
+  // the nodes on level i. The last level has a single node, the root.
+  std::vector<std::vector<Node>> _levels;
+};
+
+}  // namespace osm2rdf::osm
+
+#endif  // OSM2RDF_OSM_FLATRTREE_H_
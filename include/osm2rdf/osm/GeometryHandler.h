@@ -20,7 +20,9 @@
 #ifndef OSM2RDF_OSM_GEOMETRYHANDLER_H_
 #define OSM2RDF_OSM_GEOMETRYHANDLER_H_
 
+#include <atomic>
 #include <iostream>
+#include <memory>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -33,19 +35,33 @@
 #include "osm2rdf/geometry/Area.h"
 #include "osm2rdf/geometry/Location.h"
 #include "osm2rdf/geometry/Node.h"
+#include "osm2rdf/geometry/OrientedBox.h"
 #include "osm2rdf/geometry/Way.h"
 #include "osm2rdf/osm/Area.h"
+#include "osm2rdf/osm/BoxIdIntersect.h"
+#include "osm2rdf/osm/FlatRTree.h"
+#include "osm2rdf/osm/NodeView.h"
+#include "osm2rdf/osm/PreparedArea.h"
+#include "osm2rdf/osm/SegmentedSpill.h"
+#include "osm2rdf/osm/SpatialQueryBuffer.h"
+#include "osm2rdf/osm/WayView.h"
 #include "osm2rdf/ttl/Writer.h"
 #include "osm2rdf/util/CacheFile.h"
 #include "osm2rdf/util/DirectedGraph.h"
 #include "osm2rdf/util/Output.h"
+#include "osm2rdf/util/Span.h"
 
 namespace osm2rdf::osm {
 
-const static int NUM_GRID_CELLS = 5000;
+// Consecutive spilled nodes are grouped by grid cell in batches of this size.
+const static size_t NODE_BATCH_SIZE = 4096;
 
-const static double GRID_W = 360.0 / NUM_GRID_CELLS;
-const static double GRID_H = 180.0 / NUM_GRID_CELLS;
+// Set in a node grid entry if the area fully covers the cell.
+const static uint32_t NODE_GRID_FULL = 1u << 31;
+
+// With ENABLE_PREPARED_AREAS, named areas with at least this many points get
+// a PreparedArea for point containment checks.
+const static size_t PREPARED_AREA_MIN_POINTS = 1000;
 
 struct GeomRelationStats {
   size_t _totalChecks = 0;
@@ -67,6 +83,9 @@ struct GeomRelationStats {
   std::shared_ptr<std::ofstream> _fullCheckFile;
   std::shared_ptr<std::mutex> _checkFileMutex = std::make_shared<std::mutex>();
 
+  // Counts only, without a full check file.
+  GeomRelationStats() = default;
+
   explicit GeomRelationStats(const std::string& filename) {
     std::string checkFileName = filename + ".full-check.tsv";
     _fullCheckFile = std::make_shared<std::ofstream>(checkFileName);
@@ -110,13 +129,16 @@ struct GeomRelationStats {
   void skippedByNodeContained() { _skippedByNodeContained++; }
   template <typename L, typename R>
   void fullCheck(const L& leftGeom, const R& rightGeom, bool result, double timeInSeconds) {
+    _fullChecks++;
+    if (_fullCheckFile == nullptr) {
+      return;
+    }
     size_t numPointsLeft = boost::geometry::num_points(leftGeom);
     size_t numPointsRight = boost::geometry::num_points(rightGeom);
     // TODO<joka921> Buffer locally.
-    std::lock_guard l{_checkFileMutex};
+    std::lock_guard l{*_checkFileMutex};
     *_fullCheckFile << numPointsLeft << ' ' << numPointsRight << ' '
                     << timeInSeconds << ' ' << result << std::endl;
-    _fullChecks++;
   }
 
   [[nodiscard]] std::string printPercNum(size_t n) const {
@@ -177,8 +199,6 @@ struct GeomRelationStats {
 #pragma omp declare reduction(+ : GeomRelationStats : omp_out += omp_in) \
     initializer(omp_priv = omp_orig)
 
-typedef std::pair<int32_t, uint8_t> BoxId;
-
 enum class RelInfoValue { DONT_KNOW, YES, NO };
 
 enum class AreaFromType { RELATION, WAY };
@@ -213,28 +233,83 @@ struct MemberRelCmp {
   }
 };
 
-struct BoxIdCmp {
-  bool operator()(const BoxId& left, const BoxId& right) {
-    return abs(left.first) < abs(right.first);
-  }
-  bool operator()(const BoxId& left, int32_t right) {
-    return abs(left.first) < abs(right);
-  }
+// Geometry of an area that is only needed for exact checks.
+struct SpatialAreaGeometry {
+  osm2rdf::geometry::Area geom;
+  // Simplified geometries covered by / covering geom, may be empty.
+  osm2rdf::geometry::Area inner;
+  osm2rdf::geometry::Area outer;
+  // Parts of geom inside partially covered grid cells, by box id.
+  std::unordered_map<int32_t, osm2rdf::geometry::Area> cutouts;
+  osm2rdf::geometry::Polygon convexHull;
 };
 
-typedef std::vector<BoxId> BoxIdList;
+// Area as built from an osm area, unnamed areas are spilled in this form.
+struct SpatialAreaData {
+  // Envelope of the whole area, then of each of its polygons.
+  std::vector<osm2rdf::geometry::Box> envelopes;
+  osm2rdf::osm::Area::id_t id = 0;
+  osm2rdf::osm::Area::id_t objId = 0;
+  osm2rdf::geometry::area_result_t area = 0;
+  AreaFromType fromType = AreaFromType::RELATION;
+  osm2rdf::osm::BoxIdList boxIds;
+  osm2rdf::geometry::OrientedBox obb;
+  SpatialAreaGeometry geometry;
+};
 
-// Area: envelope, id, geometry, osm id, area, fromWay
-typedef std::tuple<std::vector<osm2rdf::geometry::Box>,
-                   osm2rdf::osm::Area::id_t, osm2rdf::geometry::Area,
-                   osm2rdf::osm::Area::id_t, osm2rdf::geometry::area_result_t,
-                   AreaFromType, osm2rdf::geometry::Area,
-                   osm2rdf::geometry::Area, osm2rdf::osm::BoxIdList,
-                   std::unordered_map<int32_t, osm2rdf::geometry::Area>,
-                   osm2rdf::geometry::Polygon, osm2rdf::geometry::Polygon>
-    SpatialAreaValue;
+// Entries [offset, offset + count) of a pool.
+struct PoolSpan {
+  uint64_t offset = 0;
+  uint32_t count = 0;
+};
 
-typedef std::pair<osm2rdf::geometry::Box, size_t> SpatialAreaRefValue;
+// Named area: the fields used to filter candidates. Envelopes and box ids
+// are spans of pools shared by all named areas, the geometry is an index
+// into a separate vector.
+struct SpatialAreaValue {
+  osm2rdf::osm::Area::id_t id = 0;
+  osm2rdf::osm::Area::id_t objId = 0;
+  osm2rdf::geometry::area_result_t area = 0;
+  AreaFromType fromType = AreaFromType::RELATION;
+  uint32_t geometry = 0;
+  PoolSpan envelopes;
+  PoolSpan boxIds;
+  osm2rdf::geometry::OrientedBox obb;
+};
+
+// Named or unnamed area as seen by the geometric checks.
+struct SpatialAreaView {
+  SpatialAreaView(const SpatialAreaData& data)  // NOLINT(runtime/explicit)
+      : id(data.id),
+        objId(data.objId),
+        area(data.area),
+        fromType(data.fromType),
+        envelopes(data.envelopes),
+        boxIds(data.boxIds),
+        obb(&data.obb),
+        geometry(&data.geometry) {}
+  SpatialAreaView(const SpatialAreaValue& value,
+                  const osm2rdf::geometry::Box* envelopes,
+                  const osm2rdf::osm::BoxId* boxIds,
+                  const SpatialAreaGeometry* geometry)
+      : id(value.id),
+        objId(value.objId),
+        area(value.area),
+        fromType(value.fromType),
+        envelopes(envelopes + value.envelopes.offset, value.envelopes.count),
+        boxIds(boxIds + value.boxIds.offset, value.boxIds.count),
+        obb(&value.obb),
+        geometry(geometry + value.geometry) {}
+
+  osm2rdf::osm::Area::id_t id;
+  osm2rdf::osm::Area::id_t objId;
+  osm2rdf::geometry::area_result_t area;
+  AreaFromType fromType;
+  osm2rdf::util::Span<osm2rdf::geometry::Box> envelopes;
+  osm2rdf::osm::BoxIdSpan boxIds;
+  const osm2rdf::geometry::OrientedBox* obb;
+  const SpatialAreaGeometry* geometry;
+};
 
 typedef std::vector<SpatialAreaValue> SpatialAreaVector;
 
@@ -266,9 +341,13 @@ typedef std::tuple<osm2rdf::geometry::Box, osm2rdf::osm::Way::id_t,
     SpatialWayValue;
 typedef std::vector<SpatialWayValue> SpatialWayVector;
 
+#if defined(ENABLE_FLAT_AREA_INDEX)
+typedef osm2rdf::osm::FlatRTree SpatialIndex;
+#else
 typedef boost::geometry::index::rtree<SpatialAreaRefValue,
                                       boost::geometry::index::quadratic<32>>
     SpatialIndex;
+#endif
 
 // node osm id -> area ids (not osm id)
 typedef std::unordered_map<osm2rdf::osm::Node::id_t,
@@ -284,9 +363,9 @@ class GeometryHandler {
 
   // Add data
   void area(const osm2rdf::osm::Area& area);
-  void node(const osm2rdf::osm::Node& node);
+  void node(const osm2rdf::osm::NodeView& node);
   void relation(const osm2rdf::osm::Relation& relation);
-  void way(const osm2rdf::osm::Way& way);
+  void way(const osm2rdf::osm::WayView& way);
 
   // close external storage files
   void flushExternalStorage();
@@ -294,6 +373,12 @@ class GeometryHandler {
   void calculateRelations();
 
  protected:
+  // Reorder spilled nodes, ways and unnamed areas along a Hilbert curve, such
+  // that consecutive entries of the dump phases query nearby areas.
+  void sortExternalStorage();
+  template <typename T>
+  void sortExternalStorage(SegmentedSpill<T>* spill, const std::string& name);
+
   // Stores named areas in r-tree, used for all other calculations.
   void prepareRTree();
   FRIEND_TEST(OSM_GeometryHandler, prepareRTreeEmpty);
@@ -325,6 +410,8 @@ class GeometryHandler {
   FRIEND_TEST(OSM_GeometryHandler, dumpNodeRelationsEmpty2);
   FRIEND_TEST(OSM_GeometryHandler, dumpNodeRelationsSimpleIntersects);
   FRIEND_TEST(OSM_GeometryHandler, dumpNodeRelationsSimpleContains);
+  FRIEND_TEST(OSM_GeometryHandler, dumpNodeRelationsSimpleContainsNodeGrid);
+  FRIEND_TEST(OSM_GeometryHandler, dumpNodeRelationsMultipleOuterSameCell);
 
   // Calculate relations for each way.
   void dumpWayRelations(
@@ -343,21 +430,28 @@ class GeometryHandler {
   FRIEND_TEST(OSM_GeometryHandler, simplifyGeometryArea);
   FRIEND_TEST(OSM_GeometryHandler, simplifyGeometryWay);
 
-  bool areaInArea(const SpatialAreaValue& a, const SpatialAreaValue&,
+  bool areaInArea(const SpatialAreaView& a, const SpatialAreaView&,
                   GeomRelationInfo* geomRelInf, GeomRelationStats* stats) const;
-  bool areaInAreaApprox(const SpatialAreaValue& a, const SpatialAreaValue&,
+  bool areaInAreaApprox(const SpatialAreaView& a, const SpatialAreaView&,
                         GeomRelationInfo* geomRelInf,
                         GeomRelationStats* stats) const;
-  bool nodeInArea(const SpatialNodeValue& a, const SpatialAreaValue&,
+  bool nodeInArea(const SpatialNodeValue& a, size_t areaIndex,
                   GeomRelationInfo* geomRelInf,
                   GeomRelationStats* statsa) const;
-  bool wayInArea(const SpatialWayValue& a, const SpatialAreaValue&,
+  // Prepared form of the named area with the given index, built on first use
+  // and shared between threads. nullptr for areas with few points and
+  // without ENABLE_PREPARED_AREAS.
+  const PreparedArea* preparedArea(size_t areaIndex) const;
+  // Full check whether node lies in the named area with the given index.
+  bool nodeCoveredBy(const osm2rdf::geometry::Node& node,
+                     size_t areaIndex) const;
+  bool wayInArea(const SpatialWayValue& a, const SpatialAreaView&,
                  GeomRelationInfo* geomRelInf, GeomRelationStats* stats) const;
-  bool wayIntersectsArea(const SpatialWayValue& a, const SpatialAreaValue&,
+  bool wayIntersectsArea(const SpatialWayValue& a, const SpatialAreaView&,
                          GeomRelationInfo* geomRelInf,
                          GeomRelationStats* stats) const;
 
-  bool areaIntersectsArea(const SpatialAreaValue& a, const SpatialAreaValue&,
+  bool areaIntersectsArea(const SpatialAreaView& a, const SpatialAreaView&,
                           GeomRelationInfo* geomRelInf,
                           GeomRelationStats* stats) const;
 
@@ -389,11 +483,20 @@ class GeometryHandler {
       const std::vector<osm2rdf::osm::Area::id_t>& successors,
       const std::string& entryIRI, const std::string& rel);
 
+  // Grid cell containing the coordinate, clamped to the grid.
+  int32_t gridCell(double coordinate, double offset, double cellSize) const;
+  // Id of the grid cell (x, y).
+  int32_t cellId(int32_t x, int32_t y) const;
+  // Box of the size x size grid cells starting at (x, y).
+  osm2rdf::geometry::Box cellBox(int32_t x, int32_t y, int32_t size) const;
+
+  // Add the box ids of the quadtree node with size x size grid cells
+  // starting at (x, y).
   void getBoxIds(
       const osm2rdf::geometry::Area& area, const osm2rdf::geometry::Area& inner,
       const osm2rdf::geometry::Area& outer,
-      const std::vector<osm2rdf::geometry::Box>& envelopes, int xFrom, int xTo,
-      int yFrom, int yTo, int xWidth, int yHeight, osm2rdf::osm::BoxIdList* ret,
+      const std::vector<osm2rdf::geometry::Box>& envelopes, int32_t x,
+      int32_t y, int32_t size, osm2rdf::osm::BoxIdList* ret,
       const osm2rdf::geometry::Area& curISect,
       std::unordered_map<int32_t, osm2rdf::geometry::Area>* cutouts) const;
 
@@ -409,9 +512,12 @@ class GeometryHandler {
       const osm2rdf::geometry::Box& envelope) const;
 
   int32_t getBoxId(const osm2rdf::geometry::Location&) const;
+  // Whether the grid cell boxId is fully (1), partially (-1) or not (0)
+  // covered by the area with the given box ids.
+  int8_t boxIdCover(int32_t boxId, osm2rdf::osm::BoxIdSpan boxIds) const;
+  FRIEND_TEST(OSM_GeometryHandler, boxIdCover);
 
-  void boxIdIsect(const osm2rdf::osm::BoxIdList& idsA,
-                  const osm2rdf::osm::BoxIdList& idsB,
+  void boxIdIsect(osm2rdf::osm::BoxIdSpan idsA, osm2rdf::osm::BoxIdSpan idsB,
                   GeomRelationInfo* geomRelInf) const;
   FRIEND_TEST(OSM_GeometryHandler, boxIdintersect);
 
@@ -420,28 +526,64 @@ class GeometryHandler {
   uint8_t borderContained(osm2rdf::osm::Way::id_t wayId,
                           osm2rdf::osm::Area::id_t areaId) const;
 
-  std::vector<SpatialAreaRefValue> indexQryCover(
-      const SpatialAreaValue& area) const;
-  std::vector<SpatialAreaRefValue> indexQry(const SpatialNodeValue& node) const;
-  std::vector<SpatialAreaRefValue> indexQryIntersect(
-      const SpatialAreaValue& area) const;
-  std::vector<SpatialAreaRefValue> indexQryIntersect(
+  // Index queries return areas ordered small -> big without duplicates. The
+  // result lives in the buffer of the calling thread and is valid until its
+  // next query.
+  const std::vector<SpatialAreaRefValue>& indexQryCover(
+      const SpatialAreaView& area) const;
+  // Areas intersecting envelope which cover parts of the grid cell boxId,
+  // with their cover as returned by boxIdCover().
+  const std::vector<std::pair<SpatialAreaRefValue, int8_t>>& indexQry(
+      const osm2rdf::geometry::Box& envelope, int32_t boxId) const;
+  // Same as indexQry() for nodes in the grid cell boxId, looked up in the
+  // node grid.
+  const std::vector<std::pair<SpatialAreaRefValue, int8_t>>& nodeGridQry(
+      int32_t boxId) const;
+  const std::vector<SpatialAreaRefValue>& indexQryIntersect(
+      const SpatialAreaView& area) const;
+  const std::vector<SpatialAreaRefValue>& indexQryIntersect(
       const SpatialWayValue& way) const;
-  void unique(std::vector<SpatialAreaRefValue>& refs) const;
-
-  std::fstream& getFsUnnamedAreas() { return _fsUnnamedAreas; }
-  std::fstream& getFsNodes() { return _fsNodes; }
-  std::fstream& getFsWays() { return _fsWays; }
+  // Build the node grid from the box ids of all areas.
+  void prepareNodeGrid();
+  FRIEND_TEST(OSM_GeometryHandler, prepareNodeGrid);
+  // The named area with the given index.
+  SpatialAreaView areaView(size_t areaIndex) const;
+  // Cleared query buffer of the calling thread. Its unique() orders refs
+  // small -> big, since prepareRTree() sorts the areas big -> small.
+  SpatialQueryBuffer& queryBuffer() const;
+  // Append the indexed areas with an envelope covering / intersecting box.
+  void spatialIndexCovers(const osm2rdf::geometry::Box& box,
+                          std::vector<SpatialAreaRefValue>* result) const;
+  void spatialIndexIntersects(const osm2rdf::geometry::Box& box,
+                              std::vector<SpatialAreaRefValue>* result) const;
 
   // Global config
   osm2rdf::config::Config _config;
   osm2rdf::ttl::Writer<W>* _writer;
+  // Number of grid cells per row and column, and their size.
+  int32_t _gridCells;
+  double _gridW;
+  double _gridH;
   // Store areas as r-tree
   SpatialIndex _spatialIndex;
   // Store dag
   osm2rdf::util::DirectedGraph<osm2rdf::osm::Area::id_t> _directedAreaGraph;
   // Spatial Data
   SpatialAreaVector _spatialStorageArea;
+  // Pools of the named areas, see SpatialAreaValue.
+  std::vector<osm2rdf::geometry::Box> _spatialStorageAreaEnvelopes;
+  osm2rdf::osm::BoxIdList _spatialStorageAreaBoxIds;
+  std::vector<SpatialAreaGeometry> _spatialStorageAreaGeometry;
+  // Node grid with 4^Config::nodeGridLevels cells in Hilbert order: the
+  // areas touching cell c, small -> big, are _nodeGridAreas[
+  // _nodeGridOffsets[c] .. _nodeGridOffsets[c + 1]), NODE_GRID_FULL marks
+  // areas fully covering the cell.
+  std::vector<uint64_t> _nodeGridOffsets;
+  std::vector<uint32_t> _nodeGridAreas;
+  // Query buffers, one per thread.
+  mutable std::vector<SpatialQueryBuffer> _queryBuffers;
+  // Lazily built prepared areas, one slot per entry of _spatialStorageArea.
+  std::unique_ptr<std::atomic<const PreparedArea*>[]> _preparedAreas;
   std::unordered_map<osm2rdf::osm::Area::id_t, uint64_t>
       _spatialStorageAreaIndex;
 
@@ -453,24 +595,15 @@ class GeometryHandler {
   FRIEND_TEST(OSM_GeometryHandler, addNamedAreaFromRelationWithRatios);
   FRIEND_TEST(OSM_GeometryHandler, addNamedAreaFromWayWithRatios);
 
-  size_t _numUnnamedAreas = 0;
   FRIEND_TEST(OSM_GeometryHandler, addUnnamedAreaFromRelation);
   FRIEND_TEST(OSM_GeometryHandler, addUnnamedAreaFromWay);
-  std::string _tmpPathUnnamedAreas;
-  std::fstream _fsUnnamedAreas;
-  boost::archive::binary_oarchive _oaUnnamedAreas;
+  SegmentedSpill<SpatialAreaData> _unnamedAreas;
 
-  size_t _numNodes = 0;
   FRIEND_TEST(OSM_GeometryHandler, addNode);
-  std::string _tmpPathNodes;
-  std::fstream _fsNodes;
-  boost::archive::binary_oarchive _oaNodes;
+  SegmentedSpill<SpatialNodeValue> _nodes;
 
-  size_t _numWays = 0;
   FRIEND_TEST(OSM_GeometryHandler, addWay);
-  std::string _tmpPathWays;
-  std::fstream _fsWays;
-  boost::archive::binary_oarchive _oaWays;
+  SegmentedSpill<SpatialWayValue> _ways;
 
   size_t _dummyAreaCount = 0;
 };
@@ -515,20 +648,20 @@ void serialize(Archive& ar, osm2rdf::osm::SpatialWayValue& v,
 }
 
 template <class Archive>
-void serialize(Archive& ar, osm2rdf::osm::SpatialAreaValue& v,
+void serialize(Archive& ar, osm2rdf::osm::SpatialAreaData& v,
                [[maybe_unused]] const unsigned int version) {
-  ar& boost::serialization::make_nvp("envelope", std::get<0>(v));
-  ar& boost::serialization::make_nvp("id", std::get<1>(v));
-  ar& boost::serialization::make_nvp("geom", std::get<2>(v));
-  ar& boost::serialization::make_nvp("objId", std::get<3>(v));
-  ar& boost::serialization::make_nvp("geomArea", std::get<4>(v));
-  ar& boost::serialization::make_nvp("fromWay", std::get<5>(v));
-  ar& boost::serialization::make_nvp("inner", std::get<6>(v));
-  ar& boost::serialization::make_nvp("outer", std::get<7>(v));
-  ar& boost::serialization::make_nvp("boxIds", std::get<8>(v));
-  ar& boost::serialization::make_nvp("cutouts", std::get<9>(v));
-  ar& boost::serialization::make_nvp("convexhull", std::get<10>(v));
-  ar& boost::serialization::make_nvp("obb", std::get<11>(v));
+  ar& boost::serialization::make_nvp("envelope", v.envelopes);
+  ar& boost::serialization::make_nvp("id", v.id);
+  ar& boost::serialization::make_nvp("geom", v.geometry.geom);
+  ar& boost::serialization::make_nvp("objId", v.objId);
+  ar& boost::serialization::make_nvp("geomArea", v.area);
+  ar& boost::serialization::make_nvp("fromWay", v.fromType);
+  ar& boost::serialization::make_nvp("inner", v.geometry.inner);
+  ar& boost::serialization::make_nvp("outer", v.geometry.outer);
+  ar& boost::serialization::make_nvp("boxIds", v.boxIds);
+  ar& boost::serialization::make_nvp("cutouts", v.geometry.cutouts);
+  ar& boost::serialization::make_nvp("convexhull", v.geometry.convexHull);
+  ar& boost::serialization::make_nvp("obb", v.obb);
 }
 
 }  // namespace boost::serialization
@@ -19,8 +19,14 @@
 #ifndef OSM2RDF_OSM_LOCATIONHANDLER_H_
 #define OSM2RDF_OSM_LOCATIONHANDLER_H_
 
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
 #include "osm2rdf/config/Config.h"
+#include "osm2rdf/osm/CompressedLocationStore.h"
 #include "osm2rdf/util/CacheFile.h"
+#include "osm2rdf/util/RankBitmap.h"
 #include "osmium/handler.hpp"
 #include "osmium/handler/node_locations_for_ways.hpp"
 #include "osmium/index/map/dense_file_array.hpp"
@@ -39,10 +45,89 @@ class LocationHandler : public osmium::handler::Handler {
   virtual ~LocationHandler() {}
   virtual void node(const osmium::Node& node) = 0;
   virtual void way(osmium::Way& way) = 0;
+  virtual void relation(const osmium::Relation& /*unused*/) {}
   [[nodiscard]] virtual osmium::Location get_node_location(
       const osmium::object_id_type id) const = 0;
-  // Helper creating the correct instance.
-  static LocationHandler* create(const osm2rdf::config::Config& config);
+  // Lookup count locations at once, ids may contain duplicates.
+  virtual void get_node_locations(const uint64_t* ids, size_t count,
+                                  osmium::Location* locations) const;
+  // Helper creating the correct instance. neededNodes is required for
+  // config.storeNeededLocationsOnly.
+  static LocationHandler* create(
+      const osm2rdf::config::Config& config,
+      const osm2rdf::util::RankBitmap* neededNodes = nullptr);
+
+ protected:
+  // Lookup each distinct id once in ascending order, so that the backing
+  // storage is read sequentially, and scatter the results.
+  template <typename F>
+  static void lookupSorted(const uint64_t* ids, size_t count,
+                           osmium::Location* locations, F lookup) {
+    std::vector<size_t> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(),
+              [ids](size_t a, size_t b) { return ids[a] < ids[b]; });
+    for (size_t i = 0; i < count; ++i) {
+      if (i > 0 && ids[order[i]] == ids[order[i - 1]]) {
+        locations[order[i]] = locations[order[i - 1]];
+      } else {
+        locations[order[i]] = lookup(ids[order[i]]);
+      }
+    }
+  }
+};
+
+// Collects the ids of all nodes referenced by ways and relations.
+class NeededNodes : public osmium::handler::Handler {
+ public:
+  void relation(const osmium::Relation& relation);
+  void way(const osmium::Way& way);
+  // Prepare the bitmap for rank queries.
+  void prepare_for_lookup();
+  [[nodiscard]] const osm2rdf::util::RankBitmap& bitmap() const noexcept;
+
+ protected:
+  osm2rdf::util::RankBitmap _bitmap;
+};
+
+// Stores only locations of nodes in the given bitmap. The location of a node
+// is stored at the rank of its id, other nodes have no location.
+class LocationHandlerNeeded : public LocationHandler {
+ public:
+  LocationHandlerNeeded(const osm2rdf::config::Config& config,
+                        const osm2rdf::util::RankBitmap& neededNodes);
+  void node(const osmium::Node& node);
+  void way(osmium::Way& way);
+  [[nodiscard]] osmium::Location get_node_location(
+      const osmium::object_id_type nodeId) const;
+  void get_node_locations(const uint64_t* ids, size_t count,
+                          osmium::Location* locations) const;
+
+ protected:
+  const osm2rdf::util::RankBitmap& _neededNodes;
+  std::vector<osmium::Location> _locations;
+};
+
+// Stores locations in a block compressed file, see CompressedLocationStore.
+// Nodes have to be sorted by id. The store is finalized by the first way or
+// relation on the reading thread, lookups require a finalized store.
+class LocationHandlerCompressed : public LocationHandler {
+ public:
+  explicit LocationHandlerCompressed(const osm2rdf::config::Config& config);
+  void node(const osmium::Node& node);
+  void way(osmium::Way& way);
+  void relation(const osmium::Relation& relation);
+  [[nodiscard]] osmium::Location get_node_location(
+      const osmium::object_id_type nodeId) const;
+  void get_node_locations(const uint64_t* ids, size_t count,
+                          osmium::Location* locations) const;
+
+ protected:
+  // Finalize the store after the last node.
+  void finalize();
+
+  osm2rdf::osm::CompressedLocationStore _store;
+  bool _finalized = false;
 };
 
 template <typename T>
@@ -53,6 +138,8 @@ class LocationHandlerImpl : public LocationHandler {
   void way(osmium::Way& way);
   [[nodiscard]] osmium::Location get_node_location(
       const osmium::object_id_type nodeId) const;
+  void get_node_locations(const uint64_t* ids, size_t count,
+                          osmium::Location* locations) const;
 
  protected:
   T _index;
@@ -69,6 +156,8 @@ class LocationHandlerImpl<osmium::index::map::SparseFileArray<
   void way(osmium::Way& way);
   [[nodiscard]] osmium::Location get_node_location(
       const osmium::object_id_type nodeId) const;
+  void get_node_locations(const uint64_t* ids, size_t count,
+                          osmium::Location* locations) const;
 
  protected:
   osm2rdf::util::CacheFile _cacheFile;
@@ -90,6 +179,8 @@ class LocationHandlerImpl<osmium::index::map::DenseFileArray<
   void way(osmium::Way& way);
   [[nodiscard]] osmium::Location get_node_location(
       const osmium::object_id_type nodeId) const;
+  void get_node_locations(const uint64_t* ids, size_t count,
+                          osmium::Location* locations) const;
 
  protected:
   osm2rdf::util::CacheFile _cacheFile;
@@ -0,0 +1,49 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef OSM2RDF_OSM_NODEVIEW_H_
+#define OSM2RDF_OSM_NODEVIEW_H_
+
+#include "osm2rdf/geometry/Box.h"
+#include "osm2rdf/geometry/Location.h"
+#include "osm2rdf/geometry/Polygon.h"
+#include "osm2rdf/osm/Node.h"
+#include "osmium/osm/node.hpp"
+#include "osmium/tags/taglist.hpp"
+
+namespace osm2rdf::osm {
+
+// Read-only view of an osmium::Node inside its buffer. Nothing is copied, so
+// the buffer has to outlive the view.
+class NodeView {
+ public:
+  explicit NodeView(const osmium::Node& node);
+  [[nodiscard]] osm2rdf::osm::Node::id_t id() const noexcept;
+  [[nodiscard]] osm2rdf::geometry::Location geom() const;
+  [[nodiscard]] osm2rdf::geometry::Box envelope() const;
+  [[nodiscard]] const osmium::TagList& tags() const noexcept;
+  [[nodiscard]] osm2rdf::geometry::Polygon convexHull() const;
+  [[nodiscard]] osm2rdf::geometry::Polygon orientedBoundingBox() const;
+
+ protected:
+  const osmium::Node* _node;
+};
+
+}  // namespace osm2rdf::osm
+
+#endif  // OSM2RDF_OSM_NODEVIEW_H_
@@ -20,11 +20,17 @@
 #ifndef OSM2RDF_OSM_OSMIUMHANDLER_H
 #define OSM2RDF_OSM_OSMIUMHANDLER_H
 
+#include <atomic>
+
+#include "gtest/gtest_prod.h"
 #include "osm2rdf/config/Config.h"
 #include "osm2rdf/osm/FactHandler.h"
 #include "osm2rdf/osm/GeometryHandler.h"
+#include "osm2rdf/osm/LocationHandler.h"
+#include "osm2rdf/osm/TagFilter.h"
 #include "osm2rdf/ttl/Writer.h"
 #include "osmium/handler.hpp"
+#include "osmium/memory/buffer.hpp"
 #include "osmium/osm/area.hpp"
 #include "osmium/osm/node.hpp"
 #include "osmium/osm/relation.hpp"
@@ -55,24 +61,35 @@ class OsmiumHandler : public osmium::handler::Handler {
   [[nodiscard]] size_t waysSeen() const;
   [[nodiscard]] size_t waysDumped() const;
   [[nodiscard]] size_t wayGeometriesHandled() const;
+  // Number of buffers converted on the reading thread due to maxInFlightMB.
+  [[nodiscard]] size_t backpressureTriggered() const;
 
  protected:
+  // Converts all entities in the given buffer in a separate task.
+  void convertBuffer(osmium::memory::Buffer&& buffer);
+  FRIEND_TEST(OSM_OsmiumHandler, handleThrottled);
+
   osm2rdf::config::Config _config;
   osm2rdf::osm::FactHandler<W> _factHandler;
   osm2rdf::osm::GeometryHandler<W> _geometryHandler;
   osm2rdf::osm::RelationHandler _relationHandler;
-  size_t _areasSeen = 0;
-  size_t _areasDumped = 0;
-  size_t _areaGeometriesHandled = 0;
-  size_t _nodesSeen = 0;
-  size_t _nodesDumped = 0;
-  size_t _nodeGeometriesHandled = 0;
-  size_t _relationsSeen = 0;
-  size_t _relationsDumped = 0;
-  size_t _relationGeometriesHandled = 0;
-  size_t _waysSeen = 0;
-  size_t _waysDumped = 0;
-  size_t _wayGeometriesHandled = 0;
+  osm2rdf::osm::TagFilter _tagFilter;
+  osm2rdf::osm::NeededNodes _neededNodes;
+  std::atomic<size_t> _areasSeen = 0;
+  std::atomic<size_t> _areasDumped = 0;
+  std::atomic<size_t> _areaGeometriesHandled = 0;
+  std::atomic<size_t> _nodesSeen = 0;
+  std::atomic<size_t> _nodesDumped = 0;
+  std::atomic<size_t> _nodeGeometriesHandled = 0;
+  std::atomic<size_t> _relationsSeen = 0;
+  std::atomic<size_t> _relationsDumped = 0;
+  std::atomic<size_t> _relationGeometriesHandled = 0;
+  std::atomic<size_t> _waysSeen = 0;
+  std::atomic<size_t> _waysDumped = 0;
+  std::atomic<size_t> _wayGeometriesHandled = 0;
+  // Size of buffers handed to conversion tasks and not finished yet.
+  std::atomic<size_t> _inFlightBytes = 0;
+  std::atomic<size_t> _backpressureTriggered = 0;
 };
 }  // namespace osm2rdf::osm
 
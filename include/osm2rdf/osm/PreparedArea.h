@@ -0,0 +1,87 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef OSM2RDF_OSM_PREPAREDAREA_H_
+#define OSM2RDF_OSM_PREPAREDAREA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "osm2rdf/geometry/Area.h"
+#include "osm2rdf/geometry/Box.h"
+#include "osm2rdf/geometry/Location.h"
+#include "osm2rdf/geometry/Ring.h"
+
+namespace osm2rdf::osm {
+
+// Point containment index for areas with many points. The edges of all rings
+// are bucketed into vertical bands of equal width, so a query only sums the
+// winding numbers of the edges of a single band instead of walking all rings.
+// Each edge is decided like boost::geometry::covered_by decides it, so both
+// agree for valid areas, including points on and next to the boundary. The
+// edges of each band are stored as separate coordinate arrays and counted
+// with vector instructions where the CPU supports them.
+// Immutable after construction and thus safe to share between threads.
+class PreparedArea {
+ public:
+  // Implementations of the winding number, all return the same results.
+  enum class Kernel { SCALAR, AVX2, AVX512 };
+
+  explicit PreparedArea(const osm2rdf::geometry::Area& area);
+
+  // Whether the point lies inside or on the boundary of the area, like
+  // boost::geometry::covered_by. Uses bestKernel().
+  [[nodiscard]] bool covers(const osm2rdf::geometry::Location& point) const;
+  [[nodiscard]] bool covers(const osm2rdf::geometry::Location& point,
+                            Kernel kernel) const;
+  [[nodiscard]] size_t numEdges() const noexcept;
+  [[nodiscard]] size_t numBands() const noexcept;
+
+  // Whether the CPU running this supports the kernel.
+  static bool supported(Kernel kernel);
+  // Fastest kernel supported by the CPU running this.
+  static Kernel bestKernel();
+
+ protected:
+  struct Edge {
+    // End points in ring order.
+    osm2rdf::geometry::Location from;
+    osm2rdf::geometry::Location to;
+  };
+
+  static void addRing(const osm2rdf::geometry::Ring& ring,
+                      std::vector<Edge>* edges);
+  [[nodiscard]] size_t band(double x) const;
+
+  osm2rdf::geometry::Box _envelope;
+  double _bandWidth = 1;
+  size_t _numEdges = 0;
+  // Edges of band i are at positions _bandStarts[i] up to, excluding,
+  // _bandStarts[i + 1] of the coordinate arrays. Edges spanning several bands
+  // are repeated.
+  std::vector<uint32_t> _bandStarts;
+  std::vector<double> _fromX;
+  std::vector<double> _fromY;
+  std::vector<double> _toX;
+  std::vector<double> _toY;
+};
+
+}  // namespace osm2rdf::osm
+
+#endif  // OSM2RDF_OSM_PREPAREDAREA_H_
@@ -0,0 +1,97 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef OSM2RDF_OSM_RELATIONCACHE_H
+#define OSM2RDF_OSM_RELATIONCACHE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include "gtest/gtest_prod.h"
+#include "osm2rdf/config/Config.h"
+#include "osmium/handler.hpp"
+#include "osmium/memory/buffer.hpp"
+#include "osmium/osm/relation.hpp"
+
+namespace osm2rdf::osm {
+
+// Persistent copy of all relations seen in OSM Pass 1. The cache file is
+// stored next to the other cache files, named after a hash of the canonical
+// input path, and is only valid for an input file with the same size,
+// modification time, first and last bytes. A valid cache is mapped
+// into memory and replayed instead of reading the input again.
+//
+// The class is used like a relation manager with
+// osmium::relations::read_relations and collects relations only if
+// config.relationCache is set.
+class RelationCache : public osmium::handler::Handler {
+ public:
+  explicit RelationCache(const osm2rdf::config::Config& config);
+  ~RelationCache();
+  RelationCache(const RelationCache&) = delete;
+  RelationCache& operator=(const RelationCache&) = delete;
+
+  // Collect relations during Pass 1.
+  void relation(const osmium::Relation& relation);
+  // Write the collected relations to the cache file.
+  void prepare_for_lookup();
+
+  // Maps the cache file if it is valid for the current input.
+  bool load();
+  // Buffer with all cached relations, only valid after a successful load().
+  [[nodiscard]] osmium::memory::Buffer& buffer();
+
+  [[nodiscard]] std::filesystem::path path() const;
+
+ protected:
+  struct Header {
+    char magic[8];
+    uint64_t inputSize;
+    int64_t inputModified;
+    uint64_t inputHash;
+    uint64_t dataSize;
+  };
+  static_assert(sizeof(Header) % osmium::memory::align_bytes == 0);
+
+  // Fill a header describing the current input file.
+  [[nodiscard]] Header inputHeader() const;
+  FRIEND_TEST(OSM_RelationCache, inputHeaderChangesWithInput);
+  FRIEND_TEST(OSM_RelationCache, inputHeaderChangesWithTail);
+  // Write the collected relations into the temporary file.
+  void writeRelations();
+  // Stop caching after a failed write and remove the temporary file.
+  void disable(const std::string& reason);
+  FRIEND_TEST(OSM_RelationCache, unwritableCacheDirectory);
+  [[nodiscard]] std::filesystem::path tmpPath() const;
+
+  osm2rdf::config::Config _config;
+  osmium::memory::Buffer _relations;
+  std::ofstream _out;
+  uint64_t _dataSize = 0;
+
+  void* _mapped = nullptr;
+  size_t _mappedSize = 0;
+  std::unique_ptr<osmium::memory::Buffer> _buffer;
+};
+
+}  // namespace osm2rdf::osm
+
+#endif  // OSM2RDF_OSM_RELATIONCACHE_H
@@ -21,6 +21,7 @@
 
 #include "osm2rdf/config/Config.h"
 #include "osm2rdf/osm/LocationHandler.h"
+#include "osm2rdf/osm/WayNodeIndex.h"
 
 namespace osm2rdf::osm {
 
@@ -33,12 +34,17 @@ class RelationHandler : public osmium::handler::Handler {
   void setLocationHandler(osm2rdf::osm::LocationHandler* locationHandler);
   bool hasLocationHandler() const;
   osmium::Location get_node_location(const uint64_t nodeId) const;
-  std::vector<uint64_t> get_noderefs_of_way(const uint64_t wayId);
+  void get_node_locations(const std::vector<uint64_t>& nodeIds,
+                          std::vector<osmium::Location>* locations) const;
+  osm2rdf::osm::WayNodeIndex::NodeRefs get_noderefs_of_way(
+      const uint64_t wayId);
 
  protected:
   osm2rdf::config::Config _config;
   osm2rdf::osm::LocationHandler* _locationHandler = nullptr;
-  std::unordered_map<uint64_t, std::vector<uint64_t>> _ways;
+  // Ways referenced by relations, sorted after Pass 1.
+  std::vector<uint64_t> _neededWays;
+  osm2rdf::osm::WayNodeIndex _wayNodes;
   std::unordered_map<uint64_t, std::vector<uint64_t>> _relations;
   bool _firstPassDone = false;
 };
@@ -0,0 +1,101 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef OSM2RDF_OSM_SEGMENTEDSPILL_H_
+#define OSM2RDF_OSM_SEGMENTEDSPILL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "osm2rdf/util/CacheFile.h"
+
+namespace osm2rdf::osm {
+
+// Values spilled to disk in one segment per OpenMP thread, like
+// util::Output writes one part per thread. Writing uses the segment of the
+// calling thread without any locking. Each segment consists of a file of
+// fixed-width records and a data file holding the variable-length arrays
+// (see SpillFormat.h) referenced by them. After flush() both files are
+// mapped and all values are addressable by index: the segments are numbered
+// consecutively and records have a fixed width, so any thread can decode any
+// range of values without coordination.
+template <typename T>
+class SegmentedSpill {
+ public:
+  // Segment files are created at basePath with the segment number appended
+  // and unlinked immediately.
+  explicit SegmentedSpill(const std::string& basePath);
+  SegmentedSpill(const SegmentedSpill&) = delete;
+  SegmentedSpill& operator=(const SegmentedSpill&) = delete;
+  ~SegmentedSpill();
+
+  // Append a value to the segment of the calling thread.
+  void write(const T& value);
+  // Number of written values.
+  [[nodiscard]] size_t size() const noexcept;
+  // Number of bytes written to all segments.
+  [[nodiscard]] size_t bytes() const noexcept;
+  // Flush all segments and map them for reading.
+  void flush();
+  // Reorder the values of each segment along the Hilbert curve through the
+  // centres of their envelopes, such that values with close indices are
+  // spatially close. Records are sorted externally in bounded runs, the data
+  // files are left untouched. Requires flush().
+  void sortSpatially();
+  // Decode the value with the given index, 0 <= index < size(). Safe to call
+  // from multiple threads. Requires flush().
+  void get(size_t index, T* value) const;
+
+ protected:
+  struct alignas(64) Segment {
+    std::string path;
+    std::unique_ptr<osm2rdf::util::CacheFile> recordFile;
+    std::unique_ptr<osm2rdf::util::CacheFile> dataFile;
+    // Not yet written parts of both files.
+    std::vector<uint8_t> recordBuffer;
+    std::vector<uint8_t> dataBuffer;
+    uint64_t recordFileSize = 0;
+    uint64_t dataFileSize = 0;
+    size_t count = 0;
+    // Mapped files, set by flush().
+    const uint8_t* records = nullptr;
+    const uint8_t* data = nullptr;
+  };
+
+  // Append buffer to the file and clear it.
+  static void writeBuffer(const osm2rdf::util::CacheFile& file,
+                          std::vector<uint8_t>* buffer, uint64_t* fileSize);
+  static void writeBytes(const osm2rdf::util::CacheFile& file,
+                         const uint8_t* bytes, size_t size);
+  static const uint8_t* map(const osm2rdf::util::CacheFile& file,
+                            uint64_t fileSize);
+  static void unmap(Segment* segment);
+  static void sortSegment(Segment* segment);
+
+  std::vector<std::unique_ptr<Segment>> _segments;
+  // Non-empty segments and the index of their first value, built by flush().
+  std::vector<const Segment*> _manifest;
+  std::vector<size_t> _manifestStarts;
+};
+
+}  // namespace osm2rdf::osm
+
+#endif  // OSM2RDF_OSM_SEGMENTEDSPILL_H_
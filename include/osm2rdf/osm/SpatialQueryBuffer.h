@@ -0,0 +1,55 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef OSM2RDF_OSM_SPATIALQUERYBUFFER_H_
+#define OSM2RDF_OSM_SPATIALQUERYBUFFER_H_
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "osm2rdf/geometry/Box.h"
+
+namespace osm2rdf::osm {
+
+// Envelope of an area polygon and the index of the area.
+typedef std::pair<osm2rdf::geometry::Box, size_t> SpatialAreaRefValue;
+
+// Scratch space of one thread for area index queries, reused by all its
+// queries such that they do not allocate once warmed up.
+struct SpatialQueryBuffer {
+  // Results up to this size are ordered by insertion sort.
+  static const size_t INSERTION_SORT_MAX = 32;
+
+  // Empty refs and covers for a new query over numAreas areas.
+  void clear(size_t numAreas);
+  // Remove duplicate areas from refs and order them by descending area
+  // index. The bits of the kept areas are cleared again afterwards, so seen
+  // is all zero between calls.
+  void unique();
+
+  std::vector<SpatialAreaRefValue> refs;
+  std::vector<std::pair<SpatialAreaRefValue, int8_t>> covers;
+  // One bit per area, set while unique() runs for the areas in refs.
+  std::vector<uint64_t> seen;
+};
+
+}  // namespace osm2rdf::osm
+
+#endif  // OSM2RDF_OSM_SPATIALQUERYBUFFER_H_
@@ -0,0 +1,102 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef OSM2RDF_OSM_SPILLFORMAT_H_
+#define OSM2RDF_OSM_SPILLFORMAT_H_
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "osm2rdf/geometry/Area.h"
+#include "osm2rdf/geometry/Location.h"
+#include "osm2rdf/geometry/Polygon.h"
+
+namespace osm2rdf::osm {
+
+// Position of an array in the data section of a spill segment.
+struct SpillSpan {
+  uint64_t offset = 0;
+  uint64_t count = 0;
+};
+
+static_assert(std::is_trivially_copyable_v<osm2rdf::geometry::Location>);
+
+// Appends arrays to the data section of a spill segment. All arrays are
+// aligned to 8 bytes. Polygons are stored as number of rings, ring sizes and
+// all points, multipolygons as their polygons one after another.
+class SpillDataWriter {
+ public:
+  // buffer holds the end of the data section which starts at bufferOffset.
+  SpillDataWriter(std::vector<uint8_t>* buffer, uint64_t bufferOffset);
+
+  template <typename V>
+  SpillSpan array(const V* values, size_t count) {
+    static_assert(std::is_trivially_copyable_v<V>);
+    SpillSpan span{align(), count};
+    append(values, count * sizeof(V));
+    return span;
+  }
+  template <typename V>
+  SpillSpan array(const std::vector<V>& values) {
+    return array(values.data(), values.size());
+  }
+  SpillSpan polygon(const osm2rdf::geometry::Polygon& polygon);
+  SpillSpan multiPolygon(const osm2rdf::geometry::MultiPolygon& multiPolygon);
+
+ protected:
+  // Pad to 8 bytes and return the current offset.
+  uint64_t align();
+  void append(const void* data, size_t size);
+
+  std::vector<uint8_t>* _buffer;
+  uint64_t _bufferOffset;
+};
+
+// Reads arrays from a mapped data section of a spill segment.
+class SpillDataReader {
+ public:
+  explicit SpillDataReader(const uint8_t* data) : _data(data) {}
+
+  template <typename V>
+  [[nodiscard]] const V* array(const SpillSpan& span) const {
+    static_assert(std::is_trivially_copyable_v<V>);
+    return reinterpret_cast<const V*>(_data + span.offset);
+  }
+  // Copy an array into any container of V, e.g. std::vector or rings.
+  template <typename V, typename C>
+  void array(const SpillSpan& span, C* out) const {
+    const V* begin = array<V>(span);
+    out->assign(begin, begin + span.count);
+  }
+  void polygon(const SpillSpan& span, osm2rdf::geometry::Polygon* out) const;
+  void multiPolygon(const SpillSpan& span,
+                    osm2rdf::geometry::MultiPolygon* out) const;
+
+ protected:
+  // Read a polygon at pos and return the position after it.
+  const uint8_t* polygon(const uint8_t* pos,
+                         osm2rdf::geometry::Polygon* out) const;
+
+  const uint8_t* _data;
+};
+
+}  // namespace osm2rdf::osm
+
+#endif  // OSM2RDF_OSM_SPILLFORMAT_H_
@@ -0,0 +1,83 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef OSM2RDF_OSM_TAGFILTER_H_
+#define OSM2RDF_OSM_TAGFILTER_H_
+
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "osm2rdf/config/Config.h"
+#include "osmium/osm/entity_bits.hpp"
+#include "osmium/osm/tag.hpp"
+
+namespace osm2rdf::osm {
+
+// Include and exclude rules on tags, compiled from config.includeTags and
+// config.excludeTags. Each rule has the form [type/]key[=value] with type
+// one of node, way, relation or area. An object is accepted if no include
+// rule applies to its type or one of them matches, and no exclude rule
+// matches. Rules are matched against the raw osmium tags, so objects can
+// be dropped before they are converted.
+class TagFilter {
+ public:
+  explicit TagFilter(const osm2rdf::config::Config& config);
+  TagFilter(const TagFilter&) = delete;
+  TagFilter& operator=(const TagFilter&) = delete;
+  // Check if there is at least one rule.
+  [[nodiscard]] bool empty() const noexcept;
+  [[nodiscard]] bool area(const osmium::TagList& tags) const noexcept;
+  [[nodiscard]] bool node(const osmium::TagList& tags) const noexcept;
+  [[nodiscard]] bool relation(const osmium::TagList& tags) const noexcept;
+  [[nodiscard]] bool way(const osmium::TagList& tags) const noexcept;
+
+ protected:
+  struct Rule {
+    osmium::osm_entity_bits::type types;
+    // Empty if any value matches.
+    std::string value;
+  };
+  typedef std::unordered_map<std::string_view, std::vector<Rule>> RuleMap;
+
+  // Parse a single rule and add it to the given map.
+  void addRule(const std::string& rule, RuleMap* rules,
+               osmium::osm_entity_bits::type* types);
+  // Check if any rule for the given type matches one of the tags.
+  [[nodiscard]] static bool matches(const RuleMap& rules,
+                                    osmium::osm_entity_bits::type type,
+                                    const osmium::TagList& tags) noexcept;
+  [[nodiscard]] bool accept(osmium::osm_entity_bits::type type,
+                            const osmium::TagList& tags) const noexcept;
+
+  // Storage for the keys referenced by the rule maps.
+  std::deque<std::string> _keys;
+  RuleMap _include;
+  RuleMap _exclude;
+  // Types with at least one include or exclude rule.
+  osmium::osm_entity_bits::type _includeTypes =
+      osmium::osm_entity_bits::nothing;
+  osmium::osm_entity_bits::type _excludeTypes =
+      osmium::osm_entity_bits::nothing;
+};
+
+}  // namespace osm2rdf::osm
+
+#endif  // OSM2RDF_OSM_TAGFILTER_H_
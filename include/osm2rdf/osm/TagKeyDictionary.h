@@ -0,0 +1,80 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef OSM2RDF_OSM_TAGKEYDICTIONARY_H_
+#define OSM2RDF_OSM_TAGKEYDICTIONARY_H_
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace osm2rdf::osm {
+
+typedef uint32_t TagKeyId;
+
+// Process wide dictionary mapping tag keys to small integer ids. Keys are
+// stored in an open addressing table with atomic slots, so lookups and
+// inserts from multiple threads never block. Ids are stable for the
+// lifetime of the process. Once the table is full, further keys are kept in
+// a slower overflow map with ids greater than NOT_FOUND.
+class TagKeyDictionary {
+ public:
+  static constexpr size_t CAPACITY = 1U << 20U;
+  static constexpr TagKeyId NOT_FOUND = CAPACITY;
+
+  TagKeyDictionary();
+  ~TagKeyDictionary();
+  TagKeyDictionary(const TagKeyDictionary&) = delete;
+  TagKeyDictionary& operator=(const TagKeyDictionary&) = delete;
+
+  // The dictionary shared by all tag lists.
+  static TagKeyDictionary& instance();
+
+  // Return the id of the given key, adding it if needed.
+  TagKeyId intern(std::string_view key);
+  // Return the id of the given key or NOT_FOUND.
+  [[nodiscard]] TagKeyId find(std::string_view key) const noexcept;
+  // Return the key for an id returned by intern.
+  [[nodiscard]] const std::string& key(TagKeyId id) const noexcept;
+
+ protected:
+  [[nodiscard]] static size_t hash(std::string_view key) noexcept;
+  // Lookup or add a key in the overflow map.
+  TagKeyId internOverflow(std::string_view key);
+  [[nodiscard]] TagKeyId findOverflow(std::string_view key) const noexcept;
+
+  std::unique_ptr<std::atomic<const std::string*>[]> _slots;
+  std::atomic<size_t> _size = 0;
+
+  // Keys added after the table is full, the key with id i is stored at
+  // _overflowKeys[i - NOT_FOUND - 1].
+  mutable std::mutex _overflowMutex;
+  std::deque<std::string> _overflowKeys;
+  std::map<std::string_view, TagKeyId, std::less<>> _overflowIds;
+  std::atomic<bool> _hasOverflow = false;
+};
+
+}  // namespace osm2rdf::osm
+
+#endif  // OSM2RDF_OSM_TAGKEYDICTIONARY_H_
@@ -20,18 +20,78 @@
 #define OSM2RDF_OSM_TAGLIST_H_
 
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <vector>
 
 #include "boost/version.hpp"
 #if BOOST_VERSION >= 107400 && BOOST_VERSION < 107500
 #include "boost/serialization/library_version_type.hpp"
 #endif
-#include "boost/serialization/unordered_map.hpp"
+#include "boost/serialization/nvp.hpp"
+#include "boost/serialization/split_member.hpp"
+#include "boost/serialization/string.hpp"
+#include "osm2rdf/osm/TagKeyDictionary.h"
 #include "osmium/tags/taglist.hpp"
 
 namespace osm2rdf::osm {
 
-typedef std::unordered_map<std::string, std::string> TagList;
+// Tags of a single object as a vector of (key id, value) pairs sorted by key
+// id. Keys are interned in the TagKeyDictionary, so each tag only stores its
+// value.
+class TagList {
+ public:
+  struct Entry {
+    TagKeyId keyId;
+    std::string value;
+    [[nodiscard]] const std::string& key() const noexcept;
+    bool operator==(const Entry& other) const noexcept;
+  };
+  typedef std::vector<Entry>::const_iterator const_iterator;
+
+  // Return the value for key, inserting an empty value if needed.
+  std::string& operator[](std::string_view key);
+  // Return the value for key, throws std::out_of_range if missing.
+  [[nodiscard]] const std::string& at(std::string_view key) const;
+  [[nodiscard]] size_t count(std::string_view key) const noexcept;
+  [[nodiscard]] const_iterator find(std::string_view key) const noexcept;
+  [[nodiscard]] size_t size() const noexcept;
+  [[nodiscard]] bool empty() const noexcept;
+  void reserve(size_t size);
+  [[nodiscard]] const_iterator begin() const noexcept;
+  [[nodiscard]] const_iterator end() const noexcept;
+
+  bool operator==(const osm2rdf::osm::TagList& other) const noexcept;
+  bool operator!=(const osm2rdf::osm::TagList& other) const noexcept;
+
+ protected:
+  std::vector<Entry> _entries;
+
+  // Keys are stored as strings, ids are only valid inside one process.
+  friend class boost::serialization::access;
+  template <class Archive>
+  void save(Archive& ar, [[maybe_unused]] const unsigned int version) const {
+    size_t size = _entries.size();
+    ar << boost::serialization::make_nvp("size", size);
+    for (const auto& entry : _entries) {
+      std::string key = entry.key();
+      ar << boost::serialization::make_nvp("key", key);
+      ar << boost::serialization::make_nvp("value", entry.value);
+    }
+  }
+  template <class Archive>
+  void load(Archive& ar, [[maybe_unused]] const unsigned int version) {
+    size_t size;
+    ar >> boost::serialization::make_nvp("size", size);
+    _entries.clear();
+    _entries.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+      std::string key;
+      ar >> boost::serialization::make_nvp("key", key);
+      ar >> boost::serialization::make_nvp("value", (*this)[key]);
+    }
+  }
+  BOOST_SERIALIZATION_SPLIT_MEMBER()
+};
 
 // Convert an osmium::TagList into a osm2rdf::osm::TagList
 osm2rdf::osm::TagList convertTagList(const osmium::TagList& tagList);
@@ -0,0 +1,118 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef OSM2RDF_OSM_WAYNODEINDEX_H_
+#define OSM2RDF_OSM_WAYNODEINDEX_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "osm2rdf/util/CacheFile.h"
+#include "osmium/osm/way.hpp"
+
+namespace osm2rdf::osm {
+
+// Node ids of ways in compressed sparse row layout: sorted way ids, the
+// offset of each way in a byte array and the node ids of each way as count
+// followed by zigzag/varint encoded deltas. The byte array is kept in memory
+// or, after spillTo(), written to a file which is mapped for lookups.
+class WayNodeIndex {
+ public:
+  // Zero-copy view of the node ids of a way, decoded while iterating.
+  class NodeRefs {
+   public:
+    class iterator {
+     public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = uint64_t;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const uint64_t*;
+      using reference = const uint64_t&;
+
+      iterator() = default;
+      iterator(const uint8_t* pos, uint64_t remaining);
+      reference operator*() const noexcept { return _value; }
+      iterator& operator++();
+      iterator operator++(int);
+      bool operator==(const iterator& other) const noexcept {
+        return _remaining == other._remaining;
+      }
+      bool operator!=(const iterator& other) const noexcept {
+        return _remaining != other._remaining;
+      }
+
+     protected:
+      const uint8_t* _pos = nullptr;
+      uint64_t _remaining = 0;
+      uint64_t _value = 0;
+    };
+
+    NodeRefs() = default;
+    NodeRefs(const uint8_t* data, uint64_t size) : _data(data), _size(size) {}
+    [[nodiscard]] iterator begin() const { return iterator{_data, _size}; }
+    [[nodiscard]] iterator end() const { return iterator{}; }
+    [[nodiscard]] size_t size() const noexcept { return _size; }
+    [[nodiscard]] bool empty() const noexcept { return _size == 0; }
+
+   protected:
+    const uint8_t* _data = nullptr;
+    uint64_t _size = 0;
+  };
+
+  WayNodeIndex() = default;
+  ~WayNodeIndex();
+  WayNodeIndex(const WayNodeIndex&) = delete;
+  WayNodeIndex& operator=(const WayNodeIndex&) = delete;
+
+  // Write node ids to a file at path instead of keeping them in memory, has
+  // to be called before the first add().
+  void spillTo(const std::filesystem::path& path);
+  // Store the node ids of a way. Ways may be added in any order.
+  void add(uint64_t wayId, const osmium::WayNodeList& nodes);
+  // Sort the way ids and map spilled data. Can be called multiple times and
+  // from multiple threads.
+  void finalize();
+  // Node ids of a way or an empty view for unknown ways, requires finalize().
+  [[nodiscard]] NodeRefs get(uint64_t wayId) const;
+  // Number of stored ways.
+  [[nodiscard]] size_t size() const noexcept;
+  // Number of bytes used for encoded node ids.
+  [[nodiscard]] uint64_t dataSize() const noexcept;
+
+ protected:
+  void flushWriteBuffer();
+  void doFinalize();
+
+  std::vector<uint64_t> _wayIds;
+  std::vector<uint64_t> _offsets;
+  // Encoded node ids, only the unwritten part if spilled.
+  std::vector<uint8_t> _data;
+  uint64_t _dataSize = 0;
+  std::unique_ptr<osm2rdf::util::CacheFile> _spillFile;
+  const uint8_t* _mapped = nullptr;
+  std::once_flag _finalized;
+};
+
+}  // namespace osm2rdf::osm
+
+#endif  // OSM2RDF_OSM_WAYNODEINDEX_H_
@@ -0,0 +1,57 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef OSM2RDF_OSM_WAYVIEW_H_
+#define OSM2RDF_OSM_WAYVIEW_H_
+
+#include "osm2rdf/geometry/Box.h"
+#include "osm2rdf/geometry/Polygon.h"
+#include "osm2rdf/geometry/Way.h"
+#include "osm2rdf/osm/Way.h"
+#include "osmium/osm/way.hpp"
+#include "osmium/tags/taglist.hpp"
+
+namespace osm2rdf::osm {
+
+// Read-only view of an osmium::Way inside its buffer. Tags and node refs are
+// read in place, geometries are only built on request. The buffer has to
+// outlive the view.
+class WayView {
+ public:
+  explicit WayView(const osmium::Way& way);
+  [[nodiscard]] osm2rdf::osm::Way::id_t id() const noexcept;
+  [[nodiscard]] bool closed() const noexcept;
+  [[nodiscard]] const osmium::WayNodeList& nodes() const noexcept;
+  [[nodiscard]] const osmium::TagList& tags() const noexcept;
+  // Locations of the nodes without consecutive duplicates.
+  [[nodiscard]] osm2rdf::geometry::Way geom() const;
+  [[nodiscard]] osm2rdf::geometry::Box envelope() const;
+  // Convex hull of geom(), callers build the geometry only once.
+  [[nodiscard]] static osm2rdf::geometry::Polygon convexHull(
+      const osm2rdf::geometry::Way& geom);
+  // Oriented bounding box of the convex hull returned by convexHull().
+  [[nodiscard]] static osm2rdf::geometry::Polygon orientedBoundingBox(
+      const osm2rdf::geometry::Polygon& convexHull);
+
+ protected:
+  const osmium::Way* _way;
+};
+
+}  // namespace osm2rdf::osm
+
+#endif  // OSM2RDF_OSM_WAYVIEW_H_
@@ -0,0 +1,62 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef OSM2RDF_UTIL_HILBERT_H_
+#define OSM2RDF_UTIL_HILBERT_H_
+
+#include <cstdint>
+#include <utility>
+
+namespace osm2rdf::util {
+
+// Position of cell (x, y) along the Hilbert curve filling the 2^32 x 2^32
+// grid. Cells close on the curve are close in the plane.
+inline uint64_t hilbertIndex(uint32_t x, uint32_t y) {
+  uint64_t index = 0;
+  for (uint32_t s = 1U << 31U; s > 0; s >>= 1U) {
+    const uint32_t rx = (x & s) != 0 ? 1 : 0;
+    const uint32_t ry = (y & s) != 0 ? 1 : 0;
+    index += static_cast<uint64_t>(s) * s * ((3 * rx) ^ ry);
+    // Rotate the quadrant such that the curve continues in it.
+    if (ry == 0) {
+      if (rx == 1) {
+        x = ~x;
+        y = ~y;
+      }
+      std::swap(x, y);
+    }
+  }
+  return index;
+}
+
+// Map value from [min, max] to a cell of the Hilbert grid, values outside
+// are clamped.
+inline uint32_t hilbertCell(double value, double min, double max) {
+  const double scaled = (value - min) / (max - min) * 4294967295.0;
+  if (!(scaled > 0)) {
+    return 0;
+  }
+  if (scaled >= 4294967295.0) {
+    return UINT32_MAX;
+  }
+  return static_cast<uint32_t>(scaled);
+}
+
+}  // namespace osm2rdf::util
+
+#endif  // OSM2RDF_UTIL_HILBERT_H_
@@ -0,0 +1,56 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef OSM2RDF_UTIL_RANKBITMAP_H_
+#define OSM2RDF_UTIL_RANKBITMAP_H_
+
+#include <cstdint>
+#include <vector>
+
+namespace osm2rdf::util {
+
+// Growable bitmap with constant time rank queries. Bits are set while
+// building, prepareRank() then precomputes the number of set bits before
+// each block of 512 bits.
+class RankBitmap {
+ public:
+  static const uint64_t BITS_PER_BLOCK = 512;
+
+  // Set bit i, the bitmap grows as needed. Invalidates rank data.
+  void set(uint64_t i);
+  // Check if bit i is set.
+  [[nodiscard]] bool test(uint64_t i) const noexcept;
+  // Precompute data for rank(), call after all bits are set.
+  void prepareRank();
+  // Number of set bits before position i, requires prepareRank(). Returns 0
+  // while the rank data is missing.
+  [[nodiscard]] uint64_t rank(uint64_t i) const noexcept;
+  // Number of set bits, requires prepareRank(). Returns 0 while the rank data
+  // is missing.
+  [[nodiscard]] uint64_t count() const noexcept;
+  // Number of bytes used.
+  [[nodiscard]] uint64_t memoryUsage() const noexcept;
+
+ protected:
+  std::vector<uint64_t> _words;
+  std::vector<uint64_t> _blockRanks;
+};
+
+}  // namespace osm2rdf::util
+
+#endif  // OSM2RDF_UTIL_RANKBITMAP_H_
@@ -0,0 +1,52 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef OSM2RDF_UTIL_SPAN_H_
+#define OSM2RDF_UTIL_SPAN_H_
+
+#include <cstddef>
+#include <vector>
+
+namespace osm2rdf::util {
+
+// Read-only view of contiguous elements owned elsewhere.
+template <typename T>
+class Span {
+ public:
+  Span() = default;
+  Span(const T* data, size_t size) : _data(data), _size(size) {}
+  Span(const std::vector<T>& values)  // NOLINT(runtime/explicit)
+      : _data(values.data()), _size(values.size()) {}
+
+  [[nodiscard]] const T* data() const noexcept { return _data; }
+  [[nodiscard]] size_t size() const noexcept { return _size; }
+  [[nodiscard]] bool empty() const noexcept { return _size == 0; }
+  const T& operator[](size_t i) const noexcept { return _data[i]; }
+  const T& front() const noexcept { return _data[0]; }
+  const T& back() const noexcept { return _data[_size - 1]; }
+  const T* begin() const noexcept { return _data; }
+  const T* end() const noexcept { return _data + _size; }
+
+ private:
+  const T* _data = nullptr;
+  size_t _size = 0;
+};
+
+}  // namespace osm2rdf::util
+
+#endif  // OSM2RDF_UTIL_SPAN_H_
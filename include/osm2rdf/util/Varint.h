@@ -0,0 +1,63 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef OSM2RDF_UTIL_VARINT_H_
+#define OSM2RDF_UTIL_VARINT_H_
+
+#include <cstdint>
+#include <vector>
+
+namespace osm2rdf::util {
+
+// Append value in LEB128 encoding, 7 bits per byte.
+inline void writeVarint(std::vector<uint8_t>* out, uint64_t value) {
+  while (value >= 0x80U) {
+    out->push_back(static_cast<uint8_t>(value | 0x80U));
+    value >>= 7U;
+  }
+  out->push_back(static_cast<uint8_t>(value));
+}
+
+// Read a LEB128 encoded value and advance pos.
+inline uint64_t readVarint(const uint8_t** pos) {
+  uint64_t value = 0;
+  unsigned shift = 0;
+  while ((**pos & 0x80U) != 0) {
+    value |= static_cast<uint64_t>(**pos & 0x7FU) << shift;
+    shift += 7;
+    ++(*pos);
+  }
+  value |= static_cast<uint64_t>(**pos) << shift;
+  ++(*pos);
+  return value;
+}
+
+// Map signed to unsigned values, small absolute values stay small.
+inline uint64_t zigzagEncode(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1U) ^
+         static_cast<uint64_t>(value >> 63);
+}
+
+// Inverse of zigzagEncode.
+inline int64_t zigzagDecode(uint64_t value) {
+  return static_cast<int64_t>(value >> 1U) ^ -static_cast<int64_t>(value & 1U);
+}
+
+}  // namespace osm2rdf::util
+
+#endif  // OSM2RDF_UTIL_VARINT_H_
@@ -53,6 +53,14 @@ std::string osm2rdf::config::Config::getInfo(std::string_view prefix) const {
       oss << "\n"
           << prefix << osm2rdf::config::constants::ADMIN_RELATIONS_ONLY_INFO;
     }
+    for (const auto& rule : includeTags) {
+      oss << "\n"
+          << prefix << osm2rdf::config::constants::INCLUDE_TAGS_INFO << rule;
+    }
+    for (const auto& rule : excludeTags) {
+      oss << "\n"
+          << prefix << osm2rdf::config::constants::EXCLUDE_TAGS_INFO << rule;
+    }
     if (noAreaFacts) {
       oss << "\n" << prefix << osm2rdf::config::constants::NO_AREA_FACTS_INFO;
     } else {
@@ -196,6 +204,14 @@ std::string osm2rdf::config::Config::getInfo(std::string_view prefix) const {
           << prefix << osm2rdf::config::constants::SIMPLIFY_GEOMETRIES_INFO
           << std::to_string(simplifyGeometries);
     }
+    oss << "\n"
+        << prefix << osm2rdf::config::constants::BOX_ID_GRID_LEVELS_INFO
+        << boxIdGridLevels;
+    if (nodeGridLevels > 0) {
+      oss << "\n"
+          << prefix << osm2rdf::config::constants::NODE_GRID_LEVELS_INFO
+          << nodeGridLevels;
+    }
     if (writeGeomRelTransClosure) {
       oss << "\n"
           << prefix
@@ -213,6 +229,21 @@ std::string osm2rdf::config::Config::getInfo(std::string_view prefix) const {
         << prefix << osm2rdf::config::constants::STORE_LOCATIONS_ON_DISK_INFO
         << " " << storeLocationsOnDisk;
   }
+  if (storeNeededLocationsOnly) {
+    oss << "\n"
+        << prefix
+        << osm2rdf::config::constants::STORE_NEEDED_LOCATIONS_ONLY_INFO;
+  }
+  if (storeWayNodesOnDisk) {
+    oss << "\n"
+        << prefix << osm2rdf::config::constants::STORE_WAY_NODES_ON_DISK_INFO;
+  }
+  oss << "\n"
+      << prefix << osm2rdf::config::constants::MAX_IN_FLIGHT_MB_INFO
+      << maxInFlightMB;
+  if (relationCache) {
+    oss << "\n" << prefix << osm2rdf::config::constants::RELATION_CACHE_INFO;
+  }
 
   if (writeRDFStatistics) {
     oss << "\n"
@@ -243,6 +274,26 @@ void osm2rdf::config::Config::fromArgs(int argc, char** argv) {
           osm2rdf::config::constants::STORE_LOCATIONS_ON_DISK_SHORT,
           osm2rdf::config::constants::STORE_LOCATIONS_ON_DISK_LONG,
           osm2rdf::config::constants::STORE_LOCATIONS_ON_DISK_HELP, "sparse");
+  auto storeNeededLocationsOnlyOp =
+      parser.add<popl::Switch, popl::Attribute::advanced>(
+          osm2rdf::config::constants::STORE_NEEDED_LOCATIONS_ONLY_OPTION_SHORT,
+          osm2rdf::config::constants::STORE_NEEDED_LOCATIONS_ONLY_OPTION_LONG,
+          osm2rdf::config::constants::STORE_NEEDED_LOCATIONS_ONLY_OPTION_HELP);
+  auto storeWayNodesOnDiskOp =
+      parser.add<popl::Switch, popl::Attribute::advanced>(
+          osm2rdf::config::constants::STORE_WAY_NODES_ON_DISK_OPTION_SHORT,
+          osm2rdf::config::constants::STORE_WAY_NODES_ON_DISK_OPTION_LONG,
+          osm2rdf::config::constants::STORE_WAY_NODES_ON_DISK_OPTION_HELP);
+  auto maxInFlightMBOp =
+      parser.add<popl::Value<size_t>, popl::Attribute::expert>(
+          osm2rdf::config::constants::MAX_IN_FLIGHT_MB_OPTION_SHORT,
+          osm2rdf::config::constants::MAX_IN_FLIGHT_MB_OPTION_LONG,
+          osm2rdf::config::constants::MAX_IN_FLIGHT_MB_OPTION_HELP,
+          maxInFlightMB);
+  auto relationCacheOp = parser.add<popl::Switch, popl::Attribute::advanced>(
+      osm2rdf::config::constants::RELATION_CACHE_OPTION_SHORT,
+      osm2rdf::config::constants::RELATION_CACHE_OPTION_LONG,
+      osm2rdf::config::constants::RELATION_CACHE_OPTION_HELP);
 
   auto noAreasOp = parser.add<popl::Switch, popl::Attribute::advanced>(
       osm2rdf::config::constants::NO_AREA_OPTION_SHORT,
@@ -391,6 +442,16 @@ void osm2rdf::config::Config::fromArgs(int argc, char** argv) {
       osm2rdf::config::constants::ADMIN_RELATIONS_ONLY_OPTION_SHORT,
       osm2rdf::config::constants::ADMIN_RELATIONS_ONLY_OPTION_LONG,
       osm2rdf::config::constants::ADMIN_RELATIONS_ONLY_OPTION_HELP);
+  auto includeTagsOp =
+      parser.add<popl::Value<std::string>, popl::Attribute::advanced>(
+          osm2rdf::config::constants::INCLUDE_TAGS_OPTION_SHORT,
+          osm2rdf::config::constants::INCLUDE_TAGS_OPTION_LONG,
+          osm2rdf::config::constants::INCLUDE_TAGS_OPTION_HELP);
+  auto excludeTagsOp =
+      parser.add<popl::Value<std::string>, popl::Attribute::advanced>(
+          osm2rdf::config::constants::EXCLUDE_TAGS_OPTION_SHORT,
+          osm2rdf::config::constants::EXCLUDE_TAGS_OPTION_LONG,
+          osm2rdf::config::constants::EXCLUDE_TAGS_OPTION_HELP);
   auto skipWikiLinksOp = parser.add<popl::Switch>(
       osm2rdf::config::constants::SKIP_WIKI_LINKS_OPTION_SHORT,
       osm2rdf::config::constants::SKIP_WIKI_LINKS_OPTION_LONG,
@@ -423,6 +484,18 @@ void osm2rdf::config::Config::fromArgs(int argc, char** argv) {
       osm2rdf::config::constants::APPROX_SPATIAL_REL_OPTION_SHORT,
       osm2rdf::config::constants::APPROX_SPATIAL_REL_OPTION_LONG,
       osm2rdf::config::constants::APPROX_SPATIAL_REL_OPTION_HELP);
+  auto boxIdGridLevelsOp =
+      parser.add<popl::Value<uint16_t>, popl::Attribute::expert>(
+          osm2rdf::config::constants::BOX_ID_GRID_LEVELS_OPTION_SHORT,
+          osm2rdf::config::constants::BOX_ID_GRID_LEVELS_OPTION_LONG,
+          osm2rdf::config::constants::BOX_ID_GRID_LEVELS_OPTION_HELP,
+          boxIdGridLevels);
+  auto nodeGridLevelsOp =
+      parser.add<popl::Value<uint16_t>, popl::Attribute::expert>(
+          osm2rdf::config::constants::NODE_GRID_LEVELS_OPTION_SHORT,
+          osm2rdf::config::constants::NODE_GRID_LEVELS_OPTION_LONG,
+          osm2rdf::config::constants::NODE_GRID_LEVELS_OPTION_HELP,
+          nodeGridLevels);
   auto simplifyWKTOp =
       parser.add<popl::Value<uint16_t>, popl::Attribute::advanced>(
           osm2rdf::config::constants::SIMPLIFY_WKT_OPTION_SHORT,
@@ -503,6 +576,16 @@ void osm2rdf::config::Config::fromArgs(int argc, char** argv) {
     if (storeLocationsOnDiskOp->is_set()) {
       storeLocationsOnDisk = storeLocationsOnDiskOp->value();
     }
+    storeNeededLocationsOnly = storeNeededLocationsOnlyOp->is_set();
+    if (storeNeededLocationsOnly && !storeLocationsOnDisk.empty()) {
+      std::cerr << "Storing needed locations only can not be combined with "
+                   "storing locations on disk\n"
+                << parser.help() << "\n";
+      exit(osm2rdf::config::ExitCode::FAILURE);
+    }
+    storeWayNodesOnDisk = storeWayNodesOnDiskOp->is_set();
+    relationCache = relationCacheOp->is_set();
+    maxInFlightMB = maxInFlightMBOp->value();
 
     // Select types to dump
     noAreaFacts = noAreaFactsOp->is_set();
@@ -546,12 +629,39 @@ void osm2rdf::config::Config::fromArgs(int argc, char** argv) {
     addWayNodeOrder = addWayNodeOrderOp->is_set();
     addWayNodeSpatialMetadata = addWayNodeSpatialMetadataOp->is_set();
     adminRelationsOnly = adminRelationsOnlyOp->is_set();
+    for (size_t i = 0; i < includeTagsOp->count(); ++i) {
+      includeTags.push_back(includeTagsOp->value(i));
+    }
+    for (size_t i = 0; i < excludeTagsOp->count(); ++i) {
+      excludeTags.push_back(excludeTagsOp->value(i));
+    }
     hasGeometryAsWkt = hasGeometryAsWktOp->is_set();
     skipWikiLinks = skipWikiLinksOp->is_set();
     simplifyGeometries = simplifyGeometriesOp->value();
     simplifyGeometriesInnerOuter = simplifyGeometriesInnerOuterOp->value();
     dontUseInnerOuterGeoms = dontUseInnerOuterGeomsOp->value();
     approximateSpatialRels = approximateSpatialRelsOp->value();
+    boxIdGridLevels = boxIdGridLevelsOp->value();
+    if (boxIdGridLevels < 1 || boxIdGridLevels > 15) {
+      std::cerr << "Box id grid levels must be between 1 and 15: "
+                << boxIdGridLevels << "\n"
+                << parser.help() << "\n";
+      exit(osm2rdf::config::ExitCode::FAILURE);
+    }
+    nodeGridLevels = nodeGridLevelsOp->value();
+    if (nodeGridLevels > boxIdGridLevels) {
+      std::cerr << "Node grid levels must be at most the box id grid levels: "
+                << nodeGridLevels << "\n"
+                << parser.help() << "\n";
+      exit(osm2rdf::config::ExitCode::FAILURE);
+    }
+    // 4^12 cells need 128 MiB of offsets.
+    if (nodeGridLevels > 12) {
+      std::cerr << "Node grid levels must be at most 12: " << nodeGridLevels
+                << "\n"
+                << parser.help() << "\n";
+      exit(osm2rdf::config::ExitCode::FAILURE);
+    }
     simplifyWKT = simplifyWKTOp->value();
     wktDeviation = wktDeviationOp->value();
     wktPrecision = wktPrecisionOp->value();
@@ -0,0 +1,476 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/geometry/BoxClipper.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+#include <utility>
+
+#include "osm2rdf/geometry/Orientation.h"
+
+using osm2rdf::geometry::Location;
+using osm2rdf::geometry::Ring;
+
+namespace {
+
+// Even-odd test whether (x, y) lies inside the ring.
+bool containsPoint(const Ring& ring, double x, double y) {
+  bool inside = false;
+  for (size_t i = 0; i + 1 < ring.size(); ++i) {
+    const double x1 = ring[i].x();
+    const double y1 = ring[i].y();
+    const double x2 = ring[i + 1].x();
+    const double y2 = ring[i + 1].y();
+    if ((y1 > y) != (y2 > y) && x < x1 + (x2 - x1) * (y - y1) / (y2 - y1)) {
+      inside = !inside;
+    }
+  }
+  return inside;
+}
+
+bool equal(const Location& a, const Location& b) {
+  return a.x() == b.x() && a.y() == b.y();
+}
+
+// Whether b is the apex of a spike a, b, c.
+bool isSpike(const Location& a, const Location& b, const Location& c) {
+  const double dot = (static_cast<double>(b.x()) - a.x()) * (c.x() - b.x()) +
+                    (static_cast<double>(b.y()) - a.y()) * (c.y() - b.y());
+  return osm2rdf::geometry::cross(a, b, c) == 0 && dot < 0;
+}
+
+// Append p unless it repeats the last point. Rounded intersection points
+// can turn thin parts into spikes, which are cut off.
+void append(Ring* ring, const Location& p) {
+  while (ring->size() >= 2 &&
+         isSpike((*ring)[ring->size() - 2], ring->back(), p)) {
+    ring->pop_back();
+  }
+  if (ring->empty() || !equal(ring->back(), p)) {
+    ring->push_back(p);
+  }
+}
+
+// Close the ring, removing spikes around its first point.
+void close(Ring* ring) {
+  append(ring, ring->front());
+  while (ring->size() >= 4) {
+    if (equal((*ring)[ring->size() - 2], ring->front())) {
+      ring->pop_back();
+    } else if (isSpike((*ring)[ring->size() - 2], ring->front(), (*ring)[1])) {
+      ring->erase(ring->begin());
+      ring->back() = ring->front();
+    } else {
+      break;
+    }
+  }
+}
+
+}  // namespace
+
+// ____________________________________________________________________________
+osm2rdf::geometry::BoxClipper::BoxClipper(const osm2rdf::geometry::Box& box)
+    : _minX(box.min_corner().x()),
+      _minY(box.min_corner().y()),
+      _maxX(box.max_corner().x()),
+      _maxY(box.max_corner().y()) {}
+
+// ____________________________________________________________________________
+osm2rdf::geometry::Area osm2rdf::geometry::BoxClipper::clip(
+    const osm2rdf::geometry::Area& area) const {
+  osm2rdf::geometry::Area result;
+  for (const auto& polygon : area) {
+    clip(polygon, &result);
+  }
+  return result;
+}
+
+// ____________________________________________________________________________
+void osm2rdf::geometry::BoxClipper::clip(
+    const osm2rdf::geometry::Polygon& polygon,
+    osm2rdf::geometry::Area* out) const {
+  std::vector<Chain> chains;
+  const RingClip outer = clipRing(polygon.outer(), &chains);
+  if (outer == RingClip::INSIDE) {
+    out->push_back(polygon);
+    return;
+  }
+  std::vector<const Ring*> insideHoles;
+  std::vector<const Ring*> outsideHoles;
+  for (const auto& inner : polygon.inners()) {
+    const RingClip clipped = clipRing(inner, &chains);
+    if (clipped == RingClip::INSIDE) {
+      insideHoles.push_back(&inner);
+    } else if (clipped == RingClip::OUTSIDE) {
+      outsideHoles.push_back(&inner);
+    }
+  }
+
+  const size_t first = out->size();
+  if (chains.empty()) {
+    // No boundary crosses the inside of the box, so the box lies either
+    // completely inside or outside of each ring.
+    if (outer == RingClip::OUTSIDE && !containsCenter(polygon.outer())) {
+      return;
+    }
+    for (const auto* hole : outsideHoles) {
+      if (containsCenter(*hole)) {
+        return;
+      }
+    }
+    out->emplace_back();
+    out->back().outer() = boxRing();
+  } else {
+    for (auto& ring : join(&chains)) {
+      out->emplace_back();
+      out->back().outer() = std::move(ring);
+    }
+  }
+
+  for (const auto* hole : insideHoles) {
+    size_t target = first;
+    // A hole may touch the outer ring, so look for a vertex strictly inside.
+    for (size_t i = 0; i + 1 < hole->size() && out->size() - first > 1; ++i) {
+      const auto match =
+          std::find_if(out->begin() + first, out->end(), [&](const auto& p) {
+            return containsPoint(p.outer(), (*hole)[i].x(), (*hole)[i].y());
+          });
+      if (match != out->end()) {
+        target = match - out->begin();
+        break;
+      }
+    }
+    if (target < out->size()) {
+      (*out)[target].inners().push_back(*hole);
+    }
+  }
+}
+
+// ____________________________________________________________________________
+osm2rdf::geometry::BoxClipper::RingClip
+osm2rdf::geometry::BoxClipper::clipRing(const Ring& ring,
+                                        std::vector<Chain>* chains) const {
+  struct Edge {
+    Location a;
+    Location b;
+    bool inside;
+    bool boundary;
+  };
+  std::vector<Edge> edges;
+  edges.reserve(ring.size());
+  size_t numInside = 0;
+  bool clipped = false;
+  for (size_t i = 0; i + 1 < ring.size(); ++i) {
+    Edge edge{ring[i], ring[i + 1], false, false};
+    if (equal(edge.a, edge.b)) {
+      continue;
+    }
+    edge.inside = clipSegment(&edge.a, &edge.b) && insideRight(edge.a, edge.b);
+    edge.boundary = edge.inside && onBoundary(edge.a, edge.b);
+    clipped |= !edge.inside || !equal(edge.a, ring[i]) ||
+               !equal(edge.b, ring[i + 1]);
+    numInside += edge.inside ? 1 : 0;
+    edges.push_back(edge);
+  }
+  if (edges.size() < 3 || numInside == 0) {
+    return RingClip::OUTSIDE;
+  }
+  if (!clipped) {
+    return RingClip::INSIDE;
+  }
+
+  // A chain continues with the next edge unless it leaves the box or runs
+  // along its boundary in between.
+  const auto continues = [&](size_t i) {
+    const Edge& previous = edges[(i + edges.size() - 1) % edges.size()];
+    return previous.inside && !previous.boundary &&
+           equal(previous.b, edges[i].a);
+  };
+  // Start at a break, so that chains are not split.
+  size_t offset = 0;
+  while (offset < edges.size() && continues(offset)) {
+    ++offset;
+  }
+  offset %= edges.size();
+  // Chains are split where they touch the boundary such that the area on
+  // both sides of the touching point lies inside, and along the boundary.
+  // The sides are connected when joining the chains.
+  const size_t numChains = chains->size();
+  Chain chain;
+  const auto finish = [&]() {
+    if (!chain.points.empty()) {
+      chain.start = position(chain.points.front());
+      chain.end = position(chain.points.back());
+      chains->push_back(std::move(chain));
+      chain = Chain{};
+    }
+  };
+  for (size_t j = 0; j < edges.size(); ++j) {
+    const size_t i = (offset + j) % edges.size();
+    const auto& edge = edges[i];
+    if (!continues(i)) {
+      finish();
+    }
+    if (!edge.inside || edge.boundary) {
+      continue;
+    }
+    if (!chain.points.empty() && onBoundary(edge.a, edge.a) &&
+        cross(edge.a, edge.b, chain.points[chain.points.size() - 2]) > 0) {
+      finish();
+    }
+    if (chain.points.empty()) {
+      chain.points.push_back(edge.a);
+    }
+    chain.points.push_back(edge.b);
+  }
+  finish();
+  return chains->size() > numChains ? RingClip::CROSSING : RingClip::OUTSIDE;
+}
+
+// ____________________________________________________________________________
+bool osm2rdf::geometry::BoxClipper::clipSegment(Location* a,
+                                                Location* b) const {
+  const double ax = a->x();
+  const double ay = a->y();
+  const double bx = b->x();
+  const double by = b->y();
+  const double dx = bx - ax;
+  const double dy = by - ay;
+  const bool aInside =
+      ax >= _minX && ax <= _maxX && ay >= _minY && ay <= _maxY;
+  const bool bInside =
+      bx >= _minX && bx <= _maxX && by >= _minY && by <= _maxY;
+  if (aInside && bInside) {
+    return true;
+  }
+
+  // Liang-Barsky, sides are left, right, bottom and top.
+  const std::array<double, 4> p{-dx, dx, -dy, dy};
+  const std::array<double, 4> q{ax - _minX, _maxX - ax, ay - _minY,
+                                _maxY - ay};
+  double t0 = 0;
+  double t1 = 1;
+  size_t entry = 0;
+  size_t exit = 0;
+  for (size_t side = 0; side < 4; ++side) {
+    if (p[side] == 0) {
+      if (q[side] < 0) {
+        return false;
+      }
+      continue;
+    }
+    const double t = q[side] / p[side];
+    if (p[side] < 0 && t > t0) {
+      t0 = t;
+      entry = side;
+    } else if (p[side] > 0 && t < t1) {
+      t1 = t;
+      exit = side;
+    }
+  }
+  if (aInside) {
+    t0 = 0;
+  }
+  if (bInside) {
+    t1 = 1;
+  }
+  if (t0 >= t1) {
+    return false;
+  }
+
+  // Points on a side get its exact coordinate.
+  const auto onSide = [&](size_t side, double t, Location* out) {
+    if (side < 2) {
+      out->x(side == 0 ? _minX : _maxX);
+      out->y(std::clamp(ay + t * dy, _minY, _maxY));
+    } else {
+      out->x(std::clamp(ax + t * dx, _minX, _maxX));
+      out->y(side == 2 ? _minY : _maxY);
+    }
+  };
+  if (t1 < 1) {
+    onSide(exit, t1, b);
+  }
+  if (t0 > 0) {
+    onSide(entry, t0, a);
+  }
+  return !equal(*a, *b);
+}
+
+// ____________________________________________________________________________
+bool osm2rdf::geometry::BoxClipper::insideRight(const Location& a,
+                                                const Location& b) const {
+  if (a.x() == _minX && b.x() == _minX) {
+    return b.y() > a.y();
+  }
+  if (a.y() == _maxY && b.y() == _maxY) {
+    return b.x() > a.x();
+  }
+  if (a.x() == _maxX && b.x() == _maxX) {
+    return b.y() < a.y();
+  }
+  if (a.y() == _minY && b.y() == _minY) {
+    return b.x() < a.x();
+  }
+  return true;
+}
+
+// ____________________________________________________________________________
+bool osm2rdf::geometry::BoxClipper::onBoundary(const Location& a,
+                                               const Location& b) const {
+  return (a.x() == _minX && b.x() == _minX) ||
+         (a.x() == _maxX && b.x() == _maxX) ||
+         (a.y() == _minY && b.y() == _minY) ||
+         (a.y() == _maxY && b.y() == _maxY);
+}
+
+// ____________________________________________________________________________
+double osm2rdf::geometry::BoxClipper::position(const Location& p) const {
+  const double width = _maxX - _minX;
+  const double height = _maxY - _minY;
+  // Rounded intersection points may miss the boundary slightly, use the
+  // nearest side.
+  const std::array<double, 4> distances{
+      std::abs(p.x() - _minX), std::abs(_maxY - p.y()),
+      std::abs(_maxX - p.x()), std::abs(p.y() - _minY)};
+  switch (std::min_element(distances.begin(), distances.end()) -
+          distances.begin()) {
+    case 0:
+      return std::clamp(p.y() - _minY, 0.0, height);
+    case 1:
+      return height + std::clamp(p.x() - _minX, 0.0, width);
+    case 2:
+      return height + width + std::clamp(_maxY - p.y(), 0.0, height);
+    default:
+      return 2 * height + width + std::clamp(_maxX - p.x(), 0.0, width);
+  }
+}
+
+// ____________________________________________________________________________
+std::vector<Ring> osm2rdf::geometry::BoxClipper::join(
+    std::vector<Chain>* chains) const {
+  const double width = _maxX - _minX;
+  const double height = _maxY - _minY;
+  const double perimeter = 2 * (width + height);
+  const std::array<std::pair<double, Location>, 4> corners{{
+      {0, Location(_minX, _minY)},
+      {height, Location(_minX, _maxY)},
+      {height + width, Location(_maxX, _maxY)},
+      {2 * height + width, Location(_maxX, _minY)},
+  }};
+  const auto clockwise = [&](double from, double to) {
+    const double distance = to - from;
+    return distance < 0 ? distance + perimeter : distance;
+  };
+
+  std::vector<size_t> byStart(chains->size());
+  std::iota(byStart.begin(), byStart.end(), 0);
+  std::sort(byStart.begin(), byStart.end(), [&](size_t a, size_t b) {
+    return (*chains)[a].start < (*chains)[b].start;
+  });
+  std::vector<bool> used(chains->size(), false);
+
+  std::vector<Ring> rings;
+  for (size_t first = 0; first < chains->size(); ++first) {
+    if (used[first]) {
+      continue;
+    }
+    Ring ring;
+    size_t current = first;
+    while (true) {
+      used[current] = true;
+      const Chain& chain = (*chains)[current];
+      for (const auto& point : chain.points) {
+        append(&ring, point);
+      }
+
+      // The next chain starting clockwise from here, the first one closes
+      // the ring. A chain starting right here is only continued if the area
+      // does not also lie on both sides of this point, see clipRing.
+      const size_t i =
+          std::lower_bound(byStart.begin(), byStart.end(), chain.end,
+                           [&](size_t index, double value) {
+                             return (*chains)[index].start < value;
+                           }) -
+          byStart.begin();
+      size_t next = first;
+      bool found = false;
+      for (size_t j = 0; j < byStart.size() && !found; ++j) {
+        const size_t candidate = byStart[(i + j) % byStart.size()];
+        const Chain& other = (*chains)[candidate];
+        if (candidate != first && used[candidate]) {
+          continue;
+        }
+        if (other.start == chain.end &&
+            cross(chain.points.back(), other.points[1],
+                  chain.points[chain.points.size() - 2]) > 0) {
+          continue;
+        }
+        next = candidate;
+        found = true;
+      }
+
+      double distance = clockwise(chain.end, (*chains)[next].start);
+      if (!found && distance == 0) {
+        distance = perimeter;
+      }
+      std::array<std::pair<double, Location>, 4> passed;
+      size_t numPassed = 0;
+      for (const auto& [corner, location] : corners) {
+        const double cornerDistance = clockwise(chain.end, corner);
+        if (cornerDistance > 0 && cornerDistance < distance) {
+          passed[numPassed++] = {cornerDistance, location};
+        }
+      }
+      std::sort(passed.begin(), passed.begin() + numPassed,
+                [](const auto& a, const auto& b) { return a.first < b.first; });
+      for (size_t j = 0; j < numPassed; ++j) {
+        append(&ring, passed[j].second);
+      }
+
+      if (next == first) {
+        break;
+      }
+      current = next;
+    }
+    close(&ring);
+    if (ring.size() >= 4 && osm2rdf::geometry::ringOrientation(ring) != 0) {
+      rings.push_back(std::move(ring));
+    }
+  }
+  return rings;
+}
+
+// ____________________________________________________________________________
+bool osm2rdf::geometry::BoxClipper::containsCenter(const Ring& ring) const {
+  return containsPoint(ring, (_minX + _maxX) / 2, (_minY + _maxY) / 2);
+}
+
+// ____________________________________________________________________________
+Ring osm2rdf::geometry::BoxClipper::boxRing() const {
+  Ring ring;
+  ring.push_back(Location(_minX, _minY));
+  ring.push_back(Location(_minX, _maxY));
+  ring.push_back(Location(_maxX, _maxY));
+  ring.push_back(Location(_maxX, _minY));
+  ring.push_back(Location(_minX, _minY));
+  return ring;
+}
@@ -0,0 +1,283 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "osm2rdf/osm/BoxIdIntersect.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define OSM2RDF_BOX_ID_INTERSECT_X86
+#endif
+
+#include <algorithm>
+
+using osm2rdf::osm::BoxId;
+using osm2rdf::osm::BoxIdIntersect;
+using osm2rdf::osm::BoxIdSpan;
+
+// Galloping is used if one list has at least this many times the runs of
+// the other one.
+static const size_t GALLOP_RATIO = 16;
+// Most skips are short, this many runs are checked one by one before the
+// vector or galloping search takes over.
+static const size_t SHORT_SKIP = 4;
+
+static_assert(sizeof(BoxId) == 8, "vector kernels load runs as 2 x 32 bit");
+
+namespace {
+
+// First index from `from` on whose run ends after pos, or ids.size().
+typedef size_t (*SkipKernel)(BoxIdSpan ids, size_t from, int32_t pos);
+
+}  // namespace
+
+// ____________________________________________________________________________
+static int32_t runBegin(const BoxId& id) { return abs(id.first); }
+
+// ____________________________________________________________________________
+static int32_t runEnd(const BoxId& id) {
+  return abs(id.first) + static_cast<int32_t>(id.second) + 1;
+}
+
+// ____________________________________________________________________________
+static size_t skipScalar(BoxIdSpan ids, size_t from, int32_t pos) {
+  while (from < ids.size() && runEnd(ids[from]) <= pos) {
+    ++from;
+  }
+  return from;
+}
+
+// ____________________________________________________________________________
+// Like skipScalar, but checks at most SHORT_SKIP runs. Returns whether from
+// is the result.
+static bool skipShort(BoxIdSpan ids, size_t* from, int32_t pos) {
+  const size_t end = std::min(*from + SHORT_SKIP, ids.size());
+  for (; *from < end; ++*from) {
+    if (runEnd(ids[*from]) > pos) {
+      return true;
+    }
+  }
+  return *from == ids.size();
+}
+
+#if defined(OSM2RDF_BOX_ID_INTERSECT_X86)
+// ____________________________________________________________________________
+// Compares the last ids of four runs at once, the low half of each 64 bit
+// lane holds abs(first) + second.
+__attribute__((target("avx2"))) static size_t skipAvx2(BoxIdSpan ids,
+                                                       size_t from,
+                                                       int32_t pos) {
+  if (skipShort(ids, &from, pos)) {
+    return from;
+  }
+  const __m256i p = _mm256_set1_epi32(pos);
+  for (; from + 4 <= ids.size(); from += 4) {
+    const __m256i runs = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(ids.data() + from));
+    const __m256i last = _mm256_add_epi32(_mm256_abs_epi32(runs),
+                                          _mm256_srli_epi64(runs, 32));
+    const auto before = static_cast<unsigned>(_mm256_movemask_ps(
+                            _mm256_castsi256_ps(_mm256_cmpgt_epi32(p, last)))) &
+                        0x55U;
+    if (before != 0x55U) {
+      return from + __builtin_ctz(~before & 0x55U) / 2;
+    }
+  }
+  return skipScalar(ids, from, pos);
+}
+#endif
+
+// ____________________________________________________________________________
+// Exponential search followed by a binary search within the last step.
+static size_t skipGallop(BoxIdSpan ids, size_t from, int32_t pos) {
+  if (skipShort(ids, &from, pos)) {
+    return from;
+  }
+  // All runs up to and including lo end at or before pos.
+  size_t lo = from - 1;
+  size_t step = 1;
+  while (lo + step < ids.size() && runEnd(ids[lo + step]) <= pos) {
+    lo += step;
+    step *= 2;
+  }
+  const size_t hi = std::min(lo + step, ids.size());
+  return std::partition_point(
+             ids.begin() + static_cast<std::ptrdiff_t>(lo) + 1,
+             ids.begin() + static_cast<std::ptrdiff_t>(hi),
+             [pos](const BoxId& id) { return runEnd(id) <= pos; }) -
+         ids.begin();
+}
+
+// ____________________________________________________________________________
+// Merge of the runs of a and b, with ANY_FULL set only the existence of an
+// id of a in a full run of b is computed.
+template <SkipKernel skip, bool ANY_FULL>
+static int isectRuns(BoxIdSpan a, BoxIdSpan b,
+                     std::vector<int32_t>* toCheck) {
+  // The first entry holds the number of box ids.
+  if (a.size() < 2 || b.size() < 2) {
+    return 0;
+  }
+  // shortcuts
+  if (runBegin(a[1]) >= runEnd(b.back()) ||
+      runEnd(a.back()) <= runBegin(b[1])) {
+    return 0;
+  }
+
+  int fullContained = 0;
+  bool noContained = false;
+  size_t i = 1;
+  size_t j = 1;
+  // Start of the part of a[i] not handled yet.
+  int32_t pos = runBegin(a[i]);
+
+  while (true) {
+    j = skip(b, j, pos);
+    if (j == b.size()) {
+      break;
+    }
+    if (runBegin(b[j]) > pos) {
+      // The ids of a up to b[j] are not in b. If we already know that we
+      // intersect, we cannot be contained and are done.
+      if (!ANY_FULL) {
+        if (fullContained > 0) {
+          return fullContained;
+        }
+        noContained = true;
+      }
+      i = skip(a, i, runBegin(b[j]));
+      if (i == a.size()) {
+        break;
+      }
+      pos = std::max(runBegin(a[i]), runBegin(b[j]));
+      continue;
+    }
+
+    const int32_t aEnd = runEnd(a[i]);
+    const int32_t overlapEnd = std::min(aEnd, runEnd(b[j]));
+    if (b[j].first > 0) {
+      if (ANY_FULL) {
+        return 1;
+      }
+      fullContained += overlapEnd - pos;
+      // we now know that we surely intersect, but are not contained
+      if (noContained) {
+        return fullContained;
+      }
+    } else if (!ANY_FULL) {
+      for (int32_t id = pos; id < overlapEnd; id++) {
+        toCheck->push_back(id);
+      }
+    }
+
+    if (overlapEnd < aEnd) {
+      pos = overlapEnd;
+    } else {
+      if (++i == a.size()) {
+        break;
+      }
+      pos = runBegin(a[i]);
+    }
+  }
+  return fullContained;
+}
+
+#if defined(OSM2RDF_BOX_ID_INTERSECT_X86)
+// ____________________________________________________________________________
+// The skip is only inlined into a merge compiled for AVX2 as well.
+template <bool ANY_FULL>
+__attribute__((target("avx2"), flatten)) static int isectRunsAvx2(
+    BoxIdSpan a, BoxIdSpan b, std::vector<int32_t>* toCheck) {
+  return isectRuns<skipAvx2, ANY_FULL>(a, b, toCheck);
+}
+#endif
+
+// ____________________________________________________________________________
+template <bool ANY_FULL>
+static int isectRuns(BoxIdSpan a, BoxIdSpan b,
+                     std::vector<int32_t>* toCheck,
+                     BoxIdIntersect::Kernel kernel) {
+  switch (kernel) {
+#if defined(OSM2RDF_BOX_ID_INTERSECT_X86)
+    case BoxIdIntersect::Kernel::AVX2:
+      return isectRunsAvx2<ANY_FULL>(a, b, toCheck);
+#endif
+    case BoxIdIntersect::Kernel::GALLOP:
+      return isectRuns<skipGallop, ANY_FULL>(a, b, toCheck);
+    default:
+      return isectRuns<skipScalar, ANY_FULL>(a, b, toCheck);
+  }
+}
+
+// ____________________________________________________________________________
+static BoxIdIntersect::Kernel kernelFor(BoxIdSpan a, BoxIdSpan b) {
+  static const BoxIdIntersect::Kernel linear = BoxIdIntersect::bestKernel();
+  if (a.size() >= GALLOP_RATIO * b.size() ||
+      b.size() >= GALLOP_RATIO * a.size()) {
+    return BoxIdIntersect::Kernel::GALLOP;
+  }
+  return linear;
+}
+
+// ____________________________________________________________________________
+int osm2rdf::osm::BoxIdIntersect::isect(BoxIdSpan a, BoxIdSpan b,
+                                        std::vector<int32_t>* toCheck) {
+  return isect(a, b, toCheck, kernelFor(a, b));
+}
+
+// ____________________________________________________________________________
+int osm2rdf::osm::BoxIdIntersect::isect(BoxIdSpan a, BoxIdSpan b,
+                                        std::vector<int32_t>* toCheck,
+                                        Kernel kernel) {
+  return isectRuns<false>(a, b, toCheck, kernel);
+}
+
+// ____________________________________________________________________________
+bool osm2rdf::osm::BoxIdIntersect::anyFull(BoxIdSpan a, BoxIdSpan b) {
+  return anyFull(a, b, kernelFor(a, b));
+}
+
+// ____________________________________________________________________________
+bool osm2rdf::osm::BoxIdIntersect::anyFull(BoxIdSpan a, BoxIdSpan b,
+                                           Kernel kernel) {
+  return isectRuns<true>(a, b, nullptr, kernel) > 0;
+}
+
+// ____________________________________________________________________________
+bool osm2rdf::osm::BoxIdIntersect::supported(Kernel kernel) {
+  switch (kernel) {
+#if defined(OSM2RDF_BOX_ID_INTERSECT_X86)
+    case Kernel::AVX2:
+      return __builtin_cpu_supports("avx2") != 0;
+#endif
+    case Kernel::SCALAR:
+    case Kernel::GALLOP:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// ____________________________________________________________________________
+osm2rdf::osm::BoxIdIntersect::Kernel
+osm2rdf::osm::BoxIdIntersect::bestKernel() {
+  if (supported(Kernel::AVX2)) {
+    return Kernel::AVX2;
+  }
+  return Kernel::SCALAR;
+}
@@ -0,0 +1,217 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/CompressedLocationStore.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <stdexcept>
+#include <system_error>
+
+#include "osm2rdf/util/Varint.h"
+
+// Encoded blocks are written to disk in chunks of this size.
+static const size_t WRITE_BUFFER_BYTES = 1U << 20U;
+// Number of decoded blocks cached per thread.
+static const size_t CACHED_BLOCKS = 64;
+
+static std::atomic<uint64_t> nextStoreId{1};
+
+namespace {
+struct DecodedBlock {
+  uint64_t storeId = 0;
+  uint64_t block = 0;
+  std::array<osmium::Location,
+             osm2rdf::osm::CompressedLocationStore::NODES_PER_BLOCK>
+      locations;
+};
+}  // namespace
+
+// ____________________________________________________________________________
+osm2rdf::osm::CompressedLocationStore::CompressedLocationStore(
+    const std::filesystem::path& path)
+    : _cacheFile(path), _storeId(nextStoreId++) {
+  _writeBuffer.reserve(WRITE_BUFFER_BYTES);
+}
+
+// ____________________________________________________________________________
+osm2rdf::osm::CompressedLocationStore::~CompressedLocationStore() {
+  if (_mapped != nullptr) {
+    ::munmap(const_cast<uint8_t*>(_mapped), _fileSize);
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::CompressedLocationStore::set(
+    uint64_t id, const osmium::Location& location) {
+  if (_isFinalized) {
+    throw std::runtime_error(
+        "CompressedLocationStore: nodes have to be stored before lookups");
+  }
+  const uint64_t block = id / NODES_PER_BLOCK;
+  if (!_hasCurrentBlock || block != _currentBlock) {
+    if (_hasCurrentBlock && block < _currentBlock) {
+      throw std::runtime_error(
+          "CompressedLocationStore: nodes have to be sorted by id");
+    }
+    flushBlock();
+    // Blocks without nodes start and end at the same offset.
+    while (_blockOffsets.size() <= block) {
+      _blockOffsets.push_back(_fileSize + _writeBuffer.size());
+    }
+    _currentBlock = block;
+    _hasCurrentBlock = true;
+  }
+  _currentData.push_back(static_cast<uint8_t>(id % NODES_PER_BLOCK));
+  osm2rdf::util::writeVarint(
+      &_currentData, osm2rdf::util::zigzagEncode(location.x() - _lastX));
+  osm2rdf::util::writeVarint(
+      &_currentData, osm2rdf::util::zigzagEncode(location.y() - _lastY));
+  _lastX = location.x();
+  _lastY = location.y();
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::CompressedLocationStore::flushBlock() {
+  _writeBuffer.insert(_writeBuffer.end(), _currentData.begin(),
+                      _currentData.end());
+  _currentData.clear();
+  _lastX = 0;
+  _lastY = 0;
+  if (_writeBuffer.size() >= WRITE_BUFFER_BYTES) {
+    flushWriteBuffer();
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::CompressedLocationStore::flushWriteBuffer() {
+  size_t written = 0;
+  while (written < _writeBuffer.size()) {
+    const auto result =
+        ::write(_cacheFile.fileDescriptor(), _writeBuffer.data() + written,
+                _writeBuffer.size() - written);
+    if (result < 0) {
+      throw std::system_error(errno, std::system_category(),
+                              "CompressedLocationStore: write failed");
+    }
+    written += static_cast<size_t>(result);
+  }
+  _fileSize += written;
+  _writeBuffer.clear();
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::CompressedLocationStore::finalize() {
+  std::call_once(_finalized, &CompressedLocationStore::doFinalize, this);
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::CompressedLocationStore::doFinalize() {
+  flushBlock();
+  flushWriteBuffer();
+  _blockOffsets.push_back(_fileSize);
+  _writeBuffer.shrink_to_fit();
+  _currentData.shrink_to_fit();
+  if (_fileSize > 0) {
+    void* mapped = ::mmap(nullptr, _fileSize, PROT_READ, MAP_SHARED,
+                          _cacheFile.fileDescriptor(), 0);
+    if (mapped == MAP_FAILED) {
+      throw std::system_error(errno, std::system_category(),
+                              "CompressedLocationStore: mmap failed");
+    }
+    ::madvise(mapped, _fileSize, MADV_RANDOM);
+    _mapped = static_cast<const uint8_t*>(mapped);
+  }
+  _isFinalized = true;
+}
+
+// ____________________________________________________________________________
+osmium::Location osm2rdf::osm::CompressedLocationStore::get(
+    uint64_t id) const {
+  const uint64_t block = id / NODES_PER_BLOCK;
+  if (block + 1 >= _blockOffsets.size()) {
+    return osmium::Location{};
+  }
+  const uint64_t begin = _blockOffsets[block];
+  const uint64_t end = _blockOffsets[block + 1];
+  if (begin == end) {
+    return osmium::Location{};
+  }
+
+  thread_local std::vector<DecodedBlock> cache(CACHED_BLOCKS);
+  DecodedBlock& decoded = cache[block % CACHED_BLOCKS];
+  if (decoded.storeId != _storeId || decoded.block != block) {
+    decoded.locations.fill(osmium::Location{});
+    const uint8_t* pos = _mapped + begin;
+    const uint8_t* const blockEnd = _mapped + end;
+    int64_t x = 0;
+    int64_t y = 0;
+    while (pos < blockEnd) {
+      const uint8_t offset = *pos++;
+      x += osm2rdf::util::zigzagDecode(osm2rdf::util::readVarint(&pos));
+      y += osm2rdf::util::zigzagDecode(osm2rdf::util::readVarint(&pos));
+      decoded.locations[offset] = osmium::Location{static_cast<int32_t>(x),
+                                                   static_cast<int32_t>(y)};
+    }
+    decoded.storeId = _storeId;
+    decoded.block = block;
+  }
+  return decoded.locations[id % NODES_PER_BLOCK];
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::CompressedLocationStore::prefetch(const uint64_t* ids,
+                                                     size_t count) const {
+  if (_mapped == nullptr) {
+    return;
+  }
+  const auto pageSize = static_cast<uint64_t>(::sysconf(_SC_PAGESIZE));
+  std::vector<uint64_t> pages;
+  pages.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    const uint64_t block = ids[i] / NODES_PER_BLOCK;
+    if (block + 1 < _blockOffsets.size() &&
+        _blockOffsets[block] != _blockOffsets[block + 1]) {
+      for (uint64_t page = _blockOffsets[block] / pageSize;
+           page <= (_blockOffsets[block + 1] - 1) / pageSize; ++page) {
+        pages.push_back(page);
+      }
+    }
+  }
+  std::sort(pages.begin(), pages.end());
+  pages.erase(std::unique(pages.begin(), pages.end()), pages.end());
+  // One call per run of consecutive pages.
+  size_t runStart = 0;
+  for (size_t i = 1; i <= pages.size(); ++i) {
+    if (i == pages.size() || pages[i] != pages[i - 1] + 1) {
+      ::madvise(const_cast<uint8_t*>(_mapped) + pages[runStart] * pageSize,
+                (pages[i - 1] - pages[runStart] + 1) * pageSize,
+                MADV_WILLNEED);
+      runStart = i;
+    }
+  }
+}
+
+// ____________________________________________________________________________
+uint64_t osm2rdf::osm::CompressedLocationStore::fileSize() const noexcept {
+  return _fileSize + _writeBuffer.size() + _currentData.size();
+}
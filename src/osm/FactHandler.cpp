@@ -17,8 +17,12 @@
 // You should have received a copy of the GNU General Public License
 // along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <algorithm>
+#include <atomic>
 #include <iomanip>
 #include <iostream>
+#include <memory>
+#include <string_view>
 
 #include "boost/geometry.hpp"
 #include "boost/version.hpp"
@@ -26,9 +30,13 @@
 #include "osm2rdf/osm/Area.h"
 #include "osm2rdf/osm/Constants.h"
 #include "osm2rdf/osm/FactHandler.h"
+#include "osm2rdf/osm/Generic.h"
 #include "osm2rdf/osm/Node.h"
+#include "osm2rdf/osm/NodeView.h"
 #include "osm2rdf/osm/Relation.h"
+#include "osm2rdf/osm/TagKeyDictionary.h"
 #include "osm2rdf/osm/Way.h"
+#include "osm2rdf/osm/WayView.h"
 #include "osm2rdf/ttl/Writer.h"
 
 using osm2rdf::osm::constants::AREA_PRECISION;
@@ -71,6 +79,17 @@ osm2rdf::osm::FactHandler<W>::FactHandler(const osm2rdf::config::Config& config,
                                           osm2rdf::ttl::Writer<W>* writer)
     : _config(config), _writer(writer) {}
 
+// ____________________________________________________________________________
+template <typename W>
+osm2rdf::osm::FactHandler<W>::~FactHandler() {
+  if (_tagKeyIRIs == nullptr) {
+    return;
+  }
+  for (size_t i = 0; i < osm2rdf::osm::TagKeyDictionary::CAPACITY; ++i) {
+    delete _tagKeyIRIs[i].load();
+  }
+}
+
 // ____________________________________________________________________________
 template <typename W>
 void osm2rdf::osm::FactHandler<W>::area(const osm2rdf::osm::Area& area) {
@@ -121,7 +140,7 @@ void osm2rdf::osm::FactHandler<W>::area(const osm2rdf::osm::Area& area) {
 
 // ____________________________________________________________________________
 template <typename W>
-void osm2rdf::osm::FactHandler<W>::node(const osm2rdf::osm::Node& node) {
+void osm2rdf::osm::FactHandler<W>::node(const osm2rdf::osm::NodeView& node) {
   const std::string& subj =
       _writer->generateIRI(NAMESPACE__OSM_NODE, node.id());
 
@@ -234,7 +253,7 @@ void osm2rdf::osm::FactHandler<W>::relation(
 
 // ____________________________________________________________________________
 template <typename W>
-void osm2rdf::osm::FactHandler<W>::way(const osm2rdf::osm::Way& way) {
+void osm2rdf::osm::FactHandler<W>::way(const osm2rdf::osm::WayView& way) {
   const std::string& subj = _writer->generateIRI(NAMESPACE__OSM_WAY, way.id());
 
   _writer->writeTriple(subj, IRI__RDF_TYPE, IRI__OSM_WAY);
@@ -244,14 +263,17 @@ void osm2rdf::osm::FactHandler<W>::way(const osm2rdf::osm::Way& way) {
   if (_config.addWayNodeOrder) {
     size_t wayOrder = 0;
     std::string lastBlankNode;
-    auto lastNode = way.nodes().front();
-    for (const auto& node : way.nodes()) {
+    osm2rdf::geometry::Location lastLocation;
+    for (const auto& nodeRef : way.nodes()) {
+      const osm2rdf::osm::Node::id_t nodeId = nodeRef.positive_ref();
+      const osm2rdf::geometry::Location location{nodeRef.lon(),
+                                                 nodeRef.lat()};
       const std::string& blankNode = _writer->generateBlankNode();
       _writer->writeTriple(subj, IRI__OSMWAY_NODE, blankNode);
 
       _writer->writeTriple(
           blankNode, osm2rdf::ttl::constants::IRI__OSMWAY_NODE,
-          _writer->generateIRI(NAMESPACE__OSM_NODE, node.id()));
+          _writer->generateIRI(NAMESPACE__OSM_NODE, nodeId));
 
       _writer->writeTriple(
           blankNode, IRI__OSM2RDF__POS,
@@ -260,35 +282,35 @@ void osm2rdf::osm::FactHandler<W>::way(const osm2rdf::osm::Way& way) {
 
       if (_config.addWayNodeGeometry) {
         const std::string& subj =
-            _writer->generateIRI(NAMESPACE__OSM_NODE, node.id());
+            _writer->generateIRI(NAMESPACE__OSM_NODE, nodeId);
 
         _writer->writeTriple(subj, IRI__RDF_TYPE, IRI__OSM_NODE);
 
         if (!_config.hasGeometryAsWkt) {
           const std::string& geomObj = _writer->generateIRI(
-              NAMESPACE__OSM2RDF_GEOM, "node_" + std::to_string(node.id()));
+              NAMESPACE__OSM2RDF_GEOM, "node_" + std::to_string(nodeId));
 
           _writer->writeTriple(subj, IRI__GEOSPARQL__HAS_GEOMETRY, geomObj);
-          writeBoostGeometry(geomObj, IRI__GEOSPARQL__AS_WKT, node.geom());
+          writeBoostGeometry(geomObj, IRI__GEOSPARQL__AS_WKT, location);
         } else {
-          writeBoostGeometry(subj, IRI__GEOSPARQL__HAS_GEOMETRY, node.geom());
+          writeBoostGeometry(subj, IRI__GEOSPARQL__HAS_GEOMETRY, location);
         }
       }
 
       if (_config.addWayNodeSpatialMetadata && !lastBlankNode.empty()) {
         _writer->writeTriple(
             lastBlankNode, IRI__OSMWAY_NEXT_NODE,
-            _writer->generateIRI(NAMESPACE__OSM_NODE, node.id()));
+            _writer->generateIRI(NAMESPACE__OSM_NODE, nodeId));
         // Haversine distance
-        const double distanceLat = (node.geom().y() - lastNode.geom().y()) *
+        const double distanceLat = (location.y() - lastLocation.y()) *
                                    osm2rdf::osm::constants::DEGREE;
-        const double distanceLon = (node.geom().x() - lastNode.geom().x()) *
+        const double distanceLon = (location.x() - lastLocation.x()) *
                                    osm2rdf::osm::constants::DEGREE;
         const double haversine =
             (sin(distanceLat / 2) * sin(distanceLat / 2)) +
             (sin(distanceLon / 2) * sin(distanceLon / 2) *
-             cos(lastNode.geom().y() * osm2rdf::osm::constants::DEGREE) *
-             cos(node.geom().y() * osm2rdf::osm::constants::DEGREE));
+             cos(lastLocation.y() * osm2rdf::osm::constants::DEGREE) *
+             cos(location.y() * osm2rdf::osm::constants::DEGREE));
         const double distance = osm2rdf::osm::constants::EARTH_RADIUS_KM *
                                 osm2rdf::osm::constants::METERS_IN_KM * 2 *
                                 asin(sqrt(haversine));
@@ -298,11 +320,11 @@ void osm2rdf::osm::FactHandler<W>::way(const osm2rdf::osm::Way& way) {
                                            "^^" + IRI__XSD_DECIMAL));
       }
       lastBlankNode = blankNode;
-      lastNode = node;
+      lastLocation = location;
     }
   }
 
-  osm2rdf::geometry::Linestring locations{way.geom()};
+  const osm2rdf::geometry::Way locations = way.geom();
   size_t numUniquePoints = locations.size();
 
   if (!_config.hasGeometryAsWkt) {
@@ -315,15 +337,20 @@ void osm2rdf::osm::FactHandler<W>::way(const osm2rdf::osm::Way& way) {
     writeBoostGeometry(subj, IRI__GEOSPARQL__HAS_GEOMETRY, locations);
   }
 
+  osm2rdf::geometry::Polygon convexHull;
+  if (_config.addWayConvexHull || _config.addWayOrientedBoundingBox) {
+    convexHull = osm2rdf::osm::WayView::convexHull(locations);
+  }
   if (_config.addWayConvexHull) {
-    writeBoostGeometry(subj, IRI__OSM2RDF_GEOM__CONVEX_HULL, way.convexHull());
+    writeBoostGeometry(subj, IRI__OSM2RDF_GEOM__CONVEX_HULL, convexHull);
   }
   if (_config.addWayEnvelope) {
     writeBox(subj, IRI__OSM2RDF_GEOM__ENVELOPE, way.envelope());
   }
 
   if (_config.addWayOrientedBoundingBox) {
-    writeBoostGeometry(subj, IRI__OSM2RDF_GEOM__OBB, way.orientedBoundingBox());
+    writeBoostGeometry(subj, IRI__OSM2RDF_GEOM__OBB,
+                       osm2rdf::osm::WayView::orientedBoundingBox(convexHull));
   }
 
   if (_config.addWayMetadata) {
@@ -343,7 +370,7 @@ void osm2rdf::osm::FactHandler<W>::way(const osm2rdf::osm::Way& way) {
     _writer->writeTriple(
         subj, _writer->generateIRIUnsafe(NAMESPACE__OSM2RDF, "length"),
         _writer->generateLiteral(
-            std::to_string(boost::geometry::length(way.geom())),
+            std::to_string(boost::geometry::length(locations)),
             "^^" + osm2rdf::ttl::constants::IRI__XSD_DOUBLE));
   }
 }
@@ -394,8 +421,48 @@ void osm2rdf::osm::FactHandler<W>::writeBox(const std::string& subj,
 template <typename W>
 void osm2rdf::osm::FactHandler<W>::writeTag(const std::string& subj,
                                             const osm2rdf::osm::Tag& tag) {
-  const std::string& key = tag.first;
-  const std::string& value = tag.second;
+  writeTag(subj, osm2rdf::osm::TagKeyDictionary::instance().intern(tag.first),
+           tag.second);
+}
+
+// ____________________________________________________________________________
+template <typename W>
+const std::string& osm2rdf::osm::FactHandler<W>::tagKeyIRI(
+    osm2rdf::osm::TagKeyId keyId) {
+  if (keyId >= osm2rdf::osm::TagKeyDictionary::CAPACITY) {
+    thread_local std::string uncached;
+    uncached = _writer->generateIRI(
+        NAMESPACE__OSM_TAG,
+        osm2rdf::osm::TagKeyDictionary::instance().key(keyId));
+    return uncached;
+  }
+  std::call_once(_tagKeyIRIsAllocated, [this]() {
+    _tagKeyIRIs = std::make_unique<std::atomic<const std::string*>[]>(
+        osm2rdf::osm::TagKeyDictionary::CAPACITY);
+  });
+  const std::string* iri = _tagKeyIRIs[keyId].load(std::memory_order_acquire);
+  if (iri != nullptr) {
+    return *iri;
+  }
+  // Throws std::domain_error for keys not usable in an IRI, these are not
+  // cached.
+  auto generated = std::make_unique<std::string>(_writer->generateIRI(
+      NAMESPACE__OSM_TAG,
+      osm2rdf::osm::TagKeyDictionary::instance().key(keyId)));
+  if (_tagKeyIRIs[keyId].compare_exchange_strong(
+          iri, generated.get(), std::memory_order_acq_rel)) {
+    iri = generated.release();
+  }
+  return *iri;
+}
+
+// ____________________________________________________________________________
+template <typename W>
+void osm2rdf::osm::FactHandler<W>::writeTag(const std::string& subj,
+                                            osm2rdf::osm::TagKeyId keyId,
+                                            const std::string& value) {
+  const std::string& key =
+      osm2rdf::osm::TagKeyDictionary::instance().key(keyId);
   if (key == "admin_level") {
     std::string objectValue;
     std::string rTrimmed;
@@ -417,11 +484,10 @@ void osm2rdf::osm::FactHandler<W>::writeTag(const std::string& subj,
       objectValue = _writer->generateLiteral(value, "");
     }
 
-    _writer->writeTriple(subj, _writer->generateIRI(NAMESPACE__OSM_TAG, key),
-                         objectValue);
+    _writer->writeTriple(subj, tagKeyIRI(keyId), objectValue);
   } else {
     try {
-      _writer->writeTriple(subj, _writer->generateIRI(NAMESPACE__OSM_TAG, key),
+      _writer->writeTriple(subj, tagKeyIRI(keyId),
                            _writer->generateLiteral(value, ""));
     } catch (const std::domain_error&) {
       const std::string& blankNode = _writer->generateBlankNode();
@@ -442,70 +508,107 @@ void osm2rdf::osm::FactHandler<W>::writeTagList(
     const std::string& subj, const osm2rdf::osm::TagList& tags) {
   size_t tagTripleCount = 0;
   for (const auto& tag : tags) {
-    const std::string& key = tag.first;
-    const std::string& value = tag.second;
-    // Special handling for ref tag splitting. Maybe generalize this...
-    if (_config.semicolonTagKeys.find(key) != _config.semicolonTagKeys.end() &&
-        value.find(';') != std::string::npos) {
-      size_t end;
-      size_t start = 0;
-      while ((end = value.find(';', start)) != std::string::npos) {
-        const std::string& partialValue = value.substr(start, end);
-        writeTag(subj, osm2rdf::osm::Tag(key, partialValue));
-        tagTripleCount++;
-        start = end + 1;
-      };
-      const std::string& partialValue = value.substr(start, value.size());
-      writeTag(subj, osm2rdf::osm::Tag(key, partialValue));
-      tagTripleCount++;
-    } else {
-      writeTag(subj, tag);
-      tagTripleCount++;
+    tagTripleCount += writeTagListEntry(subj, tag.keyId, tag.value);
+  }
+  _writer->writeTriple(
+      subj, _writer->generateIRIUnsafe(NAMESPACE__OSM2RDF, "facts"),
+      _writer->generateLiteralUnsafe(std::to_string(tagTripleCount),
+                                     "^^" + IRI__XSD_INTEGER));
+}
+
+// ____________________________________________________________________________
+template <typename W>
+void osm2rdf::osm::FactHandler<W>::writeTagList(const std::string& subj,
+                                                const osmium::TagList& tags) {
+  // Reused for all tags, keys and values are copied only if needed.
+  std::string key;
+  std::string value;
+  size_t tagTripleCount = 0;
+  for (const auto& tag : tags) {
+    std::string_view rawKey = tag.key();
+    if (rawKey.find(' ') != std::string_view::npos) {
+      // Same as convertTagList()
+      key.assign(rawKey);
+      std::replace(key.begin(), key.end(), ' ', '_');
+      rawKey = key;
     }
+    value.assign(tag.value());
+    tagTripleCount += writeTagListEntry(
+        subj, osm2rdf::osm::TagKeyDictionary::instance().intern(rawKey),
+        value);
+  }
+  _writer->writeTriple(
+      subj, _writer->generateIRIUnsafe(NAMESPACE__OSM2RDF, "facts"),
+      _writer->generateLiteralUnsafe(std::to_string(tagTripleCount),
+                                     "^^" + IRI__XSD_INTEGER));
+}
 
-    // Handling for wiki tags
-    if (!_config.skipWikiLinks &&
-        (key == "wikidata" || hasSuffix(key, ":wikidata"))) {
-      // Only take first wikidata entry if ; is found
-      std::string valueTmp = value;
-      auto end = valueTmp.find(';');
-      if (end != std::string::npos) {
-        valueTmp = valueTmp.erase(end);
-      }
-      // Remove all but Q and digits to ensure Qdddddd format
-      valueTmp.erase(
-          remove_if(valueTmp.begin(), valueTmp.end(),
-                    [](char chr) { return (chr != 'Q' && isdigit(chr) == 0); }),
-          valueTmp.end());
+// ____________________________________________________________________________
+template <typename W>
+size_t osm2rdf::osm::FactHandler<W>::writeTagListEntry(
+    const std::string& subj, osm2rdf::osm::TagKeyId keyId,
+    const std::string& value) {
+  const std::string& key =
+      osm2rdf::osm::TagKeyDictionary::instance().key(keyId);
+  size_t tagTripleCount = 0;
+  // Special handling for ref tag splitting. Maybe generalize this...
+  if (_config.semicolonTagKeys.find(key) != _config.semicolonTagKeys.end() &&
+      value.find(';') != std::string::npos) {
+    size_t end;
+    size_t start = 0;
+    while ((end = value.find(';', start)) != std::string::npos) {
+      const std::string& partialValue = value.substr(start, end);
+      writeTag(subj, keyId, partialValue);
+      tagTripleCount++;
+      start = end + 1;
+    };
+    const std::string& partialValue = value.substr(start, value.size());
+    writeTag(subj, keyId, partialValue);
+    tagTripleCount++;
+  } else {
+    writeTag(subj, keyId, value);
+    tagTripleCount++;
+  }
 
+  // Handling for wiki tags
+  if (!_config.skipWikiLinks &&
+      (key == "wikidata" || hasSuffix(key, ":wikidata"))) {
+    // Only take first wikidata entry if ; is found
+    std::string valueTmp = value;
+    auto end = valueTmp.find(';');
+    if (end != std::string::npos) {
+      valueTmp = valueTmp.erase(end);
+    }
+    // Remove all but Q and digits to ensure Qdddddd format
+    valueTmp.erase(
+        remove_if(valueTmp.begin(), valueTmp.end(),
+                  [](char chr) { return (chr != 'Q' && isdigit(chr) == 0); }),
+        valueTmp.end());
+
+    _writer->writeTriple(
+        subj, _writer->generateIRI(NAMESPACE__OSM, key),
+        _writer->generateIRI(NAMESPACE__WIKIDATA_ENTITY, valueTmp));
+    tagTripleCount++;
+  }
+  if (!_config.skipWikiLinks &&
+      (key == "wikipedia" || hasSuffix(key, ":wikipedia"))) {
+    auto pos = value.find(':');
+    if (pos != std::string::npos) {
+      const std::string& lang = value.substr(0, pos);
+      const std::string& entry = value.substr(pos + 1);
       _writer->writeTriple(
           subj, _writer->generateIRI(NAMESPACE__OSM, key),
-          _writer->generateIRI(NAMESPACE__WIKIDATA_ENTITY, valueTmp));
+          _writer->generateIRI("https://" + lang + ".wikipedia.org/wiki/",
+                               entry));
+      tagTripleCount++;
+    } else {
+      _writer->writeTriple(
+          subj, _writer->generateIRI(NAMESPACE__OSM, key),
+          _writer->generateIRI("https://www.wikipedia.org/wiki/", value));
       tagTripleCount++;
-    }
-    if (!_config.skipWikiLinks &&
-        (key == "wikipedia" || hasSuffix(key, ":wikipedia"))) {
-      auto pos = value.find(':');
-      if (pos != std::string::npos) {
-        const std::string& lang = value.substr(0, pos);
-        const std::string& entry = value.substr(pos + 1);
-        _writer->writeTriple(
-            subj, _writer->generateIRI(NAMESPACE__OSM, key),
-            _writer->generateIRI("https://" + lang + ".wikipedia.org/wiki/",
-                                 entry));
-        tagTripleCount++;
-      } else {
-        _writer->writeTriple(
-            subj, _writer->generateIRI(NAMESPACE__OSM, key),
-            _writer->generateIRI("https://www.wikipedia.org/wiki/", value));
-        tagTripleCount++;
-      }
     }
   }
-  _writer->writeTriple(
-      subj, _writer->generateIRIUnsafe(NAMESPACE__OSM2RDF, "facts"),
-      _writer->generateLiteralUnsafe(std::to_string(tagTripleCount),
-                                     "^^" + IRI__XSD_INTEGER));
+  return tagTripleCount;
 }
 
 // ____________________________________________________________________________
@@ -0,0 +1,251 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "osm2rdf/osm/FlatRTree.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define OSM2RDF_FLAT_RTREE_X86
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "osm2rdf/util/Hilbert.h"
+
+using osm2rdf::geometry::Box;
+using osm2rdf::osm::FlatRTree;
+
+// Finite, such that -ffast-math holds. Stored and query bounds are clamped to
+// [-LIMIT, LIMIT], so unused children never match, not even infinite or
+// inverted queries.
+static const float EMPTY_MIN = std::numeric_limits<float>::max();
+static const float EMPTY_MAX = std::numeric_limits<float>::lowest();
+static const double LIMIT = std::nextafter(EMPTY_MIN, 0.0F);
+
+// ____________________________________________________________________________
+static float roundDown(double value) {
+  const double clamped = std::clamp(value, -LIMIT, LIMIT);
+  const auto result = static_cast<float>(clamped);
+  return result > clamped ? std::nextafter(result, EMPTY_MAX) : result;
+}
+
+// ____________________________________________________________________________
+static float roundUp(double value) {
+  const double clamped = std::clamp(value, -LIMIT, LIMIT);
+  const auto result = static_cast<float>(clamped);
+  return result < clamped ? std::nextafter(result, EMPTY_MIN) : result;
+}
+
+// ____________________________________________________________________________
+static uint32_t maskScalar(const float* node, const float* bounds) {
+  const size_t n = FlatRTree::NODE_SIZE;
+  uint32_t mask = 0;
+  for (size_t i = 0; i < n; ++i) {
+    const bool match = node[i] <= bounds[0] && node[n + i] <= bounds[1] &&
+                       node[2 * n + i] >= bounds[2] &&
+                       node[3 * n + i] >= bounds[3];
+    mask |= static_cast<uint32_t>(match) << i;
+  }
+  return mask;
+}
+
+#if defined(OSM2RDF_FLAT_RTREE_X86)
+// ____________________________________________________________________________
+// Two halves of eight children.
+__attribute__((target("avx2"))) static uint32_t maskAvx2(const float* node,
+                                                         const float* bounds) {
+  const size_t n = FlatRTree::NODE_SIZE;
+  const __m256 ax = _mm256_set1_ps(bounds[0]);
+  const __m256 ay = _mm256_set1_ps(bounds[1]);
+  const __m256 bx = _mm256_set1_ps(bounds[2]);
+  const __m256 by = _mm256_set1_ps(bounds[3]);
+  uint32_t mask = 0;
+  for (size_t i = 0; i < n; i += 8) {
+    const __m256 match = _mm256_and_ps(
+        _mm256_and_ps(
+            _mm256_cmp_ps(_mm256_load_ps(node + i), ax, _CMP_LE_OQ),
+            _mm256_cmp_ps(_mm256_load_ps(node + n + i), ay, _CMP_LE_OQ)),
+        _mm256_and_ps(
+            _mm256_cmp_ps(_mm256_load_ps(node + 2 * n + i), bx, _CMP_GE_OQ),
+            _mm256_cmp_ps(_mm256_load_ps(node + 3 * n + i), by, _CMP_GE_OQ)));
+    mask |= static_cast<uint32_t>(_mm256_movemask_ps(match)) << i;
+  }
+  return mask;
+}
+
+// ____________________________________________________________________________
+// All sixteen children at once.
+__attribute__((target("avx512f"))) static uint32_t maskAvx512(
+    const float* node, const float* bounds) {
+  const size_t n = FlatRTree::NODE_SIZE;
+  const __mmask16 minX = _mm512_cmp_ps_mask(
+      _mm512_load_ps(node), _mm512_set1_ps(bounds[0]), _CMP_LE_OQ);
+  const __mmask16 minY = _mm512_mask_cmp_ps_mask(
+      minX, _mm512_load_ps(node + n), _mm512_set1_ps(bounds[1]), _CMP_LE_OQ);
+  const __mmask16 maxX =
+      _mm512_mask_cmp_ps_mask(minY, _mm512_load_ps(node + 2 * n),
+                              _mm512_set1_ps(bounds[2]), _CMP_GE_OQ);
+  return _mm512_mask_cmp_ps_mask(maxX, _mm512_load_ps(node + 3 * n),
+                                 _mm512_set1_ps(bounds[3]), _CMP_GE_OQ);
+}
+#endif
+
+// ____________________________________________________________________________
+osm2rdf::osm::FlatRTree::FlatRTree(const std::vector<Value>& values)
+    : FlatRTree(values, bestKernel()) {}
+
+// ____________________________________________________________________________
+osm2rdf::osm::FlatRTree::FlatRTree(const std::vector<Value>& values,
+                                   Kernel kernel) {
+  switch (kernel) {
+#if defined(OSM2RDF_FLAT_RTREE_X86)
+    case Kernel::AVX2:
+      _mask = maskAvx2;
+      break;
+    case Kernel::AVX512:
+      _mask = maskAvx512;
+      break;
+#endif
+    default:
+      _mask = maskScalar;
+  }
+  if (values.empty()) {
+    return;
+  }
+
+  // Sort by the position of the box centers on the Hilbert curve.
+  double minX = std::numeric_limits<double>::infinity();
+  double minY = minX;
+  double maxX = -minX;
+  double maxY = -minX;
+  const auto centerX = [](const Box& box) {
+    return static_cast<double>(box.min_corner().get<0>()) / 2 +
+           static_cast<double>(box.max_corner().get<0>()) / 2;
+  };
+  const auto centerY = [](const Box& box) {
+    return static_cast<double>(box.min_corner().get<1>()) / 2 +
+           static_cast<double>(box.max_corner().get<1>()) / 2;
+  };
+  for (const auto& value : values) {
+    minX = std::min(minX, centerX(value.first));
+    maxX = std::max(maxX, centerX(value.first));
+    minY = std::min(minY, centerY(value.first));
+    maxY = std::max(maxY, centerY(value.first));
+  }
+  std::vector<std::pair<uint64_t, size_t>> order;
+  order.reserve(values.size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    // The extended maximum keeps the range non-empty.
+    const auto& box = values[i].first;
+    order.emplace_back(
+        osm2rdf::util::hilbertIndex(
+            osm2rdf::util::hilbertCell(centerX(box), minX, maxX + 1),
+            osm2rdf::util::hilbertCell(centerY(box), minY, maxY + 1)),
+        i);
+  }
+  std::sort(order.begin(), order.end());
+  _boxes.reserve(values.size());
+  _values.reserve(values.size());
+  for (const auto& [key, i] : order) {
+    _boxes.push_back(values[i].first);
+    _values.push_back(values[i].second);
+  }
+
+  // Pack the leaves, then each level from the one below until a single node
+  // is left.
+  const auto emptyNode = [] {
+    Node node;
+    for (size_t i = 0; i < NODE_SIZE; ++i) {
+      node.coords[0][i] = EMPTY_MIN;
+      node.coords[1][i] = EMPTY_MIN;
+      node.coords[2][i] = EMPTY_MAX;
+      node.coords[3][i] = EMPTY_MAX;
+    }
+    return node;
+  };
+  _levels.emplace_back((_boxes.size() + NODE_SIZE - 1) / NODE_SIZE,
+                       emptyNode());
+  for (size_t i = 0; i < _boxes.size(); ++i) {
+    auto& node = _levels[0][i / NODE_SIZE];
+    node.coords[0][i % NODE_SIZE] = roundDown(_boxes[i].min_corner().get<0>());
+    node.coords[1][i % NODE_SIZE] = roundDown(_boxes[i].min_corner().get<1>());
+    node.coords[2][i % NODE_SIZE] = roundUp(_boxes[i].max_corner().get<0>());
+    node.coords[3][i % NODE_SIZE] = roundUp(_boxes[i].max_corner().get<1>());
+  }
+  while (_levels.back().size() > 1) {
+    const auto& children = _levels.back();
+    std::vector<Node> nodes((children.size() + NODE_SIZE - 1) / NODE_SIZE,
+                            emptyNode());
+    for (size_t i = 0; i < children.size(); ++i) {
+      const auto& coords = children[i].coords;
+      auto& node = nodes[i / NODE_SIZE];
+      node.coords[0][i % NODE_SIZE] =
+          *std::min_element(coords[0], coords[0] + NODE_SIZE);
+      node.coords[1][i % NODE_SIZE] =
+          *std::min_element(coords[1], coords[1] + NODE_SIZE);
+      node.coords[2][i % NODE_SIZE] =
+          *std::max_element(coords[2], coords[2] + NODE_SIZE);
+      node.coords[3][i % NODE_SIZE] =
+          *std::max_element(coords[3], coords[3] + NODE_SIZE);
+    }
+    _levels.push_back(std::move(nodes));
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::FlatRTree::queryBounds(const Box& box, bool covers,
+                                          float* bounds) {
+  // Intersecting children start before the query box ends, covering
+  // children before it starts.
+  const auto& upper = covers ? box.min_corner() : box.max_corner();
+  const auto& lower = covers ? box.max_corner() : box.min_corner();
+  bounds[0] = roundUp(upper.get<0>());
+  bounds[1] = roundUp(upper.get<1>());
+  bounds[2] = roundDown(lower.get<0>());
+  bounds[3] = roundDown(lower.get<1>());
+}
+
+// ____________________________________________________________________________
+bool osm2rdf::osm::FlatRTree::supported(Kernel kernel) {
+  switch (kernel) {
+#if defined(OSM2RDF_FLAT_RTREE_X86)
+    case Kernel::AVX2:
+      return __builtin_cpu_supports("avx2") != 0;
+    case Kernel::AVX512:
+      return __builtin_cpu_supports("avx512f") != 0;
+#endif
+    case Kernel::SCALAR:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// ____________________________________________________________________________
+osm2rdf::osm::FlatRTree::Kernel osm2rdf::osm::FlatRTree::bestKernel() {
+  if (supported(Kernel::AVX512)) {
+    return Kernel::AVX512;
+  }
+  if (supported(Kernel::AVX2)) {
+    return Kernel::AVX2;
+  }
+  return Kernel::SCALAR;
+}
@@ -23,6 +23,7 @@
 #include <algorithm>
 #include <iostream>
 #include <memory>
+#include <numeric>
 #include <utility>
 #include <vector>
 
@@ -30,7 +31,9 @@
 #include "boost/geometry.hpp"
 #include "boost/geometry/index/rtree.hpp"
 #include "boost/thread.hpp"
+#include "omp.h"
 #include "osm2rdf/config/Config.h"
+#include "osm2rdf/geometry/BoxClipper.h"
 #include "osm2rdf/osm/Area.h"
 #include "osm2rdf/osm/Constants.h"
 #include "osm2rdf/osm/FactHandler.h"
@@ -39,6 +42,7 @@
 #include "osm2rdf/ttl/Writer.h"
 #include "osm2rdf/util/DirectedAcyclicGraph.h"
 #include "osm2rdf/util/DirectedGraph.h"
+#include "osm2rdf/util/Hilbert.h"
 #include "osm2rdf/util/ProgressBar.h"
 #include "osm2rdf/util/Time.h"
 #include "osm2rdf/util/Timer.h"
@@ -47,12 +51,19 @@
 #pragma ide diagnostic ignored "modernize-loop-convert"
 
 using osm2rdf::osm::Area;
+using osm2rdf::osm::BoxIdIntersect;
 using osm2rdf::osm::BoxIdList;
+using osm2rdf::osm::BoxIdSpan;
 using osm2rdf::osm::GeometryHandler;
 using osm2rdf::osm::Node;
+using osm2rdf::osm::NodeView;
+using osm2rdf::osm::PreparedArea;
 using osm2rdf::osm::Relation;
 using osm2rdf::osm::SpatialAreaRefValue;
+using osm2rdf::osm::SpatialAreaView;
+using osm2rdf::osm::SpatialQueryBuffer;
 using osm2rdf::osm::Way;
+using osm2rdf::osm::WayView;
 using osm2rdf::osm::constants::BASE_SIMPLIFICATION_FACTOR;
 using osm2rdf::ttl::constants::IRI__OSM2RDF_CONTAINS_AREA;
 using osm2rdf::ttl::constants::IRI__OSM2RDF_CONTAINS_NON_AREA;
@@ -70,34 +81,23 @@ GeometryHandler<W>::GeometryHandler(const osm2rdf::config::Config& config,
                                     osm2rdf::ttl::Writer<W>* writer)
     : _config(config),
       _writer(writer),
-      _tmpPathUnnamedAreas(config.getTempPath("spatial", "areas_unnamed")),
-      _fsUnnamedAreas(_tmpPathUnnamedAreas, std::ios::in | std::ios::out |
-                                                std::ios::trunc |
-                                                std::ios::binary),
-      _oaUnnamedAreas(_fsUnnamedAreas),
-      _tmpPathNodes(config.getTempPath("spatial", "nodes")),
-      _fsNodes(_tmpPathNodes, std::ios::in | std::ios::out | std::ios::trunc |
-                                  std::ios::binary),
-      _oaNodes(_fsNodes),
-      _tmpPathWays(config.getTempPath("spatial", "ways")),
-      _fsWays(_tmpPathWays, std::ios::in | std::ios::out | std::ios::trunc |
-                                std::ios::binary),
-      _oaWays(_fsWays) {
-  // immediately unlink all opened files to ensure their removal at exit / crash
-  // note that if one of the initializations above fails after a file was
-  // opened, it will not be deleted
-  unlink(_tmpPathUnnamedAreas.c_str());
-  unlink(_tmpPathNodes.c_str());
-  unlink(_tmpPathWays.c_str());
-
-  _fsUnnamedAreas << std::fixed << std::setprecision(_config.wktPrecision);
-  _fsWays << std::fixed << std::setprecision(_config.wktPrecision);
-  _fsNodes << std::fixed << std::setprecision(_config.wktPrecision);
-}
+      _gridCells(1 << config.boxIdGridLevels),
+      _gridW(360.0 / _gridCells),
+      _gridH(180.0 / _gridCells),
+      _unnamedAreas(config.getTempPath("spatial", "areas_unnamed")),
+      _nodes(config.getTempPath("spatial", "nodes")),
+      _ways(config.getTempPath("spatial", "ways")) {}
 
 // ___________________________________________________________________________
 template <typename W>
-GeometryHandler<W>::~GeometryHandler() = default;
+GeometryHandler<W>::~GeometryHandler() {
+  if (_preparedAreas == nullptr) {
+    return;
+  }
+  for (size_t i = 0; i < _spatialStorageArea.size(); ++i) {
+    delete _preparedAreas[i].load();
+  }
+}
 
 // ____________________________________________________________________________
 template <typename W>
@@ -105,7 +105,7 @@ void GeometryHandler<W>::relation(const Relation& rel) {
   const auto& tags = rel.tags();
   auto typeTag = tags.find("type");
   if (typeTag != tags.end() &&
-      (typeTag->second == "boundary" || typeTag->second == "multipolygon")) {
+      (typeTag->value == "boundary" || typeTag->value == "multipolygon")) {
     for (const auto& member : rel.members()) {
       if (member.type() == RelationMemberType::WAY &&
           (member.role() == "outer" || member.role() == "inner")) {
@@ -133,7 +133,7 @@ void GeometryHandler<W>::area(const Area& area) {
   // the convex hull of the geometry
   osm2rdf::geometry::Polygon convexHull;
 
-  const auto& geom = simplifyGeometry(area.geom());
+  auto geom = simplifyGeometry(area.geom());
 
   size_t totPoints = 0;
   const size_t MIN_CUTOUT_POINTS = 10000;
@@ -178,46 +178,66 @@ void GeometryHandler<W>::area(const Area& area) {
       pack(getBoxIds(area.geom(), envelopes, innerGeom, outerGeom,
                      totPoints > MIN_CUTOUT_POINTS ? &cutouts : 0));
 
+  SpatialAreaData value{
+      std::move(envelopes),
+      area.id(),
+      area.objId(),
+      area.geomArea(),
+      area.fromWay() ? AreaFromType::WAY : AreaFromType::RELATION,
+      boxIds,
+      osm2rdf::geometry::orientedBox(area.orientedBoundingBox(),
+                                     area.envelope()),
+      SpatialAreaGeometry{std::move(geom), std::move(innerGeom),
+                          std::move(outerGeom), std::move(cutouts),
+                          std::move(convexHull)}};
+
+  if (area.hasName()) {
 #pragma omp critical(areaDataInsert)
-  {
-    if (area.hasName()) {
-      _spatialStorageArea.push_back(
-          {envelopes, area.id(), geom, area.objId(), area.geomArea(),
-           area.fromWay() ? AreaFromType::WAY : AreaFromType::RELATION,
-           innerGeom, outerGeom, boxIds, cutouts, convexHull,
-           area.orientedBoundingBox()});
-    } else if (!area.fromWay()) {
-      // Areas from ways are handled in GeometryHandler<W>::way
-      _oaUnnamedAreas << SpatialAreaValue(
-          envelopes, area.id(), geom, area.objId(), area.geomArea(),
-          area.fromWay() ? AreaFromType::WAY : AreaFromType::RELATION,
-          innerGeom, outerGeom, boxIds, cutouts, convexHull,
-          area.orientedBoundingBox());
-      _numUnnamedAreas++;
+    {
+      SpatialAreaValue named{value.id, value.objId, value.area, value.fromType,
+                             static_cast<uint32_t>(
+                                 _spatialStorageAreaGeometry.size()),
+                             {_spatialStorageAreaEnvelopes.size(),
+                              static_cast<uint32_t>(value.envelopes.size())},
+                             {_spatialStorageAreaBoxIds.size(),
+                              static_cast<uint32_t>(value.boxIds.size())},
+                             value.obb};
+      _spatialStorageAreaEnvelopes.insert(_spatialStorageAreaEnvelopes.end(),
+                                          value.envelopes.begin(),
+                                          value.envelopes.end());
+      _spatialStorageAreaBoxIds.insert(_spatialStorageAreaBoxIds.end(),
+                                       value.boxIds.begin(),
+                                       value.boxIds.end());
+      _spatialStorageAreaGeometry.push_back(std::move(value.geometry));
+      _spatialStorageArea.push_back(named);
     }
+  } else if (!area.fromWay()) {
+    // Areas from ways are handled in GeometryHandler<W>::way
+    _unnamedAreas.write(value);
   }
 }
 
 // ____________________________________________________________________________
 template <typename W>
-void GeometryHandler<W>::node(const Node& node) {
-#pragma omp critical(nodeDataInsert)
-  {
-    _oaNodes << SpatialNodeValue(node.id(), node.geom());
-    _numNodes++;
-  }
+void GeometryHandler<W>::node(const NodeView& node) {
+  _nodes.write(SpatialNodeValue(node.id(), node.geom()));
 }
 
 // ____________________________________________________________________________
 template <typename W>
-void GeometryHandler<W>::way(const Way& way) {
+void GeometryHandler<W>::way(const WayView& way) {
   WayNodeList nodeIds;
   nodeIds.reserve(way.nodes().size());
 
   for (const auto& nodeRef : way.nodes()) {
-    nodeIds.push_back(nodeRef.id());
+    nodeIds.push_back(nodeRef.positive_ref());
   }
-  const auto& geom = simplifyGeometry(way.geom());
+  // The hulls are built from the full geometry, the index stores the
+  // simplified one.
+  const osm2rdf::geometry::Way fullGeom = way.geom();
+  const auto convexHull = WayView::convexHull(fullGeom);
+  const auto& geom = simplifyGeometry(fullGeom);
+  const osm2rdf::geometry::Box envelope = way.envelope();
 
   std::vector<osm2rdf::geometry::Box> boxes;
 
@@ -239,18 +259,14 @@ void GeometryHandler<W>::way(const Way& way) {
       curSize += CHUNKSIZE;
     }
   } else {
-    boxes.push_back(way.envelope());
+    boxes.push_back(envelope);
   }
 
-  const auto& boxIds = pack(getBoxIds(geom, way.envelope()));
+  const auto& boxIds = pack(getBoxIds(geom, envelope));
 
-#pragma omp critical(wayDataInsert)
-  {
-    _oaWays << SpatialWayValue(way.envelope(), way.id(), geom, nodeIds, boxes,
-                               boxIds, way.convexHull(),
-                               way.orientedBoundingBox());
-    _numWays++;
-  }
+  _ways.write(SpatialWayValue(envelope, way.id(), geom, nodeIds, boxes, boxIds,
+                              convexHull,
+                              WayView::orientedBoundingBox(convexHull)));
 }
 
 // ____________________________________________________________________________
@@ -505,15 +521,32 @@ osm2rdf::geometry::Area GeometryHandler<W>::simplifiedArea(
 // ____________________________________________________________________________
 template <typename W>
 void GeometryHandler<W>::flushExternalStorage() {
-  if (_fsNodes.is_open()) {
-    _fsNodes.flush();
-  }
-  if (_fsUnnamedAreas.is_open()) {
-    _fsUnnamedAreas.flush();
-  }
-  if (_fsWays.is_open()) {
-    _fsWays.flush();
-  }
+  _nodes.flush();
+  _unnamedAreas.flush();
+  _ways.flush();
+}
+
+// ____________________________________________________________________________
+template <typename W>
+void GeometryHandler<W>::sortExternalStorage() {
+  sortExternalStorage(&_nodes, "nodes");
+  sortExternalStorage(&_ways, "ways");
+  sortExternalStorage(&_unnamedAreas, "unnamed areas");
+}
+
+// ____________________________________________________________________________
+template <typename W>
+template <typename T>
+void GeometryHandler<W>::sortExternalStorage(SegmentedSpill<T>* spill,
+                                             const std::string& name) {
+  std::cerr << std::endl;
+  std::cerr << currentTimeFormatted() << " Sorting " << spill->size() << " "
+            << name << " (" << (spill->bytes() >> 20U)
+            << " MB) along Hilbert curve ... " << std::endl;
+  Timer t;
+  spill->sortSpatially();
+  std::cerr << currentTimeFormatted() << " ... done in " << t.secs() << "s"
+            << std::endl;
 }
 
 // ____________________________________________________________________________
@@ -521,6 +554,7 @@ template <typename W>
 void GeometryHandler<W>::calculateRelations() {
   // Ensure functions can open external storage for reading.
   flushExternalStorage();
+  sortExternalStorage();
   prepareRTree();
   prepareDAG();
   dumpNamedAreaRelations();
@@ -535,10 +569,13 @@ void GeometryHandler<W>::prepareRTree() {
   std::cerr << std::endl;
   std::cerr << currentTimeFormatted() << " Sorting "
             << _spatialStorageArea.size() << " areas ... " << std::endl;
-  std::sort(_spatialStorageArea.begin(), _spatialStorageArea.end(),
-            [](const auto& a, const auto& b) {
-              return std::get<4>(a) > std::get<4>(b);
-            });
+  // Queries return candidates by descending index, reverse first such that
+  // areas of equal size come out in insertion order.
+  std::reverse(_spatialStorageArea.begin(), _spatialStorageArea.end());
+  std::stable_sort(_spatialStorageArea.begin(), _spatialStorageArea.end(),
+                   [](const auto& a, const auto& b) {
+                     return a.area > b.area;
+                   });
   std::cerr << currentTimeFormatted() << " ... done " << std::endl;
 
   std::cerr << currentTimeFormatted() << " Packing area r-tree with "
@@ -547,14 +584,118 @@ void GeometryHandler<W>::prepareRTree() {
   std::vector<SpatialAreaRefValue> values;
 
   for (size_t i = 0; i < _spatialStorageArea.size(); i++) {
-    for (size_t j = 1; j < std::get<0>(_spatialStorageArea[i]).size(); j++) {
-      values.emplace_back(std::get<0>(_spatialStorageArea[i])[j], i);
+    const auto& envelopes = areaView(i).envelopes;
+    for (size_t j = 1; j < envelopes.size(); j++) {
+      values.emplace_back(envelopes[j], i);
     }
   }
 
+#if defined(ENABLE_FLAT_AREA_INDEX)
+  _spatialIndex = SpatialIndex(values);
+#else
   _spatialIndex = SpatialIndex(values.begin(), values.end());
+#endif
+#if defined(ENABLE_PREPARED_AREAS)
+  _preparedAreas = std::make_unique<std::atomic<const PreparedArea*>[]>(
+      _spatialStorageArea.size());
+#endif
+  _queryBuffers.assign(omp_get_max_threads(), {});
+
+  size_t numBoxIds = 0;
+  size_t numCells = 0;
+  size_t numCutouts = 0;
+  size_t numCutoutPoints = 0;
+  for (size_t i = 0; i < _spatialStorageArea.size(); i++) {
+    const auto& area = areaView(i);
+    numBoxIds += area.boxIds.size();
+    if (!area.boxIds.empty()) {
+      numCells += area.boxIds[0].first;
+    }
+    for (const auto& [boxId, cutout] : area.geometry->cutouts) {
+      numCutouts++;
+      numCutoutPoints += boost::geometry::num_points(cutout);
+    }
+  }
+
+  std::cerr << currentTimeFormatted() << " ... done\n"
+            << osm2rdf::util::formattedTimeSpacer << " box ids on "
+            << _config.boxIdGridLevels << " grid levels: " << numBoxIds
+            << " runs for " << numCells << " cells ("
+            << numBoxIds * sizeof(BoxId) / 1024 << " KB), " << numCutouts
+            << " cutouts ("
+            << numCutoutPoints * sizeof(osm2rdf::geometry::Location) / 1024
+            << " KB)" << std::endl;
 
-  std::cerr << currentTimeFormatted() << " ... done" << std::endl;
+  if (_config.nodeGridLevels > 0) {
+    prepareNodeGrid();
+  }
+}
+
+// ____________________________________________________________________________
+template <typename W>
+void GeometryHandler<W>::prepareNodeGrid() {
+  std::cerr << currentTimeFormatted() << " Building node grid with "
+            << _config.nodeGridLevels << " levels ... " << std::endl;
+
+  // A node grid cell is an aligned quadtree node of the box id grid, its
+  // cells form a single range of box ids.
+  const uint32_t cellShift =
+      2 * (_config.boxIdGridLevels - _config.nodeGridLevels);
+  const uint64_t cellSize = uint64_t{1} << cellShift;
+  const size_t numCells = size_t{1} << (2 * _config.nodeGridLevels);
+
+  // Call visit(cell, full) for each node grid cell touched by the box ids.
+  const auto forEachCell = [cellShift, cellSize](BoxIdSpan boxIds,
+                                                 const auto& visit) {
+    uint64_t cell = 0;
+    uint64_t numFull = 0;
+    bool touched = false;
+    for (size_t i = 1; i < boxIds.size(); i++) {
+      const uint64_t from = abs(boxIds[i].first) - 1;
+      const uint64_t to = from + boxIds[i].second;
+      for (uint64_t c = from >> cellShift; c <= to >> cellShift; c++) {
+        if (touched && c != cell) {
+          visit(cell, numFull == cellSize);
+          numFull = 0;
+        }
+        cell = c;
+        touched = true;
+        if (boxIds[i].first > 0) {
+          numFull += std::min(to, ((c + 1) << cellShift) - 1) -
+                     std::max(from, c << cellShift) + 1;
+        }
+      }
+    }
+    if (touched) {
+      visit(cell, numFull == cellSize);
+    }
+  };
+
+  // Count the areas per cell, then fill each cell back to front. Areas are
+  // sorted big -> small, so every cell ends up small -> big.
+  _nodeGridOffsets.assign(numCells + 1, 0);
+  for (size_t i = 0; i < _spatialStorageArea.size(); i++) {
+    forEachCell(areaView(i).boxIds,
+                [this](uint64_t cell, bool) { _nodeGridOffsets[cell]++; });
+  }
+  std::partial_sum(_nodeGridOffsets.begin(), _nodeGridOffsets.end(),
+                   _nodeGridOffsets.begin());
+  _nodeGridAreas.resize(_nodeGridOffsets[numCells]);
+  for (size_t i = 0; i < _spatialStorageArea.size(); i++) {
+    forEachCell(areaView(i).boxIds,
+                [this, i](uint64_t cell, bool full) {
+                  _nodeGridAreas[--_nodeGridOffsets[cell]] =
+                      static_cast<uint32_t>(i) | (full ? NODE_GRID_FULL : 0);
+                });
+  }
+
+  std::cerr << currentTimeFormatted() << " ... done, "
+            << _nodeGridAreas.size() << " entries in " << numCells
+            << " cells ("
+            << (_nodeGridAreas.size() * sizeof(uint32_t) +
+                _nodeGridOffsets.size() * sizeof(uint64_t)) /
+                   1024
+            << " KB)" << std::endl;
 }
 
 // ____________________________________________________________________________
@@ -567,7 +708,7 @@ void GeometryHandler<W>::prepareDAG() {
     _spatialStorageAreaIndex.reserve(_spatialStorageArea.size());
     for (size_t i = 0; i < _spatialStorageArea.size(); ++i) {
       const auto& area = _spatialStorageArea[i];
-      _spatialStorageAreaIndex[std::get<1>(area)] = i;
+      _spatialStorageAreaIndex[area.id] = i;
     }
 
     std::cerr << currentTimeFormatted() << " Generating non-reduced DAG from "
@@ -586,8 +727,8 @@ void GeometryHandler<W>::prepareDAG() {
             progressBar) reduction(+ : stats) default(none) schedule(dynamic)
 
     for (size_t i = 0; i < _spatialStorageArea.size(); i++) {
-      const auto& entry = _spatialStorageArea[i];
-      const auto& entryId = std::get<1>(entry);
+      const auto entry = areaView(i);
+      const auto& entryId = entry.id;
 
       // Set containing all areas we are inside of
       SkipSet skip;
@@ -596,11 +737,11 @@ void GeometryHandler<W>::prepareDAG() {
       const auto& queryResult = indexQryCover(entry);
 
       for (const auto& areaRef : queryResult) {
-        const auto& area = _spatialStorageArea[areaRef.second];
-        const auto& areaId = std::get<1>(area);
-        const auto& areaObjId = std::get<3>(area);
-        const auto& areaArea = std::get<4>(area);
-        const auto& areaFromType = std::get<5>(area);
+        const auto area = areaView(areaRef.second);
+        const auto& areaId = area.id;
+        const auto& areaObjId = area.objId;
+        const auto& areaArea = area.area;
+        const auto& areaFromType = area.fromType;
 
         stats.checked();
 
@@ -759,10 +900,10 @@ void GeometryHandler<W>::dumpNamedAreaRelations() {
     reduction(+ : intersectStats) default(none) schedule(static)
   for (size_t i = 0; i < vertices.size(); i++) {
     const auto id = vertices[i];
-    const auto& entry = _spatialStorageArea[_spatialStorageAreaIndex[id]];
-    const auto& entryId = std::get<1>(entry);
-    const auto& entryObjId = std::get<3>(entry);
-    const auto& entryFromType = std::get<5>(entry);
+    const auto entry = areaView(_spatialStorageAreaIndex[id]);
+    const auto& entryId = entry.id;
+    const auto& entryObjId = entry.objId;
+    const auto& entryFromType = entry.fromType;
     std::string entryIRI =
         _writer->generateIRI(areaNS(entryFromType), entryObjId);
 
@@ -773,9 +914,9 @@ void GeometryHandler<W>::dumpNamedAreaRelations() {
     for (const auto& dst : _directedAreaGraph.getEdges(id)) {
       assert(_spatialStorageAreaIndex[dst] < _spatialStorageArea.size());
       const auto& area = _spatialStorageArea[_spatialStorageAreaIndex[dst]];
-      const auto& areaId = std::get<1>(area);
-      const auto& areaObjId = std::get<3>(area);
-      const auto& areaFromType = std::get<5>(area);
+      const auto& areaId = area.id;
+      const auto& areaObjId = area.objId;
+      const auto& areaFromType = area.fromType;
       std::string areaIRI =
           _writer->generateIRI(areaNS(areaFromType), areaObjId);
 
@@ -798,10 +939,10 @@ void GeometryHandler<W>::dumpNamedAreaRelations() {
     const auto& queryResult = indexQryIntersect(entry);
 
     for (const auto& areaRef : queryResult) {
-      const auto& area = _spatialStorageArea[areaRef.second];
-      const auto& areaId = std::get<1>(area);
-      const auto& areaObjId = std::get<3>(area);
-      const auto& areaFromType = std::get<5>(area);
+      const auto area = areaView(areaRef.second);
+      const auto& areaId = area.id;
+      const auto& areaObjId = area.objId;
+      const auto& areaFromType = area.fromType;
 
       intersectStats.checked();
 
@@ -876,7 +1017,7 @@ void GeometryHandler<W>::dumpUnnamedAreaRelations() {
     std::cerr << currentTimeFormatted() << " "
               << "Skipping contains relation for unnamed areas ... disabled"
               << std::endl;
-  } else if (_numUnnamedAreas == 0) {
+  } else if (_unnamedAreas.size() == 0) {
     std::cerr << std::endl;
     std::cerr
         << currentTimeFormatted() << " "
@@ -885,16 +1026,11 @@ void GeometryHandler<W>::dumpUnnamedAreaRelations() {
   } else {
     std::cerr << std::endl;
     std::cerr << currentTimeFormatted() << " "
-              << "Contains relations for " << _numUnnamedAreas
+              << "Contains relations for " << _unnamedAreas.size()
               << " unnamed areas in " << _spatialIndex.size() << " areas ..."
               << std::endl;
 
-    // reset stream
-    _fsUnnamedAreas.clear();
-    _fsUnnamedAreas.seekg(0, std::ios::beg);
-    boost::archive::binary_iarchive ia(_fsUnnamedAreas);
-
-    osm2rdf::util::ProgressBar progressBar{_numUnnamedAreas, true};
+    osm2rdf::util::ProgressBar progressBar{_unnamedAreas.size(), true};
     GeomRelationStats intersectStats, containsStats;
     size_t entryCount = 0;
     progressBar.update(entryCount);
@@ -903,17 +1039,16 @@ void GeometryHandler<W>::dumpUnnamedAreaRelations() {
             osm2rdf::ttl::constants::NAMESPACE__OSM_RELATION,          \
             osm2rdf::ttl::constants::IRI__OSM2RDF_INTERSECTS_NON_AREA, \
             osm2rdf::ttl::constants::IRI__OSM2RDF_CONTAINS_NON_AREA,   \
-            progressBar, entryCount, ia)                               \
+            progressBar, entryCount)                                   \
     reduction(+ : intersectStats, containsStats) default(none)         \
     schedule(dynamic)
-    for (size_t i = 0; i < _numUnnamedAreas; i++) {
-      SpatialAreaValue entry;
-#pragma omp critical(loadEntry)
-      ia >> entry;
-
-      const auto& entryId = std::get<1>(entry);
-      const auto& entryObjId = std::get<3>(entry);
-      const auto& entryFromType = std::get<5>(entry);
+    for (size_t i = 0; i < _unnamedAreas.size(); i++) {
+      SpatialAreaData entry;
+      _unnamedAreas.get(i, &entry);
+
+      const auto& entryId = entry.id;
+      const auto& entryObjId = entry.objId;
+      const auto& entryFromType = entry.fromType;
       std::string entryIRI =
           _writer->generateIRI(areaNS(entryFromType), entryObjId);
 
@@ -924,10 +1059,10 @@ void GeometryHandler<W>::dumpUnnamedAreaRelations() {
       const auto& queryResult = indexQryIntersect(entry);
 
       for (const auto& areaRef : queryResult) {
-        const auto& area = _spatialStorageArea[areaRef.second];
-        const auto& areaId = std::get<1>(area);
-        const auto& areaObjId = std::get<3>(area);
-        const auto& areaFromType = std::get<5>(area);
+        const auto area = areaView(areaRef.second);
+        const auto& areaId = area.id;
+        const auto& areaObjId = area.objId;
+        const auto& areaFromType = area.fromType;
 
         intersectStats.checked();
         containsStats.checked();
@@ -1056,7 +1191,7 @@ void GeometryHandler<W>::dumpUnnamedAreaRelations() {
               << std::endl;
     std::cerr << osm2rdf::util::formattedTimeSpacer << " "
               << (static_cast<double>(intersectStats._totalChecks) /
-                  _numUnnamedAreas)
+                  _unnamedAreas.size())
               << " areas checked per geometry on average" << std::endl;
   }
 }
@@ -1072,7 +1207,7 @@ GeometryHandler<W>::dumpNodeRelations() {
     std::cerr << currentTimeFormatted() << " "
               << "Skipping contains relation for nodes ... disabled"
               << std::endl;
-  } else if (_numNodes == 0) {
+  } else if (_nodes.size() == 0) {
     std::cerr << std::endl;
     std::cerr << currentTimeFormatted() << " "
               << "Skipping contains relation for nodes ... no nodes"
@@ -1080,15 +1215,13 @@ GeometryHandler<W>::dumpNodeRelations() {
   } else {
     std::cerr << std::endl;
     std::cerr << currentTimeFormatted() << " "
-              << "Contains relations for " << _numNodes << " nodes in "
+              << "Contains relations for " << _nodes.size() << " nodes in "
               << _spatialIndex.size() << " areas ..." << std::endl;
 
-    _fsNodes.clear();
-    _fsNodes.seekg(0, std::ios::beg);
-    boost::archive::binary_iarchive ia(_fsNodes);
-
-    osm2rdf::util::ProgressBar progressBar{_numNodes, true};
+    osm2rdf::util::ProgressBar progressBar{_nodes.size(), true};
     size_t entryCount = 0;
+    const size_t numBatches =
+        (_nodes.size() + NODE_BATCH_SIZE - 1) / NODE_BATCH_SIZE;
 
     GeomRelationStats stats;
 
@@ -1101,91 +1234,144 @@ GeometryHandler<W>::dumpNodeRelations() {
             osm2rdf::ttl::constants::IRI__OSM2RDF_CONTAINS_NON_AREA,         \
             osm2rdf::ttl::constants::IRI__OSM2RDF_INTERSECTS_NON_AREA,       \
             osm2rdf::ttl::constants::IRI__OSM2RDF_INTERSECTS_AREA, nodeData, \
-            progressBar, ia, entryCount) reduction(+ : stats) default(none)  \
-    schedule(dynamic)
-    for (size_t i = 0; i < _numNodes; i++) {
-      SpatialNodeValue node;
-#pragma omp critical(loadEntry)
-      ia >> node;
-
-      const auto& nodeId = std::get<0>(node);
-      std::string nodeIRI = _writer->generateIRI(NAMESPACE__OSM_NODE, nodeId);
-
-      // Set containing all areas we are inside of
-      SkipSet skip;
-      std::unordered_set<Area::id_t> skipByContainedInInner;
-
-      const auto& queryResult = indexQry(node);
+            progressBar, entryCount, numBatches) reduction(+ : stats)        \
+    default(none) schedule(dynamic)
+    for (size_t batch = 0; batch < numBatches; batch++) {
+      const size_t first = batch * NODE_BATCH_SIZE;
+      const size_t last = std::min(_nodes.size(), first + NODE_BATCH_SIZE);
+
+      // Group the nodes of this batch by grid cell. Spills are sorted
+      // spatially, so groups are usually large.
+      std::vector<SpatialNodeValue> nodes(last - first);
+      std::vector<std::pair<int32_t, size_t>> cells;
+      cells.reserve(nodes.size());
+      for (size_t i = 0; i < nodes.size(); i++) {
+        _nodes.get(first + i, &nodes[i]);
+        cells.emplace_back(getBoxId(std::get<1>(nodes[i])), i);
+      }
+      std::sort(cells.begin(), cells.end());
+
+      for (size_t groupStart = 0; groupStart < cells.size();) {
+        const int32_t boxId = cells[groupStart].first;
+        size_t groupEnd = groupStart;
+        osm2rdf::geometry::Box groupEnvelope;
+        boost::geometry::assign_inverse(groupEnvelope);
+        while (groupEnd < cells.size() && cells[groupEnd].first == boxId) {
+          boost::geometry::expand(groupEnvelope,
+                                  std::get<1>(nodes[cells[groupEnd].second]));
+          groupEnd++;
+        }
 
-      for (const auto& areaRef : queryResult) {
-        const auto& area = _spatialStorageArea[areaRef.second];
-        const auto& areaId = std::get<1>(area);
-        const auto& areaObjId = std::get<3>(area);
-        const auto& areaFromType = std::get<5>(area);
+        // Query the index and decide fully covered and disjoint areas once
+        // for the whole cell.
+        const auto& candidates = _config.nodeGridLevels > 0
+                                     ? nodeGridQry(boxId)
+                                     : indexQry(groupEnvelope, boxId);
+
+        for (size_t i = groupStart; i < groupEnd; i++) {
+          const auto& node = nodes[cells[i].second];
+
+          const auto& nodeId = std::get<0>(node);
+          std::string nodeIRI =
+              _writer->generateIRI(NAMESPACE__OSM_NODE, nodeId);
+
+          // Set containing all areas we are inside of
+          SkipSet skip;
+          std::unordered_set<Area::id_t> skipByContainedInInner;
+
+          for (const auto& [areaRef, cover] : candidates) {
+            const auto area = areaView(areaRef.second);
+            // The candidates are deduplicated per area, so only the envelope
+            // of the whole area is a valid filter here. Areas covering the
+            // whole cell contain every node in it.
+            if (cover < 0 && !boost::geometry::covered_by(std::get<1>(node),
+                                                          area.envelopes[0])) {
+              continue;
+            }
+            const auto& areaId = area.id;
+            const auto& areaObjId = area.objId;
+            const auto& areaFromType = area.fromType;
 
-        stats.checked();
+            stats.checked();
 
-        if (areaFromType == AreaFromType::RELATION &&
-            skipByContainedInInner.find(areaObjId) !=
-                skipByContainedInInner.end()) {
-          stats.skippedByContainedInInnerRing();
-          continue;
-        }
+            if (areaFromType == AreaFromType::RELATION &&
+                skipByContainedInInner.find(areaObjId) !=
+                    skipByContainedInInner.end()) {
+              stats.skippedByContainedInInnerRing();
+              continue;
+            }
 
-        if (skip.find(areaId) != skip.end()) {
-          stats.skippedByDAG();
-          continue;
-        }
+            if (skip.find(areaId) != skip.end()) {
+              stats.skippedByDAG();
+              continue;
+            }
 
-        GeomRelationInfo geomRelInf;
-        if (!nodeInArea(node, area, &geomRelInf, &stats)) {
-          continue;
-        }
+            GeomRelationInfo geomRelInf;
+            if (cover > 0) {
+              stats.skippedByBoxIdIntersect();
+            } else {
+              // Only the part of the area in this cell remains to check.
+              geomRelInf.fullContained = 0;
+              geomRelInf.toCheck.push_back(boxId);
+              if (!nodeInArea(node, areaRef.second, &geomRelInf, &stats)) {
+                continue;
+              }
+            }
 
-        if (areaFromType == AreaFromType::WAY) {
-          // we are contained in an area derived from a way.
-          const auto& relations = _areaBorderWaysIndex.find(areaObjId);
-          if (relations != _areaBorderWaysIndex.end()) {
-            for (auto r : relations->second) {
-              if (r.second) {
-                // way is inner geometry of this area relation, so if we
-                // encounter the enclosing area again for this way, we can
-                // be sure that we are not contained in it!
-                skipByContainedInInner.insert(r.first);
+            if (areaFromType == AreaFromType::WAY) {
+              // we are contained in an area derived from a way.
+              const auto& relations = _areaBorderWaysIndex.find(areaObjId);
+              if (relations != _areaBorderWaysIndex.end()) {
+                for (auto r : relations->second) {
+                  if (r.second) {
+                    // way is inner geometry of this area relation, so if we
+                    // encounter the enclosing area again for this way, we can
+                    // be sure that we are not contained in it!
+                    skipByContainedInInner.insert(r.first);
+                  }
+                }
               }
             }
-          }
-        }
 
-        skip.insert(areaId);
+            skip.insert(areaId);
 
-        const auto& successors = _directedAreaGraph.findSuccessorsFast(areaId);
-        skip.insert(successors.begin(), successors.end());
+            const auto& successors =
+                _directedAreaGraph.findSuccessorsFast(areaId);
+            skip.insert(successors.begin(), successors.end());
 
-        std::string areaIRI =
-            _writer->generateIRI(areaNS(areaFromType), areaObjId);
+            std::string areaIRI =
+                _writer->generateIRI(areaNS(areaFromType), areaObjId);
 
-        // transitive closure
-        writeTransitiveClosure(successors, nodeIRI,
-                               IRI__OSM2RDF_INTERSECTS_NON_AREA,
-                               IRI__OSM2RDF_INTERSECTS_AREA);
-        writeTransitiveClosure(successors, nodeIRI,
-                               IRI__OSM2RDF_CONTAINS_NON_AREA);
-
-        _writer->writeTriple(
-            areaIRI, osm2rdf::ttl::constants::IRI__OSM2RDF_INTERSECTS_NON_AREA,
-            nodeIRI);
-        _writer->writeTriple(
-            nodeIRI, osm2rdf::ttl::constants::IRI__OSM2RDF_INTERSECTS_AREA,
-            areaIRI);
-        _writer->writeTriple(
-            areaIRI, osm2rdf::ttl::constants::IRI__OSM2RDF_CONTAINS_NON_AREA,
-            nodeIRI);
-      }
+            // transitive closure
+            writeTransitiveClosure(successors, nodeIRI,
+                                   IRI__OSM2RDF_INTERSECTS_NON_AREA,
+                                   IRI__OSM2RDF_INTERSECTS_AREA);
+            writeTransitiveClosure(successors, nodeIRI,
+                                   IRI__OSM2RDF_CONTAINS_NON_AREA);
+
+            _writer->writeTriple(
+                areaIRI,
+                osm2rdf::ttl::constants::IRI__OSM2RDF_INTERSECTS_NON_AREA,
+                nodeIRI);
+            _writer->writeTriple(
+                nodeIRI, osm2rdf::ttl::constants::IRI__OSM2RDF_INTERSECTS_AREA,
+                areaIRI);
+            _writer->writeTriple(
+                areaIRI,
+                osm2rdf::ttl::constants::IRI__OSM2RDF_CONTAINS_NON_AREA,
+                nodeIRI);
+          }
 #pragma omp critical(nodeDataChange)
-      std::copy(skip.begin(), skip.end(), std::back_inserter(nodeData[nodeId]));
+          std::copy(skip.begin(), skip.end(),
+                    std::back_inserter(nodeData[nodeId]));
+        }
+        groupStart = groupEnd;
+      }
 #pragma omp critical(progress)
-      progressBar.update(entryCount++);
+      {
+        entryCount += nodes.size();
+        progressBar.update(entryCount);
+      }
     }
     progressBar.done();
 
@@ -1216,7 +1402,7 @@ GeometryHandler<W>::dumpNodeRelations() {
               << std::endl;
 
     std::cerr << osm2rdf::util::formattedTimeSpacer << " "
-              << (static_cast<double>(stats._totalChecks) / _numWays)
+              << (static_cast<double>(stats._totalChecks) / _ways.size())
               << " areas checked per geometry on average" << std::endl;
   }
   return nodeData;
@@ -1231,21 +1417,17 @@ void GeometryHandler<W>::dumpWayRelations(
     std::cerr << currentTimeFormatted() << " "
               << "Skipping contains relation for ways ... disabled"
               << std::endl;
-  } else if (_numWays == 0) {
+  } else if (_ways.size() == 0) {
     std::cerr << std::endl;
     std::cerr << currentTimeFormatted() << " "
               << "Skipping contains relation for ways ... no ways" << std::endl;
   } else {
     std::cerr << std::endl;
     std::cerr << currentTimeFormatted() << " "
-              << "Contains relations for " << _numWays << " ways in "
+              << "Contains relations for " << _ways.size() << " ways in "
               << _spatialIndex.size() << " areas ..." << std::endl;
 
-    _fsWays.clear();
-    _fsWays.seekg(0, std::ios::beg);
-    boost::archive::binary_iarchive ia(_fsWays);
-
-    osm2rdf::util::ProgressBar progressBar{_numWays, true};
+    osm2rdf::util::ProgressBar progressBar{_ways.size(), true};
     size_t entryCount = 0;
 
     GeomRelationStats intersectStats, containsStats;
@@ -1257,15 +1439,13 @@ void GeometryHandler<W>::dumpWayRelations(
             osm2rdf::ttl::constants::IRI__OSM2RDF_INTERSECTS_NON_AREA,     \
             osm2rdf::ttl::constants::IRI__OSM2RDF_INTERSECTS_AREA,         \
             osm2rdf::ttl::constants::IRI__OSM2RDF_CONTAINS_NON_AREA,       \
-            progressBar, entryCount, ia)                                   \
+            progressBar, entryCount)                                       \
     reduction(+ : intersectStats, containsStats) default(none)             \
     schedule(dynamic)
 
-    for (size_t i = 0; i < _numWays; i++) {
+    for (size_t i = 0; i < _ways.size(); i++) {
       SpatialWayValue way;
-
-#pragma omp critical(loadEntry)
-      ia >> way;
+      _ways.get(i, &way);
 
       const auto& wayId = std::get<1>(way);
       const auto& wayNodeIds = std::get<3>(way);
@@ -1298,10 +1478,10 @@ void GeometryHandler<W>::dumpWayRelations(
       const auto& queryResult = indexQryIntersect(way);
 
       for (const auto& areaRef : queryResult) {
-        const auto& area = _spatialStorageArea[areaRef.second];
-        const auto& areaId = std::get<1>(area);
-        const auto& areaObjId = std::get<3>(area);
-        const auto& areaFromType = std::get<5>(area);
+        const auto area = areaView(areaRef.second);
+        const auto& areaId = area.id;
+        const auto& areaObjId = area.objId;
+        const auto& areaFromType = area.fromType;
 
         intersectStats.checked();
         containsStats.checked();
@@ -1505,7 +1685,7 @@ void GeometryHandler<W>::dumpWayRelations(
 
               << std::endl;
     std::cerr << osm2rdf::util::formattedTimeSpacer << " "
-              << (static_cast<double>(intersectStats._totalChecks) / _numWays)
+              << (static_cast<double>(intersectStats._totalChecks) / _ways.size())
               << " areas checked per geometry on average" << std::endl;
   }
 }
@@ -1513,18 +1693,18 @@ void GeometryHandler<W>::dumpWayRelations(
 // ____________________________________________________________________________
 template <typename W>
 bool GeometryHandler<W>::nodeInArea(const SpatialNodeValue& a,
-                                    const SpatialAreaValue& b,
+                                    size_t areaIndex,
                                     GeomRelationInfo* geomRelInf,
                                     GeomRelationStats* stats) const {
+  const auto b = areaView(areaIndex);
   const auto& geomA = std::get<1>(a);
-  int32_t ndBoxId = getBoxId(geomA);
 
-  const auto& geomB = std::get<2>(b);
-  const auto& innerGeomB = std::get<6>(b);
-  const auto& outerGeomB = std::get<7>(b);
-  const auto& areaBoxIds = std::get<8>(b);
-  const auto& areaCutouts = std::get<9>(b);
-  const auto& areaObb = std::get<11>(b);
+  const auto& geomB = b.geometry->geom;
+  const auto& innerGeomB = b.geometry->inner;
+  const auto& outerGeomB = b.geometry->outer;
+  const auto& areaBoxIds = b.boxIds;
+  const auto& areaCutouts = b.geometry->cutouts;
+  const auto& areaObb = *b.obb;
 
   if (!boost::geometry::intersects(geomA, areaObb)) {
     // not in oriented bounding box
@@ -1534,8 +1714,10 @@ bool GeometryHandler<W>::nodeInArea(const SpatialNodeValue& a,
     return false;
   }
 
-  if (geomRelInf->fullContained < 0)
-    boxIdIsect({{1, 0}, {ndBoxId, 0}}, areaBoxIds, geomRelInf);
+  if (geomRelInf->fullContained < 0) {
+    const BoxIdList nodeBoxIds{{1, 0}, {getBoxId(geomA), 0}};
+    boxIdIsect(nodeBoxIds, areaBoxIds, geomRelInf);
+  }
 
   if (geomRelInf->fullContained > 0) {
     geomRelInf->intersects = RelInfoValue::YES;
@@ -1572,7 +1754,7 @@ bool GeometryHandler<W>::nodeInArea(const SpatialNodeValue& a,
   if (_config.dontUseInnerOuterGeoms || boost::geometry::is_empty(innerGeomB) ||
       boost::geometry::is_empty(outerGeomB)) {
       ad_utility::Timer t{ad_utility::timer::Timer::InitialStatus::Started};
-      bool result = boost::geometry::covered_by(geomA, geomB);
+      bool result = nodeCoveredBy(geomA, areaIndex);
       stats->fullCheck(geomA, geomB,result, t.secs());
     if (result) {
       geomRelInf->intersects = RelInfoValue::YES;
@@ -1611,33 +1793,67 @@ bool GeometryHandler<W>::nodeInArea(const SpatialNodeValue& a,
   }
 
   ad_utility::Timer t{ad_utility::timer::Timer::InitialStatus::Started};
-  auto result = boost::geometry::covered_by(geomA, geomB);
+  auto result = nodeCoveredBy(geomA, areaIndex);
   stats->fullCheck(geomA, geomB, result, t.secs());
   return result;
 }
 
 // ____________________________________________________________________________
 template <typename W>
-bool GeometryHandler<W>::areaIntersectsArea(const SpatialAreaValue& a,
-                                            const SpatialAreaValue& b,
+const PreparedArea* GeometryHandler<W>::preparedArea(size_t areaIndex) const {
+  const auto& geom = areaView(areaIndex).geometry->geom;
+  if (_preparedAreas == nullptr ||
+      boost::geometry::num_points(geom) < PREPARED_AREA_MIN_POINTS) {
+    return nullptr;
+  }
+  const PreparedArea* prepared =
+      _preparedAreas[areaIndex].load(std::memory_order_acquire);
+  if (prepared != nullptr) {
+    return prepared;
+  }
+  // Threads may build the same area concurrently, only one result is kept.
+  auto built = std::make_unique<PreparedArea>(geom);
+  if (_preparedAreas[areaIndex].compare_exchange_strong(
+          prepared, built.get(), std::memory_order_acq_rel)) {
+    prepared = built.release();
+  }
+  return prepared;
+}
+
+// ____________________________________________________________________________
+template <typename W>
+bool GeometryHandler<W>::nodeCoveredBy(const osm2rdf::geometry::Node& node,
+                                       size_t areaIndex) const {
+  const auto* prepared = preparedArea(areaIndex);
+  if (prepared != nullptr) {
+    return prepared->covers(node);
+  }
+  return boost::geometry::covered_by(node,
+                                     areaView(areaIndex).geometry->geom);
+}
+
+// ____________________________________________________________________________
+template <typename W>
+bool GeometryHandler<W>::areaIntersectsArea(const SpatialAreaView& a,
+                                            const SpatialAreaView& b,
                                             GeomRelationInfo* geomRelInf,
                                             GeomRelationStats* stats) const {
   if (geomRelInf->intersects == RelInfoValue::YES) {
     return true;
   }
 
-  const auto& geomA = std::get<2>(a);
-  const auto& geomB = std::get<2>(b);
-  const auto& innerGeomA = std::get<6>(a);
-  const auto& outerGeomA = std::get<7>(a);
-  const auto& innerGeomB = std::get<6>(b);
-  const auto& outerGeomB = std::get<7>(b);
-  const auto& boxIdsA = std::get<8>(a);
-  const auto& boxIdsB = std::get<8>(b);
-  const auto& cutoutsA = std::get<9>(a);
-  const auto& cutoutsB = std::get<9>(b);
-  const auto& obbA = std::get<11>(a);
-  const auto& obbB = std::get<11>(b);
+  const auto& geomA = a.geometry->geom;
+  const auto& geomB = b.geometry->geom;
+  const auto& innerGeomA = a.geometry->inner;
+  const auto& outerGeomA = a.geometry->outer;
+  const auto& innerGeomB = b.geometry->inner;
+  const auto& outerGeomB = b.geometry->outer;
+  const auto& boxIdsA = a.boxIds;
+  const auto& boxIdsB = b.boxIds;
+  const auto& cutoutsA = a.geometry->cutouts;
+  const auto& cutoutsB = b.geometry->cutouts;
+  const auto& obbA = *a.obb;
+  const auto& obbB = *b.obb;
 
   if (!boost::geometry::intersects(obbA, obbB)) {
     // ... oriented bounding boxes do no intersect
@@ -1646,7 +1862,16 @@ bool GeometryHandler<W>::areaIntersectsArea(const SpatialAreaValue& a,
     return false;
   }
 
-  // if no geometric relation has been written so far, do it now
+  // if no geometric relation has been written so far, a single full contained
+  // box is enough to know that we intersect, without collecting the rest
+  if (geomRelInf->fullContained < 0 &&
+      BoxIdIntersect::anyFull(boxIdsA, boxIdsB)) {
+    geomRelInf->intersects = RelInfoValue::YES;
+    stats->skippedByBoxIdIntersect();
+    return true;
+  }
+
+  // otherwise, intersect the box ids now
   if (geomRelInf->fullContained < 0) boxIdIsect(boxIdsA, boxIdsB, geomRelInf);
 
   // if there is at least one full contained box, we surely intersect
@@ -1741,7 +1966,7 @@ bool GeometryHandler<W>::areaIntersectsArea(const SpatialAreaValue& a,
 // ____________________________________________________________________________
 template <typename W>
 bool GeometryHandler<W>::wayIntersectsArea(const SpatialWayValue& a,
-                                           const SpatialAreaValue& b,
+                                           const SpatialAreaView& b,
                                            GeomRelationInfo* geomRelInf,
                                            GeomRelationStats* stats) const {
   // shortcut
@@ -1753,14 +1978,14 @@ bool GeometryHandler<W>::wayIntersectsArea(const SpatialWayValue& a,
   const auto& wayBoxIds = std::get<5>(a);
   const auto& wayOBB = std::get<7>(a);
 
-  const auto& geomB = std::get<2>(b);
-  const auto& envelopesB = std::get<0>(b);
-  const auto& innerGeomB = std::get<6>(b);
-  const auto& outerGeomB = std::get<7>(b);
-  const auto& areaBoxIds = std::get<8>(b);
-  const auto& areaCutouts = std::get<9>(b);
-  // const auto& areaConvexHull = std::get<10>(b);
-  const auto& areaOBB = std::get<11>(b);
+  const auto& geomB = b.geometry->geom;
+  const auto& envelopesB = b.envelopes;
+  const auto& innerGeomB = b.geometry->inner;
+  const auto& outerGeomB = b.geometry->outer;
+  const auto& areaBoxIds = b.boxIds;
+  const auto& areaCutouts = b.geometry->cutouts;
+  // const auto& areaConvexHull = b.geometry->convexHull;
+  const auto& areaOBB = *b.obb;
 
   if (!boost::geometry::intersects(wayOBB, areaOBB)) {
     // ... does not intersect with oriented bounding box
@@ -1897,7 +2122,7 @@ bool GeometryHandler<W>::wayIntersectsArea(const SpatialWayValue& a,
 // ____________________________________________________________________________
 template <typename W>
 bool GeometryHandler<W>::wayInArea(const SpatialWayValue& a,
-                                   const SpatialAreaValue& b,
+                                   const SpatialAreaView& b,
                                    GeomRelationInfo* geomRelInf,
                                    GeomRelationStats* stats) const {
   // shortcut
@@ -1908,16 +2133,16 @@ bool GeometryHandler<W>::wayInArea(const SpatialWayValue& a,
   const auto& geomA = std::get<2>(a);
   const auto& envelopeA = std::get<0>(a);
   const auto& wayBoxIds = std::get<5>(a);
-  const auto& obbA = std::get<7>(b);
+  const auto& obbA = std::get<7>(a);
 
-  const auto& geomB = std::get<2>(b);
-  const auto& innerGeomB = std::get<6>(b);
-  const auto& outerGeomB = std::get<7>(b);
-  const auto& envelopesB = std::get<0>(b);
-  const auto& areaBoxIds = std::get<8>(b);
-  const auto& areaCutouts = std::get<9>(b);
-  // const auto& areaConvexHull = std::get<10>(b);
-  const auto& obbB = std::get<11>(b);
+  const auto& geomB = b.geometry->geom;
+  const auto& innerGeomB = b.geometry->inner;
+  const auto& outerGeomB = b.geometry->outer;
+  const auto& envelopesB = b.envelopes;
+  const auto& areaBoxIds = b.boxIds;
+  const auto& areaCutouts = b.geometry->cutouts;
+  // const auto& areaConvexHull = b.geometry->convexHull;
+  const auto& obbB = *b.obb;
 
   if (geomRelInf->intersects == RelInfoValue::NO) {
     geomRelInf->contained = RelInfoValue::NO;
@@ -2063,21 +2288,21 @@ bool GeometryHandler<W>::wayInArea(const SpatialWayValue& a,
 
 // ____________________________________________________________________________
 template <typename W>
-bool GeometryHandler<W>::areaInAreaApprox(const SpatialAreaValue& a,
-                                          const SpatialAreaValue& b,
+bool GeometryHandler<W>::areaInAreaApprox(const SpatialAreaView& a,
+                                          const SpatialAreaView& b,
                                           GeomRelationInfo* geomRelInf,
                                           GeomRelationStats* stats) const {
-  const auto& entryArea = std::get<4>(a);
-  const auto& entryBoxIds = std::get<8>(a);
-  const auto& areaArea = std::get<4>(b);
-  const auto& areaBoxIds = std::get<8>(b);
-  const auto& entryEnvelopes = std::get<0>(a);
-  const auto& entryConvexHull = std::get<10>(a);
-  const auto& areaEnvelopes = std::get<0>(b);
-  const auto& areaCutouts = std::get<9>(b);
-  const auto& entryGeom = std::get<2>(a);
-  const auto& areaGeom = std::get<2>(b);
-  const auto& areaConvexHull = std::get<10>(b);
+  const auto& entryArea = a.area;
+  const auto& entryBoxIds = a.boxIds;
+  const auto& areaArea = b.area;
+  const auto& areaBoxIds = b.boxIds;
+  const auto& entryEnvelopes = a.envelopes;
+  const auto& entryConvexHull = a.geometry->convexHull;
+  const auto& areaEnvelopes = b.envelopes;
+  const auto& areaCutouts = b.geometry->cutouts;
+  const auto& entryGeom = a.geometry->geom;
+  const auto& areaGeom = b.geometry->geom;
+  const auto& areaConvexHull = b.geometry->convexHull;
 
   if (areaArea / entryArea <= 0.95) {
     stats->skippedByAreaSize();
@@ -2152,8 +2377,8 @@ bool GeometryHandler<W>::areaInAreaApprox(const SpatialAreaValue& a,
 
 // ____________________________________________________________________________
 template <typename W>
-bool GeometryHandler<W>::areaInArea(const SpatialAreaValue& a,
-                                    const SpatialAreaValue& b,
+bool GeometryHandler<W>::areaInArea(const SpatialAreaView& a,
+                                    const SpatialAreaView& b,
                                     GeomRelationInfo* geomRelInf,
                                     GeomRelationStats* stats) const {
   // if we don't intersect, we are not contained
@@ -2163,22 +2388,22 @@ bool GeometryHandler<W>::areaInArea(const SpatialAreaValue& a,
     return false;
   }
 
-  const auto& geomA = std::get<2>(a);
-  const auto& areaA = std::get<4>(a);
-  const auto& innerGeomA = std::get<6>(a);
-  const auto& outerGeomA = std::get<7>(a);
-  const auto& boxIdsA = std::get<8>(a);
-  const auto& envelopesA = std::get<0>(a);
-
-  const auto& geomB = std::get<2>(b);
-  const auto& areaB = std::get<4>(b);
-  const auto& innerGeomB = std::get<6>(b);
-  const auto& outerGeomB = std::get<7>(b);
-  const auto& boxIdsB = std::get<8>(b);
-  const auto& envelopesB = std::get<0>(b);
-  const auto& cutoutsB = std::get<9>(b);
-
-  const auto& obbB = std::get<11>(b);
+  const auto& geomA = a.geometry->geom;
+  const auto& areaA = a.area;
+  const auto& innerGeomA = a.geometry->inner;
+  const auto& outerGeomA = a.geometry->outer;
+  const auto& boxIdsA = a.boxIds;
+  const auto& envelopesA = a.envelopes;
+
+  const auto& geomB = b.geometry->geom;
+  const auto& areaB = b.area;
+  const auto& innerGeomB = b.geometry->inner;
+  const auto& outerGeomB = b.geometry->outer;
+  const auto& boxIdsB = b.boxIds;
+  const auto& envelopesB = b.envelopes;
+  const auto& cutoutsB = b.geometry->cutouts;
+
+  const auto& obbB = *b.obb;
 
   // if A is bigger than B, B cannot contain A
   if (areaA > areaB) {
@@ -2300,39 +2525,71 @@ int GeometryHandler<W>::polygonOrientation(
 
 // ____________________________________________________________________________
 template <typename W>
-BoxIdList GeometryHandler<W>::getBoxIds(
-    const osm2rdf::geometry::Way& way,
-    const osm2rdf::geometry::Box& envelope) const {
-  int32_t startX =
-      std::floor((envelope.min_corner().get<0>() + 180.0) / GRID_W);
-  int32_t startY = std::floor((envelope.min_corner().get<1>() + 90.0) / GRID_H);
+int32_t GeometryHandler<W>::gridCell(double coordinate, double offset,
+                                     double cellSize) const {
+  const auto cell =
+      static_cast<int32_t>(std::floor((coordinate + offset) / cellSize));
+  return std::clamp(cell, 0, _gridCells - 1);
+}
 
-  int32_t endX =
-      std::floor((envelope.max_corner().get<0>() + 180.0) / GRID_W) + 1;
-  int32_t endY =
-      std::floor((envelope.max_corner().get<1>() + 90.0) / GRID_H) + 1;
+// ____________________________________________________________________________
+template <typename W>
+int32_t GeometryHandler<W>::cellId(int32_t x, int32_t y) const {
+  const uint32_t shift = 32 - _config.boxIdGridLevels;
+  return static_cast<int32_t>(
+             osm2rdf::util::hilbertIndex(static_cast<uint32_t>(x) << shift,
+                                         static_cast<uint32_t>(y) << shift) >>
+             (2 * shift)) +
+         1;
+}
 
-  BoxIdList boxIds;
+// ____________________________________________________________________________
+template <typename W>
+osm2rdf::geometry::Box GeometryHandler<W>::cellBox(int32_t x, int32_t y,
+                                                   int32_t size) const {
+  // Boxes reach into the next cell, such that points on the border are
+  // covered.
+  osm2rdf::geometry::Box box;
+  box.min_corner().set<0>(x * _gridW - 180.0);
+  box.min_corner().set<1>(y * _gridH - 90.0);
+  box.max_corner().set<0>((x + size + 1) * _gridW - 180.0);
+  box.max_corner().set<1>((y + size + 1) * _gridH - 90.0);
+  return box;
+}
 
+// ____________________________________________________________________________
+template <typename W>
+BoxIdList GeometryHandler<W>::getBoxIds(
+    const osm2rdf::geometry::Way& way,
+    const osm2rdf::geometry::Box& envelope) const {
+  const int32_t startX =
+      gridCell(envelope.min_corner().get<0>(), 180.0, _gridW);
+  const int32_t startY = gridCell(envelope.min_corner().get<1>(), 90.0, _gridH);
+  const int32_t endX =
+      gridCell(envelope.max_corner().get<0>(), 180.0, _gridW) + 1;
+  const int32_t endY =
+      gridCell(envelope.max_corner().get<1>(), 90.0, _gridH) + 1;
+
+  std::vector<int32_t> ids;
   for (int32_t y = startY; y < endY; y++) {
     for (int32_t x = startX; x < endX; x++) {
-      osm2rdf::geometry::Box box;
-      box.min_corner().set<0>(x * GRID_W - 180.0);
-      box.min_corner().set<1>(y * GRID_H - 90.0);
-      box.max_corner().set<0>((x + 1) * GRID_W - 180.0);
-      box.max_corner().set<1>((y + 1) * GRID_H - 90.0);
-
-      if (boost::geometry::intersects(way, box)) {
-        int32_t newId = y * NUM_GRID_CELLS + x + 1;
-        if (!boxIds.empty() && boxIds.back().second < 254 &&
-            boxIds.back().first + boxIds.back().second == newId - 1) {
-          boxIds.back().second++;
-        } else {
-          boxIds.push_back({newId, 0});
-        }
+      if (boost::geometry::intersects(way, cellBox(x, y, 0))) {
+        ids.push_back(cellId(x, y));
       }
     }
   }
+  std::sort(ids.begin(), ids.end());
+
+  BoxIdList boxIds;
+  for (const auto id : ids) {
+    if (!boxIds.empty() &&
+        boxIds.back().first + static_cast<int32_t>(boxIds.back().second) ==
+            id - 1) {
+      boxIds.back().second++;
+    } else {
+      boxIds.push_back({id, 0});
+    }
+  }
 
   return boxIds;
 }
@@ -2342,99 +2599,82 @@ template <typename W>
 void GeometryHandler<W>::getBoxIds(
     const osm2rdf::geometry::Area& area, const osm2rdf::geometry::Area& inner,
     const osm2rdf::geometry::Area& outer,
-    const std::vector<osm2rdf::geometry::Box>& envelopes, int xFrom, int xTo,
-    int yFrom, int yTo, int xWidth, int yHeight, BoxIdList* ret,
-    const osm2rdf::geometry::Area& curIsect,
+    const std::vector<osm2rdf::geometry::Box>& envelopes, int32_t x, int32_t y,
+    int32_t size, BoxIdList* ret, const osm2rdf::geometry::Area& curIsect,
     std::unordered_map<int32_t, osm2rdf::geometry::Area>* cutouts) const {
-  for (int32_t y = yFrom; y < yTo; y += yHeight) {
-    for (int32_t x = xFrom; x < xTo; x += xWidth) {
-      int localXWidth = std::min(xTo - x, xWidth);
-      int localYHeight = std::min(yTo - y, yHeight);
+  const osm2rdf::geometry::Box box = cellBox(x, y, size);
 
-      osm2rdf::geometry::Box box;
-      box.min_corner().set<0>(x * GRID_W - 180.0);
-      box.min_corner().set<1>(y * GRID_H - 90.0);
-      box.max_corner().set<0>((x + localXWidth + 1) * GRID_W - 180.0);
-      box.max_corner().set<1>((y + localYHeight + 1) * GRID_H - 90.0);
-
-      bool boxIntersects = false;
-      for (size_t i = 1; i < envelopes.size(); i++) {
-        if (boost::geometry::intersects(envelopes[i], box)) {
-          boxIntersects = true;
-        }
-      }
+  bool boxIntersects = false;
+  for (size_t i = 1; i < envelopes.size(); i++) {
+    if (boost::geometry::intersects(envelopes[i], box)) {
+      boxIntersects = true;
+    }
+  }
 
-      if (!boxIntersects) {
-        continue;
-      }
+  if (!boxIntersects) {
+    return;
+  }
 
-      boost::geometry::model::ring<osm2rdf::geometry::Location> ring;
-      ring.push_back(box.min_corner());
-      ring.push_back({box.min_corner().get<0>(), box.max_corner().get<1>()});
-      ring.push_back(box.max_corner());
-      ring.push_back({box.max_corner().get<0>(), box.min_corner().get<1>()});
-      ring.push_back(box.min_corner());
-      osm2rdf::geometry::Polygon bboxPoly;
-      bboxPoly.outer() = ring;
-
-      bool outerIsects = boost::geometry::is_empty(outer) ||
-                         boost::geometry::intersects(outer, box);
-      bool innerIsects = outerIsects && !boost::geometry::is_empty(inner) &&
-                         boost::geometry::intersects(inner, box);
-
-      if (outerIsects &&
-          (innerIsects || boost::geometry::intersects(area, box))) {
-        bool outerConted = boost::geometry::is_empty(outer) ||
-                           boost::geometry::covered_by(bboxPoly, outer);
-        bool innerConted = outerConted && !boost::geometry::is_empty(inner) &&
-                           boost::geometry::covered_by(bboxPoly, inner);
-
-        if (outerConted &&
-            (innerConted || boost::geometry::covered_by(bboxPoly, area))) {
-          // we can insert all at once
-          for (int32_t ly = y; ly < y + localYHeight; ly++) {
-            int a = 1;
-            int start = ly * NUM_GRID_CELLS + x;
-            while (a <= (localXWidth + ((255 + 1) - 1)) / (255 + 1)) {
-              int r = std::min(
-                  255, start + localXWidth - (start + (a - 1) * (255 + 1)) - 1);
-              ret->push_back({start + (a - 1) * (255 + 1) + 1, r});
-              a++;
-            }
-          }
-        } else {
-          // compute cutout if requested
-          osm2rdf::geometry::Area intersection;
-          if (cutouts) {
-            boost::geometry::intersection(bboxPoly, curIsect, intersection);
-          }
+  boost::geometry::model::ring<osm2rdf::geometry::Location> ring;
+  ring.push_back(box.min_corner());
+  ring.push_back({box.min_corner().get<0>(), box.max_corner().get<1>()});
+  ring.push_back(box.max_corner());
+  ring.push_back({box.max_corner().get<0>(), box.min_corner().get<1>()});
+  ring.push_back(box.min_corner());
+  osm2rdf::geometry::Polygon bboxPoly;
+  bboxPoly.outer() = ring;
 
-          if (localXWidth == 1 && localYHeight == 1) {
-            // only intersecting
-            int32_t newId = -(y * NUM_GRID_CELLS + x + 1);
+  // The clip of the parent cell covers this cell, so it can replace the
+  // full area in the exact checks.
+  const osm2rdf::geometry::Area& local = cutouts ? curIsect : area;
 
-            if (cutouts) {
-              (*cutouts)[-newId] = intersection;
-            }
+  bool outerIsects = boost::geometry::is_empty(outer) ||
+                     boost::geometry::intersects(outer, box);
+  bool innerIsects = outerIsects && !boost::geometry::is_empty(inner) &&
+                     boost::geometry::intersects(inner, box);
 
-            if (!ret->empty() && ret->back().second < 254 &&
-                ret->back().first - ret->back().second == newId + 1) {
-              ret->back().second++;
-            } else {
-              ret->push_back({newId, 0});
-            }
-          } else {
-            // we need to check in detail on a smaller level!
-            // recurse down...
-            int newXWidth = (localXWidth + 1) / 2;
-            int newYHeight = (localYHeight + 1) / 2;
-
-            getBoxIds(area, inner, outer, envelopes, x, x + localXWidth, y,
-                      y + localYHeight, newXWidth, newYHeight, ret,
-                      intersection, cutouts);
-          }
-        }
-      }
+  if (!outerIsects ||
+      !(innerIsects || boost::geometry::intersects(local, box))) {
+    return;
+  }
+
+  bool outerConted = boost::geometry::is_empty(outer) ||
+                     boost::geometry::covered_by(bboxPoly, outer);
+  bool innerConted = outerConted && !boost::geometry::is_empty(inner) &&
+                     boost::geometry::covered_by(bboxPoly, inner);
+
+  if (outerConted &&
+      (innerConted || boost::geometry::covered_by(bboxPoly, local))) {
+    // The cell is a quadtree node, its leaves form a single run of ids.
+    const int32_t numLeaves = size * size;
+    const int32_t first = (cellId(x, y) - 1) / numLeaves * numLeaves + 1;
+    ret->push_back({first, numLeaves - 1});
+    return;
+  }
+
+  // compute cutout if requested
+  osm2rdf::geometry::Area intersection;
+  if (cutouts) {
+    intersection = osm2rdf::geometry::BoxClipper{box}.clip(curIsect);
+  }
+
+  if (size == 1) {
+    // only intersecting
+    const int32_t newId = cellId(x, y);
+    if (cutouts) {
+      (*cutouts)[newId] = std::move(intersection);
+    }
+    ret->push_back({-newId, 0});
+    return;
+  }
+
+  // we need to check in detail on a smaller level!
+  // recurse down...
+  const int32_t half = size / 2;
+  for (int32_t dy = 0; dy < size; dy += half) {
+    for (int32_t dx = 0; dx < size; dx += half) {
+      getBoxIds(area, inner, outer, envelopes, x + dx, y + dy, half, ret,
+                intersection, cutouts);
     }
   }
 }
@@ -2446,24 +2686,54 @@ BoxIdList GeometryHandler<W>::getBoxIds(
     const std::vector<osm2rdf::geometry::Box>& envelopes,
     const osm2rdf::geometry::Area& inner, const osm2rdf::geometry::Area& outer,
     std::unordered_map<int32_t, osm2rdf::geometry::Area>* cutouts) const {
-  size_t totNumPoints = 0;
-  for (const auto& p : area) totNumPoints += p.outer().size();
-
-  int32_t startX =
-      std::floor((envelopes[0].min_corner().get<0>() + 180.0) / GRID_W);
-  int32_t startY =
-      std::floor((envelopes[0].min_corner().get<1>() + 90.0) / GRID_H);
-
-  int32_t endX =
-      std::floor((envelopes[0].max_corner().get<0>() + 180.0) / GRID_W) + 1;
-  int32_t endY =
-      std::floor((envelopes[0].max_corner().get<1>() + 90.0) / GRID_H) + 1;
+  const int32_t startX =
+      gridCell(envelopes[0].min_corner().get<0>(), 180.0, _gridW);
+  const int32_t startY =
+      gridCell(envelopes[0].min_corner().get<1>(), 90.0, _gridH);
+  const int32_t endX =
+      gridCell(envelopes[0].max_corner().get<0>(), 180.0, _gridW) + 1;
+  const int32_t endY =
+      gridCell(envelopes[0].max_corner().get<1>(), 90.0, _gridH) + 1;
+
+  // Start with quadtree nodes of which about 4 x 4 cover the envelope, fully
+  // covered nodes are kept as a whole, partially covered ones are split
+  // down to single grid cells.
+  int32_t size = 1;
+  while (size * 4 < std::max(endX - startX, endY - startY)) {
+    size *= 2;
+  }
+  std::vector<std::pair<int32_t, int32_t>> cells;
+  for (int32_t y = startY - startY % size; y < endY; y += size) {
+    for (int32_t x = startX - startX % size; x < endX; x += size) {
+      cells.emplace_back(x, y);
+    }
+  }
 
   BoxIdList boxIds;
-
-  getBoxIds(area, inner, outer, envelopes, startX, endX, startY, endY,
-            (endX - startX + 3) / 4, (endY - startY + 3) / 4, &boxIds, area,
-            cutouts);
+  if (cutouts == nullptr) {
+    for (const auto& [x, y] : cells) {
+      getBoxIds(area, inner, outer, envelopes, x, y, size, &boxIds, area,
+                cutouts);
+    }
+  } else {
+    // Areas with cutouts are large, compute the top level cells in parallel.
+    std::vector<BoxIdList> cellBoxIds(cells.size());
+    std::vector<std::unordered_map<int32_t, osm2rdf::geometry::Area>>
+        cellCutouts(cells.size());
+#if defined(_OPENMP)
+#pragma omp taskloop grainsize(1) default(none)                       \
+    shared(area, inner, outer, envelopes, cells, cellBoxIds, cellCutouts) \
+    firstprivate(size)
+#endif
+    for (size_t i = 0; i < cells.size(); i++) {
+      getBoxIds(area, inner, outer, envelopes, cells[i].first, cells[i].second,
+                size, &cellBoxIds[i], area, &cellCutouts[i]);
+    }
+    for (size_t i = 0; i < cells.size(); i++) {
+      boxIds.insert(boxIds.end(), cellBoxIds[i].begin(), cellBoxIds[i].end());
+      cutouts->merge(cellCutouts[i]);
+    }
+  }
   std::sort(boxIds.begin(), boxIds.end(), BoxIdCmp());
 
   return boxIds;
@@ -2473,10 +2743,28 @@ BoxIdList GeometryHandler<W>::getBoxIds(
 template <typename W>
 int32_t GeometryHandler<W>::getBoxId(
     const osm2rdf::geometry::Location& p) const {
-  int32_t x = floor((p.get<0>() + 180.0) / GRID_W);
-  int32_t y = floor((p.get<1>() + 90.0) / GRID_H);
+  return cellId(gridCell(p.get<0>(), 180.0, _gridW),
+                gridCell(p.get<1>(), 90.0, _gridH));
+}
 
-  return y * NUM_GRID_CELLS + x + 1;
+// ____________________________________________________________________________
+template <typename W>
+int8_t GeometryHandler<W>::boxIdCover(int32_t boxId,
+                                      BoxIdSpan boxIds) const {
+  // The first entry holds the number of box ids.
+  if (boxIds.size() < 2) {
+    return 0;
+  }
+  auto it = std::lower_bound(boxIds.begin() + 1, boxIds.end(), boxId + 1,
+                             BoxIdCmp());
+  if (it == boxIds.begin() + 1) {
+    return 0;
+  }
+  --it;
+  if (abs(it->first) + static_cast<int32_t>(it->second) < boxId) {
+    return 0;
+  }
+  return it->first > 0 ? 1 : -1;
 }
 
 // ____________________________________________________________________________
@@ -2494,97 +2782,10 @@ std::string GeometryHandler<W>::areaNS(AreaFromType type) const {
 
 // ____________________________________________________________________________
 template <typename W>
-void GeometryHandler<W>::boxIdIsect(const BoxIdList& idsA,
-                                    const BoxIdList& idsB,
+void GeometryHandler<W>::boxIdIsect(BoxIdSpan idsA, BoxIdSpan idsB,
                                     GeomRelationInfo* geomRelInf) const {
-  geomRelInf->fullContained = 0;
-
-  // shortcuts
-  if (abs(idsA[1].first) > abs(idsB.back().first) + idsB.back().second) {
-    return;
-  }
-  if (abs(idsA.back().first) + idsA.back().second < idsB[1].first) {
-    return;
-  }
-
-  size_t i = 1;
-  int32_t ii = 0;
-  size_t j = 1;
-  int32_t jj = 0;
-
-  bool noContained = false;
-
-  while (i < idsA.size() && j < idsB.size()) {
-    if (abs(idsA[i].first) + ii == abs(idsB[j].first) + jj) {
-      if (idsB[j].first > 0) {
-        geomRelInf->fullContained++;
-
-        // we now know that we surely intersect. If we know already that
-        // we cannot be contained, return here
-        if (noContained) {
-          return;
-        }
-      }
-      if (idsB[j].first < 0) {
-        geomRelInf->toCheck.push_back(abs(idsA[i].first));
-      }
-
-      if (++ii > idsA[i].second) {
-        i++;
-        ii = 0;
-      }
-      if (++jj > idsB[j].second) {
-        j++;
-        jj = 0;
-      }
-    } else if (abs(idsA[i].first) + ii < abs(idsB[j].first) + jj) {
-      // if we already know that we intersect, we are now sure that we
-      // cannot be contained - it is irrelevant by how "much" we cannot be
-      // contained, so just return
-      if (geomRelInf->fullContained > 0) {
-        return;
-      }
-
-      // set noContained marker to true for later
-      noContained = true;
-
-      if (abs(idsA[i].first) + idsA[i].second < abs(idsB[j].first) + jj) {
-        // entire block smaller, jump it
-        ii = 0;
-        i++;
-      } else {
-        if (++ii > idsA[i].second) {
-          i++;
-          ii = 0;
-        }
-      }
-    } else {
-      size_t gallop = 1;
-      do {
-        auto end = idsB.end();
-        if (j + gallop < idsB.size()) {
-          end = idsB.begin() + j + gallop;
-        }
-
-        if (end == idsB.end() || abs(end->first) >= abs(idsA[i].first) + ii) {
-          jj = 0;
-          j = std::lower_bound(idsB.begin() + j + gallop / 2, end,
-                               abs(idsA[i].first) + ii, BoxIdCmp()) -
-              idsB.begin();
-          if (j > 0 && abs(idsB[j - 1].first) < abs(idsA[i].first) + ii &&
-              abs(idsB[j - 1].first) + idsB[j - 1].second >=
-                  abs(idsA[i].first) + ii) {
-            j--;
-            jj = (abs(idsA[i].first) + ii) - abs(idsB[j].first);
-          }
-          break;
-        }
-
-        gallop *= 2;
-
-      } while (true);
-    }
-  }
+  geomRelInf->fullContained =
+      BoxIdIntersect::isect(idsA, idsB, &geomRelInf->toCheck);
 }
 
 // ____________________________________________________________________________
@@ -2597,18 +2798,17 @@ BoxIdList GeometryHandler<W>::pack(const BoxIdList& ids) const {
 
   BoxIdList ret;
   // dummy value, will later hold number of entries
-  ret.push_back({ids.front().second + 1, 0});
+  ret.push_back({static_cast<int32_t>(ids.front().second) + 1, 0});
   ret.push_back(ids.front());
 
   for (size_t i = 1; i < ids.size(); i++) {
-    ret[0].first += ids[i].second + 1;
-    if (ret.back().second < 254 - ids[i].second && ids[i].first > 0 &&
-        ret.back().first > 0 &&
-        ret.back().first + ret.back().second == ids[i].first - 1) {
+    ret[0].first += static_cast<int32_t>(ids[i].second) + 1;
+    const auto last = static_cast<int32_t>(ret.back().second);
+    if (ids[i].first > 0 && ret.back().first > 0 &&
+        ret.back().first + last == ids[i].first - 1) {
       ret.back().second += 1 + ids[i].second;
-    } else if (ret.back().second < 254 - ids[i].second && ids[i].first < 0 &&
-               ret.back().first < 0 &&
-               ret.back().first - ret.back().second == ids[i].first + 1) {
+    } else if (ids[i].first < 0 && ret.back().first < 0 &&
+               ret.back().first - last == ids[i].first + 1) {
       ret.back().second += 1 + ids[i].second;
     } else {
       ret.push_back(ids[i]);
@@ -2620,94 +2820,147 @@ BoxIdList GeometryHandler<W>::pack(const BoxIdList& ids) const {
 
 // ____________________________________________________________________________
 template <typename W>
-std::vector<SpatialAreaRefValue> GeometryHandler<W>::indexQryCover(
-    const SpatialAreaValue& area) const {
-  std::vector<SpatialAreaRefValue> queryResult;
+const std::vector<SpatialAreaRefValue>& GeometryHandler<W>::indexQryCover(
+    const SpatialAreaView& area) const {
+  auto& buffer = queryBuffer();
 
-  const auto& envelopes = std::get<0>(area);
+  const auto& envelopes = area.envelopes;
 
   for (size_t i = 1; i < envelopes.size(); i++) {
-    _spatialIndex.query(boost::geometry::index::covers(envelopes[i]),
-                        std::back_inserter(queryResult));
+    spatialIndexCovers(envelopes[i], &buffer.refs);
   }
 
-  unique(queryResult);
+  buffer.unique();
 
-  return queryResult;
+  return buffer.refs;
 }
 
 // ____________________________________________________________________________
 template <typename W>
-std::vector<SpatialAreaRefValue> GeometryHandler<W>::indexQryIntersect(
-    const SpatialAreaValue& area) const {
-  std::vector<SpatialAreaRefValue> queryResult;
+const std::vector<SpatialAreaRefValue>& GeometryHandler<W>::indexQryIntersect(
+    const SpatialAreaView& area) const {
+  auto& buffer = queryBuffer();
 
-  const auto& envelopes = std::get<0>(area);
+  const auto& envelopes = area.envelopes;
 
   for (size_t i = 1; i < envelopes.size(); i++) {
-    _spatialIndex.query(boost::geometry::index::intersects(envelopes[i]),
-                        std::back_inserter(queryResult));
+    spatialIndexIntersects(envelopes[i], &buffer.refs);
   }
 
-  unique(queryResult);
+  buffer.unique();
 
-  return queryResult;
+  return buffer.refs;
 }
 
 // ____________________________________________________________________________
 template <typename W>
-std::vector<SpatialAreaRefValue> GeometryHandler<W>::indexQry(
-    const SpatialNodeValue& node) const {
-  std::vector<SpatialAreaRefValue> queryResult;
-
-  osm2rdf::geometry::Box nodeEnvelope;
-  boost::geometry::envelope(std::get<1>(node), nodeEnvelope);
-
-  _spatialIndex.query(boost::geometry::index::covers(nodeEnvelope),
-                      std::back_inserter(queryResult));
-
-  unique(queryResult);
+const std::vector<std::pair<SpatialAreaRefValue, int8_t>>&
+GeometryHandler<W>::indexQry(const osm2rdf::geometry::Box& envelope,
+                             int32_t boxId) const {
+  auto& buffer = queryBuffer();
+  spatialIndexIntersects(envelope, &buffer.refs);
+
+  buffer.unique();
+
+  for (const auto& areaRef : buffer.refs) {
+    const auto cover = boxIdCover(boxId, areaView(areaRef.second).boxIds);
+    if (cover != 0) {
+      buffer.covers.emplace_back(areaRef, cover);
+    }
+  }
+  return buffer.covers;
+}
 
-  return queryResult;
+// ____________________________________________________________________________
+template <typename W>
+const std::vector<std::pair<SpatialAreaRefValue, int8_t>>&
+GeometryHandler<W>::nodeGridQry(int32_t boxId) const {
+  auto& buffer = queryBuffer();
+  const uint32_t cellShift =
+      2 * (_config.boxIdGridLevels - _config.nodeGridLevels);
+  const uint64_t cell = static_cast<uint64_t>(boxId - 1) >> cellShift;
+
+  for (uint64_t i = _nodeGridOffsets[cell]; i < _nodeGridOffsets[cell + 1];
+       i++) {
+    const uint32_t entry = _nodeGridAreas[i];
+    const size_t areaIndex = entry & ~NODE_GRID_FULL;
+    const auto area = areaView(areaIndex);
+    // Only areas partially covering the node grid cell need a look at the
+    // box ids of the finer cell.
+    const int8_t cover =
+        (entry & NODE_GRID_FULL) ? 1 : boxIdCover(boxId, area.boxIds);
+    if (cover != 0) {
+      buffer.covers.emplace_back(
+          SpatialAreaRefValue{area.envelopes[0], areaIndex}, cover);
+    }
+  }
+  return buffer.covers;
 }
 
 // ____________________________________________________________________________
 template <typename W>
-std::vector<SpatialAreaRefValue> GeometryHandler<W>::indexQryIntersect(
+const std::vector<SpatialAreaRefValue>& GeometryHandler<W>::indexQryIntersect(
     const SpatialWayValue& way) const {
-  std::vector<SpatialAreaRefValue> queryResult;
+  auto& buffer = queryBuffer();
 
   const auto& envelopes = std::get<4>(way);
 
   for (size_t i = 0; i < envelopes.size(); i++) {
-    _spatialIndex.query(boost::geometry::index::intersects(envelopes[i]),
-                        std::back_inserter(queryResult));
+    spatialIndexIntersects(envelopes[i], &buffer.refs);
   }
 
-  unique(queryResult);
+  buffer.unique();
+
+  return buffer.refs;
+}
+
+// ____________________________________________________________________________
+template <typename W>
+SpatialAreaView GeometryHandler<W>::areaView(size_t areaIndex) const {
+  return SpatialAreaView{_spatialStorageArea[areaIndex],
+                         _spatialStorageAreaEnvelopes.data(),
+                         _spatialStorageAreaBoxIds.data(),
+                         _spatialStorageAreaGeometry.data()};
+}
+
+// ____________________________________________________________________________
+template <typename W>
+SpatialQueryBuffer& GeometryHandler<W>::queryBuffer() const {
+  auto& buffer = _queryBuffers[omp_get_thread_num()];
+  buffer.clear(_spatialStorageArea.size());
+  return buffer;
+}
 
-  return queryResult;
+// ____________________________________________________________________________
+template <typename W>
+void GeometryHandler<W>::spatialIndexCovers(
+    const osm2rdf::geometry::Box& box,
+    std::vector<SpatialAreaRefValue>* result) const {
+#if defined(ENABLE_FLAT_AREA_INDEX)
+  _spatialIndex.queryCovers(
+      box, [result](const osm2rdf::geometry::Box& envelope, size_t i) {
+        result->emplace_back(envelope, i);
+      });
+#else
+  _spatialIndex.query(boost::geometry::index::covers(box),
+                      std::back_inserter(*result));
+#endif
 }
 
 // ____________________________________________________________________________
 template <typename W>
-void GeometryHandler<W>::unique(std::vector<SpatialAreaRefValue>& refs) const {
-  // remove duplicates, may occur since we used multiple envelope queries
-  // to build the result!
-  std::sort(refs.begin(), refs.end(),
-            [](const auto& a, const auto& b) { return a.second < b.second; });
-  auto last = std::unique(
-      refs.begin(), refs.end(),
-      [](const auto& a, const auto& b) { return a.second == b.second; });
-
-  // duplicates were swapped to the end of vector, beginning at last
-  refs.erase(last, refs.end());
-
-  // small -> big
-  std::sort(refs.begin(), refs.end(), [this](const auto& a, const auto& b) {
-    return std::get<4>(_spatialStorageArea[a.second]) <
-           std::get<4>(_spatialStorageArea[b.second]);
-  });
+void GeometryHandler<W>::spatialIndexIntersects(
+    const osm2rdf::geometry::Box& box,
+    std::vector<SpatialAreaRefValue>* result) const {
+#if defined(ENABLE_FLAT_AREA_INDEX)
+  _spatialIndex.queryIntersects(
+      box, [result](const osm2rdf::geometry::Box& envelope, size_t i) {
+        result->emplace_back(envelope, i);
+      });
+#else
+  _spatialIndex.query(boost::geometry::index::intersects(box),
+                      std::back_inserter(*result));
+#endif
 }
 
 // ____________________________________________________________________________
@@ -2742,8 +2995,8 @@ void GeometryHandler<W>::writeTransitiveClosure(
   if (_config.writeGeomRelTransClosure) {
     for (const auto& succ : successors) {
       auto succIdx = _spatialStorageAreaIndex[succ];
-      const auto& succAreaId = std::get<3>(_spatialStorageArea[succIdx]);
-      const auto& succAreaFromType = std::get<5>(_spatialStorageArea[succIdx]);
+      const auto& succAreaId = _spatialStorageArea[succIdx].objId;
+      const auto& succAreaFromType = _spatialStorageArea[succIdx].fromType;
       const auto& succAreaIRI =
           _writer->generateIRI(areaNS(succAreaFromType), succAreaId);
 
@@ -2762,8 +3015,8 @@ void GeometryHandler<W>::writeTransitiveClosure(
   if (_config.writeGeomRelTransClosure) {
     for (const auto& succ : successors) {
       auto succIdx = _spatialStorageAreaIndex[succ];
-      const auto& succAreaId = std::get<3>(_spatialStorageArea[succIdx]);
-      const auto& succAreaFromType = std::get<5>(_spatialStorageArea[succIdx]);
+      const auto& succAreaId = _spatialStorageArea[succIdx].objId;
+      const auto& succAreaFromType = _spatialStorageArea[succIdx].fromType;
       const auto& succAreaIRI =
           _writer->generateIRI(areaNS(succAreaFromType), succAreaId);
 
@@ -28,7 +28,12 @@
 
 // ____________________________________________________________________________
 osm2rdf::osm::LocationHandler* osm2rdf::osm::LocationHandler::create(
-    const osm2rdf::config::Config& config) {
+    const osm2rdf::config::Config& config,
+    const osm2rdf::util::RankBitmap* neededNodes) {
+  if (config.storeNeededLocationsOnly && neededNodes != nullptr) {
+    return new osm2rdf::osm::LocationHandlerNeeded(config, *neededNodes);
+  }
+
   if (config.storeLocationsOnDisk == "sparse") {
     return new osm2rdf::osm::LocationHandlerFSSparse(config);
   }
@@ -37,9 +42,20 @@ osm2rdf::osm::LocationHandler* osm2rdf::osm::LocationHandler::create(
     return new osm2rdf::osm::LocationHandlerFSDense(config);
   }
 
+  if (config.storeLocationsOnDisk == "compressed") {
+    return new osm2rdf::osm::LocationHandlerCompressed(config);
+  }
+
   return new osm2rdf::osm::LocationHandlerRAM(config);
 }
 
+// ____________________________________________________________________________
+void osm2rdf::osm::LocationHandler::get_node_locations(
+    const uint64_t* ids, size_t count, osmium::Location* locations) const {
+  lookupSorted(ids, count, locations,
+               [this](uint64_t id) { return get_node_location(id); });
+}
+
 // ____________________________________________________________________________
 template <typename T>
 osmium::Location osm2rdf::osm::LocationHandlerImpl<T>::get_node_location(
@@ -47,6 +63,15 @@ osmium::Location osm2rdf::osm::LocationHandlerImpl<T>::get_node_location(
   return _handler.get_node_location(nodeId);
 }
 
+// ____________________________________________________________________________
+template <typename T>
+void osm2rdf::osm::LocationHandlerImpl<T>::get_node_locations(
+    const uint64_t* ids, size_t count, osmium::Location* locations) const {
+  lookupSorted(ids, count, locations, [this](uint64_t id) {
+    return _handler.get_node_location(id);
+  });
+}
+
 // ____________________________________________________________________________
 template <typename T>
 void osm2rdf::osm::LocationHandlerImpl<T>::node(const osmium::Node& node) {
@@ -85,6 +110,16 @@ osm2rdf::osm::LocationHandlerImpl<osmium::index::map::SparseFileArray<
   return _handler.get_node_location(nodeId);
 }
 
+// ____________________________________________________________________________
+void osm2rdf::osm::LocationHandlerImpl<osmium::index::map::SparseFileArray<
+    osmium::unsigned_object_id_type, osmium::Location>>::
+    get_node_locations(const uint64_t* ids, size_t count,
+                       osmium::Location* locations) const {
+  lookupSorted(ids, count, locations, [this](uint64_t id) {
+    return _handler.get_node_location(id);
+  });
+}
+
 // ____________________________________________________________________________
 void osm2rdf::osm::LocationHandlerImpl<osmium::index::map::SparseFileArray<
     osmium::unsigned_object_id_type,
@@ -109,6 +144,16 @@ osm2rdf::osm::LocationHandlerImpl<osmium::index::map::DenseFileArray<
   _handler.ignore_errors();
 }
 
+// ____________________________________________________________________________
+void osm2rdf::osm::LocationHandlerImpl<osmium::index::map::DenseFileArray<
+    osmium::unsigned_object_id_type, osmium::Location>>::
+    get_node_locations(const uint64_t* ids, size_t count,
+                       osmium::Location* locations) const {
+  lookupSorted(ids, count, locations, [this](uint64_t id) {
+    return _handler.get_node_location(id);
+  });
+}
+
 // ____________________________________________________________________________
 void osm2rdf::osm::LocationHandlerImpl<osmium::index::map::DenseFileArray<
     osmium::unsigned_object_id_type,
@@ -130,3 +175,117 @@ osm2rdf::osm::LocationHandlerImpl<osmium::index::map::DenseFileArray<
     get_node_location(const osmium::object_id_type nodeId) const {
   return _handler.get_node_location(nodeId);
 }
+
+// ____________________________________________________________________________
+void osm2rdf::osm::NeededNodes::relation(const osmium::Relation& relation) {
+  for (const auto& member : relation.members()) {
+    if (member.type() == osmium::item_type::node) {
+      _bitmap.set(member.positive_ref());
+    }
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::NeededNodes::way(const osmium::Way& way) {
+  for (const auto& nodeRef : way.nodes()) {
+    _bitmap.set(nodeRef.positive_ref());
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::NeededNodes::prepare_for_lookup() { _bitmap.prepareRank(); }
+
+// ____________________________________________________________________________
+const osm2rdf::util::RankBitmap& osm2rdf::osm::NeededNodes::bitmap()
+    const noexcept {
+  return _bitmap;
+}
+
+// ____________________________________________________________________________
+osm2rdf::osm::LocationHandlerNeeded::LocationHandlerNeeded(
+    const osm2rdf::config::Config& /*unused*/,
+    const osm2rdf::util::RankBitmap& neededNodes)
+    : _neededNodes(neededNodes), _locations(neededNodes.count()) {}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::LocationHandlerNeeded::node(const osmium::Node& node) {
+  const auto id = node.positive_id();
+  if (_neededNodes.test(id)) {
+    _locations[_neededNodes.rank(id)] = node.location();
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::LocationHandlerNeeded::way(osmium::Way& way) {
+  // Like osmium::handler::NodeLocationsForWays with ignore_errors()
+  for (auto& nodeRef : way.nodes()) {
+    nodeRef.set_location(get_node_location(nodeRef.positive_ref()));
+  }
+}
+
+// ____________________________________________________________________________
+osmium::Location osm2rdf::osm::LocationHandlerNeeded::get_node_location(
+    const osmium::object_id_type nodeId) const {
+  const auto id = static_cast<osmium::unsigned_object_id_type>(nodeId);
+  if (!_neededNodes.test(id)) {
+    return osmium::Location{};
+  }
+  return _locations[_neededNodes.rank(id)];
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::LocationHandlerNeeded::get_node_locations(
+    const uint64_t* ids, size_t count, osmium::Location* locations) const {
+  lookupSorted(ids, count, locations, [this](uint64_t id) {
+    return _neededNodes.test(id) ? _locations[_neededNodes.rank(id)]
+                                 : osmium::Location{};
+  });
+}
+
+// ____________________________________________________________________________
+osm2rdf::osm::LocationHandlerCompressed::LocationHandlerCompressed(
+    const osm2rdf::config::Config& config)
+    : _store(config.getTempPath("osmium", "n2l.compressed.cache")) {}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::LocationHandlerCompressed::node(const osmium::Node& node) {
+  _store.set(node.positive_id(), node.location());
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::LocationHandlerCompressed::way(osmium::Way& way) {
+  finalize();
+  for (auto& nodeRef : way.nodes()) {
+    nodeRef.set_location(get_node_location(nodeRef.positive_ref()));
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::LocationHandlerCompressed::relation(
+    const osmium::Relation& /*unused*/) {
+  // Relations are converted after the reading thread handled their buffer,
+  // their member lookups see the finalized store.
+  finalize();
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::LocationHandlerCompressed::finalize() {
+  if (!_finalized) {
+    _store.finalize();
+    _finalized = true;
+  }
+}
+
+// ____________________________________________________________________________
+osmium::Location osm2rdf::osm::LocationHandlerCompressed::get_node_location(
+    const osmium::object_id_type nodeId) const {
+  return _store.get(static_cast<uint64_t>(nodeId));
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::LocationHandlerCompressed::get_node_locations(
+    const uint64_t* ids, size_t count, osmium::Location* locations) const {
+  _store.prefetch(ids, count);
+  lookupSorted(ids, count, locations,
+               [this](uint64_t id) { return _store.get(id); });
+}
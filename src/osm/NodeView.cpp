@@ -0,0 +1,63 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/NodeView.h"
+
+#include "boost/geometry.hpp"
+#include "osm2rdf/geometry/Box.h"
+#include "osm2rdf/geometry/Location.h"
+#include "osm2rdf/geometry/Polygon.h"
+#include "osm2rdf/osm/Generic.h"
+#include "osmium/osm/node.hpp"
+
+// ____________________________________________________________________________
+osm2rdf::osm::NodeView::NodeView(const osmium::Node& node) : _node(&node) {}
+
+// ____________________________________________________________________________
+osm2rdf::osm::Node::id_t osm2rdf::osm::NodeView::id() const noexcept {
+  return _node->positive_id();
+}
+
+// ____________________________________________________________________________
+osm2rdf::geometry::Location osm2rdf::osm::NodeView::geom() const {
+  const auto& loc = _node->location();
+  return osm2rdf::geometry::Location(loc.lon(), loc.lat());
+}
+
+// ____________________________________________________________________________
+osm2rdf::geometry::Box osm2rdf::osm::NodeView::envelope() const {
+  osm2rdf::geometry::Box envelope;
+  boost::geometry::envelope(geom(), envelope);
+  return envelope;
+}
+
+// ____________________________________________________________________________
+const osmium::TagList& osm2rdf::osm::NodeView::tags() const noexcept {
+  return _node->tags();
+}
+
+// ____________________________________________________________________________
+osm2rdf::geometry::Polygon osm2rdf::osm::NodeView::convexHull() const {
+  return osm2rdf::osm::generic::boxToPolygon(envelope());
+}
+
+// ____________________________________________________________________________
+osm2rdf::geometry::Polygon osm2rdf::osm::NodeView::orientedBoundingBox()
+    const {
+  return convexHull();
+}
@@ -17,12 +17,17 @@
 // You should have received a copy of the GNU General Public License
 // along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <memory>
+
 #include "boost/version.hpp"
 #include "osm2rdf/osm/FactHandler.h"
 #include "osm2rdf/osm/GeometryHandler.h"
 #include "osm2rdf/osm/LocationHandler.h"
+#include "osm2rdf/osm/NodeView.h"
 #include "osm2rdf/osm/OsmiumHandler.h"
+#include "osm2rdf/osm/RelationCache.h"
 #include "osm2rdf/osm/RelationHandler.h"
+#include "osm2rdf/osm/WayView.h"
 #include "osm2rdf/util/Time.h"
 #include "osmium/area/assembler.hpp"
 #include "osmium/area/multipolygon_manager.hpp"
@@ -37,7 +42,8 @@ osm2rdf::osm::OsmiumHandler<W>::OsmiumHandler(
     : _config(config),
       _factHandler(osm2rdf::osm::FactHandler<W>(config, writer)),
       _geometryHandler(osm2rdf::osm::GeometryHandler<W>(config, writer)),
-      _relationHandler(osm2rdf::osm::RelationHandler(config)) {}
+      _relationHandler(osm2rdf::osm::RelationHandler(config)),
+      _tagFilter(config) {}
 
 // ____________________________________________________________________________
 template <typename W>
@@ -53,20 +59,70 @@ void osm2rdf::osm::OsmiumHandler<W>::handle() {
     // read relations for areas
     {
       std::cerr << std::endl;
-      osmium::io::Reader reader{input_file};
-      osmium::ProgressBar progress{reader.file_size(), osmium::isatty(2)};
-      std::cerr << osm2rdf::util::currentTimeFormatted()
-                << "OSM Pass 1 ... (Relations for areas"
+      osm2rdf::osm::RelationCache relationCache{_config};
+      if (_config.storeNeededLocationsOnly) {
+        // Ways are needed as well to collect their nodes, the relation cache
+        // can be filled but not used.
+        osmium::io::Reader reader{
+            input_file,
+            osmium::osm_entity_bits::way | osmium::osm_entity_bits::relation};
+        osmium::ProgressBar progress{reader.file_size(), osmium::isatty(2)};
+        std::cerr << osm2rdf::util::currentTimeFormatted()
+                  << "OSM Pass 1 ... (Relations for areas"
 #if BOOST_VERSION >= 107800
-                << ", Relation members"
+                  << ", Relation members"
 #endif  // BOOST_VERSION >= 107800
-                << ")"
-                << std::endl;
-      osmium::relations::read_relations(progress, input_file, mp_manager
+                  << ", Needed nodes)" << std::endl;
+        while (auto buf = reader.read()) {
+          progress.update(reader.offset());
+          osmium::apply(buf, mp_manager
+#if BOOST_VERSION >= 107800
+                        , _relationHandler
+#endif  // BOOST_VERSION >= 107800
+                        , relationCache, _neededNodes);
+        }
+        reader.close();
+        progress.done();
+        mp_manager.prepare_for_lookup();
+#if BOOST_VERSION >= 107800
+        _relationHandler.prepare_for_lookup();
+#endif  // BOOST_VERSION >= 107800
+        relationCache.prepare_for_lookup();
+        _neededNodes.prepare_for_lookup();
+        std::cerr << osm2rdf::util::currentTimeFormatted() << "Needed nodes: "
+                  << _neededNodes.bitmap().count() << " ("
+                  << _neededNodes.bitmap().memoryUsage() / (1024 * 1024)
+                  << " MB bitmap)" << std::endl;
+      } else if (relationCache.load()) {
+        std::cerr << osm2rdf::util::currentTimeFormatted()
+                  << "OSM Pass 1 ... (Relations from cache "
+                  << relationCache.path() << ")" << std::endl;
+        osmium::apply(relationCache.buffer(), mp_manager
+#if BOOST_VERSION >= 107800
+                      , _relationHandler
+#endif  // BOOST_VERSION >= 107800
+        );
+        mp_manager.prepare_for_lookup();
+#if BOOST_VERSION >= 107800
+        _relationHandler.prepare_for_lookup();
+#endif  // BOOST_VERSION >= 107800
+      } else {
+        osmium::io::Reader reader{input_file};
+        osmium::ProgressBar progress{reader.file_size(), osmium::isatty(2)};
+        std::cerr << osm2rdf::util::currentTimeFormatted()
+                  << "OSM Pass 1 ... (Relations for areas"
 #if BOOST_VERSION >= 107800
-                                        , _relationHandler
+                  << ", Relation members"
 #endif  // BOOST_VERSION >= 107800
-      );
+                  << ")"
+                  << std::endl;
+        osmium::relations::read_relations(progress, input_file, mp_manager
+#if BOOST_VERSION >= 107800
+                                          , _relationHandler
+#endif  // BOOST_VERSION >= 107800
+                                          , relationCache
+        );
+      }
       std::cerr << osm2rdf::util::currentTimeFormatted() << "... done"
                 << std::endl;
     }
@@ -79,9 +135,15 @@ void osm2rdf::osm::OsmiumHandler<W>::handle() {
       osmium::io::ReaderWithProgressBar reader{true, input_file,
                                                osmium::osm_entity_bits::object};
       osm2rdf::osm::LocationHandler* locationHandler =
-          osm2rdf::osm::LocationHandler::create(_config);
+          osm2rdf::osm::LocationHandler::create(_config,
+                                                &_neededNodes.bitmap());
       _relationHandler.setLocationHandler(locationHandler);
 
+      // Pass 2 is split into stages: libosmium decodes buffers in its own
+      // thread pool, the location handler, relation handler and multipolygon
+      // manager depend on seeing the buffers in file order and run on the
+      // reading thread, and the conversion to osm2rdf objects runs as one
+      // task per buffer on all threads.
 #pragma omp parallel
       {
 #pragma omp single
@@ -93,9 +155,9 @@ void osm2rdf::osm::OsmiumHandler<W>::handle() {
                 _relationHandler,
 #endif  // BOOST_VERSION >= 107800
                 mp_manager.handler([&](osmium::memory::Buffer&& buffer) {
-                  osmium::apply(buffer, *this);
-                }),
-                *this);
+                  convertBuffer(std::move(buffer));
+                }));
+            convertBuffer(std::move(buf));
           }
         }
       }
@@ -118,7 +180,10 @@ void osm2rdf::osm::OsmiumHandler<W>::handle() {
                 << " geometry: " << _relationGeometriesHandled << "\n"
                 << osm2rdf::util::formattedTimeSpacer
                 << "ways seen:" << _waysSeen << " dumped: " << _waysDumped
-                << " geometry: " << _wayGeometriesHandled << std::endl;
+                << " geometry: " << _wayGeometriesHandled << "\n"
+                << osm2rdf::util::formattedTimeSpacer
+                << "buffers converted while reading paused: "
+                << _backpressureTriggered << std::endl;
     }
 
     if (!_config.noGeometricRelations) {
@@ -136,6 +201,35 @@ void osm2rdf::osm::OsmiumHandler<W>::handle() {
   }
 }
 
+// ____________________________________________________________________________
+template <typename W>
+void osm2rdf::osm::OsmiumHandler<W>::convertBuffer(
+    osmium::memory::Buffer&& buffer) {
+  const size_t bytes = buffer.committed();
+  const size_t maxBytes = _config.maxInFlightMB * 1024 * 1024;
+  if (_inFlightBytes > 0 && _inFlightBytes + bytes > maxBytes) {
+    // Too much data waiting for conversion: convert on the reading thread,
+    // which pauses reading until the workers caught up.
+    _backpressureTriggered++;
+#pragma omp taskgroup
+    osmium::apply(buffer, *this);
+    return;
+  }
+  _inFlightBytes += bytes;
+  // The buffer is shared with the conversion task, it is freed as soon as
+  // all entities are converted.
+  auto sharedBuffer =
+      std::make_shared<osmium::memory::Buffer>(std::move(buffer));
+#pragma omp task firstprivate(sharedBuffer, bytes)
+  {
+    // Include the tasks for areas, relations and way geometries, they may
+    // reference the buffer.
+#pragma omp taskgroup
+    osmium::apply(*sharedBuffer, *this);
+    _inFlightBytes -= bytes;
+  }
+}
+
 // ____________________________________________________________________________
 template <typename W>
 void osm2rdf::osm::OsmiumHandler<W>::area(const osmium::Area& area) {
@@ -143,18 +237,21 @@ void osm2rdf::osm::OsmiumHandler<W>::area(const osmium::Area& area) {
   if (_config.adminRelationsOnly && area.tags()["admin_level"] == nullptr) {
     return;
   }
+  if (!_tagFilter.area(area.tags())) {
+    return;
+  }
   auto osmArea = osm2rdf::osm::Area(area);
+  // Finalizing areas is expensive, the handlers then work on the same object
+  // instead of copies in separate tasks.
 #pragma omp task
   {
     osmArea.finalize();
     if (!_config.noFacts && !_config.noAreaFacts) {
       _areasDumped++;
-#pragma omp task
       _factHandler.area(osmArea);
     }
     if (!_config.noGeometricRelations && !_config.noAreaGeometricRelations) {
       _areaGeometriesHandled++;
-#pragma omp task
       _geometryHandler.area(osmArea);
     }
   }
@@ -167,19 +264,22 @@ void osm2rdf::osm::OsmiumHandler<W>::node(const osmium::Node& node) {
   if (_config.adminRelationsOnly) {
     return;
   }
-  const auto& osmNode = osm2rdf::osm::Node(node);
   if (node.tags().empty()) {
     return;
   }
+  if (!_tagFilter.node(node.tags())) {
+    return;
+  }
+  // Called from the conversion task of the buffer, so nodes are already
+  // handled in parallel. Both handlers read the node in place.
+  const osm2rdf::osm::NodeView nodeView{node};
   if (!_config.noFacts && !_config.noNodeFacts) {
     _nodesDumped++;
-#pragma omp task
-    _factHandler.node(osmNode);
+    _factHandler.node(nodeView);
   }
   if (!_config.noGeometricRelations && !_config.noNodeGeometricRelations) {
     _nodeGeometriesHandled++;
-#pragma omp task
-    _geometryHandler.node(osmNode);
+    _geometryHandler.node(nodeView);
   }
 }
 
@@ -194,6 +294,9 @@ void osm2rdf::osm::OsmiumHandler<W>::relation(
   if (_config.adminRelationsOnly && relation.tags()["admin_level"] == nullptr) {
     return;
   }
+  if (!_tagFilter.relation(relation.tags())) {
+    return;
+  }
   auto osmRelation = osm2rdf::osm::Relation(relation);
 #if BOOST_VERSION >= 107800
   // only task this away if we actually build the relation geometries,
@@ -206,11 +309,9 @@ void osm2rdf::osm::OsmiumHandler<W>::relation(
 #endif  // BOOST_VERSION >= 107800
     if (!_config.noFacts && !_config.noRelationFacts) {
       _relationsDumped++;
-#pragma omp task
       _factHandler.relation(osmRelation);
     }
 
-#pragma omp task
     _geometryHandler.relation(osmRelation);
 
 #if BOOST_VERSION >= 107800
@@ -228,16 +329,21 @@ void osm2rdf::osm::OsmiumHandler<W>::way(const osmium::Way& way) {
   if (_config.adminRelationsOnly) {
     return;
   }
-  const auto& osmWay = osm2rdf::osm::Way(way);
-  if (!_config.noFacts && !_config.noWayFacts) {
-    _waysDumped++;
-#pragma omp task
-    _factHandler.way(osmWay);
+  if (!_tagFilter.way(way.tags())) {
+    return;
   }
   if (!_config.noGeometricRelations && !_config.noWayGeometricRelations) {
     _wayGeometriesHandled++;
-#pragma omp task
-    _geometryHandler.way(osmWay);
+    // The geometry handler builds the convex hull and oriented bounding box,
+    // run it in parallel to the facts. The taskgroup in convertBuffer() keeps
+    // the buffer alive until this is done.
+    const osmium::Way* wayPtr = &way;
+#pragma omp task firstprivate(wayPtr)
+    _geometryHandler.way(osm2rdf::osm::WayView{*wayPtr});
+  }
+  if (!_config.noFacts && !_config.noWayFacts) {
+    _waysDumped++;
+    _factHandler.way(osm2rdf::osm::WayView{way});
   }
 }
 
@@ -313,6 +419,12 @@ size_t osm2rdf::osm::OsmiumHandler<W>::wayGeometriesHandled() const {
   return _wayGeometriesHandled;
 }
 
+// ____________________________________________________________________________
+template <typename W>
+size_t osm2rdf::osm::OsmiumHandler<W>::backpressureTriggered() const {
+  return _backpressureTriggered;
+}
+
 // ____________________________________________________________________________
 template class osm2rdf::osm::OsmiumHandler<osm2rdf::ttl::format::NT>;
 template class osm2rdf::osm::OsmiumHandler<osm2rdf::ttl::format::TTL>;
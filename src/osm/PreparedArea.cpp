@@ -0,0 +1,444 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/PreparedArea.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define OSM2RDF_PREPARED_AREA_X86
+#endif
+
+#include <algorithm>
+#include <cmath>
+
+#include "boost/geometry.hpp"
+
+// Average number of edges per band.
+static const size_t EDGES_PER_BAND = 4;
+// Upper bound for the number of bands.
+static const size_t MAX_BANDS = 1U << 20U;
+// Upper bound for the average number of bands an edge is stored in.
+static const size_t MAX_ENTRIES_PER_EDGE = 4;
+// Boost compares x coordinates with a tolerance of machine epsilon times
+// max(1, |x|). Edges are stored in all bands within this times (1 + |x|) of
+// their x range, and the vector kernels leave x coordinates this close to
+// the point to the scalar test.
+static const double X_EPSILON = 1e-12;
+// The vector kernels decide the side of the point only if the orientation
+// exceeds this times (|dx| + |dpx| + 1) * (|dy| + |dpy| + 1), with dx, dy the
+// extent of the edge and dpx, dpy the offset of the point from its start.
+// This covers the rounding errors of both computations and the tolerance of
+// boost's side strategy, so certain lanes agree with the scalar test. Other
+// edges are decided by the scalar test.
+static const double ORIENTATION_EPSILON = 1e-12;
+
+using osm2rdf::geometry::Location;
+
+namespace {
+
+// Coordinate arrays of the edges in one band, in ring order.
+struct BandEdges {
+  const double* fromX;
+  const double* fromY;
+  const double* toX;
+  const double* toY;
+  size_t size;
+};
+
+// Whether the point lies inside or on the boundary of the edges in a band.
+typedef bool (*WindingKernel)(const BandEdges& edges, const Location& point);
+
+}  // namespace
+
+// ____________________________________________________________________________
+// Contribution of the edge from s1 to s2 to the winding number of the point,
+// sets touches if the point lies on the edge. Same decisions as
+// boost::geometry::strategy::within::cartesian_winding, which
+// boost::geometry::covered_by uses: a vertical ray through the point, x
+// coordinates compared with a tolerance and the side of the point decided by
+// boost's cartesian side strategy.
+static int winding(const Location& s1, const Location& s2,
+                   const Location& point, bool* touches) {
+  const bool eq1 = boost::geometry::math::equals(s1.x(), point.x());
+  const bool eq2 = boost::geometry::math::equals(s2.x(), point.x());
+  if (eq1 && eq2) {
+    // Vertical edge.
+    if ((s1.y() <= point.y() && s2.y() >= point.y()) ||
+        (s2.y() <= point.y() && s1.y() >= point.y())) {
+      *touches = true;
+    }
+    return 0;
+  }
+  const int count = eq1   ? (s2.x() > point.x() ? 1 : -1)
+                    : eq2 ? (s1.x() > point.x() ? -1 : 1)
+                    : s1.x() < point.x() && s2.x() > point.x() ? 2
+                    : s2.x() < point.x() && s1.x() > point.x() ? -2
+                                                               : 0;
+  if (count == 0) {
+    return 0;
+  }
+  int side;
+  if (count == 1 || count == -1) {
+    // The point lies on the level of an end point.
+    const Location& end = eq1 ? s1 : s2;
+    side = boost::geometry::math::equals(point.y(), end.y()) ? 0
+           : point.y() < end.y()                             ? -count
+                                                             : count;
+  } else {
+    side = boost::geometry::strategy::side::side_by_triangle<>::apply(
+        s1, s2, point);
+  }
+  if (side == 0) {
+    *touches = true;
+    return 0;
+  }
+  return side * count > 0 ? count : 0;
+}
+
+// ____________________________________________________________________________
+static int winding(const BandEdges& edges, size_t i, const Location& point,
+                   bool* touches) {
+  return winding(Location{edges.fromX[i], edges.fromY[i]},
+                 Location{edges.toX[i], edges.toY[i]}, point, touches);
+}
+
+// ____________________________________________________________________________
+static bool coversScalar(const BandEdges& edges, const Location& point) {
+  int count = 0;
+  bool touches = false;
+  for (size_t i = 0; i < edges.size && !touches; ++i) {
+    count += winding(edges, i, point, &touches);
+  }
+  return touches || count != 0;
+}
+
+#if defined(OSM2RDF_PREPARED_AREA_X86)
+// ____________________________________________________________________________
+// Lanes with both x coordinates clearly on one side of the point do not
+// count. Lanes spanning the point count if the orientation exceeds its
+// bound, see ORIENTATION_EPSILON. All other lanes are rare and decided by the
+// scalar test.
+__attribute__((target("avx2"))) static bool coversAvx2(
+    const BandEdges& edges, const Location& point) {
+  const __m256d px = _mm256_set1_pd(static_cast<double>(point.x()));
+  const __m256d py = _mm256_set1_pd(static_cast<double>(point.y()));
+  const __m256d xBound =
+      _mm256_set1_pd(X_EPSILON * (1 + std::abs(point.x())));
+  const __m256d epsilon = _mm256_set1_pd(ORIENTATION_EPSILON);
+  const __m256d one = _mm256_set1_pd(1);
+  const __m256d signBit = _mm256_set1_pd(-0.0);
+  int count = 0;
+  bool touches = false;
+  size_t i = 0;
+  for (; i + 4 <= edges.size; i += 4) {
+    const __m256d fromX = _mm256_loadu_pd(edges.fromX + i);
+    const __m256d toX = _mm256_loadu_pd(edges.toX + i);
+    const __m256d dpx = _mm256_sub_pd(px, fromX);
+    const __m256d dqx = _mm256_sub_pd(px, toX);
+    const __m256d nearX = _mm256_or_pd(
+        _mm256_cmp_pd(_mm256_andnot_pd(signBit, dpx), xBound, _CMP_LE_OQ),
+        _mm256_cmp_pd(_mm256_andnot_pd(signBit, dqx), xBound, _CMP_LE_OQ));
+    const __m256d east =
+        _mm256_and_pd(_mm256_cmp_pd(fromX, px, _CMP_LT_OQ),
+                      _mm256_cmp_pd(px, toX, _CMP_LT_OQ));
+    const __m256d west =
+        _mm256_and_pd(_mm256_cmp_pd(toX, px, _CMP_LT_OQ),
+                      _mm256_cmp_pd(px, fromX, _CMP_LT_OQ));
+    const __m256d spanning = _mm256_andnot_pd(nearX, _mm256_or_pd(east, west));
+    if (_mm256_movemask_pd(_mm256_or_pd(nearX, spanning)) == 0) {
+      continue;
+    }
+    const __m256d fromY = _mm256_loadu_pd(edges.fromY + i);
+    const __m256d toY = _mm256_loadu_pd(edges.toY + i);
+    const __m256d dx = _mm256_sub_pd(toX, fromX);
+    const __m256d dy = _mm256_sub_pd(toY, fromY);
+    const __m256d dpy = _mm256_sub_pd(py, fromY);
+    const __m256d side =
+        _mm256_sub_pd(_mm256_mul_pd(dx, dpy), _mm256_mul_pd(dy, dpx));
+    const __m256d extentX =
+        _mm256_add_pd(_mm256_add_pd(_mm256_andnot_pd(signBit, dx),
+                                    _mm256_andnot_pd(signBit, dpx)),
+                      one);
+    const __m256d extentY =
+        _mm256_add_pd(_mm256_add_pd(_mm256_andnot_pd(signBit, dy),
+                                    _mm256_andnot_pd(signBit, dpy)),
+                      one);
+    const __m256d bound =
+        _mm256_mul_pd(epsilon, _mm256_mul_pd(extentX, extentY));
+    // Left of an eastward edge counts 2, right of a westward edge -2.
+    const __m256d left = _mm256_cmp_pd(side, bound, _CMP_GT_OQ);
+    const __m256d right = _mm256_cmp_pd(
+        side, _mm256_xor_pd(bound, signBit), _CMP_LT_OQ);
+    const __m256d uncertain = _mm256_or_pd(
+        nearX, _mm256_andnot_pd(_mm256_or_pd(left, right), spanning));
+    count += 2 * __builtin_popcount(_mm256_movemask_pd(
+                     _mm256_and_pd(_mm256_andnot_pd(nearX, east), left)));
+    count -= 2 * __builtin_popcount(_mm256_movemask_pd(
+                     _mm256_and_pd(_mm256_andnot_pd(nearX, west), right)));
+    for (auto mask = static_cast<unsigned>(_mm256_movemask_pd(uncertain));
+         mask != 0; mask &= mask - 1) {
+      count += winding(edges, i + __builtin_ctz(mask), point, &touches);
+      if (touches) {
+        return true;
+      }
+    }
+  }
+  for (; i < edges.size && !touches; ++i) {
+    count += winding(edges, i, point, &touches);
+  }
+  return touches || count != 0;
+}
+
+// ____________________________________________________________________________
+// Same as coversAvx2 with eight lanes.
+__attribute__((target("avx512f"))) static bool coversAvx512(
+    const BandEdges& edges, const Location& point) {
+  const __m512d px = _mm512_set1_pd(static_cast<double>(point.x()));
+  const __m512d py = _mm512_set1_pd(static_cast<double>(point.y()));
+  const __m512d xBound =
+      _mm512_set1_pd(X_EPSILON * (1 + std::abs(point.x())));
+  const __m512d epsilon = _mm512_set1_pd(ORIENTATION_EPSILON);
+  const __m512d one = _mm512_set1_pd(1);
+  int count = 0;
+  bool touches = false;
+  size_t i = 0;
+  for (; i + 8 <= edges.size; i += 8) {
+    const __m512d fromX = _mm512_loadu_pd(edges.fromX + i);
+    const __m512d toX = _mm512_loadu_pd(edges.toX + i);
+    const __m512d dpx = _mm512_sub_pd(px, fromX);
+    const __m512d dqx = _mm512_sub_pd(px, toX);
+    const __mmask8 nearX =
+        _mm512_cmp_pd_mask(_mm512_abs_pd(dpx), xBound, _CMP_LE_OQ) |
+        _mm512_cmp_pd_mask(_mm512_abs_pd(dqx), xBound, _CMP_LE_OQ);
+    const __mmask8 east = _mm512_cmp_pd_mask(fromX, px, _CMP_LT_OQ) &
+                          _mm512_cmp_pd_mask(px, toX, _CMP_LT_OQ) & ~nearX;
+    const __mmask8 west = _mm512_cmp_pd_mask(toX, px, _CMP_LT_OQ) &
+                          _mm512_cmp_pd_mask(px, fromX, _CMP_LT_OQ) & ~nearX;
+    if ((nearX | east | west) == 0) {
+      continue;
+    }
+    const __m512d fromY = _mm512_loadu_pd(edges.fromY + i);
+    const __m512d toY = _mm512_loadu_pd(edges.toY + i);
+    const __m512d dx = _mm512_sub_pd(toX, fromX);
+    const __m512d dy = _mm512_sub_pd(toY, fromY);
+    const __m512d dpy = _mm512_sub_pd(py, fromY);
+    const __m512d side =
+        _mm512_sub_pd(_mm512_mul_pd(dx, dpy), _mm512_mul_pd(dy, dpx));
+    const __m512d extentX = _mm512_add_pd(
+        _mm512_add_pd(_mm512_abs_pd(dx), _mm512_abs_pd(dpx)), one);
+    const __m512d extentY = _mm512_add_pd(
+        _mm512_add_pd(_mm512_abs_pd(dy), _mm512_abs_pd(dpy)), one);
+    const __m512d bound =
+        _mm512_mul_pd(epsilon, _mm512_mul_pd(extentX, extentY));
+    const __mmask8 left = _mm512_cmp_pd_mask(side, bound, _CMP_GT_OQ);
+    const __mmask8 right = _mm512_cmp_pd_mask(
+        side, _mm512_sub_pd(_mm512_setzero_pd(), bound), _CMP_LT_OQ);
+    const __mmask8 uncertain = nearX | ((east | west) & ~(left | right));
+    count += 2 * __builtin_popcount(east & left);
+    count -= 2 * __builtin_popcount(west & right);
+    for (unsigned mask = uncertain; mask != 0; mask &= mask - 1) {
+      count += winding(edges, i + __builtin_ctz(mask), point, &touches);
+      if (touches) {
+        return true;
+      }
+    }
+  }
+  for (; i < edges.size && !touches; ++i) {
+    count += winding(edges, i, point, &touches);
+  }
+  return touches || count != 0;
+}
+#endif
+
+// ____________________________________________________________________________
+static WindingKernel windingKernel(osm2rdf::osm::PreparedArea::Kernel kernel) {
+  switch (kernel) {
+#if defined(OSM2RDF_PREPARED_AREA_X86)
+    case osm2rdf::osm::PreparedArea::Kernel::AVX2:
+      return coversAvx2;
+    case osm2rdf::osm::PreparedArea::Kernel::AVX512:
+      return coversAvx512;
+#endif
+    default:
+      return coversScalar;
+  }
+}
+
+// ____________________________________________________________________________
+osm2rdf::osm::PreparedArea::PreparedArea(
+    const osm2rdf::geometry::Area& area) {
+  std::vector<Edge> edges;
+  for (const auto& polygon : area) {
+    // Like boost, skip polygons with a degenerated outer ring.
+    if (polygon.outer().size() < 4) {
+      continue;
+    }
+    addRing(polygon.outer(), &edges);
+    for (const auto& inner : polygon.inners()) {
+      addRing(inner, &edges);
+    }
+  }
+  _numEdges = edges.size();
+  if (edges.empty()) {
+    boost::geometry::assign_inverse(_envelope);
+    _bandStarts = {0, 0};
+    return;
+  }
+  boost::geometry::assign_inverse(_envelope);
+  for (const auto& edge : edges) {
+    boost::geometry::expand(_envelope, edge.from);
+    boost::geometry::expand(_envelope, edge.to);
+  }
+  // Points within the x tolerance of an edge may touch it.
+  const auto minX = static_cast<double>(_envelope.min_corner().x());
+  const auto maxX = static_cast<double>(_envelope.max_corner().x());
+  _envelope.min_corner().set<0>(minX - X_EPSILON * (1 + std::abs(minX)));
+  _envelope.max_corner().set<0>(maxX + X_EPSILON * (1 + std::abs(maxX)));
+
+  const double width = static_cast<double>(_envelope.max_corner().x()) -
+                       static_cast<double>(_envelope.min_corner().x());
+  const auto firstBand = [this](const Edge& edge) {
+    const double x = std::min(edge.from.x(), edge.to.x());
+    return band(x - X_EPSILON * (1 + std::abs(x)));
+  };
+  const auto lastBand = [this](const Edge& edge) {
+    const double x = std::max(edge.from.x(), edge.to.x());
+    return band(x + X_EPSILON * (1 + std::abs(x)));
+  };
+  // Edges are repeated in every band they span. Coarsen the bands until long
+  // edges no longer dominate the size.
+  size_t numBands =
+      std::clamp<size_t>(edges.size() / EDGES_PER_BAND, 1, MAX_BANDS);
+  while (true) {
+    _bandWidth = width > 0 ? width / static_cast<double>(numBands) : 1;
+    _bandStarts.assign(numBands + 1, 0);
+    size_t entries = 0;
+    for (const auto& edge : edges) {
+      entries += lastBand(edge) - firstBand(edge) + 1;
+    }
+    if (numBands == 1 || entries <= MAX_ENTRIES_PER_EDGE * edges.size()) {
+      break;
+    }
+    numBands /= 2;
+  }
+
+  // Count the edges of each band, then fill in place.
+  for (const auto& edge : edges) {
+    for (size_t b = firstBand(edge); b <= lastBand(edge); ++b) {
+      _bandStarts[b + 1]++;
+    }
+  }
+  for (size_t b = 0; b < numBands; ++b) {
+    _bandStarts[b + 1] += _bandStarts[b];
+  }
+  _fromX.resize(_bandStarts.back());
+  _fromY.resize(_bandStarts.back());
+  _toX.resize(_bandStarts.back());
+  _toY.resize(_bandStarts.back());
+  std::vector<uint32_t> next(_bandStarts.begin(), _bandStarts.end() - 1);
+  for (const auto& edge : edges) {
+    for (size_t b = firstBand(edge); b <= lastBand(edge); ++b) {
+      const uint32_t i = next[b]++;
+      _fromX[i] = edge.from.x();
+      _fromY[i] = edge.from.y();
+      _toX[i] = edge.to.x();
+      _toY[i] = edge.to.y();
+    }
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::PreparedArea::addRing(const osm2rdf::geometry::Ring& ring,
+                                         std::vector<Edge>* edges) {
+  // Like boost, ignore degenerated rings.
+  if (ring.size() < 4) {
+    return;
+  }
+  for (size_t i = 0; i + 1 < ring.size(); ++i) {
+    edges->push_back({ring[i], ring[i + 1]});
+  }
+}
+
+// ____________________________________________________________________________
+size_t osm2rdf::osm::PreparedArea::band(double x) const {
+  const double offset =
+      (x - static_cast<double>(_envelope.min_corner().x())) / _bandWidth;
+  if (!(offset > 0)) {
+    return 0;
+  }
+  return std::min(_bandStarts.size() - 2, static_cast<size_t>(offset));
+}
+
+// ____________________________________________________________________________
+bool osm2rdf::osm::PreparedArea::covers(const Location& point) const {
+  static const Kernel best = bestKernel();
+  return covers(point, best);
+}
+
+// ____________________________________________________________________________
+bool osm2rdf::osm::PreparedArea::covers(const Location& point,
+                                        Kernel kernel) const {
+  if (point.x() < _envelope.min_corner().x() ||
+      point.x() > _envelope.max_corner().x()) {
+    return false;
+  }
+  // Sum the winding numbers of the edges of the band below and above point.
+  const size_t b = band(point.x());
+  const uint32_t first = _bandStarts[b];
+  const BandEdges edges{_fromX.data() + first, _fromY.data() + first,
+                        _toX.data() + first, _toY.data() + first,
+                        _bandStarts[b + 1] - first};
+  return windingKernel(kernel)(edges, point);
+}
+
+// ____________________________________________________________________________
+size_t osm2rdf::osm::PreparedArea::numEdges() const noexcept {
+  return _numEdges;
+}
+
+// ____________________________________________________________________________
+size_t osm2rdf::osm::PreparedArea::numBands() const noexcept {
+  return _bandStarts.size() - 1;
+}
+
+// ____________________________________________________________________________
+bool osm2rdf::osm::PreparedArea::supported(Kernel kernel) {
+  switch (kernel) {
+#if defined(OSM2RDF_PREPARED_AREA_X86)
+    case Kernel::AVX2:
+      return __builtin_cpu_supports("avx2") != 0;
+    case Kernel::AVX512:
+      return __builtin_cpu_supports("avx512f") != 0;
+#endif
+    case Kernel::SCALAR:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// ____________________________________________________________________________
+osm2rdf::osm::PreparedArea::Kernel osm2rdf::osm::PreparedArea::bestKernel() {
+  if (supported(Kernel::AVX512)) {
+    return Kernel::AVX512;
+  }
+  if (supported(Kernel::AVX2)) {
+    return Kernel::AVX2;
+  }
+  return Kernel::SCALAR;
+}
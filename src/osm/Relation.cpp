@@ -92,19 +92,43 @@ const osm2rdf::geometry::Polygon& osm2rdf::osm::Relation::orientedBoundingBox()
 void osm2rdf::osm::Relation::buildGeometry(
     osm2rdf::osm::RelationHandler& relationHandler) {
   _hasCompleteGeometry = true;
+  // Collect the nodes of all members first and look up their locations in
+  // one batch.
+  std::vector<uint64_t> nodeIds;
+  std::vector<size_t> wayNodeCounts;
+  for (const auto& member : _members) {
+    switch (member.type()) {
+      case RelationMemberType::WAY: {
+        const auto nodeRefs = relationHandler.get_noderefs_of_way(member.id());
+        nodeIds.insert(nodeIds.end(), nodeRefs.begin(), nodeRefs.end());
+        wayNodeCounts.push_back(nodeRefs.size());
+        break;
+      }
+      case RelationMemberType::NODE:
+        nodeIds.push_back(member.id());
+        break;
+      default:
+        break;
+    }
+  }
+  std::vector<osmium::Location> locations;
+  relationHandler.get_node_locations(nodeIds, &locations);
+
+  auto nextLocation = locations.cbegin();
+  auto nextWayNodeCount = wayNodeCounts.cbegin();
   for (const auto& member : _members) {
     osmium::Location res;
     osm2rdf::geometry::Way way;
-    std::vector<uint64_t> nodeRefs;
+    size_t wayNodeCount = 0;
     switch (member.type()) {
       case RelationMemberType::WAY:
-        nodeRefs = relationHandler.get_noderefs_of_way(member.id());
-        if (nodeRefs.empty()) {
+        wayNodeCount = *nextWayNodeCount++;
+        if (wayNodeCount == 0) {
           _hasCompleteGeometry = false;
           break;
         }
-        for (const auto& nodeRef : nodeRefs) {
-          res = relationHandler.get_node_location(nodeRef);
+        for (size_t i = 0; i < wayNodeCount; ++i) {
+          res = *nextLocation++;
           if (res.valid()) {
             boost::geometry::append(
                 way, osm2rdf::geometry::Node{res.lon(), res.lat()});
@@ -116,7 +140,7 @@ void osm2rdf::osm::Relation::buildGeometry(
             _geom, std::move(way));
         break;
       case RelationMemberType::NODE:
-        res = relationHandler.get_node_location(member.id());
+        res = *nextLocation++;
         if (res.valid()) {
           boost::geometry::traits::emplace_back<geometry::Relation>::apply(
               _geom, osm2rdf::geometry::Node{res.lon(), res.lat()});
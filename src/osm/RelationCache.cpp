@@ -0,0 +1,246 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/RelationCache.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static const char MAGIC[8] = {'o', '2', 'r', '-', 'r', 'e', 'l', '2'};
+// Number of bytes at the start and at the end of the input file used for the
+// header hash.
+static const size_t HASHED_BYTES = 1U << 16U;
+static const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+// Collected relations are written to disk in chunks of this size.
+static const size_t FLUSH_BYTES = 1U << 24U;
+
+// ____________________________________________________________________________
+// FNV-1a, continuing from the given hash.
+static uint64_t fnv1a(const char* bytes, size_t count, uint64_t hash) {
+  for (size_t i = 0; i < count; ++i) {
+    hash ^= static_cast<uint8_t>(bytes[i]);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+// ____________________________________________________________________________
+osm2rdf::osm::RelationCache::RelationCache(
+    const osm2rdf::config::Config& config)
+    : _config(config),
+      _relations(FLUSH_BYTES, osmium::memory::Buffer::auto_grow::yes) {}
+
+// ____________________________________________________________________________
+osm2rdf::osm::RelationCache::~RelationCache() {
+  if (_mapped != nullptr) {
+    _buffer.reset();
+    ::munmap(_mapped, _mappedSize);
+  }
+  if (_out.is_open()) {
+    // Pass 1 did not finish, do not leave a partial file behind.
+    _out.close();
+    std::error_code ec;
+    std::filesystem::remove(tmpPath(), ec);
+  }
+}
+
+// ____________________________________________________________________________
+std::filesystem::path osm2rdf::osm::RelationCache::path() const {
+  // Inputs with the same name in different directories get different caches.
+  std::error_code ec;
+  std::filesystem::path input = std::filesystem::weakly_canonical(
+      std::filesystem::absolute(_config.input), ec);
+  if (ec) {
+    input = std::filesystem::absolute(_config.input);
+  }
+  const std::string& inputString = input.string();
+  std::ostringstream name;
+  name << _config.input.filename().string() << "-" << std::hex
+       << std::setw(16) << std::setfill('0')
+       << fnv1a(inputString.data(), inputString.size(), FNV_OFFSET_BASIS);
+  return _config.getTempPath(name.str(), "relations.cache");
+}
+
+// ____________________________________________________________________________
+osm2rdf::osm::RelationCache::Header
+osm2rdf::osm::RelationCache::inputHeader() const {
+  Header header{};
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.inputSize = std::filesystem::file_size(_config.input);
+  header.inputModified = std::filesystem::last_write_time(_config.input)
+                             .time_since_epoch()
+                             .count();
+  // FNV-1a over the first and the last bytes of the input, the end of a file
+  // changes when data is appended or the last blocks are rewritten.
+  std::vector<char> bytes(HASHED_BYTES);
+  std::ifstream in(_config.input, std::ios::binary);
+  in.read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+  uint64_t hash = fnv1a(bytes.data(), static_cast<size_t>(in.gcount()),
+                        FNV_OFFSET_BASIS);
+  if (header.inputSize > HASHED_BYTES) {
+    // Skip bytes already hashed for inputs shorter than twice HASHED_BYTES.
+    const uint64_t tailStart =
+        std::max<uint64_t>(HASHED_BYTES, header.inputSize - HASHED_BYTES);
+    in.clear();
+    in.seekg(static_cast<std::streamoff>(tailStart));
+    in.read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    hash = fnv1a(bytes.data(), static_cast<size_t>(in.gcount()), hash);
+  }
+  header.inputHash = hash;
+  return header;
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::RelationCache::relation(const osmium::Relation& relation) {
+  if (!_config.relationCache || relation.members().empty()) {
+    return;
+  }
+  _relations.add_item(relation);
+  _relations.commit();
+  if (_relations.committed() >= FLUSH_BYTES) {
+    writeRelations();
+  }
+}
+
+// ____________________________________________________________________________
+std::filesystem::path osm2rdf::osm::RelationCache::tmpPath() const {
+  std::filesystem::path tmpPath{path()};
+  tmpPath += ".tmp";
+  return tmpPath;
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::RelationCache::disable(const std::string& reason) {
+  std::cerr << "Warning: " << reason << ", not caching relations"
+            << std::endl;
+  _config.relationCache = false;
+  _relations.clear();
+  if (_out.is_open()) {
+    _out.close();
+  }
+  std::error_code ec;
+  std::filesystem::remove(tmpPath(), ec);
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::RelationCache::writeRelations() {
+  if (!_out.is_open()) {
+    _out.open(tmpPath(), std::ios::binary | std::ios::trunc);
+    if (!_out) {
+      disable("Could not open " + tmpPath().string());
+      return;
+    }
+    // Placeholder, the header is written once all relations are known.
+    Header header{};
+    _out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  }
+  _out.write(reinterpret_cast<const char*>(_relations.data()),
+             static_cast<std::streamsize>(_relations.committed()));
+  if (!_out) {
+    disable("Could not write " + tmpPath().string());
+    return;
+  }
+  _dataSize += _relations.committed();
+  _relations.clear();
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::RelationCache::prepare_for_lookup() {
+  if (!_config.relationCache) {
+    return;
+  }
+  writeRelations();
+  if (!_config.relationCache) {
+    return;
+  }
+  Header header = inputHeader();
+  header.dataSize = _dataSize;
+  _out.seekp(0);
+  _out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  _out.close();
+  if (!_out) {
+    disable("Could not write " + tmpPath().string());
+    return;
+  }
+  std::error_code ec;
+  std::filesystem::rename(tmpPath(), path(), ec);
+  if (ec) {
+    disable("Could not rename " + tmpPath().string() + ": " + ec.message());
+  }
+}
+
+// ____________________________________________________________________________
+bool osm2rdf::osm::RelationCache::load() {
+  if (!_config.relationCache || !std::filesystem::exists(path())) {
+    return false;
+  }
+  const int fd = ::open(path().c_str(), O_RDONLY);
+  if (fd == -1) {
+    return false;
+  }
+  struct stat fileStat {};
+  if (::fstat(fd, &fileStat) != 0 ||
+      static_cast<size_t>(fileStat.st_size) < sizeof(Header)) {
+    ::close(fd);
+    return false;
+  }
+  _mappedSize = static_cast<size_t>(fileStat.st_size);
+  // Private mapping: osmium buffers hand out non-const items, changes are
+  // never written back.
+  _mapped = ::mmap(nullptr, _mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                   fd, 0);
+  ::close(fd);
+  if (_mapped == MAP_FAILED) {
+    _mapped = nullptr;
+    return false;
+  }
+
+  Header stored{};
+  std::memcpy(&stored, _mapped, sizeof(Header));
+  const Header expected = inputHeader();
+  if (std::memcmp(stored.magic, expected.magic, sizeof(MAGIC)) != 0 ||
+      stored.inputSize != expected.inputSize ||
+      stored.inputModified != expected.inputModified ||
+      stored.inputHash != expected.inputHash ||
+      stored.dataSize + sizeof(Header) != _mappedSize) {
+    ::munmap(_mapped, _mappedSize);
+    _mapped = nullptr;
+    return false;
+  }
+  ::madvise(_mapped, _mappedSize, MADV_SEQUENTIAL);
+  _buffer = std::make_unique<osmium::memory::Buffer>(
+      static_cast<unsigned char*>(_mapped) + sizeof(Header), stored.dataSize);
+  return true;
+}
+
+// ____________________________________________________________________________
+osmium::memory::Buffer& osm2rdf::osm::RelationCache::buffer() {
+  return *_buffer;
+}
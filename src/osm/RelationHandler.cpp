@@ -18,6 +18,7 @@
 
 #include "osm2rdf/osm/RelationHandler.h"
 
+#include <algorithm>
 #include <iostream>
 
 // ____________________________________________________________________________
@@ -25,10 +26,17 @@ osm2rdf::osm::RelationHandler::RelationHandler(
     const osm2rdf::config::Config& config) {
   _config = config;
   _locationHandler = nullptr;
+  if (_config.storeWayNodesOnDisk) {
+    _wayNodes.spillTo(_config.getTempPath("relations", "way-nodes.cache"));
+  }
 }
 
 // ____________________________________________________________________________
 void osm2rdf::osm::RelationHandler::prepare_for_lookup() {
+  std::sort(_neededWays.begin(), _neededWays.end());
+  _neededWays.erase(std::unique(_neededWays.begin(), _neededWays.end()),
+                    _neededWays.end());
+  _neededWays.shrink_to_fit();
   _firstPassDone = true;
 }
 
@@ -50,9 +58,20 @@ osmium::Location osm2rdf::osm::RelationHandler::get_node_location(
 }
 
 // ____________________________________________________________________________
-std::vector<uint64_t> osm2rdf::osm::RelationHandler::get_noderefs_of_way(
-    const uint64_t wayId) {
-  return _ways[wayId];
+void osm2rdf::osm::RelationHandler::get_node_locations(
+    const std::vector<uint64_t>& nodeIds,
+    std::vector<osmium::Location>* locations) const {
+  locations->resize(nodeIds.size());
+  _locationHandler->get_node_locations(nodeIds.data(), nodeIds.size(),
+                                       locations->data());
+}
+
+// ____________________________________________________________________________
+osm2rdf::osm::WayNodeIndex::NodeRefs
+osm2rdf::osm::RelationHandler::get_noderefs_of_way(const uint64_t wayId) {
+  // All ways are read before the first relation geometry is built.
+  _wayNodes.finalize();
+  return _wayNodes.get(wayId);
 }
 
 // ____________________________________________________________________________
@@ -63,7 +82,7 @@ void osm2rdf::osm::RelationHandler::relation(const osmium::Relation& relation) {
   for (const auto& relationMember : relation.cmembers()) {
     switch (relationMember.type()) {
       case osmium::item_type::way:
-        _ways[relationMember.positive_ref()] = {};
+        _neededWays.push_back(relationMember.positive_ref());
         break;
       case osmium::item_type::relation:
         _relations[relationMember.positive_ref()] = {};
@@ -79,11 +98,8 @@ void osm2rdf::osm::RelationHandler::way(const osmium::Way& way) {
   if (!_firstPassDone) {
     return;
   }
-  if (_ways.find(way.positive_id()) != _ways.end()) {
-    std::vector<uint64_t> ids;
-    for (const auto& nodeRef : way.nodes()) {
-      ids.push_back(nodeRef.positive_ref());
-    }
-    _ways[way.positive_id()] = std::move(ids);
+  if (std::binary_search(_neededWays.begin(), _neededWays.end(),
+                         way.positive_id())) {
+    _wayNodes.add(way.positive_id(), way.nodes());
   }
 }
@@ -0,0 +1,509 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/SegmentedSpill.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <stdexcept>
+#include <system_error>
+
+#include "omp.h"
+#include "osm2rdf/osm/GeometryHandler.h"
+#include "osm2rdf/osm/SpillFormat.h"
+#include "osm2rdf/util/Hilbert.h"
+
+// Segment files are written in chunks of this size.
+static const size_t WRITE_BUFFER_BYTES = 1U << 20U;
+// Records are sorted in runs of at most this size, one run per thread.
+static const size_t SORT_RUN_BYTES = 32U << 20U;
+
+namespace osm2rdf::osm {
+
+static_assert(std::is_trivially_copyable_v<osm2rdf::geometry::Box>);
+static_assert(std::is_trivially_copyable_v<osm2rdf::geometry::OrientedBox>);
+
+// BoxId as stored in the data file.
+struct SpillBoxId {
+  int32_t id;
+  uint32_t count;
+};
+
+// Converts values to fixed-width records and arrays in the data file.
+template <typename T>
+struct SpillCodec;
+
+// ____________________________________________________________________________
+static SpillSpan writeBoxIds(const BoxIdList& boxIds, SpillDataWriter* writer) {
+  std::vector<SpillBoxId> packed;
+  packed.reserve(boxIds.size());
+  for (const auto& [id, count] : boxIds) {
+    packed.push_back({id, count});
+  }
+  return writer->array(packed);
+}
+
+// ____________________________________________________________________________
+static uint64_t spatialKey(const osm2rdf::geometry::Box& envelope) {
+  const double x = (envelope.min_corner().x() + envelope.max_corner().x()) / 2;
+  const double y = (envelope.min_corner().y() + envelope.max_corner().y()) / 2;
+  return osm2rdf::util::hilbertIndex(osm2rdf::util::hilbertCell(x, -180, 180),
+                                     osm2rdf::util::hilbertCell(y, -90, 90));
+}
+
+// ____________________________________________________________________________
+static void readBoxIds(const SpillSpan& span, const SpillDataReader& reader,
+                       BoxIdList* boxIds) {
+  const auto* packed = reader.array<SpillBoxId>(span);
+  boxIds->resize(span.count);
+  for (size_t i = 0; i < span.count; ++i) {
+    (*boxIds)[i] = BoxId{packed[i].id, packed[i].count};
+  }
+}
+
+template <>
+struct SpillCodec<SpatialNodeValue> {
+  struct Record {
+    uint64_t id;
+    osm2rdf::geometry::Location geom;
+  };
+
+  static void encode(const SpatialNodeValue& value, Record* record,
+                     [[maybe_unused]] SpillDataWriter* writer) {
+    record->id = std::get<0>(value);
+    record->geom = std::get<1>(value);
+  }
+
+  static void decode(const Record& record,
+                     [[maybe_unused]] const SpillDataReader& reader,
+                     SpatialNodeValue* value) {
+    std::get<0>(*value) = record.id;
+    std::get<1>(*value) = record.geom;
+  }
+
+  static osm2rdf::geometry::Box envelope(const Record& record) {
+    return {record.geom, record.geom};
+  }
+};
+
+template <>
+struct SpillCodec<SpatialWayValue> {
+  struct Record {
+    osm2rdf::geometry::Box envelope;
+    uint64_t id;
+    SpillSpan geom;
+    SpillSpan nodeIds;
+    SpillSpan boxes;
+    SpillSpan boxIds;
+    SpillSpan convexHull;
+    SpillSpan obb;
+  };
+
+  static void encode(const SpatialWayValue& value, Record* record,
+                     SpillDataWriter* writer) {
+    const auto& [envelope, id, geom, nodeIds, boxes, boxIds, convexHull, obb] =
+        value;
+    record->envelope = envelope;
+    record->id = id;
+    record->geom = writer->array(geom.data(), geom.size());
+    record->nodeIds = writer->array(nodeIds);
+    record->boxes = writer->array(boxes);
+    record->boxIds = writeBoxIds(boxIds, writer);
+    record->convexHull = writer->polygon(convexHull);
+    record->obb = writer->polygon(obb);
+  }
+
+  static void decode(const Record& record, const SpillDataReader& reader,
+                     SpatialWayValue* value) {
+    auto& [envelope, id, geom, nodeIds, boxes, boxIds, convexHull, obb] =
+        *value;
+    envelope = record.envelope;
+    id = static_cast<osm2rdf::osm::Way::id_t>(record.id);
+    reader.array<osm2rdf::geometry::Location>(record.geom, &geom);
+    reader.array<osm2rdf::osm::Node::id_t>(record.nodeIds, &nodeIds);
+    reader.array<osm2rdf::geometry::Box>(record.boxes, &boxes);
+    readBoxIds(record.boxIds, reader, &boxIds);
+    reader.polygon(record.convexHull, &convexHull);
+    reader.polygon(record.obb, &obb);
+  }
+
+  static osm2rdf::geometry::Box envelope(const Record& record) {
+    return record.envelope;
+  }
+};
+
+template <>
+struct SpillCodec<SpatialAreaData> {
+  struct Cutout {
+    int32_t boxId;
+    SpillSpan area;
+  };
+
+  struct Record {
+    // Union of all envelopes, only used for sorting.
+    osm2rdf::geometry::Box envelope;
+    uint64_t id;
+    uint64_t objId;
+    osm2rdf::geometry::area_result_t area;
+    AreaFromType fromType;
+    SpillSpan envelopes;
+    SpillSpan geom;
+    SpillSpan inner;
+    SpillSpan outer;
+    SpillSpan boxIds;
+    SpillSpan cutouts;
+    SpillSpan convexHull;
+    osm2rdf::geometry::OrientedBox obb;
+  };
+
+  static void encode(const SpatialAreaData& value, Record* record,
+                     SpillDataWriter* writer) {
+    const auto& [geom, inner, outer, cutouts, convexHull] = value.geometry;
+    boost::geometry::assign_inverse(record->envelope);
+    for (const auto& box : value.envelopes) {
+      boost::geometry::expand(record->envelope, box);
+    }
+    record->id = value.id;
+    record->objId = value.objId;
+    record->area = value.area;
+    record->fromType = value.fromType;
+    record->envelopes = writer->array(value.envelopes);
+    record->geom = writer->multiPolygon(geom);
+    record->inner = writer->multiPolygon(inner);
+    record->outer = writer->multiPolygon(outer);
+    record->boxIds = writeBoxIds(value.boxIds, writer);
+    std::vector<Cutout> cutoutTable;
+    cutoutTable.reserve(cutouts.size());
+    for (const auto& [boxId, cutout] : cutouts) {
+      cutoutTable.push_back({boxId, writer->multiPolygon(cutout)});
+    }
+    record->cutouts = writer->array(cutoutTable);
+    record->convexHull = writer->polygon(convexHull);
+    record->obb = value.obb;
+  }
+
+  static void decode(const Record& record, const SpillDataReader& reader,
+                     SpatialAreaData* value) {
+    auto& [geom, inner, outer, cutouts, convexHull] = value->geometry;
+    value->id = static_cast<osm2rdf::osm::Area::id_t>(record.id);
+    value->objId = static_cast<osm2rdf::osm::Area::id_t>(record.objId);
+    value->area = record.area;
+    value->fromType = record.fromType;
+    reader.array<osm2rdf::geometry::Box>(record.envelopes, &value->envelopes);
+    reader.multiPolygon(record.geom, &geom);
+    reader.multiPolygon(record.inner, &inner);
+    reader.multiPolygon(record.outer, &outer);
+    readBoxIds(record.boxIds, reader, &value->boxIds);
+    cutouts.clear();
+    const auto* cutoutTable = reader.array<Cutout>(record.cutouts);
+    for (size_t i = 0; i < record.cutouts.count; ++i) {
+      reader.multiPolygon(cutoutTable[i].area,
+                          &cutouts[cutoutTable[i].boxId]);
+    }
+    reader.polygon(record.convexHull, &convexHull);
+    value->obb = record.obb;
+  }
+
+  static osm2rdf::geometry::Box envelope(const Record& record) {
+    return record.envelope;
+  }
+};
+
+}  // namespace osm2rdf::osm
+
+// ____________________________________________________________________________
+template <typename T>
+osm2rdf::osm::SegmentedSpill<T>::SegmentedSpill(const std::string& basePath) {
+#if defined(_OPENMP)
+  const auto numSegments = static_cast<size_t>(omp_get_max_threads());
+#else
+  const size_t numSegments = 1;
+#endif
+  _segments.reserve(numSegments);
+  for (size_t i = 0; i < numSegments; ++i) {
+    auto segment = std::make_unique<Segment>();
+    segment->path = basePath + "." + std::to_string(i);
+    segment->recordFile =
+        std::make_unique<osm2rdf::util::CacheFile>(segment->path + ".records");
+    segment->dataFile =
+        std::make_unique<osm2rdf::util::CacheFile>(segment->path + ".data");
+    // Unlink immediately to ensure removal at exit / crash.
+    segment->recordFile->remove();
+    segment->dataFile->remove();
+    _segments.push_back(std::move(segment));
+  }
+}
+
+// ____________________________________________________________________________
+template <typename T>
+osm2rdf::osm::SegmentedSpill<T>::~SegmentedSpill() {
+  for (auto& segment : _segments) {
+    unmap(segment.get());
+  }
+}
+
+// ____________________________________________________________________________
+template <typename T>
+void osm2rdf::osm::SegmentedSpill<T>::writeBuffer(
+    const osm2rdf::util::CacheFile& file, std::vector<uint8_t>* buffer,
+    uint64_t* fileSize) {
+  writeBytes(file, buffer->data(), buffer->size());
+  *fileSize += buffer->size();
+  buffer->clear();
+}
+
+// ____________________________________________________________________________
+template <typename T>
+void osm2rdf::osm::SegmentedSpill<T>::writeBytes(
+    const osm2rdf::util::CacheFile& file, const uint8_t* bytes, size_t size) {
+  size_t written = 0;
+  while (written < size) {
+    const auto result =
+        ::write(file.fileDescriptor(), bytes + written, size - written);
+    if (result < 0) {
+      throw std::system_error(errno, std::system_category(),
+                              "SegmentedSpill: write failed");
+    }
+    written += static_cast<size_t>(result);
+  }
+}
+
+// ____________________________________________________________________________
+template <typename T>
+const uint8_t* osm2rdf::osm::SegmentedSpill<T>::map(
+    const osm2rdf::util::CacheFile& file, uint64_t fileSize) {
+  void* bytes = ::mmap(nullptr, fileSize, PROT_READ, MAP_SHARED,
+                       file.fileDescriptor(), 0);
+  if (bytes == MAP_FAILED) {
+    throw std::system_error(errno, std::system_category(),
+                            "SegmentedSpill: mmap failed");
+  }
+  // Values are usually requested in ascending index ranges.
+  ::madvise(bytes, fileSize, MADV_SEQUENTIAL);
+  return static_cast<const uint8_t*>(bytes);
+}
+
+// ____________________________________________________________________________
+template <typename T>
+void osm2rdf::osm::SegmentedSpill<T>::unmap(Segment* segment) {
+  if (segment->records != nullptr) {
+    ::munmap(const_cast<uint8_t*>(segment->records), segment->recordFileSize);
+    segment->records = nullptr;
+  }
+  if (segment->data != nullptr) {
+    ::munmap(const_cast<uint8_t*>(segment->data), segment->dataFileSize);
+    segment->data = nullptr;
+  }
+}
+
+// ____________________________________________________________________________
+template <typename T>
+void osm2rdf::osm::SegmentedSpill<T>::write(const T& value) {
+#if defined(_OPENMP)
+  // Thread numbers are unique within the single parallel region used for
+  // conversion.
+  Segment& segment = *_segments[static_cast<size_t>(omp_get_thread_num()) %
+                                _segments.size()];
+#else
+  Segment& segment = *_segments[0];
+#endif
+  // Records are written as raw bytes, zero their padding.
+  typename SpillCodec<T>::Record record;
+  std::memset(static_cast<void*>(&record), 0, sizeof(record));
+  SpillDataWriter writer{&segment.dataBuffer, segment.dataFileSize};
+  SpillCodec<T>::encode(value, &record, &writer);
+  const auto* bytes = reinterpret_cast<const uint8_t*>(&record);
+  segment.recordBuffer.insert(segment.recordBuffer.end(), bytes,
+                              bytes + sizeof(record));
+  segment.count++;
+  if (segment.recordBuffer.size() >= WRITE_BUFFER_BYTES) {
+    writeBuffer(*segment.recordFile, &segment.recordBuffer,
+                &segment.recordFileSize);
+  }
+  if (segment.dataBuffer.size() >= WRITE_BUFFER_BYTES) {
+    writeBuffer(*segment.dataFile, &segment.dataBuffer, &segment.dataFileSize);
+  }
+}
+
+// ____________________________________________________________________________
+template <typename T>
+size_t osm2rdf::osm::SegmentedSpill<T>::size() const noexcept {
+  size_t size = 0;
+  for (const auto& segment : _segments) {
+    size += segment->count;
+  }
+  return size;
+}
+
+// ____________________________________________________________________________
+template <typename T>
+size_t osm2rdf::osm::SegmentedSpill<T>::bytes() const noexcept {
+  size_t bytes = 0;
+  for (const auto& segment : _segments) {
+    bytes += segment->recordFileSize + segment->recordBuffer.size() +
+             segment->dataFileSize + segment->dataBuffer.size();
+  }
+  return bytes;
+}
+
+// ____________________________________________________________________________
+template <typename T>
+void osm2rdf::osm::SegmentedSpill<T>::flush() {
+  _manifest.clear();
+  _manifestStarts.clear();
+  size_t start = 0;
+  for (auto& segment : _segments) {
+    unmap(segment.get());
+    writeBuffer(*segment->recordFile, &segment->recordBuffer,
+                &segment->recordFileSize);
+    writeBuffer(*segment->dataFile, &segment->dataBuffer,
+                &segment->dataFileSize);
+    if (segment->count == 0) {
+      continue;
+    }
+    segment->records = map(*segment->recordFile, segment->recordFileSize);
+    if (segment->dataFileSize > 0) {
+      segment->data = map(*segment->dataFile, segment->dataFileSize);
+    }
+    _manifest.push_back(segment.get());
+    _manifestStarts.push_back(start);
+    start += segment->count;
+  }
+}
+
+// ____________________________________________________________________________
+template <typename T>
+void osm2rdf::osm::SegmentedSpill<T>::sortSpatially() {
+  const size_t numSegments = _segments.size();
+#pragma omp parallel for default(none) shared(numSegments) schedule(dynamic)
+  for (size_t i = 0; i < numSegments; ++i) {
+    if (_segments[i]->records != nullptr) {
+      sortSegment(_segments[i].get());
+    }
+  }
+}
+
+// ____________________________________________________________________________
+template <typename T>
+void osm2rdf::osm::SegmentedSpill<T>::sortSegment(Segment* segment) {
+  using Record = typename SpillCodec<T>::Record;
+  struct KeyedRecord {
+    uint64_t key;
+    Record record;
+  };
+  const size_t runLength =
+      std::max<size_t>(1, SORT_RUN_BYTES / sizeof(KeyedRecord));
+  const auto* records = reinterpret_cast<const Record*>(segment->records);
+
+  // Sort runs of records in memory. Ties keep their order, so the complete
+  // sort is stable.
+  osm2rdf::util::CacheFile runFile(segment->path + ".runs");
+  runFile.remove();
+  uint64_t runFileSize = 0;
+  std::vector<size_t> runStarts;
+  std::vector<KeyedRecord> run;
+  run.reserve(std::min(runLength, segment->count));
+  for (size_t start = 0; start < segment->count; start += runLength) {
+    const size_t end = std::min(segment->count, start + runLength);
+    run.clear();
+    for (size_t i = start; i < end; ++i) {
+      run.push_back(
+          {spatialKey(SpillCodec<T>::envelope(records[i])), records[i]});
+    }
+    std::stable_sort(
+        run.begin(), run.end(),
+        [](const auto& a, const auto& b) { return a.key < b.key; });
+    runStarts.push_back(start);
+    writeBytes(runFile, reinterpret_cast<const uint8_t*>(run.data()),
+               run.size() * sizeof(KeyedRecord));
+    runFileSize += run.size() * sizeof(KeyedRecord);
+  }
+  runStarts.push_back(segment->count);
+
+  // Replace the record file by the merged runs.
+  ::munmap(const_cast<uint8_t*>(segment->records), segment->recordFileSize);
+  segment->records = nullptr;
+  const int fd = segment->recordFile->fileDescriptor();
+  if (::ftruncate(fd, 0) != 0 || ::lseek(fd, 0, SEEK_SET) != 0) {
+    throw std::system_error(errno, std::system_category(),
+                            "SegmentedSpill: truncate failed");
+  }
+  const auto* runs =
+      reinterpret_cast<const KeyedRecord*>(map(runFile, runFileSize));
+  // Merge with a heap of (key, run) pairs, the run breaks ties.
+  std::vector<size_t> positions(runStarts.begin(), runStarts.end() - 1);
+  std::priority_queue<std::pair<uint64_t, size_t>,
+                      std::vector<std::pair<uint64_t, size_t>>,
+                      std::greater<>>
+      heap;
+  for (size_t r = 0; r < positions.size(); ++r) {
+    heap.emplace(runs[positions[r]].key, r);
+  }
+  std::vector<uint8_t> buffer;
+  uint64_t recordFileSize = 0;
+  while (!heap.empty()) {
+    const size_t r = heap.top().second;
+    heap.pop();
+    const auto* bytes =
+        reinterpret_cast<const uint8_t*>(&runs[positions[r]].record);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(Record));
+    if (++positions[r] < runStarts[r + 1]) {
+      heap.emplace(runs[positions[r]].key, r);
+    }
+    if (buffer.size() >= WRITE_BUFFER_BYTES) {
+      writeBuffer(*segment->recordFile, &buffer, &recordFileSize);
+    }
+  }
+  writeBuffer(*segment->recordFile, &buffer, &recordFileSize);
+  ::munmap(const_cast<KeyedRecord*>(runs), runFileSize);
+  segment->recordFileSize = recordFileSize;
+  segment->records = map(*segment->recordFile, segment->recordFileSize);
+  // The data file keeps the write order, sorted records jump around in it.
+  if (segment->data != nullptr) {
+    ::madvise(const_cast<uint8_t*>(segment->data), segment->dataFileSize,
+              MADV_RANDOM);
+  }
+}
+
+// ____________________________________________________________________________
+template <typename T>
+void osm2rdf::osm::SegmentedSpill<T>::get(size_t index, T* value) const {
+  if (_manifest.empty() ||
+      index >= _manifestStarts.back() + _manifest.back()->count) {
+    throw std::out_of_range("SegmentedSpill: index out of range");
+  }
+  const auto segmentIndex = static_cast<size_t>(
+      std::upper_bound(_manifestStarts.begin(), _manifestStarts.end(), index) -
+      _manifestStarts.begin() - 1);
+  const Segment& segment = *_manifest[segmentIndex];
+  using Record = typename SpillCodec<T>::Record;
+  const auto* records = reinterpret_cast<const Record*>(segment.records);
+  SpillCodec<T>::decode(records[index - _manifestStarts[segmentIndex]],
+                        SpillDataReader{segment.data}, value);
+}
+
+// ____________________________________________________________________________
+template class osm2rdf::osm::SegmentedSpill<osm2rdf::osm::SpatialAreaData>;
+template class osm2rdf::osm::SegmentedSpill<osm2rdf::osm::SpatialNodeValue>;
+template class osm2rdf::osm::SegmentedSpill<osm2rdf::osm::SpatialWayValue>;
@@ -0,0 +1,66 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "osm2rdf/osm/SpatialQueryBuffer.h"
+
+#include <algorithm>
+
+// ____________________________________________________________________________
+void osm2rdf::osm::SpatialQueryBuffer::clear(size_t numAreas) {
+  const size_t numWords = (numAreas + 63) / 64;
+  if (seen.size() != numWords) {
+    seen.assign(numWords, 0);
+  }
+  refs.clear();
+  covers.clear();
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::SpatialQueryBuffer::unique() {
+  size_t numUnique = 0;
+  for (const auto& ref : refs) {
+    const uint64_t bit = 1ULL << (ref.second % 64);
+    auto& word = seen[ref.second / 64];
+    if ((word & bit) == 0) {
+      word |= bit;
+      refs[numUnique++] = ref;
+    }
+  }
+  refs.resize(numUnique);
+  // The kept areas are exactly the bits set above.
+  for (const auto& ref : refs) {
+    seen[ref.second / 64] = 0;
+  }
+
+  const auto greater = [](const auto& a, const auto& b) {
+    return a.second > b.second;
+  };
+  if (refs.size() > INSERTION_SORT_MAX) {
+    std::sort(refs.begin(), refs.end(), greater);
+    return;
+  }
+  for (size_t i = 1; i < refs.size(); ++i) {
+    const auto ref = refs[i];
+    size_t j = i;
+    for (; j > 0 && greater(ref, refs[j - 1]); --j) {
+      refs[j] = refs[j - 1];
+    }
+    refs[j] = ref;
+  }
+}
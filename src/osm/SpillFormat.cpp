@@ -0,0 +1,109 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/SpillFormat.h"
+
+using osm2rdf::geometry::Location;
+
+// Size of the fields in the polygon encoding.
+static const size_t WORD = sizeof(uint64_t);
+
+// ____________________________________________________________________________
+osm2rdf::osm::SpillDataWriter::SpillDataWriter(std::vector<uint8_t>* buffer,
+                                               uint64_t bufferOffset)
+    : _buffer(buffer), _bufferOffset(bufferOffset) {}
+
+// ____________________________________________________________________________
+uint64_t osm2rdf::osm::SpillDataWriter::align() {
+  while ((_bufferOffset + _buffer->size()) % WORD != 0) {
+    _buffer->push_back(0);
+  }
+  return _bufferOffset + _buffer->size();
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::SpillDataWriter::append(const void* data, size_t size) {
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  _buffer->insert(_buffer->end(), bytes, bytes + size);
+}
+
+// ____________________________________________________________________________
+osm2rdf::osm::SpillSpan osm2rdf::osm::SpillDataWriter::polygon(
+    const osm2rdf::geometry::Polygon& polygon) {
+  const uint64_t numRings = 1 + polygon.inners().size();
+  SpillSpan span{align(), numRings};
+  append(&numRings, WORD);
+  uint64_t ringSize = polygon.outer().size();
+  append(&ringSize, WORD);
+  for (const auto& inner : polygon.inners()) {
+    ringSize = inner.size();
+    append(&ringSize, WORD);
+  }
+  append(polygon.outer().data(), polygon.outer().size() * sizeof(Location));
+  for (const auto& inner : polygon.inners()) {
+    append(inner.data(), inner.size() * sizeof(Location));
+  }
+  return span;
+}
+
+// ____________________________________________________________________________
+osm2rdf::osm::SpillSpan osm2rdf::osm::SpillDataWriter::multiPolygon(
+    const osm2rdf::geometry::MultiPolygon& multiPolygon) {
+  SpillSpan span{align(), multiPolygon.size()};
+  for (const auto& polygon : multiPolygon) {
+    this->polygon(polygon);
+  }
+  return span;
+}
+
+// ____________________________________________________________________________
+const uint8_t* osm2rdf::osm::SpillDataReader::polygon(
+    const uint8_t* pos, osm2rdf::geometry::Polygon* out) const {
+  uint64_t numRings = 0;
+  std::memcpy(&numRings, pos, WORD);
+  const uint8_t* ringSizes = pos + WORD;
+  const auto* points =
+      reinterpret_cast<const Location*>(ringSizes + numRings * WORD);
+  out->inners().resize(numRings - 1);
+  for (uint64_t i = 0; i < numRings; ++i) {
+    uint64_t ringSize = 0;
+    std::memcpy(&ringSize, ringSizes + i * WORD, WORD);
+    auto& ring = i == 0 ? out->outer() : out->inners()[i - 1];
+    ring.assign(points, points + ringSize);
+    points += ringSize;
+  }
+  // Polygons are aligned like all other arrays.
+  const auto end = reinterpret_cast<uintptr_t>(points);
+  return reinterpret_cast<const uint8_t*>(end + (WORD - end % WORD) % WORD);
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::SpillDataReader::polygon(
+    const SpillSpan& span, osm2rdf::geometry::Polygon* out) const {
+  polygon(_data + span.offset, out);
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::SpillDataReader::multiPolygon(
+    const SpillSpan& span, osm2rdf::geometry::MultiPolygon* out) const {
+  out->resize(span.count);
+  const uint8_t* pos = _data + span.offset;
+  for (auto& polygon : *out) {
+    pos = this->polygon(pos, &polygon);
+  }
+}
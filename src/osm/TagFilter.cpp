@@ -0,0 +1,128 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/TagFilter.h"
+
+#include <string>
+
+// ____________________________________________________________________________
+osm2rdf::osm::TagFilter::TagFilter(const osm2rdf::config::Config& config) {
+  for (const auto& rule : config.includeTags) {
+    addRule(rule, &_include, &_includeTypes);
+  }
+  for (const auto& rule : config.excludeTags) {
+    addRule(rule, &_exclude, &_excludeTypes);
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::TagFilter::addRule(const std::string& rule, RuleMap* rules,
+                                      osmium::osm_entity_bits::type* types) {
+  std::string_view rest{rule};
+  osmium::osm_entity_bits::type ruleTypes = osmium::osm_entity_bits::nwr |
+                                            osmium::osm_entity_bits::area;
+  const auto slash = rest.find('/');
+  if (slash != std::string_view::npos) {
+    const std::string_view type = rest.substr(0, slash);
+    auto parsed = osmium::osm_entity_bits::nothing;
+    if (type == "node") {
+      parsed = osmium::osm_entity_bits::node;
+    } else if (type == "way") {
+      parsed = osmium::osm_entity_bits::way;
+    } else if (type == "relation") {
+      parsed = osmium::osm_entity_bits::relation;
+    } else if (type == "area") {
+      parsed = osmium::osm_entity_bits::area;
+    }
+    // Keys may contain slashes, only strip known types.
+    if (parsed != osmium::osm_entity_bits::nothing) {
+      ruleTypes = parsed;
+      rest = rest.substr(slash + 1);
+    }
+  }
+  Rule r{ruleTypes, ""};
+  const auto equal = rest.find('=');
+  if (equal != std::string_view::npos) {
+    r.value = std::string(rest.substr(equal + 1));
+    rest = rest.substr(0, equal);
+  }
+  if (rest.empty()) {
+    return;
+  }
+  _keys.emplace_back(rest);
+  (*rules)[_keys.back()].push_back(std::move(r));
+  *types |= ruleTypes;
+}
+
+// ____________________________________________________________________________
+bool osm2rdf::osm::TagFilter::empty() const noexcept {
+  return _include.empty() && _exclude.empty();
+}
+
+// ____________________________________________________________________________
+bool osm2rdf::osm::TagFilter::matches(const RuleMap& rules,
+                                      osmium::osm_entity_bits::type type,
+                                      const osmium::TagList& tags) noexcept {
+  for (const auto& tag : tags) {
+    const auto& it = rules.find(std::string_view{tag.key()});
+    if (it == rules.end()) {
+      continue;
+    }
+    for (const auto& rule : it->second) {
+      if ((rule.types & type) != 0 &&
+          (rule.value.empty() || rule.value == tag.value())) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// ____________________________________________________________________________
+bool osm2rdf::osm::TagFilter::accept(
+    osmium::osm_entity_bits::type type,
+    const osmium::TagList& tags) const noexcept {
+  if ((_includeTypes & type) != 0 && !matches(_include, type, tags)) {
+    return false;
+  }
+  if ((_excludeTypes & type) != 0 && matches(_exclude, type, tags)) {
+    return false;
+  }
+  return true;
+}
+
+// ____________________________________________________________________________
+bool osm2rdf::osm::TagFilter::area(const osmium::TagList& tags) const noexcept {
+  return accept(osmium::osm_entity_bits::area, tags);
+}
+
+// ____________________________________________________________________________
+bool osm2rdf::osm::TagFilter::node(const osmium::TagList& tags) const noexcept {
+  return accept(osmium::osm_entity_bits::node, tags);
+}
+
+// ____________________________________________________________________________
+bool osm2rdf::osm::TagFilter::relation(
+    const osmium::TagList& tags) const noexcept {
+  return accept(osmium::osm_entity_bits::relation, tags);
+}
+
+// ____________________________________________________________________________
+bool osm2rdf::osm::TagFilter::way(const osmium::TagList& tags) const noexcept {
+  return accept(osmium::osm_entity_bits::way, tags);
+}
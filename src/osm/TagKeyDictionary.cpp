@@ -0,0 +1,127 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/TagKeyDictionary.h"
+
+// Keep the table at most this full to bound the probe length.
+static const size_t MAX_SIZE =
+    osm2rdf::osm::TagKeyDictionary::CAPACITY / 10 * 9;
+
+// ____________________________________________________________________________
+osm2rdf::osm::TagKeyDictionary::TagKeyDictionary()
+    : _slots(std::make_unique<std::atomic<const std::string*>[]>(CAPACITY)) {}
+
+// ____________________________________________________________________________
+osm2rdf::osm::TagKeyDictionary::~TagKeyDictionary() {
+  for (size_t i = 0; i < CAPACITY; ++i) {
+    delete _slots[i].load();
+  }
+}
+
+// ____________________________________________________________________________
+osm2rdf::osm::TagKeyDictionary& osm2rdf::osm::TagKeyDictionary::instance() {
+  static TagKeyDictionary dictionary;
+  return dictionary;
+}
+
+// ____________________________________________________________________________
+size_t osm2rdf::osm::TagKeyDictionary::hash(std::string_view key) noexcept {
+  // FNV-1a
+  uint64_t hash = 14695981039346656037ULL;
+  for (const char c : key) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+// ____________________________________________________________________________
+osm2rdf::osm::TagKeyId osm2rdf::osm::TagKeyDictionary::find(
+    std::string_view key) const noexcept {
+  for (size_t slot = hash(key) % CAPACITY;; slot = (slot + 1) % CAPACITY) {
+    const std::string* stored = _slots[slot].load(std::memory_order_acquire);
+    if (stored == nullptr) {
+      return _hasOverflow.load(std::memory_order_acquire) ? findOverflow(key)
+                                                          : NOT_FOUND;
+    }
+    if (*stored == key) {
+      return slot;
+    }
+  }
+}
+
+// ____________________________________________________________________________
+osm2rdf::osm::TagKeyId osm2rdf::osm::TagKeyDictionary::intern(
+    std::string_view key) {
+  std::unique_ptr<std::string> candidate;
+  for (size_t slot = hash(key) % CAPACITY;; slot = (slot + 1) % CAPACITY) {
+    const std::string* stored = _slots[slot].load(std::memory_order_acquire);
+    if (stored == nullptr) {
+      if (candidate == nullptr) {
+        if (_size.load(std::memory_order_relaxed) >= MAX_SIZE) {
+          return internOverflow(key);
+        }
+        candidate = std::make_unique<std::string>(key);
+      }
+      if (_slots[slot].compare_exchange_strong(stored, candidate.get(),
+                                               std::memory_order_acq_rel)) {
+        candidate.release();
+        _size++;
+        return slot;
+      }
+      // Another thread filled the slot, stored now holds its key.
+    }
+    if (*stored == key) {
+      return slot;
+    }
+  }
+}
+
+// ____________________________________________________________________________
+osm2rdf::osm::TagKeyId osm2rdf::osm::TagKeyDictionary::internOverflow(
+    std::string_view key) {
+  std::lock_guard lock{_overflowMutex};
+  const auto it = _overflowIds.find(key);
+  if (it != _overflowIds.end()) {
+    return it->second;
+  }
+  const auto id = static_cast<TagKeyId>(NOT_FOUND + 1 + _overflowKeys.size());
+  // Deque elements never move, the map can view them.
+  _overflowKeys.emplace_back(key);
+  _overflowIds.emplace(_overflowKeys.back(), id);
+  _hasOverflow.store(true, std::memory_order_release);
+  return id;
+}
+
+// ____________________________________________________________________________
+osm2rdf::osm::TagKeyId osm2rdf::osm::TagKeyDictionary::findOverflow(
+    std::string_view key) const noexcept {
+  std::lock_guard lock{_overflowMutex};
+  const auto it = _overflowIds.find(key);
+  return it == _overflowIds.end() ? NOT_FOUND : it->second;
+}
+
+// ____________________________________________________________________________
+const std::string& osm2rdf::osm::TagKeyDictionary::key(
+    TagKeyId id) const noexcept {
+  if (id < CAPACITY) {
+    return *_slots[id].load(std::memory_order_acquire);
+  }
+  std::lock_guard lock{_overflowMutex};
+  return _overflowKeys[id - NOT_FOUND - 1];
+}
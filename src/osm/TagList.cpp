@@ -18,15 +18,107 @@
 
 #include "osm2rdf/osm/TagList.h"
 
+#include <algorithm>
+#include <stdexcept>
+
+#include "osm2rdf/osm/TagKeyDictionary.h"
 #include "osmium/tags/taglist.hpp"
 
+// ____________________________________________________________________________
+const std::string& osm2rdf::osm::TagList::Entry::key() const noexcept {
+  return osm2rdf::osm::TagKeyDictionary::instance().key(keyId);
+}
+
+// ____________________________________________________________________________
+bool osm2rdf::osm::TagList::Entry::operator==(
+    const osm2rdf::osm::TagList::Entry& other) const noexcept {
+  return keyId == other.keyId && value == other.value;
+}
+
+// ____________________________________________________________________________
+std::string& osm2rdf::osm::TagList::operator[](std::string_view key) {
+  const TagKeyId keyId = osm2rdf::osm::TagKeyDictionary::instance().intern(key);
+  auto it = std::lower_bound(
+      _entries.begin(), _entries.end(), keyId,
+      [](const Entry& entry, TagKeyId id) { return entry.keyId < id; });
+  if (it == _entries.end() || it->keyId != keyId) {
+    it = _entries.insert(it, Entry{keyId, ""});
+  }
+  return it->value;
+}
+
+// ____________________________________________________________________________
+osm2rdf::osm::TagList::const_iterator osm2rdf::osm::TagList::find(
+    std::string_view key) const noexcept {
+  const TagKeyId keyId = osm2rdf::osm::TagKeyDictionary::instance().find(key);
+  if (keyId == osm2rdf::osm::TagKeyDictionary::NOT_FOUND) {
+    return _entries.end();
+  }
+  const auto& it = std::lower_bound(
+      _entries.begin(), _entries.end(), keyId,
+      [](const Entry& entry, TagKeyId id) { return entry.keyId < id; });
+  if (it == _entries.end() || it->keyId != keyId) {
+    return _entries.end();
+  }
+  return it;
+}
+
+// ____________________________________________________________________________
+const std::string& osm2rdf::osm::TagList::at(std::string_view key) const {
+  const auto& it = find(key);
+  if (it == _entries.end()) {
+    throw std::out_of_range("TagList::at");
+  }
+  return it->value;
+}
+
+// ____________________________________________________________________________
+size_t osm2rdf::osm::TagList::count(std::string_view key) const noexcept {
+  return find(key) == _entries.end() ? 0 : 1;
+}
+
+// ____________________________________________________________________________
+size_t osm2rdf::osm::TagList::size() const noexcept { return _entries.size(); }
+
+// ____________________________________________________________________________
+bool osm2rdf::osm::TagList::empty() const noexcept { return _entries.empty(); }
+
+// ____________________________________________________________________________
+void osm2rdf::osm::TagList::reserve(size_t size) { _entries.reserve(size); }
+
+// ____________________________________________________________________________
+osm2rdf::osm::TagList::const_iterator osm2rdf::osm::TagList::begin()
+    const noexcept {
+  return _entries.begin();
+}
+
+// ____________________________________________________________________________
+osm2rdf::osm::TagList::const_iterator osm2rdf::osm::TagList::end()
+    const noexcept {
+  return _entries.end();
+}
+
+// ____________________________________________________________________________
+bool osm2rdf::osm::TagList::operator==(
+    const osm2rdf::osm::TagList& other) const noexcept {
+  return _entries == other._entries;
+}
+
+// ____________________________________________________________________________
+bool osm2rdf::osm::TagList::operator!=(
+    const osm2rdf::osm::TagList& other) const noexcept {
+  return !(*this == other);
+}
+
 // ____________________________________________________________________________
 osm2rdf::osm::TagList osm2rdf::osm::convertTagList(
     const osmium::TagList& tagList) {
   osm2rdf::osm::TagList result;
+  result.reserve(tagList.size());
 
+  std::string key;
   for (const auto& tag : tagList) {
-    std::string key{tag.key()};
+    key = tag.key();
     for (size_t pos = 0; pos < key.size(); ++pos) {
       switch (key[pos]) {
         case ' ':
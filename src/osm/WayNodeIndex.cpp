@@ -0,0 +1,176 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/WayNodeIndex.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <numeric>
+#include <system_error>
+
+#include "osm2rdf/util/Varint.h"
+
+// Spilled node ids are written to disk in chunks of this size.
+static const size_t WRITE_BUFFER_BYTES = 1U << 20U;
+
+// ____________________________________________________________________________
+osm2rdf::osm::WayNodeIndex::NodeRefs::iterator::iterator(const uint8_t* pos,
+                                                         uint64_t remaining)
+    : _pos(pos), _remaining(remaining) {
+  if (_remaining > 0) {
+    _value = static_cast<uint64_t>(
+        osm2rdf::util::zigzagDecode(osm2rdf::util::readVarint(&_pos)));
+  }
+}
+
+// ____________________________________________________________________________
+osm2rdf::osm::WayNodeIndex::NodeRefs::iterator&
+osm2rdf::osm::WayNodeIndex::NodeRefs::iterator::operator++() {
+  --_remaining;
+  if (_remaining > 0) {
+    _value += static_cast<uint64_t>(
+        osm2rdf::util::zigzagDecode(osm2rdf::util::readVarint(&_pos)));
+  }
+  return *this;
+}
+
+// ____________________________________________________________________________
+osm2rdf::osm::WayNodeIndex::NodeRefs::iterator
+osm2rdf::osm::WayNodeIndex::NodeRefs::iterator::operator++(int) {
+  iterator old = *this;
+  ++(*this);
+  return old;
+}
+
+// ____________________________________________________________________________
+osm2rdf::osm::WayNodeIndex::~WayNodeIndex() {
+  if (_mapped != nullptr) {
+    ::munmap(const_cast<uint8_t*>(_mapped), _dataSize);
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::WayNodeIndex::spillTo(const std::filesystem::path& path) {
+  _spillFile = std::make_unique<osm2rdf::util::CacheFile>(path);
+  _data.reserve(WRITE_BUFFER_BYTES);
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::WayNodeIndex::add(uint64_t wayId,
+                                     const osmium::WayNodeList& nodes) {
+  _wayIds.push_back(wayId);
+  _offsets.push_back(_dataSize);
+  const size_t before = _data.size();
+  osm2rdf::util::writeVarint(&_data, nodes.size());
+  uint64_t last = 0;
+  for (const auto& nodeRef : nodes) {
+    const uint64_t id = nodeRef.positive_ref();
+    osm2rdf::util::writeVarint(
+        &_data, osm2rdf::util::zigzagEncode(static_cast<int64_t>(id - last)));
+    last = id;
+  }
+  _dataSize += _data.size() - before;
+  if (_spillFile != nullptr && _data.size() >= WRITE_BUFFER_BYTES) {
+    flushWriteBuffer();
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::WayNodeIndex::flushWriteBuffer() {
+  size_t written = 0;
+  while (written < _data.size()) {
+    const auto result = ::write(_spillFile->fileDescriptor(),
+                                _data.data() + written, _data.size() - written);
+    if (result < 0) {
+      throw std::system_error(errno, std::system_category(),
+                              "WayNodeIndex: write failed");
+    }
+    written += static_cast<size_t>(result);
+  }
+  _data.clear();
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::WayNodeIndex::finalize() {
+  std::call_once(_finalized, &WayNodeIndex::doFinalize, this);
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::WayNodeIndex::doFinalize() {
+  // Ways are usually added in ascending order, only sort if needed.
+  if (!std::is_sorted(_wayIds.begin(), _wayIds.end())) {
+    std::vector<size_t> order(_wayIds.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+      return _wayIds[a] < _wayIds[b];
+    });
+    std::vector<uint64_t> wayIds(order.size());
+    std::vector<uint64_t> offsets(order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+      wayIds[i] = _wayIds[order[i]];
+      offsets[i] = _offsets[order[i]];
+    }
+    _wayIds = std::move(wayIds);
+    _offsets = std::move(offsets);
+  }
+  _wayIds.shrink_to_fit();
+  _offsets.shrink_to_fit();
+
+  if (_spillFile == nullptr) {
+    _data.shrink_to_fit();
+    return;
+  }
+  flushWriteBuffer();
+  _data.shrink_to_fit();
+  if (_dataSize > 0) {
+    void* mapped = ::mmap(nullptr, _dataSize, PROT_READ, MAP_SHARED,
+                          _spillFile->fileDescriptor(), 0);
+    if (mapped == MAP_FAILED) {
+      throw std::system_error(errno, std::system_category(),
+                              "WayNodeIndex: mmap failed");
+    }
+    ::madvise(mapped, _dataSize, MADV_RANDOM);
+    _mapped = static_cast<const uint8_t*>(mapped);
+  }
+}
+
+// ____________________________________________________________________________
+osm2rdf::osm::WayNodeIndex::NodeRefs osm2rdf::osm::WayNodeIndex::get(
+    uint64_t wayId) const {
+  const auto it = std::lower_bound(_wayIds.begin(), _wayIds.end(), wayId);
+  if (it == _wayIds.end() || *it != wayId) {
+    return NodeRefs{};
+  }
+  const uint8_t* pos =
+      (_spillFile == nullptr ? _data.data() : _mapped) +
+      _offsets[static_cast<size_t>(it - _wayIds.begin())];
+  const uint64_t size = osm2rdf::util::readVarint(&pos);
+  return NodeRefs{pos, size};
+}
+
+// ____________________________________________________________________________
+size_t osm2rdf::osm::WayNodeIndex::size() const noexcept {
+  return _wayIds.size();
+}
+
+// ____________________________________________________________________________
+uint64_t osm2rdf::osm::WayNodeIndex::dataSize() const noexcept {
+  return _dataSize;
+}
@@ -0,0 +1,99 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/WayView.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "boost/geometry.hpp"
+#include "osm2rdf/geometry/Box.h"
+#include "osm2rdf/geometry/Polygon.h"
+#include "osm2rdf/geometry/Way.h"
+#include "osm2rdf/osm/Generic.h"
+#include "osmium/osm/way.hpp"
+
+using osm2rdf::geometry::Location;
+
+// ____________________________________________________________________________
+osm2rdf::osm::WayView::WayView(const osmium::Way& way) : _way(&way) {}
+
+// ____________________________________________________________________________
+osm2rdf::osm::Way::id_t osm2rdf::osm::WayView::id() const noexcept {
+  return _way->positive_id();
+}
+
+// ____________________________________________________________________________
+bool osm2rdf::osm::WayView::closed() const noexcept {
+  const auto& nodes = _way->nodes();
+  return !nodes.empty() &&
+         nodes.front().location() == nodes.back().location();
+}
+
+// ____________________________________________________________________________
+const osmium::WayNodeList& osm2rdf::osm::WayView::nodes() const noexcept {
+  return _way->nodes();
+}
+
+// ____________________________________________________________________________
+const osmium::TagList& osm2rdf::osm::WayView::tags() const noexcept {
+  return _way->tags();
+}
+
+// ____________________________________________________________________________
+osm2rdf::geometry::Way osm2rdf::osm::WayView::geom() const {
+  osm2rdf::geometry::Way geom;
+  geom.reserve(_way->nodes().size());
+  for (const auto& nodeRef : _way->nodes()) {
+    // implicit boost::geometry::unique
+    if (geom.empty() || (nodeRef.lon() != geom.back().get<0>() ||
+                         nodeRef.lat() != geom.back().get<1>())) {
+      boost::geometry::append(geom, Location{nodeRef.lon(), nodeRef.lat()});
+    }
+  }
+  return geom;
+}
+
+// ____________________________________________________________________________
+osm2rdf::geometry::Box osm2rdf::osm::WayView::envelope() const {
+  double lonMin = std::numeric_limits<double>::infinity();
+  double latMin = std::numeric_limits<double>::infinity();
+  double lonMax = -std::numeric_limits<double>::infinity();
+  double latMax = -std::numeric_limits<double>::infinity();
+  for (const auto& nodeRef : _way->nodes()) {
+    lonMin = std::min(lonMin, nodeRef.lon());
+    latMin = std::min(latMin, nodeRef.lat());
+    lonMax = std::max(lonMax, nodeRef.lon());
+    latMax = std::max(latMax, nodeRef.lat());
+  }
+  return osm2rdf::geometry::Box({lonMin, latMin}, {lonMax, latMax});
+}
+
+// ____________________________________________________________________________
+osm2rdf::geometry::Polygon osm2rdf::osm::WayView::convexHull(
+    const osm2rdf::geometry::Way& geom) {
+  osm2rdf::geometry::Polygon convexHull;
+  boost::geometry::convex_hull(geom, convexHull);
+  return convexHull;
+}
+
+// ____________________________________________________________________________
+osm2rdf::geometry::Polygon osm2rdf::osm::WayView::orientedBoundingBox(
+    const osm2rdf::geometry::Polygon& convexHull) {
+  return osm2rdf::osm::generic::orientedBoundingBoxFromConvexHull(convexHull);
+}
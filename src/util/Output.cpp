@@ -19,6 +19,7 @@
 #include <cmath>
 #include <cstdio>
 #include <iostream>
+#include <string>
 
 #include "boost/iostreams/filter/bzip2.hpp"
 #include "boost/iostreams/filtering_stream.hpp"
@@ -26,6 +27,16 @@
 #include "osm2rdf/config/Config.h"
 #include "osm2rdf/util/Output.h"
 
+// ____________________________________________________________________________
+// Append the remaining content of in to out. Unlike operator<<, an empty input
+// does not set the failbit of out, which would drop all following writes.
+template <typename I, typename O>
+static void append(I* in, O* out) {
+  if (in->peek() != std::char_traits<char>::eof()) {
+    *out << in->rdbuf();
+  }
+}
+
 // ____________________________________________________________________________
 osm2rdf::util::Output::Output(const osm2rdf::config::Config& config,
                               const std::string& prefix)
@@ -195,7 +206,7 @@ void osm2rdf::util::Output::concatenate() {
   if (!inFilePrefix.is_open() || !inFilePrefix.good()) {
     std::cerr << "Error opening file: " << filename << std::endl;
   }
-  _outFile << inFilePrefix.rdbuf();
+  append(&inFilePrefix, &_outFile);
   inFilePrefix.close();
   if (!_config.outputKeepFiles) {
     std::filesystem::remove(filename);
@@ -208,7 +219,7 @@ void osm2rdf::util::Output::concatenate() {
     if (!inFile.is_open() || !inFile.good()) {
       std::cerr << "Error opening file: " << filename << std::endl;
     }
-    _outFile << inFile.rdbuf();
+    append(&inFile, &_outFile);
     inFile.close();
     if (!_config.outputKeepFiles) {
       std::filesystem::remove(filename);
@@ -222,7 +233,7 @@ void osm2rdf::util::Output::concatenate() {
   if (!inFileSuffix.is_open() || !inFileSuffix.good()) {
     std::cerr << "Error opening file: " << filename << std::endl;
   }
-  _outFile << inFileSuffix.rdbuf();
+  append(&inFileSuffix, &_outFile);
   inFileSuffix.close();
   if (!_config.outputKeepFiles) {
     std::filesystem::remove(filename);
@@ -248,7 +259,7 @@ void osm2rdf::util::Output::merge() {
     std::cerr << "Error opening file: " << filename << std::endl;
   }
   in.push(inFile);
-  out << in.rdbuf();
+  append(&in, &out);
   in.pop();
   inFile.close();
   if (!_config.outputKeepFiles) {
@@ -263,7 +274,7 @@ void osm2rdf::util::Output::merge() {
       std::cerr << "Error opening file: " << filename << std::endl;
     }
     in.push(inFile);
-    out << in.rdbuf();
+    append(&in, &out);
     in.pop();
     inFile.close();
     if (!_config.outputKeepFiles) {
@@ -277,7 +288,7 @@ void osm2rdf::util::Output::merge() {
     std::cerr << "Error opening file: " << filename << std::endl;
   }
   in.push(inFile);
-  out << in.rdbuf();
+  append(&in, &out);
   in.pop();
   inFile.close();
   if (!_config.outputKeepFiles) {
@@ -0,0 +1,94 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/util/RankBitmap.h"
+
+#include <algorithm>
+
+static const uint64_t BITS_PER_WORD = 64;
+static const uint64_t WORDS_PER_BLOCK =
+    osm2rdf::util::RankBitmap::BITS_PER_BLOCK / BITS_PER_WORD;
+
+// ____________________________________________________________________________
+void osm2rdf::util::RankBitmap::set(uint64_t i) {
+  const uint64_t word = i / BITS_PER_WORD;
+  if (word >= _words.size()) {
+    // Grow geometrically, ids arrive mostly sorted.
+    _words.resize(std::max(word + 1, _words.size() + _words.size() / 2), 0);
+  }
+  _words[word] |= (1ULL << (i % BITS_PER_WORD));
+  _blockRanks.clear();
+}
+
+// ____________________________________________________________________________
+bool osm2rdf::util::RankBitmap::test(uint64_t i) const noexcept {
+  const uint64_t word = i / BITS_PER_WORD;
+  return word < _words.size() &&
+         (_words[word] & (1ULL << (i % BITS_PER_WORD))) != 0;
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::RankBitmap::prepareRank() {
+  // Pad to full blocks, so rank never reads past the end.
+  _words.resize((_words.size() + WORDS_PER_BLOCK - 1) / WORDS_PER_BLOCK *
+                    WORDS_PER_BLOCK,
+                0);
+  _words.shrink_to_fit();
+  _blockRanks.clear();
+  _blockRanks.reserve(_words.size() / WORDS_PER_BLOCK + 1);
+  uint64_t rank = 0;
+  for (uint64_t word = 0; word < _words.size(); ++word) {
+    if (word % WORDS_PER_BLOCK == 0) {
+      _blockRanks.push_back(rank);
+    }
+    rank += __builtin_popcountll(_words[word]);
+  }
+  _blockRanks.push_back(rank);
+}
+
+// ____________________________________________________________________________
+uint64_t osm2rdf::util::RankBitmap::rank(uint64_t i) const noexcept {
+  if (_blockRanks.empty()) {
+    // Not prepared, or invalidated by set().
+    return 0;
+  }
+  const uint64_t block = i / BITS_PER_BLOCK;
+  if (block >= _blockRanks.size() - 1) {
+    return _blockRanks.back();
+  }
+  uint64_t rank = _blockRanks[block];
+  const uint64_t lastWord = i / BITS_PER_WORD;
+  for (uint64_t word = block * WORDS_PER_BLOCK; word < lastWord; ++word) {
+    rank += __builtin_popcountll(_words[word]);
+  }
+  const uint64_t bit = i % BITS_PER_WORD;
+  if (bit > 0) {
+    rank += __builtin_popcountll(_words[lastWord] & ((1ULL << bit) - 1));
+  }
+  return rank;
+}
+
+// ____________________________________________________________________________
+uint64_t osm2rdf::util::RankBitmap::count() const noexcept {
+  return _blockRanks.empty() ? 0 : _blockRanks.back();
+}
+
+// ____________________________________________________________________________
+uint64_t osm2rdf::util::RankBitmap::memoryUsage() const noexcept {
+  return (_words.capacity() + _blockRanks.capacity()) * sizeof(uint64_t);
+}
@@ -33,6 +33,10 @@ void assertDefaultConfig(const osm2rdf::config::Config& config) {
   ASSERT_FALSE(config.noFacts);
   ASSERT_FALSE(config.noGeometricRelations);
   ASSERT_TRUE(config.storeLocationsOnDisk.empty());
+  ASSERT_FALSE(config.storeNeededLocationsOnly);
+  ASSERT_FALSE(config.storeWayNodesOnDisk);
+  ASSERT_FALSE(config.relationCache);
+  ASSERT_EQ(1024, config.maxInFlightMB);
 
   ASSERT_FALSE(config.noAreaFacts);
   ASSERT_FALSE(config.noNodeFacts);
@@ -65,12 +69,16 @@ void assertDefaultConfig(const osm2rdf::config::Config& config) {
   ASSERT_FALSE(config.skipWikiLinks);
 
   ASSERT_EQ(0, config.semicolonTagKeys.size());
+  ASSERT_EQ(0, config.includeTags.size());
+  ASSERT_EQ(0, config.excludeTags.size());
 
   ASSERT_FALSE(config.writeDAGDotFiles);
 
   ASSERT_FALSE(config.writeRDFStatistics);
 
   ASSERT_EQ(0, config.simplifyGeometries);
+  ASSERT_EQ(13, config.boxIdGridLevels);
+  ASSERT_EQ(0, config.nodeGridLevels);
   ASSERT_EQ(250, config.simplifyWKT);
   ASSERT_EQ(5, config.wktDeviation);
   ASSERT_EQ(7, config.wktPrecision);
@@ -463,6 +471,110 @@ TEST(CONFIG_Config, fromArgsStoreLocationsOnDiskLongDense) {
   ASSERT_EQ("dense", config.storeLocationsOnDisk);
 }
 
+// ____________________________________________________________________________
+TEST(CONFIG_Config, fromArgsStoreLocationsOnDiskLongCompressed) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  osm2rdf::util::CacheFile cf("/tmp/dummyInput");
+
+  const auto arg = "--" +
+                   osm2rdf::config::constants::STORE_LOCATIONS_ON_DISK_LONG +
+                   "=compressed";
+  const int argc = 3;
+  char* argv[argc] = {const_cast<char*>(""), const_cast<char*>(arg.c_str()),
+                      const_cast<char*>("/tmp/dummyInput")};
+  config.fromArgs(argc, argv);
+  ASSERT_EQ("", config.output.string());
+  ASSERT_EQ("compressed", config.storeLocationsOnDisk);
+}
+
+// ____________________________________________________________________________
+TEST(CONFIG_Config, fromArgsStoreNeededLocationsOnlyLong) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  osm2rdf::util::CacheFile cf("/tmp/dummyInput");
+
+  const auto arg =
+      "--" +
+      osm2rdf::config::constants::STORE_NEEDED_LOCATIONS_ONLY_OPTION_LONG;
+  const int argc = 3;
+  char* argv[argc] = {const_cast<char*>(""), const_cast<char*>(arg.c_str()),
+                      const_cast<char*>("/tmp/dummyInput")};
+  config.fromArgs(argc, argv);
+  ASSERT_EQ("", config.output.string());
+  ASSERT_TRUE(config.storeNeededLocationsOnly);
+}
+
+// ____________________________________________________________________________
+TEST(CONFIG_Config, fromArgsStoreNeededLocationsOnlyOnDisk) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  osm2rdf::util::CacheFile cf("/tmp/dummyInput");
+
+  const auto arg1 =
+      "--" +
+      osm2rdf::config::constants::STORE_NEEDED_LOCATIONS_ONLY_OPTION_LONG;
+  const auto arg2 =
+      "--" + osm2rdf::config::constants::STORE_LOCATIONS_ON_DISK_LONG;
+  const int argc = 4;
+  char* argv[argc] = {const_cast<char*>(""), const_cast<char*>(arg1.c_str()),
+                      const_cast<char*>(arg2.c_str()),
+                      const_cast<char*>("/tmp/dummyInput")};
+  ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+  ASSERT_EXIT(config.fromArgs(argc, argv),
+              ::testing::ExitedWithCode(osm2rdf::config::ExitCode::FAILURE),
+              "^Storing needed locations only can not be combined with "
+              "storing locations on disk");
+}
+
+// ____________________________________________________________________________
+TEST(CONFIG_Config, fromArgsStoreWayNodesOnDiskLong) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  osm2rdf::util::CacheFile cf("/tmp/dummyInput");
+
+  const auto arg =
+      "--" + osm2rdf::config::constants::STORE_WAY_NODES_ON_DISK_OPTION_LONG;
+  const int argc = 3;
+  char* argv[argc] = {const_cast<char*>(""), const_cast<char*>(arg.c_str()),
+                      const_cast<char*>("/tmp/dummyInput")};
+  config.fromArgs(argc, argv);
+  ASSERT_EQ("", config.output.string());
+  ASSERT_TRUE(config.storeWayNodesOnDisk);
+}
+
+// ____________________________________________________________________________
+TEST(CONFIG_Config, fromArgsRelationCacheLong) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  osm2rdf::util::CacheFile cf("/tmp/dummyInput");
+
+  const auto arg = "--" + osm2rdf::config::constants::RELATION_CACHE_OPTION_LONG;
+  const int argc = 3;
+  char* argv[argc] = {const_cast<char*>(""), const_cast<char*>(arg.c_str()),
+                      const_cast<char*>("/tmp/dummyInput")};
+  config.fromArgs(argc, argv);
+  ASSERT_EQ("", config.output.string());
+  ASSERT_TRUE(config.relationCache);
+}
+
+// ____________________________________________________________________________
+TEST(CONFIG_Config, fromArgsMaxInFlightMBLong) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  osm2rdf::util::CacheFile cf("/tmp/dummyInput");
+
+  const auto arg = "--" +
+                   osm2rdf::config::constants::MAX_IN_FLIGHT_MB_OPTION_LONG +
+                   "=64";
+  const int argc = 3;
+  char* argv[argc] = {const_cast<char*>(""), const_cast<char*>(arg.c_str()),
+                      const_cast<char*>("/tmp/dummyInput")};
+  config.fromArgs(argc, argv);
+  ASSERT_EQ("", config.output.string());
+  ASSERT_EQ(64, config.maxInFlightMB);
+}
+
 // ____________________________________________________________________________
 TEST(CONFIG_Config, fromArgsNoAreasLong) {
   osm2rdf::config::Config config;
@@ -988,6 +1100,98 @@ TEST(CONFIG_Config, fromArgsSimplifyGeometriesLong) {
   ASSERT_EQ(25, config.simplifyGeometries);
 }
 
+// ____________________________________________________________________________
+TEST(CONFIG_Config, fromArgsBoxIdGridLevelsLong) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  osm2rdf::util::CacheFile cf("/tmp/dummyInput");
+
+  const auto arg = "--" +
+                   osm2rdf::config::constants::BOX_ID_GRID_LEVELS_OPTION_LONG +
+                   "=10";
+  const int argc = 3;
+  char* argv[argc] = {const_cast<char*>(""), const_cast<char*>(arg.c_str()),
+                      const_cast<char*>("/tmp/dummyInput")};
+  config.fromArgs(argc, argv);
+  ASSERT_EQ(10, config.boxIdGridLevels);
+}
+
+// ____________________________________________________________________________
+TEST(CONFIG_Config, fromArgsBoxIdGridLevelsInvalid) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  osm2rdf::util::CacheFile cf("/tmp/dummyInput");
+
+  const auto arg = "--" +
+                   osm2rdf::config::constants::BOX_ID_GRID_LEVELS_OPTION_LONG +
+                   "=16";
+  const int argc = 3;
+  char* argv[argc] = {const_cast<char*>(""), const_cast<char*>(arg.c_str()),
+                      const_cast<char*>("/tmp/dummyInput")};
+  ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+  ASSERT_EXIT(config.fromArgs(argc, argv),
+              ::testing::ExitedWithCode(osm2rdf::config::ExitCode::FAILURE),
+              "^Box id grid levels must be between 1 and 15: 16");
+}
+
+// ____________________________________________________________________________
+TEST(CONFIG_Config, fromArgsNodeGridLevelsLong) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  osm2rdf::util::CacheFile cf("/tmp/dummyInput");
+
+  const auto arg = "--" +
+                   osm2rdf::config::constants::NODE_GRID_LEVELS_OPTION_LONG +
+                   "=10";
+  const int argc = 3;
+  char* argv[argc] = {const_cast<char*>(""), const_cast<char*>(arg.c_str()),
+                      const_cast<char*>("/tmp/dummyInput")};
+  config.fromArgs(argc, argv);
+  ASSERT_EQ(10, config.nodeGridLevels);
+}
+
+// ____________________________________________________________________________
+TEST(CONFIG_Config, fromArgsNodeGridLevelsInvalid) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  osm2rdf::util::CacheFile cf("/tmp/dummyInput");
+
+  const auto arg = "--" +
+                   osm2rdf::config::constants::NODE_GRID_LEVELS_OPTION_LONG +
+                   "=14";
+  const int argc = 3;
+  char* argv[argc] = {const_cast<char*>(""), const_cast<char*>(arg.c_str()),
+                      const_cast<char*>("/tmp/dummyInput")};
+  ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+  ASSERT_EXIT(
+      config.fromArgs(argc, argv),
+      ::testing::ExitedWithCode(osm2rdf::config::ExitCode::FAILURE),
+      "^Node grid levels must be at most the box id grid levels: 14");
+}
+
+// ____________________________________________________________________________
+TEST(CONFIG_Config, fromArgsNodeGridLevelsTooLarge) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  osm2rdf::util::CacheFile cf("/tmp/dummyInput");
+
+  const auto boxIdArg =
+      "--" + osm2rdf::config::constants::BOX_ID_GRID_LEVELS_OPTION_LONG +
+      "=15";
+  const auto arg = "--" +
+                   osm2rdf::config::constants::NODE_GRID_LEVELS_OPTION_LONG +
+                   "=13";
+  const int argc = 4;
+  char* argv[argc] = {const_cast<char*>(""),
+                      const_cast<char*>(boxIdArg.c_str()),
+                      const_cast<char*>(arg.c_str()),
+                      const_cast<char*>("/tmp/dummyInput")};
+  ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+  ASSERT_EXIT(config.fromArgs(argc, argv),
+              ::testing::ExitedWithCode(osm2rdf::config::ExitCode::FAILURE),
+              "^Node grid levels must be at most 12: 13");
+}
+
 // ____________________________________________________________________________
 TEST(CONFIG_Config, fromArgsSimplifyWKTLong) {
   osm2rdf::config::Config config;
@@ -1076,6 +1280,34 @@ TEST(CONFIG_Config, fromArgsSemicolonTagKeysMultipleLong) {
   ASSERT_EQ(1, config.semicolonTagKeys.count("ref2"));
 }
 
+// ____________________________________________________________________________
+TEST(CONFIG_Config, fromArgsIncludeExcludeTagsLong) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  osm2rdf::util::CacheFile cf("/tmp/dummyInput");
+
+  const auto include =
+      "--" + osm2rdf::config::constants::INCLUDE_TAGS_OPTION_LONG;
+  const auto exclude =
+      "--" + osm2rdf::config::constants::EXCLUDE_TAGS_OPTION_LONG;
+  const int argc = 8;
+  char* argv[argc] = {const_cast<char*>(""),
+                      const_cast<char*>(include.c_str()),
+                      const_cast<char*>("amenity"),
+                      const_cast<char*>(include.c_str()),
+                      const_cast<char*>("way/highway=path"),
+                      const_cast<char*>(exclude.c_str()),
+                      const_cast<char*>("amenity=bench"),
+                      const_cast<char*>("/tmp/dummyInput")};
+  config.fromArgs(argc, argv);
+  ASSERT_EQ("", config.output.string());
+  ASSERT_EQ(2, config.includeTags.size());
+  ASSERT_EQ("amenity", config.includeTags[0]);
+  ASSERT_EQ("way/highway=path", config.includeTags[1]);
+  ASSERT_EQ(1, config.excludeTags.size());
+  ASSERT_EQ("amenity=bench", config.excludeTags[0]);
+}
+
 // ____________________________________________________________________________
 TEST(CONFIG_Config, fromArgsWriteRDFRelationStatisticsLong) {
   osm2rdf::config::Config config;
@@ -0,0 +1,217 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/geometry/BoxClipper.h"
+
+#include <cmath>
+#include <random>
+
+#include "boost/geometry.hpp"
+#include "gtest/gtest.h"
+
+namespace osm2rdf::geometry {
+
+namespace {
+
+Polygon polygon(const Ring& outer, const std::vector<Ring>& inners = {}) {
+  Polygon result;
+  result.outer() = outer;
+  result.inners() = inners;
+  boost::geometry::correct(result);
+  return result;
+}
+
+// Check a clipped area against boost::geometry::intersection.
+void assertSameAsBoost(const Area& area, const Box& box) {
+  const Area clipped = BoxClipper{box}.clip(area);
+  Area expected;
+  boost::geometry::intersection(area, box, expected);
+  std::string reason;
+  ASSERT_TRUE(boost::geometry::is_valid(clipped, reason)) << reason;
+  const double expectedArea = boost::geometry::area(expected);
+  const double tolerance = 1e-6 * std::max(1.0, expectedArea);
+  ASSERT_EQ(expected.size(), clipped.size());
+  ASSERT_NEAR(expectedArea, boost::geometry::area(clipped), tolerance);
+  Area difference;
+  boost::geometry::sym_difference(clipped, expected, difference);
+  ASSERT_NEAR(0, boost::geometry::area(difference), tolerance);
+}
+
+}  // namespace
+
+// ____________________________________________________________________________
+TEST(GEOMETRY_BoxClipper, insideAndOutside) {
+  const Box box{{0, 0}, {10, 10}};
+  const Polygon inside = polygon({{2, 2}, {2, 8}, {8, 8}, {8, 2}, {2, 2}});
+  const Area clipped = BoxClipper{box}.clip(Area{inside});
+  ASSERT_EQ(1, clipped.size());
+  ASSERT_TRUE(boost::geometry::equals(inside, clipped[0]));
+
+  ASSERT_TRUE(BoxClipper{box}
+                  .clip(Area{polygon(
+                      {{20, 20}, {20, 30}, {30, 30}, {30, 20}, {20, 20}})})
+                  .empty());
+
+  // The box lies inside the polygon.
+  const Area covering{
+      polygon({{-10, -10}, {-10, 20}, {20, 20}, {20, -10}, {-10, -10}})};
+  assertSameAsBoost(covering, box);
+  ASSERT_EQ(100, boost::geometry::area(BoxClipper{box}.clip(covering)));
+}
+
+// ____________________________________________________________________________
+TEST(GEOMETRY_BoxClipper, splitsConcavePolygons) {
+  // A U whose arms cross the box.
+  const Area u{polygon({{0, 0},
+                        {0, 30},
+                        {10, 30},
+                        {10, 10},
+                        {20, 10},
+                        {20, 30},
+                        {30, 30},
+                        {30, 0},
+                        {0, 0}})};
+  const Box box{{-5, 20}, {35, 25}};
+  const Area clipped = BoxClipper{box}.clip(u);
+  ASSERT_EQ(2, clipped.size());
+  assertSameAsBoost(u, box);
+  assertSameAsBoost(u, Box{{5, 5}, {25, 35}});
+  assertSameAsBoost(u, Box{{12, 12}, {18, 40}});
+}
+
+// ____________________________________________________________________________
+TEST(GEOMETRY_BoxClipper, holes) {
+  const Ring outer{{0, 0}, {0, 100}, {100, 100}, {100, 0}, {0, 0}};
+  const Area area{polygon(outer, {{{40, 40}, {60, 40}, {60, 60}, {40, 60},
+                                   {40, 40}}})};
+  // Hole inside the box.
+  const Box around{{30, 30}, {70, 70}};
+  assertSameAsBoost(area, around);
+  ASSERT_EQ(1, BoxClipper{around}.clip(area)[0].inners().size());
+  // Hole crossing the box.
+  assertSameAsBoost(area, Box{{50, 30}, {70, 70}});
+  assertSameAsBoost(area, Box{{45, 45}, {80, 55}});
+  // Box inside the hole.
+  const Box insideHole{{45, 45}, {55, 55}};
+  ASSERT_TRUE(BoxClipper{insideHole}.clip(area).empty());
+  // Box around the hole, but not touching it.
+  assertSameAsBoost(area, Box{{10, 10}, {30, 90}});
+}
+
+// ____________________________________________________________________________
+TEST(GEOMETRY_BoxClipper, sharedBoundary) {
+  const Box box{{0, 0}, {10, 10}};
+  // Shares the left side of the box.
+  assertSameAsBoost(
+      Area{polygon({{0, 2}, {0, 8}, {5, 8}, {5, 2}, {0, 2}})}, box);
+  // Extends beyond the box along its bottom side.
+  assertSameAsBoost(
+      Area{polygon({{-5, 0}, {-5, 5}, {15, 5}, {15, 0}, {-5, 0}})}, box);
+  // Left of the box, touching it along its left side.
+  ASSERT_TRUE(BoxClipper{box}
+                  .clip(Area{polygon(
+                      {{-5, 0}, {-5, 10}, {0, 10}, {0, 0}, {-5, 0}})})
+                  .empty());
+  // The box itself.
+  const Area same{
+      polygon({{0, 0}, {0, 10}, {10, 10}, {10, 0}, {0, 0}})};
+  ASSERT_EQ(100, boost::geometry::area(BoxClipper{box}.clip(same)));
+  // Notch reaching the boundary from inside.
+  assertSameAsBoost(Area{polygon({{2, 2},
+                                  {2, 8},
+                                  {4, 8},
+                                  {4, 10},
+                                  {6, 10},
+                                  {6, 8},
+                                  {8, 8},
+                                  {8, 2},
+                                  {2, 2}})},
+                    box);
+  // Polygon covering the box except for a notch touching its top side,
+  // which splits the part inside the box.
+  assertSameAsBoost(Area{polygon({{-5, -5},
+                                  {-5, 15},
+                                  {4, 15},
+                                  {4, 10},
+                                  {5, 0},
+                                  {6, 10},
+                                  {6, 15},
+                                  {15, 15},
+                                  {15, -5},
+                                  {-5, -5}})},
+                    box);
+}
+
+// ____________________________________________________________________________
+TEST(GEOMETRY_BoxClipper, sameAsBoostRandom) {
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> radius(200, 1000);
+  std::uniform_int_distribution<int> coordinate(-1000, 1000);
+  for (size_t k = 0; k < 200; ++k) {
+    // Star with holes in some of its spikes.
+    Ring outer;
+    const size_t numPoints = 50;
+    for (size_t i = 0; i < numPoints; ++i) {
+      const double angle = -2 * M_PI * i / numPoints;
+      const double r = i % 2 == 0 ? radius(rng) : 100;
+      outer.push_back(Location(std::round(r * std::cos(angle)),
+                               std::round(r * std::sin(angle))));
+    }
+    outer.push_back(outer.front());
+    std::vector<Ring> inners;
+    if (k % 2 == 0) {
+      inners.push_back({{-50, -50}, {50, -50}, {50, 50}, {-50, 50},
+                        {-50, -50}});
+    }
+    const Area area{polygon(outer, inners)};
+    if (!boost::geometry::is_valid(area)) {
+      continue;
+    }
+
+    const int x = coordinate(rng);
+    const int y = coordinate(rng);
+    const Box box{Location(std::min(x, y / 2), std::min(y, x / 2)),
+                  Location(std::max(x, y / 2) + 1, std::max(y, x / 2) + 1)};
+    assertSameAsBoost(area, box);
+  }
+}
+
+// ____________________________________________________________________________
+TEST(GEOMETRY_BoxClipper, clipsOfClips) {
+  const Area area{polygon({{0, 0},
+                           {0, 30},
+                           {10, 30},
+                           {10, 10},
+                           {20, 10},
+                           {20, 30},
+                           {30, 30},
+                           {30, 0},
+                           {0, 0}})};
+  // Children share sides with their parent.
+  const Area parent = BoxClipper{Box{{0, 5}, {20, 40}}}.clip(area);
+  for (const auto& child : {Box{{0, 5}, {10, 20}}, Box{{10, 5}, {20, 20}},
+                            Box{{0, 20}, {10, 40}}, Box{{10, 20}, {20, 40}}}) {
+    const Area clipped = BoxClipper{child}.clip(parent);
+    Area expected;
+    boost::geometry::intersection(area, child, expected);
+    ASSERT_NEAR(boost::geometry::area(expected),
+                boost::geometry::area(clipped), 1e-9);
+  }
+}
+
+}  // namespace osm2rdf::geometry
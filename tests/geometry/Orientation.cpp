@@ -0,0 +1,57 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/geometry/Orientation.h"
+
+#include <algorithm>
+
+#include "gtest/gtest.h"
+
+namespace osm2rdf::geometry {
+
+// ____________________________________________________________________________
+TEST(GEOMETRY_Orientation, orientation) {
+  const Location a{0, 0};
+  const Location b{10, 0};
+  ASSERT_EQ(1, orientation(a, b, Location{5, 3}));
+  ASSERT_EQ(-1, orientation(a, b, Location{5, -3}));
+  ASSERT_EQ(0, orientation(a, b, Location{20, 0}));
+  ASSERT_EQ(-1, orientation(b, a, Location{5, 3}));
+}
+
+// ____________________________________________________________________________
+TEST(GEOMETRY_Orientation, orientationWorldCorners) {
+  const Location a{-180, -90};
+  const Location b{180, 90};
+  ASSERT_EQ(0, orientation(a, b, Location{0, 0}));
+  ASSERT_EQ(1, orientation(a, b, Location{-180, 90}));
+  ASSERT_EQ(-1, orientation(a, b, Location{180, -90}));
+  ASSERT_TRUE(cross(a, b, Location{-180, 90}) > 0);
+}
+
+// ____________________________________________________________________________
+TEST(GEOMETRY_Orientation, ringOrientation) {
+  Ring ring{{0, 0}, {10, 0}, {10, 10}, {0, 10}, {0, 0}};
+  ASSERT_EQ(1, ringOrientation(ring));
+  std::reverse(ring.begin(), ring.end());
+  ASSERT_EQ(-1, ringOrientation(ring));
+  ASSERT_EQ(0, ringOrientation(Ring{{0, 0}, {10, 0}, {0, 0}}));
+  ASSERT_EQ(0, ringOrientation(Ring{}));
+}
+
+}  // namespace osm2rdf::geometry
@@ -0,0 +1,65 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/geometry/OrientedBox.h"
+
+#include "boost/geometry.hpp"
+#include "gtest/gtest.h"
+#include "osm2rdf/geometry/Linestring.h"
+
+namespace osm2rdf::geometry {
+
+// ____________________________________________________________________________
+TEST(GEOMETRY_OrientedBox, fromPolygon) {
+  Polygon obb;
+  boost::geometry::read_wkt("POLYGON((0 1,1 2,2 1,1 0,0 1))", obb);
+  const OrientedBox box = orientedBox(obb, Box{{0, 0}, {2, 2}});
+  for (size_t i = 0; i < box.size(); ++i) {
+    ASSERT_TRUE(box[i] == obb.outer()[i]);
+  }
+  ASSERT_DOUBLE_EQ(2, boost::geometry::area(box));
+}
+
+// ____________________________________________________________________________
+TEST(GEOMETRY_OrientedBox, fromEnvelope) {
+  const OrientedBox box = orientedBox(Polygon(), Box{{1, 2}, {4, 6}});
+  ASSERT_DOUBLE_EQ(12, boost::geometry::area(box));
+  ASSERT_TRUE(box.front() == box.back());
+  ASSERT_TRUE(boost::geometry::covered_by(Location{4, 6}, box));
+}
+
+// ____________________________________________________________________________
+TEST(GEOMETRY_OrientedBox, predicates) {
+  const OrientedBox box = orientedBox(Polygon(), Box{{0, 0}, {4, 4}});
+  Polygon inside;
+  boost::geometry::read_wkt("POLYGON((1 1,1 2,2 2,2 1,1 1))", inside);
+  Linestring crossing;
+  boost::geometry::read_wkt("LINESTRING(1 1,5 5)", crossing);
+  Linestring outside;
+  boost::geometry::read_wkt("LINESTRING(5 5,6 6)", outside);
+
+  ASSERT_TRUE(boost::geometry::covered_by(inside, box));
+  ASSERT_TRUE(boost::geometry::intersects(inside, box));
+  ASSERT_TRUE(boost::geometry::intersects(crossing, box));
+  ASSERT_FALSE(boost::geometry::covered_by(crossing, box));
+  ASSERT_FALSE(boost::geometry::intersects(outside, box));
+  ASSERT_TRUE(boost::geometry::intersects(
+      box, orientedBox(Polygon(), Box{{3, 3}, {5, 5}})));
+}
+
+}  // namespace osm2rdf::geometry
@@ -250,7 +250,7 @@ TEST(Issue24, nodeHasGeometryAsWkt) {
       osmium::builder::attr::_location(osmium::Location(7.51, 48.0)));
 
   // Create osm2rdf object from osmium object
-  const osm2rdf::osm::Node n{osmiumBuffer.get<osmium::Node>(0)};
+  const osm2rdf::osm::NodeView n{osmiumBuffer.get<osmium::Node>(0)};
 
   dh.node(n);
   output.flush();
@@ -294,7 +294,7 @@ TEST(Issue24, nodeHasGeometryAsGeoSPARQL) {
       osmium::builder::attr::_location(osmium::Location(7.51, 48.0)));
 
   // Create osm2rdf object from osmium object
-  const osm2rdf::osm::Node n{osmiumBuffer.get<osmium::Node>(0)};
+  const osm2rdf::osm::NodeView n{osmiumBuffer.get<osmium::Node>(0)};
 
   dh.node(n);
   output.flush();
@@ -517,7 +517,7 @@ TEST(Issue24, wayHasGeometryAsWkt) {
                            }));
 
   // Create osm2rdf object from osmium object
-  const osm2rdf::osm::Way w{osmiumBuffer.get<osmium::Way>(0)};
+  const osm2rdf::osm::WayView w{osmiumBuffer.get<osmium::Way>(0)};
 
   dh.way(w);
   output.flush();
@@ -565,7 +565,7 @@ TEST(Issue24, wayHasGeometryAsGeoSPARQL) {
                            }));
 
   // Create osm2rdf object from osmium object
-  const osm2rdf::osm::Way w{osmiumBuffer.get<osmium::Way>(0)};
+  const osm2rdf::osm::WayView w{osmiumBuffer.get<osmium::Way>(0)};
 
   dh.way(w);
   output.flush();
@@ -0,0 +1,172 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "osm2rdf/osm/BoxIdIntersect.h"
+
+#include <random>
+
+#include "gtest/gtest.h"
+
+namespace osm2rdf::osm {
+
+static const BoxIdIntersect::Kernel KERNELS[] = {
+    BoxIdIntersect::Kernel::SCALAR, BoxIdIntersect::Kernel::AVX2,
+    BoxIdIntersect::Kernel::GALLOP};
+
+// ____________________________________________________________________________
+TEST(OSM_BoxIdIntersect, scalarAlwaysSupported) {
+  ASSERT_TRUE(BoxIdIntersect::supported(BoxIdIntersect::Kernel::SCALAR));
+  ASSERT_TRUE(BoxIdIntersect::supported(BoxIdIntersect::Kernel::GALLOP));
+  ASSERT_TRUE(BoxIdIntersect::supported(BoxIdIntersect::bestKernel()));
+}
+
+// ____________________________________________________________________________
+TEST(OSM_BoxIdIntersect, empty) {
+  std::vector<int32_t> toCheck;
+  const BoxIdList empty{{0, 0}};
+  const BoxIdList one{{1, 0}, {1, 0}};
+  ASSERT_EQ(0, BoxIdIntersect::isect(empty, one, &toCheck));
+  ASSERT_EQ(0, BoxIdIntersect::isect(one, empty, &toCheck));
+  ASSERT_TRUE(toCheck.empty());
+  ASSERT_FALSE(BoxIdIntersect::anyFull(empty, one));
+}
+
+// ____________________________________________________________________________
+TEST(OSM_BoxIdIntersect, runs) {
+  // a: 3..7, 20; b: 1..4 full, 6..10 partial, 20..29 full
+  const BoxIdList a{{6, 0}, {3, 4}, {20, 0}};
+  const BoxIdList b{{19, 0}, {1, 3}, {-6, 4}, {20, 9}};
+  for (const auto kernel : KERNELS) {
+    if (!BoxIdIntersect::supported(kernel)) {
+      continue;
+    }
+    std::vector<int32_t> toCheck;
+    // 5 is not in b, but 3 and 4 are known to intersect first.
+    ASSERT_EQ(2, BoxIdIntersect::isect(a, b, &toCheck, kernel));
+    ASSERT_TRUE(toCheck.empty());
+    ASSERT_TRUE(BoxIdIntersect::anyFull(a, b, kernel));
+
+    // a without 5 is contained.
+    const BoxIdList c{{5, 0}, {3, 1}, {6, 1}, {20, 0}};
+    toCheck.clear();
+    ASSERT_EQ(3, BoxIdIntersect::isect(c, b, &toCheck, kernel));
+    ASSERT_EQ((std::vector<int32_t>{6, 7}), toCheck);
+
+    // Only partially covered ids.
+    const BoxIdList d{{2, 0}, {7, 1}};
+    toCheck.clear();
+    ASSERT_EQ(0, BoxIdIntersect::isect(d, b, &toCheck, kernel));
+    ASSERT_EQ((std::vector<int32_t>{7, 8}), toCheck);
+    ASSERT_FALSE(BoxIdIntersect::anyFull(d, b, kernel));
+  }
+}
+
+// ____________________________________________________________________________
+// Runs of single ids for cells with a non-zero state, merged like
+// GeometryHandler::pack.
+static BoxIdList makeList(const std::vector<int>& cells) {
+  BoxIdList ids{{0, 0}};
+  for (size_t i = 0; i < cells.size(); ++i) {
+    if (cells[i] == 0) {
+      continue;
+    }
+    const auto id = static_cast<int32_t>(i) + 1;
+    ids[0].first++;
+    const auto& last = ids.back();
+    if (ids.size() > 1 && (last.first > 0) == (cells[i] > 0) &&
+        abs(last.first) + static_cast<int32_t>(last.second) == id - 1) {
+      ids.back().second++;
+    } else {
+      ids.push_back({cells[i] > 0 ? id : -id, 0});
+    }
+  }
+  return ids;
+}
+
+// ____________________________________________________________________________
+TEST(OSM_BoxIdIntersect, randomAgainstCells) {
+  std::mt19937 rng(42);
+  const size_t numCells = 2000;
+  for (size_t round = 0; round < 400; ++round) {
+    // Vary the density of both lists, such that both similar and very
+    // unequal list sizes occur.
+    const unsigned densityA = 1 + round % 3 * 40;
+    const unsigned densityB = 1 + round / 3 % 4;
+    std::vector<int> cellsA(numCells);
+    std::vector<int> cellsB(numCells);
+    for (size_t i = 0; i < numCells; ++i) {
+      cellsA[i] = rng() % densityA == 0 ? 1 : 0;
+      cellsB[i] = rng() % densityB == 0 ? (rng() % 3 == 0 ? -1 : 1) : 0;
+      // Long runs in b, like coarse quadtree nodes.
+      if (i > 0 && rng() % 8 != 0) {
+        cellsB[i] = cellsB[i - 1];
+      }
+    }
+    if (round % 2 == 0) {
+      // a is contained in b.
+      for (size_t i = 0; i < numCells; ++i) {
+        if (cellsB[i] == 0) {
+          cellsA[i] = 0;
+        }
+      }
+    }
+    const BoxIdList a = makeList(cellsA);
+    const BoxIdList b = makeList(cellsB);
+
+    int full = 0;
+    bool outside = false;
+    std::vector<int32_t> partial;
+    for (size_t i = 0; i < numCells; ++i) {
+      if (cellsA[i] == 0) {
+        continue;
+      }
+      if (cellsB[i] > 0) {
+        full++;
+      } else if (cellsB[i] < 0) {
+        partial.push_back(static_cast<int32_t>(i) + 1);
+      } else {
+        outside = true;
+      }
+    }
+
+    for (const auto kernel : KERNELS) {
+      if (!BoxIdIntersect::supported(kernel)) {
+        continue;
+      }
+      std::vector<int32_t> toCheck;
+      const int result = BoxIdIntersect::isect(a, b, &toCheck, kernel);
+      ASSERT_EQ(full > 0, BoxIdIntersect::anyFull(a, b, kernel));
+      if (!outside) {
+        ASSERT_EQ(full, result);
+        ASSERT_EQ(partial, toCheck);
+      } else {
+        // Early exit once a is known to intersect, but not be contained.
+        ASSERT_EQ(full > 0, result > 0);
+        ASSERT_LE(result, full);
+        ASSERT_LT(result + static_cast<int>(toCheck.size()), a[0].first);
+      }
+    }
+    std::vector<int32_t> toCheck;
+    const int result = BoxIdIntersect::isect(a, b, &toCheck);
+    ASSERT_EQ(full > 0, result > 0);
+    ASSERT_EQ(full > 0, BoxIdIntersect::anyFull(a, b));
+  }
+}
+
+}  // namespace osm2rdf::osm
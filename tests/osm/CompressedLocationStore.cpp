@@ -0,0 +1,110 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/CompressedLocationStore.h"
+
+#include <filesystem>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace osm2rdf::osm {
+
+// ____________________________________________________________________________
+TEST(OSM_CompressedLocationStore, empty) {
+  CompressedLocationStore store{
+      std::filesystem::temp_directory_path() / "OSM_CompressedLocationStore"};
+  store.finalize();
+  ASSERT_EQ(0, store.fileSize());
+  ASSERT_FALSE(store.get(0).valid());
+  ASSERT_FALSE(store.get(42).valid());
+}
+
+// ____________________________________________________________________________
+TEST(OSM_CompressedLocationStore, storeAndGet) {
+  CompressedLocationStore store{
+      std::filesystem::temp_directory_path() / "OSM_CompressedLocationStore"};
+  store.set(1, osmium::Location{7.8, 48.0});
+  store.set(2, osmium::Location{-7.8, -48.0});
+  store.set(255, osmium::Location{180.0, 90.0});
+  store.set(256, osmium::Location{-180.0, -90.0});
+  store.set(100000, osmium::Location{0.0, 0.0});
+  store.finalize();
+  // Finalize is idempotent.
+  store.finalize();
+  ASSERT_EQ(osmium::Location(7.8, 48.0), store.get(1));
+  ASSERT_EQ(osmium::Location(-7.8, -48.0), store.get(2));
+  ASSERT_EQ(osmium::Location(180.0, 90.0), store.get(255));
+  ASSERT_EQ(osmium::Location(-180.0, -90.0), store.get(256));
+  ASSERT_EQ(osmium::Location(0.0, 0.0), store.get(100000));
+  ASSERT_FALSE(store.get(0).valid());
+  ASSERT_FALSE(store.get(3).valid());
+  ASSERT_FALSE(store.get(1000).valid());
+  ASSERT_FALSE(store.get(100001).valid());
+  ASSERT_THROW(store.set(200000, osmium::Location{0.0, 0.0}),
+               std::runtime_error);
+}
+
+// ____________________________________________________________________________
+TEST(OSM_CompressedLocationStore, unsortedBlocks) {
+  CompressedLocationStore store{
+      std::filesystem::temp_directory_path() / "OSM_CompressedLocationStore"};
+  // Order within a block does not matter.
+  store.set(1000, osmium::Location{1.0, 1.0});
+  store.set(999, osmium::Location{2.0, 2.0});
+  ASSERT_THROW(store.set(1, osmium::Location{3.0, 3.0}), std::runtime_error);
+}
+
+// ____________________________________________________________________________
+TEST(OSM_CompressedLocationStore, parallelGet) {
+  CompressedLocationStore store{
+      std::filesystem::temp_directory_path() / "OSM_CompressedLocationStore"};
+  const uint64_t count = 100000;
+  for (uint64_t id = 0; id < count; id += 3) {
+    store.set(id, osmium::Location{static_cast<int32_t>(id),
+                                   -static_cast<int32_t>(id)});
+  }
+  store.finalize();
+  ASSERT_LT(store.fileSize(), count / 3 * sizeof(osmium::Location));
+
+  std::vector<std::thread> threads;
+  std::vector<uint64_t> errors(4, 0);
+  for (size_t t = 0; t < errors.size(); ++t) {
+    threads.emplace_back([&, t]() {
+      for (uint64_t id = t; id < count; ++id) {
+        const auto location = store.get(id);
+        if (id % 3 == 0) {
+          errors[t] += location != osmium::Location{static_cast<int32_t>(id),
+                                                    -static_cast<int32_t>(id)};
+        } else {
+          errors[t] += location.valid();
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (const auto& e : errors) {
+    ASSERT_EQ(0, e);
+  }
+}
+
+}  // namespace osm2rdf::osm
@@ -20,7 +20,8 @@
 #include "gmock/gmock-matchers.h"
 #include "gtest/gtest.h"
 #include "osm2rdf/osm/FactHandler.h"
-#include "osm2rdf/osm/Node.h"
+#include "osm2rdf/osm/NodeView.h"
+#include "osm2rdf/osm/WayView.h"
 #include "osmium/builder/attr.hpp"
 #include "osmium/builder/osm_object_builder.hpp"
 
@@ -495,7 +496,7 @@ TEST(OSM_FactHandler, node) {
       osmium::builder::attr::_tag("city", "Freiburg"));
 
   // Create osm2rdf object from osmium object
-  const osm2rdf::osm::Node n{osmiumBuffer.get<osmium::Node>(0)};
+  const osm2rdf::osm::NodeView n{osmiumBuffer.get<osmium::Node>(0)};
 
   dh.node(n);
   output.flush();
@@ -542,7 +543,7 @@ TEST(OSM_FactHandler, nodeAddConvexHull) {
       osmium::builder::attr::_tag("city", "Freiburg"));
 
   // Create osm2rdf object from osmium object
-  const osm2rdf::osm::Node n{osmiumBuffer.get<osmium::Node>(0)};
+  const osm2rdf::osm::NodeView n{osmiumBuffer.get<osmium::Node>(0)};
 
   dh.node(n);
   output.flush();
@@ -592,7 +593,7 @@ TEST(OSM_FactHandler, nodeAddEnvelope) {
       osmium::builder::attr::_tag("city", "Freiburg"));
 
   // Create osm2rdf object from osmium object
-  const osm2rdf::osm::Node n{osmiumBuffer.get<osmium::Node>(0)};
+  const osm2rdf::osm::NodeView n{osmiumBuffer.get<osmium::Node>(0)};
 
   dh.node(n);
   output.flush();
@@ -642,7 +643,7 @@ TEST(OSM_FactHandler, nodeAddOrientedBoundingBox) {
       osmium::builder::attr::_tag("city", "Freiburg"));
 
   // Create osm2rdf object from osmium object
-  const osm2rdf::osm::Node n{osmiumBuffer.get<osmium::Node>(0)};
+  const osm2rdf::osm::NodeView n{osmiumBuffer.get<osmium::Node>(0)};
 
   dh.node(n);
   output.flush();
@@ -1305,7 +1306,7 @@ TEST(OSM_FactHandler, way) {
                            osmium::builder::attr::_tag("city", "Freiburg"));
 
   // Create osm2rdf object from osmium object
-  const osm2rdf::osm::Way w{osmiumBuffer.get<osmium::Way>(0)};
+  const osm2rdf::osm::WayView w{osmiumBuffer.get<osmium::Way>(0)};
 
   dh.way(w);
   output.flush();
@@ -1355,7 +1356,7 @@ TEST(OSM_FactHandler, wayAddSortMetadata) {
                            osmium::builder::attr::_tag("city", "Freiburg"));
 
   // Create osm2rdf object from osmium object
-  const osm2rdf::osm::Way w{osmiumBuffer.get<osmium::Way>(0)};
+  const osm2rdf::osm::WayView w{osmiumBuffer.get<osmium::Way>(0)};
 
   dh.way(w);
   output.flush();
@@ -1408,7 +1409,7 @@ TEST(OSM_FactHandler, wayAddWayConvexHull) {
                            osmium::builder::attr::_tag("city", "Freiburg"));
 
   // Create osm2rdf object from osmium object
-  const osm2rdf::osm::Way w{osmiumBuffer.get<osmium::Way>(0)};
+  const osm2rdf::osm::WayView w{osmiumBuffer.get<osmium::Way>(0)};
 
   dh.way(w);
   output.flush();
@@ -1461,7 +1462,7 @@ TEST(OSM_FactHandler, wayAddWayEnvelope) {
                            osmium::builder::attr::_tag("city", "Freiburg"));
 
   // Create osm2rdf object from osmium object
-  const osm2rdf::osm::Way w{osmiumBuffer.get<osmium::Way>(0)};
+  const osm2rdf::osm::WayView w{osmiumBuffer.get<osmium::Way>(0)};
 
   dh.way(w);
   output.flush();
@@ -1515,7 +1516,7 @@ TEST(OSM_FactHandler, wayAddWayOrientedBoundingBox) {
                            osmium::builder::attr::_tag("city", "Freiburg"));
 
   // Create osm2rdf object from osmium object
-  const osm2rdf::osm::Way w{osmiumBuffer.get<osmium::Way>(0)};
+  const osm2rdf::osm::WayView w{osmiumBuffer.get<osmium::Way>(0)};
 
   dh.way(w);
   output.flush();
@@ -1569,7 +1570,7 @@ TEST(OSM_FactHandler, wayAddWayNodeGeoemtry) {
                            osmium::builder::attr::_tag("city", "Freiburg"));
 
   // Create osm2rdf object from osmium object
-  const osm2rdf::osm::Way w{osmiumBuffer.get<osmium::Way>(0)};
+  const osm2rdf::osm::WayView w{osmiumBuffer.get<osmium::Way>(0)};
 
   dh.way(w);
   output.flush();
@@ -1630,7 +1631,7 @@ TEST(OSM_FactHandler, wayAddWayNodeOrder) {
                            osmium::builder::attr::_tag("city", "Freiburg"));
 
   // Create osm2rdf object from osmium object
-  const osm2rdf::osm::Way w{osmiumBuffer.get<osmium::Way>(0)};
+  const osm2rdf::osm::WayView w{osmiumBuffer.get<osmium::Way>(0)};
 
   dh.way(w);
   output.flush();
@@ -1688,7 +1689,7 @@ TEST(OSM_FactHandler, wayAddWayNodeSpatialMetadataShortWay) {
                            osmium::builder::attr::_tag("city", "Freiburg"));
 
   // Create osm2rdf object from osmium object
-  const osm2rdf::osm::Way w{osmiumBuffer.get<osmium::Way>(0)};
+  const osm2rdf::osm::WayView w{osmiumBuffer.get<osmium::Way>(0)};
 
   dh.way(w);
   output.flush();
@@ -1750,7 +1751,7 @@ TEST(OSM_FactHandler, wayAddWayNodeSpatialMetadataLongerWay) {
                            osmium::builder::attr::_tag("city", "Freiburg"));
 
   // Create osm2rdf object from osmium object
-  const osm2rdf::osm::Way w{osmiumBuffer.get<osmium::Way>(0)};
+  const osm2rdf::osm::WayView w{osmiumBuffer.get<osmium::Way>(0)};
 
   dh.way(w);
   output.flush();
@@ -1819,7 +1820,7 @@ TEST(OSM_FactHandler, wayAddWayMetaData) {
                            osmium::builder::attr::_tag("city", "Freiburg"));
 
   // Create osm2rdf object from osmium object
-  const osm2rdf::osm::Way w{osmiumBuffer.get<osmium::Way>(0)};
+  const osm2rdf::osm::WayView w{osmiumBuffer.get<osmium::Way>(0)};
 
   dh.way(w);
   output.flush();
@@ -2555,6 +2556,62 @@ TEST(OSM_FactHandler, writeTagList) {
   std::cout.rdbuf(sbuf);
 }
 
+// ____________________________________________________________________________
+TEST(OSM_FactHandler, writeTagListOsmium) {
+  // Capture std::cout
+  std::stringstream buffer;
+  std::streambuf* sbuf = std::cout.rdbuf();
+  std::cout.rdbuf(buffer.rdbuf());
+
+  osm2rdf::config::Config config;
+  config.output = "";
+  config.hasGeometryAsWkt = true;
+  config.outputCompress = false;
+  config.mergeOutput = osm2rdf::util::OutputMergeMode::NONE;
+
+  osm2rdf::util::Output output{config, config.output};
+  output.open();
+  osm2rdf::ttl::Writer<osm2rdf::ttl::format::TTL> writer{config, &output};
+  osm2rdf::osm::FactHandler dh{config, &writer};
+
+  // Tags are read from the osmium buffer, spaces in keys are replaced as in
+  // convertTagList().
+  const size_t initial_buffer_size = 10000;
+  osmium::memory::Buffer osmiumBuffer{initial_buffer_size,
+                                      osmium::memory::Buffer::auto_grow::yes};
+  osmium::builder::add_node(
+      osmiumBuffer, osmium::builder::attr::_id(42),
+      osmium::builder::attr::_location(osmium::Location(7.51, 48.0)),
+      osmium::builder::attr::_tag("admin level", "42"),
+      osmium::builder::attr::_tag("wikidata", "Q42"));
+
+  const std::string subject = "subject";
+  const std::string predicate1 = writer.generateIRI(
+      osm2rdf::ttl::constants::NAMESPACE__OSM_TAG, "admin_level");
+  const std::string object1 = writer.generateLiteral(
+      "42", "^^" + osm2rdf::ttl::constants::IRI__XSD_INTEGER);
+  const std::string predicate2 = writer.generateIRI(
+      osm2rdf::ttl::constants::NAMESPACE__OSM, "wikidata");
+  const std::string object2 = writer.generateIRI(
+      osm2rdf::ttl::constants::NAMESPACE__WIKIDATA_ENTITY, "Q42");
+
+  dh.writeTagList(subject, osmiumBuffer.get<osmium::Node>(0).tags());
+  output.flush();
+  output.close();
+
+  const std::string printedData = buffer.str();
+  ASSERT_THAT(printedData, ::testing::HasSubstr(subject + " " + predicate1 +
+                                                " " + object1 + " .\n"));
+  ASSERT_THAT(printedData, ::testing::HasSubstr(subject + " " + predicate2 +
+                                                " " + object2 + " .\n"));
+  ASSERT_THAT(printedData,
+              ::testing::HasSubstr(subject +
+                                   " osm2rdf:facts \"3\"^^xsd:integer .\n"));
+
+  // Cleanup
+  std::cout.rdbuf(sbuf);
+}
+
 // ____________________________________________________________________________
 TEST(OSM_FactHandler, writeTagListRefSingle) {
   // Capture std::cout
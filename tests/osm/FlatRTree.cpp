@@ -0,0 +1,191 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "osm2rdf/osm/FlatRTree.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <random>
+
+#include "boost/geometry.hpp"
+#include "boost/geometry/index/rtree.hpp"
+#include "gtest/gtest.h"
+
+namespace osm2rdf::osm {
+
+static const FlatRTree::Kernel KERNELS[] = {FlatRTree::Kernel::SCALAR,
+                                            FlatRTree::Kernel::AVX2,
+                                            FlatRTree::Kernel::AVX512};
+
+// ____________________________________________________________________________
+static std::vector<size_t> intersecting(const FlatRTree& tree,
+                                        const osm2rdf::geometry::Box& box) {
+  std::vector<size_t> result;
+  tree.queryIntersects(box, [&result](const osm2rdf::geometry::Box& /*unused*/,
+                                      size_t value) {
+    result.push_back(value);
+  });
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+// ____________________________________________________________________________
+static std::vector<size_t> covering(const FlatRTree& tree,
+                                    const osm2rdf::geometry::Box& box) {
+  std::vector<size_t> result;
+  tree.queryCovers(box, [&result](const osm2rdf::geometry::Box& /*unused*/,
+                                  size_t value) { result.push_back(value); });
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+// ____________________________________________________________________________
+static osm2rdf::geometry::Box makeBox(double minX, double minY, double maxX,
+                                      double maxY) {
+  return {{minX, minY}, {maxX, maxY}};
+}
+
+// ____________________________________________________________________________
+TEST(OSM_FlatRTree, scalarAlwaysSupported) {
+  ASSERT_TRUE(FlatRTree::supported(FlatRTree::Kernel::SCALAR));
+  ASSERT_TRUE(FlatRTree::supported(FlatRTree::bestKernel()));
+}
+
+// ____________________________________________________________________________
+TEST(OSM_FlatRTree, empty) {
+  const FlatRTree tree{{}};
+  ASSERT_EQ(0, tree.size());
+  ASSERT_EQ(0, tree.numLevels());
+  ASSERT_TRUE(intersecting(tree, makeBox(0, 0, 1, 1)).empty());
+  ASSERT_TRUE(covering(tree, makeBox(0, 0, 1, 1)).empty());
+}
+
+// ____________________________________________________________________________
+TEST(OSM_FlatRTree, touchingBoxes) {
+  // Boxes sharing only a border or corner intersect, a box covers itself.
+  const FlatRTree tree{{{makeBox(0, 0, 1, 1), 7},
+                        {makeBox(1, 1, 2, 2), 8},
+                        {makeBox(3, 3, 4, 4), 9}}};
+  ASSERT_EQ(3, tree.size());
+  ASSERT_EQ(1, tree.numLevels());
+  ASSERT_EQ((std::vector<size_t>{7, 8}),
+            intersecting(tree, makeBox(1, 0, 1, 1)));
+  ASSERT_EQ((std::vector<size_t>{7, 8}),
+            intersecting(tree, makeBox(1, 1, 1, 1)));
+  ASSERT_EQ((std::vector<size_t>{8}), covering(tree, makeBox(1, 1, 2, 2)));
+  ASSERT_EQ((std::vector<size_t>{7, 8}), covering(tree, makeBox(1, 1, 1, 1)));
+  ASSERT_TRUE(covering(tree, makeBox(0.5, 0.5, 1.5, 1.5)).empty());
+}
+
+// ____________________________________________________________________________
+TEST(OSM_FlatRTree, randomAgainstBoostRTree) {
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> x(-180, 180);
+  std::uniform_real_distribution<double> y(-90, 90);
+  std::exponential_distribution<double> size(2);
+  // Boxes of very different sizes, some differing only in the last digit.
+  std::vector<FlatRTree::Value> values;
+  for (size_t i = 0; i < 5000; ++i) {
+    const double minX = x(rng);
+    const double minY = y(rng);
+    values.emplace_back(
+        makeBox(minX, minY, minX + size(rng), minY + size(rng) / 2), i);
+    if (i % 10 == 0) {
+      auto box = values.back().first;
+      box.max_corner().set<0>(box.min_corner().get<0>());
+      values.emplace_back(box, ++i);
+    }
+  }
+  boost::geometry::index::rtree<FlatRTree::Value,
+                                boost::geometry::index::quadratic<32>>
+      rtree{values.begin(), values.end()};
+  for (const auto kernel : KERNELS) {
+    if (!FlatRTree::supported(kernel)) {
+      continue;
+    }
+    const FlatRTree tree{values, kernel};
+    ASSERT_EQ(values.size(), tree.size());
+    ASSERT_EQ(4, tree.numLevels());
+    for (size_t i = 0; i < 500; ++i) {
+      // Query with stored boxes as well, to hit borders exactly.
+      const auto& query =
+          i % 2 == 0 ? values[rng() % values.size()].first
+                     : makeBox(x(rng), y(rng), 0, 0);
+      auto box = query;
+      if (i % 2 == 1) {
+        box.max_corner().set<0>(box.min_corner().get<0>() + size(rng));
+        box.max_corner().set<1>(box.min_corner().get<1>() + size(rng));
+      }
+      std::vector<FlatRTree::Value> expected;
+      rtree.query(boost::geometry::index::intersects(box),
+                  std::back_inserter(expected));
+      std::vector<size_t> expectedValues;
+      for (const auto& value : expected) {
+        expectedValues.push_back(value.second);
+      }
+      std::sort(expectedValues.begin(), expectedValues.end());
+      ASSERT_EQ(expectedValues, intersecting(tree, box));
+
+      expected.clear();
+      rtree.query(boost::geometry::index::covers(box),
+                  std::back_inserter(expected));
+      expectedValues.clear();
+      for (const auto& value : expected) {
+        expectedValues.push_back(value.second);
+      }
+      std::sort(expectedValues.begin(), expectedValues.end());
+      ASSERT_EQ(expectedValues, covering(tree, box));
+    }
+  }
+}
+
+// ____________________________________________________________________________
+TEST(OSM_FlatRTree, unboundedAndInvertedQueries) {
+  // Two levels with unused children in both.
+  std::vector<FlatRTree::Value> values;
+  for (size_t i = 0; i < 20; ++i) {
+    values.emplace_back(makeBox(i, i, i + 1, i + 1), i);
+  }
+  std::vector<size_t> all(values.size());
+  std::iota(all.begin(), all.end(), 0);
+  const double inf = std::numeric_limits<double>::infinity();
+  for (const auto kernel : KERNELS) {
+    if (!FlatRTree::supported(kernel)) {
+      continue;
+    }
+    const FlatRTree tree{values, kernel};
+    ASSERT_EQ(2, tree.numLevels());
+    ASSERT_EQ(all, intersecting(tree, makeBox(-inf, -inf, inf, inf)));
+    ASSERT_TRUE(covering(tree, makeBox(-inf, -inf, inf, inf)).empty());
+    ASSERT_EQ((std::vector<size_t>{0}),
+              intersecting(tree, makeBox(-inf, -inf, 0.5, 0.5)));
+    ASSERT_EQ((std::vector<size_t>{19}),
+              intersecting(tree, makeBox(19.5, 19.5, inf, inf)));
+    ASSERT_TRUE(intersecting(tree, makeBox(inf, inf, -inf, -inf)).empty());
+    ASSERT_EQ(all, covering(tree, makeBox(inf, inf, -inf, -inf)));
+    // Inverted boxes follow the exact predicates.
+    ASSERT_EQ((std::vector<size_t>{4}),
+              intersecting(tree, makeBox(5, 5, 4, 4)));
+    ASSERT_EQ((std::vector<size_t>{3, 4, 5}),
+              covering(tree, makeBox(5, 5, 4, 4)));
+  }
+}
+
+}  // namespace osm2rdf::osm
@@ -21,7 +21,6 @@
 
 #include <omp.h>
 
-#include "boost/archive/binary_iarchive.hpp"
 #include "boost/geometry.hpp"
 #include "gmock/gmock-matchers.h"
 #include "gtest/gtest.h"
@@ -86,13 +85,13 @@ TEST(OSM_GeometryHandler, addNamedAreaFromRelation) {
   ASSERT_EQ(1, gh._spatialStorageArea.size());
 
   // Compare stored area with original
-  const auto& dst = gh._spatialStorageArea[0];
-  ASSERT_TRUE(std::get<0>(dst).size() > 0);
-  ASSERT_TRUE(src.envelope() == std::get<0>(dst)[0]);
-  ASSERT_TRUE(src.id() == std::get<1>(dst));
+  const auto dst = gh.areaView(0);
+  ASSERT_TRUE(dst.envelopes.size() > 0);
+  ASSERT_TRUE(src.envelope() == dst.envelopes[0]);
+  ASSERT_TRUE(src.id() == dst.id);
 
   osm2rdf::geometry::Area diff;
-  boost::geometry::difference(src.geom(), std::get<2>(dst), diff);
+  boost::geometry::difference(src.geom(), dst.geometry->geom, diff);
   ASSERT_FLOAT_EQ(boost::geometry::area(diff), 0);
 
   // Cleanup
@@ -138,13 +137,13 @@ TEST(OSM_GeometryHandler, addNamedAreaFromWay) {
   ASSERT_EQ(1, gh._spatialStorageArea.size());
 
   // Compare stored area with original
-  const auto& dst = gh._spatialStorageArea[0];
-  ASSERT_TRUE(std::get<0>(dst).size() > 0);
-  ASSERT_TRUE(src.envelope() == std::get<0>(dst)[0]);
-  ASSERT_TRUE(src.id() == std::get<1>(dst));
+  const auto dst = gh.areaView(0);
+  ASSERT_TRUE(dst.envelopes.size() > 0);
+  ASSERT_TRUE(src.envelope() == dst.envelopes[0]);
+  ASSERT_TRUE(src.id() == dst.id);
 
   osm2rdf::geometry::Area diff;
-  boost::geometry::difference(src.geom(), std::get<2>(dst), diff);
+  boost::geometry::difference(src.geom(), dst.geometry->geom, diff);
   ASSERT_FLOAT_EQ(boost::geometry::area(diff), 0);
 
   // Cleanup
@@ -183,28 +182,24 @@ TEST(OSM_GeometryHandler, addUnnamedAreaFromRelation) {
   // Create osm2rdf object from osmium object
   const osm2rdf::osm::Area src{buffer.get<osmium::Area>(0)};
 
-  ASSERT_EQ(0, gh._numUnnamedAreas);
+  ASSERT_EQ(0, gh._unnamedAreas.size());
   gh.area(src);
-  ASSERT_EQ(1, gh._numUnnamedAreas);
+  ASSERT_EQ(1, gh._unnamedAreas.size());
 
   // Read area from dump and compare
-  osm2rdf::osm::SpatialAreaValue dst;
+  osm2rdf::osm::SpatialAreaData dst;
 
   gh.flushExternalStorage();
-  auto& ifs = gh.getFsUnnamedAreas();
-  ifs.clear();
-  ifs.seekg(0, std::ios::beg);
-  boost::archive::binary_iarchive ia(ifs);
-  ia >> dst;
-  ifs.close();
+  ASSERT_EQ(1, gh._unnamedAreas.size());
+  gh._unnamedAreas.get(0, &dst);
 
   // Compare stored area with original
-  ASSERT_TRUE(std::get<0>(dst).size() > 0);
-  ASSERT_TRUE(src.envelope() == std::get<0>(dst)[0]);
-  ASSERT_TRUE(src.id() == std::get<1>(dst));
+  ASSERT_TRUE(dst.envelopes.size() > 0);
+  ASSERT_TRUE(src.envelope() == dst.envelopes[0]);
+  ASSERT_TRUE(src.id() == dst.id);
 
   osm2rdf::geometry::Area diff;
-  boost::geometry::difference(src.geom(), std::get<2>(dst), diff);
+  boost::geometry::difference(src.geom(), dst.geometry.geom, diff);
   ASSERT_FLOAT_EQ(boost::geometry::area(diff), 0);
 
   // Cleanup
@@ -243,21 +238,17 @@ TEST(OSM_GeometryHandler, addUnnamedAreaFromWay) {
   // Create osm2rdf object from osmium object
   const osm2rdf::osm::Area src{buffer.get<osmium::Area>(0)};
 
-  ASSERT_EQ(0, gh._numUnnamedAreas);
+  ASSERT_EQ(0, gh._unnamedAreas.size());
   gh.area(src);
-  ASSERT_EQ(0, gh._numUnnamedAreas);
+  ASSERT_EQ(0, gh._unnamedAreas.size());
 
   // Read area from dump and compare
-  osm2rdf::osm::SpatialAreaValue dst;
+  osm2rdf::osm::SpatialAreaData dst;
 
   gh.flushExternalStorage();
-  auto& ifs = gh.getFsUnnamedAreas();
-  ifs.clear();
-  ifs.seekg(0, std::ios::beg);
-  boost::archive::binary_iarchive ia(ifs);
-  // No area is stored -> expect an exception on loading
-  ASSERT_THROW(ia >> dst, boost::archive::archive_exception);
-  ifs.close();
+  // No area is stored -> nothing to read
+  ASSERT_EQ(0, gh._unnamedAreas.size());
+  ASSERT_THROW(gh._unnamedAreas.get(0, &dst), std::out_of_range);
 
   // Cleanup
   output.close();
@@ -287,22 +278,18 @@ TEST(OSM_GeometryHandler, addNode) {
       osmium::builder::attr::_location(osmium::Location(7.51, 48.0)));
 
   // Create osm2rdf object from osmium object
-  const osm2rdf::osm::Node src{buffer.get<osmium::Node>(0)};
+  const osm2rdf::osm::NodeView src{buffer.get<osmium::Node>(0)};
 
-  ASSERT_EQ(0, gh._numNodes);
+  ASSERT_EQ(0, gh._nodes.size());
   gh.node(src);
-  ASSERT_EQ(1, gh._numNodes);
+  ASSERT_EQ(1, gh._nodes.size());
 
   // Read area from dump and compare
   osm2rdf::osm::SpatialNodeValue dst;
 
   gh.flushExternalStorage();
-  auto& ifs = gh.getFsNodes();
-  ifs.clear();
-  ifs.seekg(0, std::ios::beg);
-  boost::archive::binary_iarchive ia(ifs);
-  ia >> dst;
-  ifs.close();
+  ASSERT_EQ(1, gh._nodes.size());
+  gh._nodes.get(0, &dst);
 
   // Compare stored area with original
   ASSERT_TRUE(src.id() == std::get<0>(dst));
@@ -340,20 +327,16 @@ TEST(OSM_GeometryHandler, addWay) {
   // Create osm2rdf object from osmium object
   const osm2rdf::osm::Way src{buffer.get<osmium::Way>(0)};
 
-  ASSERT_EQ(0, gh._numWays);
-  gh.way(src);
-  ASSERT_EQ(1, gh._numWays);
+  ASSERT_EQ(0, gh._ways.size());
+  gh.way(osm2rdf::osm::WayView{buffer.get<osmium::Way>(0)});
+  ASSERT_EQ(1, gh._ways.size());
 
   // Read area from dump and compare
   osm2rdf::osm::SpatialWayValue dst;
 
   gh.flushExternalStorage();
-  auto& ifs = gh.getFsWays();
-  ifs.clear();
-  ifs.seekg(0, std::ios::beg);
-  boost::archive::binary_iarchive ia(ifs);
-  ia >> dst;
-  ifs.close();
+  ASSERT_EQ(1, gh._ways.size());
+  gh._ways.get(0, &dst);
 
   // Compare stored area with original
   ASSERT_TRUE(src.envelope() == std::get<0>(dst));
@@ -485,21 +468,31 @@ TEST(OSM_GeometryHandler, prepareRTreeSimple) {
   gh.prepareRTree();
   ASSERT_EQ(gh._spatialStorageArea.size(), gh._spatialIndex.size());
 
+  // Sorting keeps each area with its pooled envelopes and its geometry.
+  for (size_t i = 0; i < gh._spatialStorageArea.size(); ++i) {
+    const auto area = gh.areaView(i);
+    osm2rdf::geometry::Box envelope;
+    boost::geometry::envelope(area.geometry->geom, envelope);
+    ASSERT_TRUE(envelope == area.envelopes[0]);
+    ASSERT_EQ(2, area.envelopes.size());
+    if (i > 0) {
+      ASSERT_GE(gh.areaView(i - 1).area, area.area);
+    }
+  }
+
   std::vector<SpatialAreaRefValue> queryResult;
   osm2rdf::geometry::Box nodeEnvelope;
 
   queryResult.clear();
   nodeEnvelope.min_corner() = osm2rdf::geometry::Location(148.05, 7.56);
   nodeEnvelope.max_corner() = osm2rdf::geometry::Location(148.05, 7.56);
-  gh._spatialIndex.query(boost::geometry::index::covers(nodeEnvelope),
-                         std::back_inserter(queryResult));
+  gh.spatialIndexCovers(nodeEnvelope, &queryResult);
   ASSERT_EQ(0, queryResult.size());
 
   queryResult.clear();
   nodeEnvelope.min_corner() = osm2rdf::geometry::Location(45.00, 8.00);
   nodeEnvelope.max_corner() = osm2rdf::geometry::Location(45.00, 8.00);
-  gh._spatialIndex.query(boost::geometry::index::covers(nodeEnvelope),
-                         std::back_inserter(queryResult));
+  gh.spatialIndexCovers(nodeEnvelope, &queryResult);
 
   // 24, 28
   ASSERT_EQ(2, queryResult.size());
@@ -507,16 +500,14 @@ TEST(OSM_GeometryHandler, prepareRTreeSimple) {
   queryResult.clear();
   nodeEnvelope.min_corner() = osm2rdf::geometry::Location(48.05, 7.56);
   nodeEnvelope.max_corner() = osm2rdf::geometry::Location(48.05, 7.56);
-  gh._spatialIndex.query(boost::geometry::index::covers(nodeEnvelope),
-                         std::back_inserter(queryResult));
+  gh.spatialIndexCovers(nodeEnvelope, &queryResult);
   // 22, 24, 28
   ASSERT_EQ(3, queryResult.size());
 
   queryResult.clear();
   nodeEnvelope.min_corner() = osm2rdf::geometry::Location(40.05, 7.56);
   nodeEnvelope.max_corner() = osm2rdf::geometry::Location(40.05, 7.56);
-  gh._spatialIndex.query(boost::geometry::index::covers(nodeEnvelope),
-                         std::back_inserter(queryResult));
+  gh.spatialIndexCovers(nodeEnvelope, &queryResult);
   // 24, 26, 28
   ASSERT_EQ(3, queryResult.size());
 
@@ -528,6 +519,124 @@ TEST(OSM_GeometryHandler, prepareRTreeSimple) {
   std::cout.rdbuf(coutBufferOrig);
 }
 
+// ____________________________________________________________________________
+TEST(OSM_GeometryHandler, prepareNodeGrid) {
+  // Capture std::cerr and std::cout
+  std::stringstream cerrBuffer;
+  std::stringstream coutBuffer;
+  std::streambuf* cerrBufferOrig = std::cerr.rdbuf();
+  std::streambuf* coutBufferOrig = std::cout.rdbuf();
+  std::cerr.rdbuf(cerrBuffer.rdbuf());
+  std::cout.rdbuf(coutBuffer.rdbuf());
+
+  osm2rdf::config::Config config;
+  config.output = "";
+  config.outputCompress = false;
+  config.mergeOutput = osm2rdf::util::OutputMergeMode::NONE;
+  config.boxIdGridLevels = 8;
+  config.nodeGridLevels = 6;
+  osm2rdf::util::Output output{config, config.output};
+  output.open();
+  osm2rdf::ttl::Writer<osm2rdf::ttl::format::NT> writer{config, &output};
+  osm2rdf::osm::GeometryHandler gh{config, &writer};
+
+  // Create osmium object
+  const size_t initial_buffer_size = 10000;
+  osmium::memory::Buffer osmiumBuffer1{initial_buffer_size,
+                                       osmium::memory::Buffer::auto_grow::yes};
+  osmium::memory::Buffer osmiumBuffer2{initial_buffer_size,
+                                       osmium::memory::Buffer::auto_grow::yes};
+  osmium::memory::Buffer osmiumBuffer3{initial_buffer_size,
+                                       osmium::memory::Buffer::auto_grow::yes};
+  osmium::memory::Buffer osmiumBuffer4{initial_buffer_size,
+                                       osmium::memory::Buffer::auto_grow::yes};
+  osmium::builder::add_area(osmiumBuffer1, osmium::builder::attr::_id(22),
+                            osmium::builder::attr::_tag("name", "22"),
+                            osmium::builder::attr::_outer_ring({
+                                {1, {48.0, 7.51}},
+                                {2, {48.0, 7.61}},
+                                {3, {48.1, 7.61}},
+                                {4, {48.1, 7.51}},
+                                {1, {48.0, 7.51}},
+                            }));
+  osmium::builder::add_area(osmiumBuffer2, osmium::builder::attr::_id(24),
+                            osmium::builder::attr::_tag("name", "24"),
+                            osmium::builder::attr::_outer_ring({
+                                {1, {40.0, 7.00}},
+                                {2, {40.0, 8.00}},
+                                {3, {50.0, 8.00}},
+                                {4, {50.0, 7.00}},
+                                {1, {40.0, 7.00}},
+                            }));
+  osmium::builder::add_area(osmiumBuffer3, osmium::builder::attr::_id(26),
+                            osmium::builder::attr::_tag("name", "26"),
+                            osmium::builder::attr::_outer_ring({
+                                {1, {40.0, 7.51}},
+                                {2, {40.0, 7.61}},
+                                {3, {40.1, 7.61}},
+                                {4, {40.1, 7.51}},
+                                {1, {40.0, 7.51}},
+                            }));
+  osmium::builder::add_area(osmiumBuffer4, osmium::builder::attr::_id(28),
+                            osmium::builder::attr::_tag("name", "28"),
+                            osmium::builder::attr::_outer_ring({
+                                {1, {20.0, 0.51}},
+                                {2, {20.0, 10.61}},
+                                {3, {50.1, 10.61}},
+                                {4, {50.1, 0.51}},
+                                {1, {20.0, 0.51}},
+                            }));
+
+  // Create osm2rdf object from osmium object
+  auto area1 = osm2rdf::osm::Area(osmiumBuffer1.get<osmium::Area>(0));
+  auto area2 = osm2rdf::osm::Area(osmiumBuffer2.get<osmium::Area>(0));
+  auto area3 = osm2rdf::osm::Area(osmiumBuffer3.get<osmium::Area>(0));
+  auto area4 = osm2rdf::osm::Area(osmiumBuffer4.get<osmium::Area>(0));
+  area1.finalize();
+  area2.finalize();
+  area3.finalize();
+  area4.finalize();
+
+  gh.area(area1);
+  gh.area(area2);
+  gh.area(area3);
+  gh.area(area4);
+
+  gh.flushExternalStorage();
+
+  gh.prepareRTree();
+  ASSERT_EQ(size_t{1} << 12, gh._nodeGridOffsets.size() - 1);
+
+  // The grid yields the same covers as the box ids of all areas.
+  size_t numFull = 0;
+  for (int32_t boxId = 1; boxId <= 1 << 16; boxId++) {
+    std::vector<std::pair<size_t, int8_t>> expected;
+    for (size_t i = gh._spatialStorageArea.size(); i-- > 0;) {
+      const auto cover = gh.boxIdCover(boxId, gh.areaView(i).boxIds);
+      if (cover != 0) {
+        expected.emplace_back(i, cover);
+      }
+    }
+    std::vector<std::pair<size_t, int8_t>> actual;
+    for (const auto& [areaRef, cover] : gh.nodeGridQry(boxId)) {
+      actual.emplace_back(areaRef.second, cover);
+    }
+    ASSERT_EQ(expected, actual);
+  }
+  for (const auto entry : gh._nodeGridAreas) {
+    numFull += (entry & osm2rdf::osm::NODE_GRID_FULL) != 0;
+  }
+  ASSERT_LT(0, numFull);
+  ASSERT_GT(gh._nodeGridAreas.size(), numFull);
+
+  output.flush();
+  output.close();
+
+  // Reset std::cerr and std::cout
+  std::cerr.rdbuf(cerrBufferOrig);
+  std::cout.rdbuf(coutBufferOrig);
+}
+
 // ____________________________________________________________________________
 TEST(OSM_GeometryHandler, prepareDAGEmpty) {
   // Capture std::cerr and std::cout
@@ -1370,9 +1479,9 @@ TEST(OSM_GeometryHandler, dumpUnnamedAreaRelationsSimpleIntersects) {
   gh.area(area3);
   gh.area(area4);
 
-  ASSERT_EQ(0, gh._numUnnamedAreas);
+  ASSERT_EQ(0, gh._unnamedAreas.size());
   gh.area(area5);
-  ASSERT_EQ(1, gh._numUnnamedAreas);
+  ASSERT_EQ(1, gh._unnamedAreas.size());
   gh.flushExternalStorage();
   gh.prepareRTree();
   gh.prepareDAG();
@@ -1498,9 +1607,9 @@ TEST(OSM_GeometryHandler, dumpUnnamedAreaRelationsSimpleContainsOnly) {
   gh.area(area3);
   gh.area(area4);
 
-  ASSERT_EQ(0, gh._numUnnamedAreas);
+  ASSERT_EQ(0, gh._unnamedAreas.size());
   gh.area(area5);
-  ASSERT_EQ(1, gh._numUnnamedAreas);
+  ASSERT_EQ(1, gh._unnamedAreas.size());
   gh.flushExternalStorage();
   gh.prepareRTree();
   gh.prepareDAG();
@@ -1787,9 +1896,9 @@ TEST(OSM_GeometryHandler, dumpNodeRelationsSimpleIntersects) {
   gh.area(area3);
   gh.area(area4);
 
-  ASSERT_EQ(0, gh._numNodes);
-  gh.node(osm2rdf::osm::Node(osmiumBuffer5.get<osmium::Node>(0)));
-  ASSERT_EQ(1, gh._numNodes);
+  ASSERT_EQ(0, gh._nodes.size());
+  gh.node(osm2rdf::osm::NodeView(osmiumBuffer5.get<osmium::Node>(0)));
+  ASSERT_EQ(1, gh._nodes.size());
   gh.flushExternalStorage();
   gh.prepareRTree();
   gh.prepareDAG();
@@ -1908,9 +2017,9 @@ TEST(OSM_GeometryHandler, dumpNodeRelationsSimpleContains) {
   gh.area(area3);
   gh.area(area4);
 
-  ASSERT_EQ(0, gh._numNodes);
-  gh.node(osm2rdf::osm::Node(osmiumBuffer5.get<osmium::Node>(0)));
-  ASSERT_EQ(1, gh._numNodes);
+  ASSERT_EQ(0, gh._nodes.size());
+  gh.node(osm2rdf::osm::NodeView(osmiumBuffer5.get<osmium::Node>(0)));
+  ASSERT_EQ(1, gh._nodes.size());
   gh.flushExternalStorage();
   gh.prepareRTree();
   gh.prepareDAG();
@@ -1933,6 +2042,214 @@ TEST(OSM_GeometryHandler, dumpNodeRelationsSimpleContains) {
   std::cout.rdbuf(coutBufferOrig);
 }
 
+// ____________________________________________________________________________
+TEST(OSM_GeometryHandler, dumpNodeRelationsSimpleContainsNodeGrid) {
+  // Capture std::cerr and std::cout
+  std::stringstream cerrBuffer;
+  std::stringstream coutBuffer;
+  std::streambuf* cerrBufferOrig = std::cerr.rdbuf();
+  std::streambuf* coutBufferOrig = std::cout.rdbuf();
+  std::cerr.rdbuf(cerrBuffer.rdbuf());
+  std::cout.rdbuf(coutBuffer.rdbuf());
+
+  osm2rdf::config::Config config;
+  config.output = "";
+  config.outputCompress = false;
+  config.mergeOutput = osm2rdf::util::OutputMergeMode::NONE;
+  config.nodeGridLevels = 8;
+  osm2rdf::util::Output output{config, config.output};
+  output.open();
+  osm2rdf::ttl::Writer<osm2rdf::ttl::format::TTL> writer{config, &output};
+  osm2rdf::osm::GeometryHandler gh{config, &writer};
+
+  // Create osmium objects
+  /*
+           28 (14)
+             |
+           24 (12)
+            /  \
+     22 (11)    26 (13)
+   */
+  const size_t initial_buffer_size = 10000;
+  osmium::memory::Buffer osmiumBuffer1{initial_buffer_size,
+                                       osmium::memory::Buffer::auto_grow::yes};
+  osmium::memory::Buffer osmiumBuffer2{initial_buffer_size,
+                                       osmium::memory::Buffer::auto_grow::yes};
+  osmium::memory::Buffer osmiumBuffer3{initial_buffer_size,
+                                       osmium::memory::Buffer::auto_grow::yes};
+  osmium::memory::Buffer osmiumBuffer4{initial_buffer_size,
+                                       osmium::memory::Buffer::auto_grow::yes};
+  osmium::memory::Buffer osmiumBuffer5{initial_buffer_size,
+                                       osmium::memory::Buffer::auto_grow::yes};
+  osmium::builder::add_area(osmiumBuffer1, osmium::builder::attr::_id(22),
+                            osmium::builder::attr::_tag("name", "22"),
+                            osmium::builder::attr::_outer_ring({
+                                {1, {48.0, 7.51}},
+                                {2, {48.0, 7.61}},
+                                {3, {48.1, 7.61}},
+                                {4, {48.1, 7.51}},
+                                {1, {48.0, 7.51}},
+                            }));
+  osmium::builder::add_area(osmiumBuffer2, osmium::builder::attr::_id(24),
+                            osmium::builder::attr::_tag("name", "24"),
+                            osmium::builder::attr::_outer_ring({
+                                {1, {40.0, 7.00}},
+                                {2, {40.0, 8.00}},
+                                {3, {50.0, 8.00}},
+                                {4, {50.0, 7.00}},
+                                {1, {40.0, 7.00}},
+                            }));
+  osmium::builder::add_area(osmiumBuffer3, osmium::builder::attr::_id(26),
+                            osmium::builder::attr::_tag("name", "26"),
+                            osmium::builder::attr::_outer_ring({
+                                {1, {40.0, 7.51}},
+                                {2, {40.0, 7.61}},
+                                {3, {40.1, 7.61}},
+                                {4, {40.1, 7.51}},
+                                {1, {40.0, 7.51}},
+                            }));
+  osmium::builder::add_area(osmiumBuffer4, osmium::builder::attr::_id(28),
+                            osmium::builder::attr::_tag("name", "28"),
+                            osmium::builder::attr::_outer_ring({
+                                {1, {20.0, 0.51}},
+                                {2, {20.0, 10.61}},
+                                {3, {50.1, 10.61}},
+                                {4, {50.1, 0.51}},
+                                {1, {20.0, 0.51}},
+                            }));
+  // Contained in 11.
+  osmium::builder::add_node(
+      osmiumBuffer5, osmium::builder::attr::_id(42),
+      osmium::builder::attr::_location(osmium::Location(48.05, 7.56)),
+      osmium::builder::attr::_tag("foo", "bar"));
+
+  // Create osm2rdf object from osmium object
+  auto area1 = osm2rdf::osm::Area(osmiumBuffer1.get<osmium::Area>(0));
+  auto area2 = osm2rdf::osm::Area(osmiumBuffer2.get<osmium::Area>(0));
+  auto area3 = osm2rdf::osm::Area(osmiumBuffer3.get<osmium::Area>(0));
+  auto area4 = osm2rdf::osm::Area(osmiumBuffer4.get<osmium::Area>(0));
+
+  area1.finalize();
+  area2.finalize();
+  area3.finalize();
+  area4.finalize();
+
+  gh.area(area1);
+  gh.area(area2);
+  gh.area(area3);
+  gh.area(area4);
+
+  ASSERT_EQ(0, gh._nodes.size());
+  gh.node(osm2rdf::osm::NodeView(osmiumBuffer5.get<osmium::Node>(0)));
+  ASSERT_EQ(1, gh._nodes.size());
+  gh.flushExternalStorage();
+  gh.prepareRTree();
+  gh.prepareDAG();
+
+  const auto nd = gh.dumpNodeRelations();
+  ASSERT_EQ(1, nd.size());
+
+  output.flush();
+  output.close();
+
+  const std::string printedData = coutBuffer.str();
+  ASSERT_EQ(
+      "osmway:11 osm2rdf:intersects_nonarea osmnode:42 .\n"
+      "osmnode:42 osm2rdf:intersects_area osmway:11 .\n"
+      "osmway:11 osm2rdf:contains_nonarea osmnode:42 .\n",
+      printedData);
+
+  // Reset std::cerr and std::cout
+  std::cerr.rdbuf(cerrBufferOrig);
+  std::cout.rdbuf(coutBufferOrig);
+}
+
+// ____________________________________________________________________________
+TEST(OSM_GeometryHandler, dumpNodeRelationsMultipleOuterSameCell) {
+  // Capture std::cerr and std::cout
+  std::stringstream cerrBuffer;
+  std::stringstream coutBuffer;
+  std::streambuf* cerrBufferOrig = std::cerr.rdbuf();
+  std::streambuf* coutBufferOrig = std::cout.rdbuf();
+  std::cerr.rdbuf(cerrBuffer.rdbuf());
+  std::cout.rdbuf(coutBuffer.rdbuf());
+
+  osm2rdf::config::Config config;
+  config.output = "";
+  config.outputCompress = false;
+  config.mergeOutput = osm2rdf::util::OutputMergeMode::NONE;
+  osm2rdf::util::Output output{config, config.output};
+  output.open();
+  osm2rdf::ttl::Writer<osm2rdf::ttl::format::TTL> writer{config, &output};
+  osm2rdf::osm::GeometryHandler gh{config, &writer};
+
+  // Relation 11 with two outer rings inside the same grid cell and one node
+  // in each ring.
+  const size_t initial_buffer_size = 10000;
+  osmium::memory::Buffer osmiumBuffer1{initial_buffer_size,
+                                       osmium::memory::Buffer::auto_grow::yes};
+  osmium::memory::Buffer osmiumBuffer2{initial_buffer_size,
+                                       osmium::memory::Buffer::auto_grow::yes};
+  osmium::builder::add_area(osmiumBuffer1, osmium::builder::attr::_id(23),
+                            osmium::builder::attr::_tag("name", "23"),
+                            osmium::builder::attr::_outer_ring({
+                                {1, {48.000, 7.500}},
+                                {2, {48.000, 7.505}},
+                                {3, {48.005, 7.505}},
+                                {4, {48.005, 7.500}},
+                                {1, {48.000, 7.500}},
+                            }),
+                            osmium::builder::attr::_outer_ring({
+                                {5, {48.015, 7.500}},
+                                {6, {48.015, 7.505}},
+                                {7, {48.020, 7.505}},
+                                {8, {48.020, 7.500}},
+                                {5, {48.015, 7.500}},
+                            }));
+  osmium::builder::add_node(
+      osmiumBuffer2, osmium::builder::attr::_id(42),
+      osmium::builder::attr::_location(osmium::Location(48.0025, 7.5025)),
+      osmium::builder::attr::_tag("foo", "bar"));
+  osmium::builder::add_node(
+      osmiumBuffer2, osmium::builder::attr::_id(43),
+      osmium::builder::attr::_location(osmium::Location(48.0175, 7.5025)),
+      osmium::builder::attr::_tag("foo", "bar"));
+
+  auto area = osm2rdf::osm::Area(osmiumBuffer1.get<osmium::Area>(0));
+  area.finalize();
+  gh.area(area);
+
+  for (const auto& node : osmiumBuffer2.select<osmium::Node>()) {
+    gh.node(osm2rdf::osm::NodeView(node));
+  }
+  ASSERT_EQ(2, gh._nodes.size());
+  gh.flushExternalStorage();
+  gh.prepareRTree();
+  ASSERT_EQ(3, gh.areaView(0).envelopes.size());
+  ASSERT_EQ(gh.getBoxId(osm2rdf::geometry::Location(48.0025, 7.5025)),
+            gh.getBoxId(osm2rdf::geometry::Location(48.0175, 7.5025)));
+  gh.prepareDAG();
+
+  const auto nd = gh.dumpNodeRelations();
+  ASSERT_EQ(2, nd.size());
+
+  output.flush();
+  output.close();
+
+  const std::string printedData = coutBuffer.str();
+  for (const std::string node : {"osmnode:42", "osmnode:43"}) {
+    ASSERT_NE(std::string::npos,
+              printedData.find("osmrel:11 osm2rdf:contains_nonarea " + node +
+                               " .\n"));
+    ASSERT_NE(std::string::npos,
+              printedData.find(node + " osm2rdf:intersects_area osmrel:11 .\n"));
+  }
+
+  // Reset std::cerr and std::cout
+  std::cerr.rdbuf(cerrBufferOrig);
+  std::cout.rdbuf(coutBufferOrig);
+}
+
 // ____________________________________________________________________________
 TEST(OSM_GeometryHandler, noWayGeometricRelations) {
   // Capture std::cerr and std::cout
@@ -2200,9 +2517,9 @@ TEST(OSM_GeometryHandler, dumpWayRelationsSimpleIntersects) {
   gh.area(area3);
   gh.area(area4);
 
-  ASSERT_EQ(0, gh._numWays);
-  gh.way(osm2rdf::osm::Way(osmiumBuffer5.get<osmium::Way>(0)));
-  ASSERT_EQ(1, gh._numWays);
+  ASSERT_EQ(0, gh._ways.size());
+  gh.way(osm2rdf::osm::WayView(osmiumBuffer5.get<osmium::Way>(0)));
+  ASSERT_EQ(1, gh._ways.size());
   gh.flushExternalStorage();
   gh.prepareRTree();
   gh.prepareDAG();
@@ -2324,9 +2641,9 @@ TEST(OSM_GeometryHandler, dumpWayRelationsSimpleContains) {
   gh.area(area3);
   gh.area(area4);
 
-  ASSERT_EQ(0, gh._numWays);
-  gh.way(osm2rdf::osm::Way(osmiumBuffer5.get<osmium::Way>(0)));
-  ASSERT_EQ(1, gh._numWays);
+  ASSERT_EQ(0, gh._ways.size());
+  gh.way(osm2rdf::osm::WayView(osmiumBuffer5.get<osmium::Way>(0)));
+  ASSERT_EQ(1, gh._ways.size());
   gh.flushExternalStorage();
   gh.prepareRTree();
   gh.prepareDAG();
@@ -2458,9 +2775,9 @@ TEST(OSM_GeometryHandler, dumpWayRelationsSimpleIntersectsWithNodeInfo) {
   gh.area(area3);
   gh.area(area4);
 
-  gh.way(osm2rdf::osm::Way(osmiumBuffer5.get<osmium::Way>(0)));
-  gh.node(osm2rdf::osm::Node(osmiumBuffer6.get<osmium::Node>(0)));
-  gh.node(osm2rdf::osm::Node(osmiumBuffer7.get<osmium::Node>(0)));
+  gh.way(osm2rdf::osm::WayView(osmiumBuffer5.get<osmium::Way>(0)));
+  gh.node(osm2rdf::osm::NodeView(osmiumBuffer6.get<osmium::Node>(0)));
+  gh.node(osm2rdf::osm::NodeView(osmiumBuffer7.get<osmium::Node>(0)));
   gh.flushExternalStorage();
   gh.prepareRTree();
   gh.prepareDAG();
@@ -2606,10 +2923,10 @@ TEST(OSM_GeometryHandler, dumpWayRelationsSimpleContainsWithNodeInfo) {
   gh.area(area3);
   gh.area(area4);
 
-  ASSERT_EQ(0, gh._numWays);
-  gh.way(osm2rdf::osm::Way(osmiumBuffer5.get<osmium::Way>(0)));
-  ASSERT_EQ(1, gh._numWays);
-  gh.node(osm2rdf::osm::Node(osmiumBuffer6.get<osmium::Node>(0)));
+  ASSERT_EQ(0, gh._ways.size());
+  gh.way(osm2rdf::osm::WayView(osmiumBuffer5.get<osmium::Way>(0)));
+  ASSERT_EQ(1, gh._ways.size());
+  gh.node(osm2rdf::osm::NodeView(osmiumBuffer6.get<osmium::Node>(0)));
   gh.flushExternalStorage();
   gh.prepareRTree();
   gh.prepareDAG();
@@ -2677,14 +2994,14 @@ TEST(OSM_GeometryHandler, simplifyGeometryArea) {
   ASSERT_EQ(1, gh._spatialStorageArea.size());
 
   // Compare stored area with original
-  const auto& dst = gh._spatialStorageArea[0];
-  ASSERT_TRUE(std::get<0>(dst).size() > 0);
-  ASSERT_TRUE(src.envelope() == std::get<0>(dst)[0]);
-  ASSERT_TRUE(src.id() == std::get<1>(dst));
-  ASSERT_TRUE(src.geom() != std::get<2>(dst));
+  const auto dst = gh.areaView(0);
+  ASSERT_TRUE(dst.envelopes.size() > 0);
+  ASSERT_TRUE(src.envelope() == dst.envelopes[0]);
+  ASSERT_TRUE(src.id() == dst.id);
+  ASSERT_TRUE(src.geom() != dst.geometry->geom);
   // Access rings
   const auto srcRings = src.geom();
-  const auto dstRings = std::get<2>(dst);
+  const auto dstRings = dst.geometry->geom;
   ASSERT_EQ(1, srcRings.size());
   ASSERT_EQ(1, dstRings.size());
   const auto srcRing = srcRings[0];
@@ -2727,20 +3044,16 @@ TEST(OSM_GeometryHandler, simplifyGeometryWay) {
   const osm2rdf::osm::Way src{buffer.get<osmium::Way>(0)};
   ASSERT_EQ(3, src.geom().size());
 
-  ASSERT_EQ(0, gh._numWays);
-  gh.way(src);
-  ASSERT_EQ(1, gh._numWays);
+  ASSERT_EQ(0, gh._ways.size());
+  gh.way(osm2rdf::osm::WayView{buffer.get<osmium::Way>(0)});
+  ASSERT_EQ(1, gh._ways.size());
 
   // Read area from dump and compare
   osm2rdf::osm::SpatialWayValue dst;
 
   gh.flushExternalStorage();
-  auto& ifs = gh.getFsWays();
-  ifs.clear();
-  ifs.seekg(0, std::ios::beg);
-  boost::archive::binary_iarchive ia(ifs);
-  ia >> dst;
-  ifs.close();
+  ASSERT_EQ(1, gh._ways.size());
+  gh._ways.get(0, &dst);
 
   // Compare stored area with original
   ASSERT_TRUE(src.envelope() == std::get<0>(dst));
@@ -2835,4 +3148,27 @@ TEST(OSM_GeometryHandler, boxIdintersect) {
   }
 }
 
+// ____________________________________________________________________________
+TEST(OSM_GeometryHandler, boxIdCover) {
+  osm2rdf::config::Config config;
+  osm2rdf::util::Output output{config, config.output};
+  osm2rdf::ttl::Writer<osm2rdf::ttl::format::NT> writer{config, &output};
+  osm2rdf::osm::GeometryHandler gh{config, &writer};
+
+  // first element is size marker! Runs cover the ids 3-5, 8 and 10-11.
+  osm2rdf::osm::BoxIdList ids{{6, 0}, {3, 2}, {-8, 0}, {10, 1}};
+  ASSERT_EQ(0, gh.boxIdCover(1, ids));
+  ASSERT_EQ(0, gh.boxIdCover(2, ids));
+  ASSERT_EQ(1, gh.boxIdCover(3, ids));
+  ASSERT_EQ(1, gh.boxIdCover(5, ids));
+  ASSERT_EQ(0, gh.boxIdCover(6, ids));
+  ASSERT_EQ(-1, gh.boxIdCover(8, ids));
+  ASSERT_EQ(0, gh.boxIdCover(9, ids));
+  ASSERT_EQ(1, gh.boxIdCover(10, ids));
+  ASSERT_EQ(1, gh.boxIdCover(11, ids));
+  ASSERT_EQ(0, gh.boxIdCover(12, ids));
+
+  ASSERT_EQ(0, gh.boxIdCover(3, osm2rdf::osm::BoxIdList{{0, 0}}));
+}
+
 }  // namespace osm2rdf::osm
@@ -0,0 +1,232 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/LocationHandler.h"
+
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "osm2rdf/config/Config.h"
+#include "osmium/builder/attr.hpp"
+#include "osmium/builder/osm_object_builder.hpp"
+#include "osmium/visitor.hpp"
+
+namespace osm2rdf::osm {
+
+// ____________________________________________________________________________
+void checkBatchedLookup(const osm2rdf::config::Config& config) {
+  const size_t initial_buffer_size = 10000;
+  osmium::memory::Buffer osmiumBuffer{initial_buffer_size,
+                                      osmium::memory::Buffer::auto_grow::yes};
+  for (int64_t id = 1; id <= 1000; id += 2) {
+    osmium::builder::add_node(
+        osmiumBuffer, osmium::builder::attr::_id(id),
+        osmium::builder::attr::_location(
+            osmium::Location(static_cast<double>(id) / 100.0, -1.0)));
+  }
+  std::unique_ptr<LocationHandler> locationHandler{
+      LocationHandler::create(config)};
+  for (const auto& node : osmiumBuffer.select<osmium::Node>()) {
+    locationHandler->node(node);
+  }
+  // Relations follow the nodes and look up their members afterwards.
+  osmium::builder::add_relation(
+      osmiumBuffer, osmium::builder::attr::_id(1),
+      osmium::builder::attr::_member(osmium::item_type::node, 1, ""));
+  for (const auto& relation : osmiumBuffer.select<osmium::Relation>()) {
+    locationHandler->relation(relation);
+  }
+
+  // Unsorted, with duplicates and missing nodes.
+  const std::vector<uint64_t> ids{999, 1, 2, 501, 1, 999, 5000, 3};
+  std::vector<osmium::Location> locations(ids.size());
+  locationHandler->get_node_locations(ids.data(), ids.size(),
+                                      locations.data());
+  for (size_t i = 0; i < ids.size(); ++i) {
+    ASSERT_EQ(locationHandler->get_node_location(ids[i]), locations[i]);
+  }
+  ASSERT_EQ(osmium::Location(9.99, -1.0), locations[0]);
+  ASSERT_EQ(osmium::Location(0.01, -1.0), locations[1]);
+  ASSERT_FALSE(locations[2].valid());
+  ASSERT_EQ(osmium::Location(5.01, -1.0), locations[3]);
+  ASSERT_EQ(locations[1], locations[4]);
+  ASSERT_FALSE(locations[6].valid());
+}
+
+// ____________________________________________________________________________
+TEST(OSM_LocationHandler, getNodeLocationsRAM) {
+  osm2rdf::config::Config config;
+  checkBatchedLookup(config);
+}
+
+// ____________________________________________________________________________
+TEST(OSM_LocationHandler, getNodeLocationsCompressed) {
+  osm2rdf::config::Config config;
+  config.storeLocationsOnDisk = "compressed";
+  checkBatchedLookup(config);
+}
+
+// ____________________________________________________________________________
+TEST(OSM_LocationHandler, compressedWayAfterNodes) {
+  osm2rdf::config::Config config;
+  config.storeLocationsOnDisk = "compressed";
+  const size_t initial_buffer_size = 10000;
+  osmium::memory::Buffer osmiumBuffer{initial_buffer_size,
+                                      osmium::memory::Buffer::auto_grow::yes};
+  for (int64_t id = 1; id <= 1000; id += 2) {
+    osmium::builder::add_node(
+        osmiumBuffer, osmium::builder::attr::_id(id),
+        osmium::builder::attr::_location(
+            osmium::Location(static_cast<double>(id) / 100.0, -1.0)));
+  }
+  osmium::builder::add_way(osmiumBuffer, osmium::builder::attr::_id(1),
+                           osmium::builder::attr::_nodes({
+                               {999, {}},
+                               {2, {}},
+                               {1, {}},
+                           }));
+  std::unique_ptr<LocationHandler> locationHandler{
+      LocationHandler::create(config)};
+  ASSERT_NE(nullptr,
+            dynamic_cast<LocationHandlerCompressed*>(locationHandler.get()));
+  osmium::apply(osmiumBuffer, *locationHandler);
+
+  for (const auto& way : osmiumBuffer.select<osmium::Way>()) {
+    ASSERT_EQ(osmium::Location(9.99, -1.0), way.nodes()[0].location());
+    ASSERT_FALSE(way.nodes()[1].location().valid());
+    ASSERT_EQ(osmium::Location(0.01, -1.0), way.nodes()[2].location());
+  }
+  ASSERT_EQ(osmium::Location(5.01, -1.0),
+            locationHandler->get_node_location(501));
+}
+
+// ____________________________________________________________________________
+// Collects nodes around the 512-bit block boundaries of the bitmap.
+void collectNeededNodes(NeededNodes* neededNodes) {
+  const size_t initial_buffer_size = 10000;
+  osmium::memory::Buffer osmiumBuffer{initial_buffer_size,
+                                      osmium::memory::Buffer::auto_grow::yes};
+  osmium::builder::add_way(osmiumBuffer, osmium::builder::attr::_id(1),
+                           osmium::builder::attr::_nodes({
+                               {511, {}},
+                               {1, {}},
+                               {512, {}},
+                               {513, {}},
+                               {1, {}},
+                               {1024, {}},
+                           }));
+  osmium::builder::add_relation(
+      osmiumBuffer, osmium::builder::attr::_id(1),
+      osmium::builder::attr::_member(osmium::item_type::node, 2000, ""),
+      osmium::builder::attr::_member(osmium::item_type::way, 7, ""));
+  for (const auto& way : osmiumBuffer.select<osmium::Way>()) {
+    neededNodes->way(way);
+  }
+  for (const auto& relation : osmiumBuffer.select<osmium::Relation>()) {
+    neededNodes->relation(relation);
+  }
+  neededNodes->prepare_for_lookup();
+}
+
+// ____________________________________________________________________________
+TEST(OSM_NeededNodes, bitmap) {
+  NeededNodes neededNodes;
+  collectNeededNodes(&neededNodes);
+  const auto& bitmap = neededNodes.bitmap();
+
+  ASSERT_EQ(6, bitmap.count());
+  for (const uint64_t id : {1, 511, 512, 513, 1024, 2000}) {
+    ASSERT_TRUE(bitmap.test(id)) << id;
+  }
+  // Way members and unreferenced nodes are not needed.
+  for (const uint64_t id : {0, 2, 7, 510, 514, 1023, 1025, 1999, 5000}) {
+    ASSERT_FALSE(bitmap.test(id)) << id;
+  }
+  ASSERT_EQ(0, bitmap.rank(1));
+  ASSERT_EQ(1, bitmap.rank(511));
+  ASSERT_EQ(2, bitmap.rank(512));
+  ASSERT_EQ(3, bitmap.rank(513));
+  ASSERT_EQ(4, bitmap.rank(1024));
+  ASSERT_EQ(5, bitmap.rank(2000));
+}
+
+// ____________________________________________________________________________
+TEST(OSM_LocationHandler, neededNodesOnly) {
+  osm2rdf::config::Config config;
+  config.storeNeededLocationsOnly = true;
+  NeededNodes neededNodes;
+  collectNeededNodes(&neededNodes);
+
+  const size_t initial_buffer_size = 10000;
+  osmium::memory::Buffer osmiumBuffer{initial_buffer_size,
+                                      osmium::memory::Buffer::auto_grow::yes};
+  for (int64_t id = 1; id <= 2000; ++id) {
+    osmium::builder::add_node(
+        osmiumBuffer, osmium::builder::attr::_id(id),
+        osmium::builder::attr::_location(
+            osmium::Location(static_cast<double>(id) / 100.0, -1.0)));
+  }
+  std::unique_ptr<LocationHandler> locationHandler{
+      LocationHandler::create(config, &neededNodes.bitmap())};
+  ASSERT_NE(nullptr,
+            dynamic_cast<LocationHandlerNeeded*>(locationHandler.get()));
+  for (const auto& node : osmiumBuffer.select<osmium::Node>()) {
+    locationHandler->node(node);
+  }
+
+  // Stored at the rank of their id, across block boundaries.
+  for (const uint64_t id : {1, 511, 512, 513, 1024, 2000}) {
+    ASSERT_EQ(osmium::Location(static_cast<double>(id) / 100.0, -1.0),
+              locationHandler->get_node_location(id))
+        << id;
+  }
+  // Seen but not needed, or never seen.
+  for (const uint64_t id : {2, 7, 510, 514, 1023, 5000}) {
+    ASSERT_FALSE(locationHandler->get_node_location(id).valid()) << id;
+  }
+
+  // Unsorted, with duplicates and not needed nodes.
+  const std::vector<uint64_t> ids{2000, 513, 2, 511, 513, 1, 5000, 1024, 512};
+  std::vector<osmium::Location> locations(ids.size());
+  locationHandler->get_node_locations(ids.data(), ids.size(),
+                                      locations.data());
+  for (size_t i = 0; i < ids.size(); ++i) {
+    ASSERT_EQ(locationHandler->get_node_location(ids[i]), locations[i]);
+  }
+  ASSERT_EQ(osmium::Location(20.0, -1.0), locations[0]);
+  ASSERT_EQ(osmium::Location(5.13, -1.0), locations[1]);
+  ASSERT_FALSE(locations[2].valid());
+  ASSERT_EQ(locations[1], locations[4]);
+  ASSERT_FALSE(locations[6].valid());
+  ASSERT_EQ(osmium::Location(5.12, -1.0), locations[8]);
+
+  // Ways get the locations of their needed nodes.
+  osmium::builder::add_way(osmiumBuffer, osmium::builder::attr::_id(2),
+                           osmium::builder::attr::_nodes({
+                               {512, {}},
+                               {3, {}},
+                           }));
+  for (auto& way : osmiumBuffer.select<osmium::Way>()) {
+    locationHandler->way(way);
+    ASSERT_EQ(osmium::Location(5.12, -1.0), way.nodes()[0].location());
+    ASSERT_FALSE(way.nodes()[1].location().valid());
+  }
+}
+
+}  // namespace osm2rdf::osm
@@ -0,0 +1,73 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/NodeView.h"
+
+#include "boost/geometry.hpp"
+#include "gtest/gtest.h"
+#include "osm2rdf/osm/Node.h"
+#include "osmium/builder/attr.hpp"
+#include "osmium/builder/osm_object_builder.hpp"
+
+namespace osm2rdf::osm {
+
+// ____________________________________________________________________________
+TEST(OSM_NodeView, FromNodeWithTags) {
+  // Create osmium object
+  const size_t initial_buffer_size = 10000;
+  osmium::memory::Buffer osmiumBuffer{initial_buffer_size,
+                                      osmium::memory::Buffer::auto_grow::yes};
+  osmium::builder::add_node(
+      osmiumBuffer, osmium::builder::attr::_id(42),
+      osmium::builder::attr::_location(osmium::Location(7.51, 48.0)),
+      osmium::builder::attr::_tag("city", "Freiburg"));
+
+  const auto& osmiumNode = osmiumBuffer.get<osmium::Node>(0);
+  const osm2rdf::osm::NodeView n{osmiumNode};
+  ASSERT_EQ(42, n.id());
+
+  ASSERT_DOUBLE_EQ(7.51, n.geom().x());
+  ASSERT_DOUBLE_EQ(48.0, n.geom().y());
+
+  // Tags are not copied.
+  ASSERT_EQ(&osmiumNode.tags(), &n.tags());
+  ASSERT_EQ(1, n.tags().size());
+  ASSERT_STREQ("Freiburg", n.tags()["city"]);
+}
+
+// ____________________________________________________________________________
+TEST(OSM_NodeView, sameGeometriesAsNode) {
+  // Create osmium object
+  const size_t initial_buffer_size = 10000;
+  osmium::memory::Buffer osmiumBuffer{initial_buffer_size,
+                                      osmium::memory::Buffer::auto_grow::yes};
+  osmium::builder::add_node(
+      osmiumBuffer, osmium::builder::attr::_id(42),
+      osmium::builder::attr::_location(osmium::Location(7.51, 48.0)));
+
+  const osm2rdf::osm::Node node{osmiumBuffer.get<osmium::Node>(0)};
+  const osm2rdf::osm::NodeView view{osmiumBuffer.get<osmium::Node>(0)};
+  ASSERT_EQ(node.id(), view.id());
+  ASSERT_TRUE(boost::geometry::equals(node.geom(), view.geom()));
+  ASSERT_TRUE(boost::geometry::equals(node.envelope(), view.envelope()));
+  ASSERT_TRUE(boost::geometry::equals(node.convexHull(), view.convexHull()));
+  ASSERT_TRUE(boost::geometry::equals(node.orientedBoundingBox(),
+                                      view.orientedBoundingBox()));
+}
+
+}  // namespace osm2rdf::osm
@@ -18,6 +18,8 @@
 
 #include "osm2rdf/osm/OsmiumHandler.h"
 
+#include <algorithm>
+
 #include "gmock/gmock-matchers.h"
 #include "gtest/gtest.h"
 #include "osmium/builder/attr.hpp"
@@ -869,4 +871,86 @@ TEST(OSM_OsmiumHandler, handleOSMWikiExample) {
   std::filesystem::remove(config.input);
 }
 
+// ____________________________________________________________________________
+TEST(OSM_OsmiumHandler, handleThrottled) {
+  // Capture std::cerr and std::cout
+  std::stringstream cerrBuffer;
+  std::stringstream coutBuffer;
+  std::streambuf* cerrBufferOrig = std::cerr.rdbuf();
+  std::streambuf* coutBufferOrig = std::cout.rdbuf();
+  std::cerr.rdbuf(cerrBuffer.rdbuf());
+  std::cout.rdbuf(coutBuffer.rdbuf());
+
+  osm2rdf::config::Config config;
+  config.outputCompress = false;
+  config.mergeOutput = osm2rdf::util::OutputMergeMode::MERGE;
+
+  // Enough nodes to fill several osmium buffers, every 100th one is tagged.
+  config.input = config.getTempPath("OSM_OsmiumHandler", "throttled.osm");
+  std::ofstream inputFile(config.input);
+  inputFile << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            << "<osm version=\"0.6\" generator=\"osm2rdf\">\n";
+  for (size_t id = 1; id <= 200000; ++id) {
+    inputFile << " <node id=\"" << id << "\" lat=\""
+              << 48.0 + (id % 1000) * 0.001 << "\" lon=\""
+              << 7.5 + (id / 1000) * 0.001 << "\" version=\"1\"";
+    if (id % 100 == 0) {
+      inputFile << ">\n  <tag k=\"name\" v=\"" << id << "\"/>\n </node>\n";
+    } else {
+      inputFile << "/>\n";
+    }
+  }
+  inputFile << "</osm>" << std::endl;
+  inputFile.close();
+
+  // Converts the input and returns the sorted output lines and the number of
+  // buffers converted on the reading thread. inFlightBytes preloads the
+  // in-flight counter, so every buffer exceeds the limit.
+  const auto run = [&config](size_t maxInFlightMB, size_t inFlightBytes,
+                             const std::string& name) {
+    config.maxInFlightMB = maxInFlightMB;
+    config.output = config.getTempPath("OSM_OsmiumHandler", name);
+    size_t backpressure;
+    {
+      osm2rdf::util::Output output{config, config.output};
+      output.open();
+      osm2rdf::ttl::Writer<osm2rdf::ttl::format::TTL> writer{config, &output};
+
+      osm2rdf::osm::OsmiumHandler osmiumHandler{config, &writer};
+      osmiumHandler._inFlightBytes = inFlightBytes;
+      osmiumHandler.handle();
+      backpressure = osmiumHandler.backpressureTriggered();
+
+      output.flush();
+      output.close();
+    }
+    std::vector<std::string> lines;
+    std::ifstream outputFile(config.output);
+    for (std::string line; std::getline(outputFile, line);) {
+      lines.push_back(line);
+    }
+    outputFile.close();
+    std::filesystem::remove(config.output);
+    std::sort(lines.begin(), lines.end());
+    return std::make_pair(lines, backpressure);
+  };
+
+  const auto [expected, unthrottled] = run(1024, 0, "unthrottled.ttl");
+  ASSERT_EQ(0, unthrottled);
+  ASSERT_FALSE(expected.empty());
+
+  // Every buffer is converted on the reading thread.
+  const auto [forcedLines, forced] = run(0, 1, "forced.ttl");
+  ASSERT_GT(forced, 1);
+  ASSERT_EQ(expected, forcedLines);
+
+  // Buffers are only throttled while another one is still in flight.
+  ASSERT_EQ(expected, run(0, 0, "throttled.ttl").first);
+
+  // Reset std::cerr and std::cout
+  std::cerr.rdbuf(cerrBufferOrig);
+  std::cout.rdbuf(coutBufferOrig);
+  std::filesystem::remove(config.input);
+}
+
 }  // namespace osm2rdf::osm
\ No newline at end of file
@@ -0,0 +1,220 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/PreparedArea.h"
+
+#include <cmath>
+#include <iomanip>
+#include <random>
+#include <vector>
+
+#include "boost/geometry.hpp"
+#include "gtest/gtest.h"
+
+namespace osm2rdf::osm {
+
+static const PreparedArea::Kernel KERNELS[] = {PreparedArea::Kernel::SCALAR,
+                                               PreparedArea::Kernel::AVX2,
+                                               PreparedArea::Kernel::AVX512};
+
+// ____________________________________________________________________________
+TEST(OSM_PreparedArea, scalarAlwaysSupported) {
+  ASSERT_TRUE(PreparedArea::supported(PreparedArea::Kernel::SCALAR));
+  ASSERT_TRUE(PreparedArea::supported(PreparedArea::bestKernel()));
+}
+
+// ____________________________________________________________________________
+static osm2rdf::geometry::Area testArea() {
+  // A square with a square hole and a triangle, counter-clockwise outer rings
+  // are corrected below.
+  osm2rdf::geometry::Polygon square;
+  square.outer() = {{0, 0}, {0, 40}, {40, 40}, {40, 0}, {0, 0}};
+  square.inners().push_back({{10, 10}, {20, 10}, {20, 20}, {10, 20}, {10, 10}});
+  osm2rdf::geometry::Polygon triangle;
+  triangle.outer() = {{50, 0}, {70, 30}, {90, 0}, {50, 0}};
+  osm2rdf::geometry::Area area{square, triangle};
+  boost::geometry::correct(area);
+  return area;
+}
+
+// ____________________________________________________________________________
+TEST(OSM_PreparedArea, empty) {
+  const PreparedArea prepared{osm2rdf::geometry::Area{}};
+  ASSERT_EQ(0, prepared.numEdges());
+  ASSERT_FALSE(prepared.covers({0, 0}));
+}
+
+// ____________________________________________________________________________
+TEST(OSM_PreparedArea, edgesAndBands) {
+  const PreparedArea prepared{testArea()};
+  ASSERT_EQ(11, prepared.numEdges());
+  ASSERT_EQ(2, prepared.numBands());
+}
+
+// ____________________________________________________________________________
+TEST(OSM_PreparedArea, boundary) {
+  const PreparedArea prepared{testArea()};
+  // Vertices, points on horizontal, vertical and diagonal edges.
+  ASSERT_TRUE(prepared.covers({0, 0}));
+  ASSERT_TRUE(prepared.covers({40, 40}));
+  ASSERT_TRUE(prepared.covers({20, 40}));
+  ASSERT_TRUE(prepared.covers({0, 25}));
+  ASSERT_TRUE(prepared.covers({15, 10}));
+  ASSERT_TRUE(prepared.covers({20, 15}));
+  ASSERT_TRUE(prepared.covers({70, 30}));
+  ASSERT_TRUE(prepared.covers({60, 15}));
+  // Inside the hole and between the polygons.
+  ASSERT_FALSE(prepared.covers({15, 15}));
+  ASSERT_FALSE(prepared.covers({45, 10}));
+  // Ray through vertices.
+  ASSERT_TRUE(prepared.covers({30, 30}));
+  ASSERT_FALSE(prepared.covers({-10, 40}));
+  ASSERT_FALSE(prepared.covers({45, 0}));
+}
+
+// ____________________________________________________________________________
+TEST(OSM_PreparedArea, sameAsCoveredBy) {
+  // Many rings with many points, such that bands are used.
+  osm2rdf::geometry::Area area;
+  for (int p = 0; p < 5; ++p) {
+    osm2rdf::geometry::Polygon polygon;
+    const double cx = p * 300;
+    for (int i = 0; i < 200; ++i) {
+      // A star with alternating radius.
+      const double angle = 2 * M_PI * i / 200;
+      const int radius = i % 2 == 0 ? 100 : 90;
+      polygon.outer().emplace_back(cx + std::lround(radius * std::cos(angle)),
+                                   std::lround(radius * std::sin(angle)));
+    }
+    polygon.outer().push_back(polygon.outer().front());
+    polygon.inners().push_back(
+        {{cx - 10, -10}, {cx + 10, -10}, {cx + 10, 10}, {cx - 10, 10},
+         {cx - 10, -10}});
+    area.push_back(polygon);
+  }
+  boost::geometry::correct(area);
+  const PreparedArea prepared{area};
+  ASSERT_TRUE(prepared.numBands() > 10);
+
+  for (const auto kernel : KERNELS) {
+    if (!PreparedArea::supported(kernel)) {
+      continue;
+    }
+    for (int x = -120; x < 1320; x += 3) {
+      for (int y = -120; y <= 120; ++y) {
+        const osm2rdf::geometry::Location point(x, y);
+        ASSERT_EQ(boost::geometry::covered_by(point, area),
+                  prepared.covers(point, kernel));
+      }
+    }
+  }
+}
+
+// ____________________________________________________________________________
+TEST(OSM_PreparedArea, kernelsSameAsCoveredByRandom) {
+  // Irregular ring around Freiburg.
+  std::mt19937 random(42);
+  std::uniform_real_distribution<double> radius(0.5, 1.0);
+  std::uniform_real_distribution<double> lon(7.6, 8.1);
+  std::uniform_real_distribution<double> lat(47.8, 48.2);
+  osm2rdf::geometry::Polygon polygon;
+  for (int i = 0; i < 5000; ++i) {
+    const double angle = 2 * M_PI * i / 5000;
+    const double r = 0.2 * radius(random);
+    polygon.outer().emplace_back(7.85 + r * std::cos(angle),
+                                 48.0 + r * std::sin(angle));
+  }
+  polygon.outer().push_back(polygon.outer().front());
+  osm2rdf::geometry::Area area{polygon};
+  boost::geometry::correct(area);
+  const PreparedArea prepared{area};
+
+  for (int i = 0; i < 20000; ++i) {
+    const osm2rdf::geometry::Location point{lon(random), lat(random)};
+    // Vertices are on the boundary.
+    const auto& vertex = polygon.outer()[i % 5000];
+    const bool expected = boost::geometry::covered_by(point, area);
+    for (const auto kernel : KERNELS) {
+      if (!PreparedArea::supported(kernel)) {
+        continue;
+      }
+      ASSERT_EQ(expected, prepared.covers(point, kernel));
+      ASSERT_TRUE(prepared.covers(vertex, kernel));
+    }
+  }
+}
+
+// ____________________________________________________________________________
+TEST(OSM_PreparedArea, kernelsSameAsCoveredByNearDiagonalEdges) {
+  // Ring with diagonal edges in OSM precision around Freiburg, with a hole.
+  osm2rdf::geometry::Polygon polygon;
+  polygon.outer() = {{7.8421030, 47.9959310}, {7.8532114, 47.9987345},
+                     {7.8590271, 48.0061728}, {7.8514483, 48.0139917},
+                     {7.8407666, 48.0122041}, {7.8351209, 48.0048513},
+                     {7.8421030, 47.9959310}};
+  polygon.inners().push_back({{7.8461113, 48.0031870},
+                              {7.8489571, 48.0079902},
+                              {7.8521947, 48.0040125},
+                              {7.8461113, 48.0031870}});
+  osm2rdf::geometry::Area area{polygon};
+  boost::geometry::correct(area);
+  const PreparedArea prepared{area};
+
+  std::vector<osm2rdf::geometry::Location> points;
+  const auto addWithNeighbours = [&points](double x, double y) {
+    for (const double dx : {-1e-7, -1e-9, 0.0, 1e-9, 1e-7}) {
+      for (const double dy : {-1e-7, -1e-9, 0.0, 1e-9, 1e-7}) {
+        points.emplace_back(x + dx, y + dy);
+      }
+    }
+    // Closest doubles next to the point.
+    points.emplace_back(std::nextafter(x, 0.0), y);
+    points.emplace_back(std::nextafter(x, 180.0), y);
+    points.emplace_back(x, std::nextafter(y, 0.0));
+    points.emplace_back(x, std::nextafter(y, 90.0));
+  };
+  const auto addRing = [&addWithNeighbours](
+                           const osm2rdf::geometry::Ring& ring) {
+    for (size_t i = 0; i + 1 < ring.size(); ++i) {
+      const auto& a = ring[i];
+      const auto& b = ring[i + 1];
+      // Vertices and points on the edge, rounded to doubles.
+      for (int t = 0; t < 16; ++t) {
+        addWithNeighbours(a.x() + (b.x() - a.x()) * t / 16,
+                          a.y() + (b.y() - a.y()) * t / 16);
+      }
+      addWithNeighbours(a.x() + (b.x() - a.x()) / 3,
+                        a.y() + (b.y() - a.y()) / 3);
+    }
+  };
+  addRing(area[0].outer());
+  addRing(area[0].inners()[0]);
+
+  for (const auto& point : points) {
+    const bool expected = boost::geometry::covered_by(point, area);
+    for (const auto kernel : KERNELS) {
+      if (!PreparedArea::supported(kernel)) {
+        continue;
+      }
+      ASSERT_EQ(expected, prepared.covers(point, kernel))
+          << std::setprecision(17) << point.x() << " " << point.y();
+    }
+  }
+}
+
+}  // namespace osm2rdf::osm
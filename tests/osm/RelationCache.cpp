@@ -0,0 +1,188 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/RelationCache.h"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "gtest/gtest.h"
+#include "osm2rdf/config/Config.h"
+#include "osmium/builder/attr.hpp"
+#include "osmium/builder/osm_object_builder.hpp"
+
+namespace osm2rdf::osm {
+
+// ____________________________________________________________________________
+void writeRelations(osm2rdf::osm::RelationCache* relationCache) {
+  const size_t initial_buffer_size = 10000;
+  osmium::memory::Buffer osmiumBuffer{initial_buffer_size,
+                                      osmium::memory::Buffer::auto_grow::yes};
+  osmium::builder::add_relation(
+      osmiumBuffer, osmium::builder::attr::_id(42),
+      osmium::builder::attr::_member(osmium::item_type::way, 1, "outer"),
+      osmium::builder::attr::_tag("type", "multipolygon"));
+  osmium::builder::add_relation(
+      osmiumBuffer, osmium::builder::attr::_id(43),
+      osmium::builder::attr::_tag("type", "empty"));
+  for (const auto& relation : osmiumBuffer.select<osmium::Relation>()) {
+    relationCache->relation(relation);
+  }
+  relationCache->prepare_for_lookup();
+}
+
+// ____________________________________________________________________________
+TEST(OSM_RelationCache, storeAndLoad) {
+  osm2rdf::config::Config config;
+  config.relationCache = true;
+  config.input = config.getTempPath("OSM_RelationCache", "storeAndLoad");
+  std::ofstream(config.input) << "input";
+
+  {
+    osm2rdf::osm::RelationCache relationCache{config};
+    ASSERT_FALSE(relationCache.load());
+    writeRelations(&relationCache);
+  }
+  {
+    osm2rdf::osm::RelationCache relationCache{config};
+    ASSERT_TRUE(std::filesystem::exists(relationCache.path()));
+    ASSERT_TRUE(relationCache.load());
+    // Relations without members are not cached.
+    size_t count = 0;
+    for (const auto& relation :
+         relationCache.buffer().select<osmium::Relation>()) {
+      ASSERT_EQ(42, relation.id());
+      ASSERT_EQ(1, relation.members().size());
+      ASSERT_STREQ("multipolygon", relation.tags()["type"]);
+      count++;
+    }
+    ASSERT_EQ(1, count);
+    std::filesystem::remove(relationCache.path());
+  }
+  std::filesystem::remove(config.input);
+}
+
+// ____________________________________________________________________________
+TEST(OSM_RelationCache, disabled) {
+  osm2rdf::config::Config config;
+  config.input = config.getTempPath("OSM_RelationCache", "disabled");
+  std::ofstream(config.input) << "input";
+
+  osm2rdf::osm::RelationCache relationCache{config};
+  writeRelations(&relationCache);
+  ASSERT_FALSE(std::filesystem::exists(relationCache.path()));
+  ASSERT_FALSE(relationCache.load());
+  std::filesystem::remove(config.input);
+}
+
+// ____________________________________________________________________________
+TEST(OSM_RelationCache, unwritableCacheDirectory) {
+  std::stringstream cerrBuffer;
+  std::streambuf* cerrBufferOrig = std::cerr.rdbuf();
+  std::cerr.rdbuf(cerrBuffer.rdbuf());
+
+  osm2rdf::config::Config config;
+  config.relationCache = true;
+  config.input =
+      config.getTempPath("OSM_RelationCache", "unwritableCacheDirectory");
+  std::ofstream(config.input) << "input";
+  // Nothing can be created below a regular file, not even by root.
+  config.cache = config.input;
+
+  osm2rdf::osm::RelationCache relationCache{config};
+  ASSERT_NO_THROW(writeRelations(&relationCache));
+  ASSERT_FALSE(relationCache._config.relationCache);
+  ASSERT_FALSE(std::filesystem::exists(relationCache.path()));
+  ASSERT_FALSE(std::filesystem::exists(relationCache.tmpPath()));
+  ASSERT_FALSE(relationCache.load());
+  ASSERT_NE(std::string::npos,
+            cerrBuffer.str().find("not caching relations"));
+
+  std::cerr.rdbuf(cerrBufferOrig);
+  std::filesystem::remove(config.input);
+}
+
+// ____________________________________________________________________________
+TEST(OSM_RelationCache, inputHeaderChangesWithInput) {
+  osm2rdf::config::Config config;
+  config.relationCache = true;
+  config.input =
+      config.getTempPath("OSM_RelationCache", "inputHeaderChangesWithInput");
+  std::ofstream(config.input) << "input";
+
+  osm2rdf::osm::RelationCache relationCache{config};
+  const auto header = relationCache.inputHeader();
+  ASSERT_EQ(5, header.inputSize);
+  writeRelations(&relationCache);
+
+  // Same size, different content
+  std::ofstream(config.input) << "INPUT";
+  const auto changed = relationCache.inputHeader();
+  ASSERT_EQ(5, changed.inputSize);
+  ASSERT_NE(header.inputHash, changed.inputHash);
+
+  osm2rdf::osm::RelationCache other{config};
+  ASSERT_FALSE(other.load());
+  std::filesystem::remove(relationCache.path());
+  std::filesystem::remove(config.input);
+}
+
+// ____________________________________________________________________________
+TEST(OSM_RelationCache, inputHeaderChangesWithTail) {
+  osm2rdf::config::Config config;
+  config.relationCache = true;
+  config.input =
+      config.getTempPath("OSM_RelationCache", "inputHeaderChangesWithTail");
+  const std::string head(1U << 17U, 'x');
+  std::ofstream(config.input) << head << "tail";
+
+  osm2rdf::osm::RelationCache relationCache{config};
+  const auto header = relationCache.inputHeader();
+
+  // Same size and head, different tail
+  std::ofstream(config.input) << head << "TAIL";
+  const auto changed = relationCache.inputHeader();
+  ASSERT_EQ(header.inputSize, changed.inputSize);
+  ASSERT_NE(header.inputHash, changed.inputHash);
+  std::filesystem::remove(config.input);
+}
+
+// ____________________________________________________________________________
+TEST(OSM_RelationCache, pathDependsOnInputDirectory) {
+  osm2rdf::config::Config config;
+  const std::filesystem::path dir =
+      config.getTempPath("OSM_RelationCache", "pathDependsOnInputDirectory");
+  std::filesystem::create_directories(dir / "a");
+  std::filesystem::create_directories(dir / "b");
+  std::ofstream(dir / "a" / "input.osm") << "input";
+  std::ofstream(dir / "b" / "input.osm") << "input";
+
+  config.input = dir / "a" / "input.osm";
+  const auto pathA = osm2rdf::osm::RelationCache{config}.path();
+  config.input = dir / "b" / "input.osm";
+  const auto pathB = osm2rdf::osm::RelationCache{config}.path();
+  // Different spellings of the same input share the cache.
+  config.input = dir / "b" / ".." / "a" / "input.osm";
+  const auto pathSame = osm2rdf::osm::RelationCache{config}.path();
+  ASSERT_NE(pathA, pathB);
+  ASSERT_EQ(pathA, pathSame);
+  std::filesystem::remove_all(dir);
+}
+
+}  // namespace osm2rdf::osm
@@ -0,0 +1,270 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/SegmentedSpill.h"
+
+#include <omp.h>
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "osm2rdf/config/Config.h"
+#include "osm2rdf/osm/GeometryHandler.h"
+#include "osm2rdf/util/Hilbert.h"
+
+namespace osm2rdf::osm {
+
+// ____________________________________________________________________________
+TEST(OSM_SegmentedSpill, empty) {
+  osm2rdf::config::Config config;
+  SegmentedSpill<SpatialNodeValue> spill{
+      config.getTempPath("TEST_OSM_SegmentedSpill", "empty")};
+  ASSERT_EQ(0, spill.size());
+  spill.flush();
+  SpatialNodeValue value;
+  ASSERT_THROW(spill.get(0, &value), std::out_of_range);
+}
+
+// ____________________________________________________________________________
+TEST(OSM_SegmentedSpill, writeAndReadParallel) {
+  osm2rdf::config::Config config;
+  SegmentedSpill<SpatialNodeValue> spill{
+      config.getTempPath("TEST_OSM_SegmentedSpill", "writeAndReadParallel")};
+  const size_t count = 10000;
+#pragma omp parallel for
+  for (size_t i = 0; i < count; ++i) {
+    spill.write(SpatialNodeValue(
+        i, osm2rdf::geometry::Node(static_cast<double>(i), 1.0)));
+  }
+  ASSERT_EQ(count, spill.size());
+  spill.flush();
+
+  std::vector<size_t> seen(count, 0);
+#pragma omp parallel for
+  for (size_t i = 0; i < count; ++i) {
+    SpatialNodeValue value;
+    spill.get(i, &value);
+#pragma omp atomic
+    seen[std::get<0>(value)]++;
+  }
+  SpatialNodeValue value;
+  ASSERT_THROW(spill.get(count, &value), std::out_of_range);
+  for (size_t i = 0; i < count; ++i) {
+    ASSERT_EQ(1, seen[i]);
+  }
+}
+
+// ____________________________________________________________________________
+TEST(OSM_SegmentedSpill, wayRoundTrip) {
+  osm2rdf::config::Config config;
+  SegmentedSpill<SpatialWayValue> spill{
+      config.getTempPath("TEST_OSM_SegmentedSpill", "wayRoundTrip")};
+  SpatialWayValue way;
+  auto& [envelope, id, geom, nodeIds, boxes, boxIds, convexHull, obb] = way;
+  envelope = osm2rdf::geometry::Box{{0, 0}, {2, 1}};
+  id = 42;
+  geom = {{0, 0}, {1, 1}, {2, 0}};
+  nodeIds = {1, 1ULL << 40U, 3};
+  boxes = {envelope};
+  boxIds = {{-5, 2}, {7, 0}};
+  convexHull.outer() = {{0, 0}, {1, 1}, {2, 0}, {0, 0}};
+  spill.write(way);
+  spill.flush();
+
+  ASSERT_EQ(1, spill.size());
+  SpatialWayValue result;
+  spill.get(0, &result);
+  ASSERT_TRUE(envelope == std::get<0>(result));
+  ASSERT_EQ(id, std::get<1>(result));
+  ASSERT_TRUE(geom == std::get<2>(result));
+  ASSERT_EQ(nodeIds, std::get<3>(result));
+  ASSERT_EQ(1, std::get<4>(result).size());
+  ASSERT_TRUE(envelope == std::get<4>(result)[0]);
+  ASSERT_EQ(boxIds, std::get<5>(result));
+  ASSERT_TRUE(convexHull == std::get<6>(result));
+  ASSERT_TRUE(std::get<7>(result).outer().empty());
+}
+
+// ____________________________________________________________________________
+TEST(OSM_SegmentedSpill, areaRoundTrip) {
+  osm2rdf::config::Config config;
+  SegmentedSpill<SpatialAreaData> spill{
+      config.getTempPath("TEST_OSM_SegmentedSpill", "areaRoundTrip")};
+  osm2rdf::geometry::Polygon polygon;
+  polygon.outer() = {{0, 0}, {4, 0}, {4, 4}, {0, 4}, {0, 0}};
+  polygon.inners().push_back({{1, 1}, {2, 1}, {2, 2}, {1, 1}});
+  SpatialAreaData area;
+  area.envelopes = {osm2rdf::geometry::Box{{0, 0}, {4, 4}}};
+  area.id = 7;
+  area.objId = 3;
+  area.area = 15;
+  area.fromType = AreaFromType::WAY;
+  area.boxIds = {{12, 1}};
+  area.obb = osm2rdf::geometry::orientedBox(polygon, area.envelopes[0]);
+  area.geometry.geom = {polygon, polygon};
+  area.geometry.outer = {polygon};
+  area.geometry.cutouts[12] = {polygon};
+  area.geometry.cutouts[-3] = {};
+  spill.write(area);
+  spill.flush();
+
+  ASSERT_EQ(1, spill.size());
+  SpatialAreaData result;
+  spill.get(0, &result);
+  ASSERT_EQ(1, result.envelopes.size());
+  ASSERT_TRUE(area.envelopes[0] == result.envelopes[0]);
+  ASSERT_EQ(area.id, result.id);
+  ASSERT_EQ(area.objId, result.objId);
+  ASSERT_EQ(area.area, result.area);
+  ASSERT_EQ(area.fromType, result.fromType);
+  ASSERT_EQ(area.boxIds, result.boxIds);
+  for (size_t i = 0; i < area.obb.size(); ++i) {
+    ASSERT_TRUE(area.obb[i] == result.obb[i]);
+  }
+  const auto& geometry = result.geometry;
+  ASSERT_EQ(2, geometry.geom.size());
+  ASSERT_TRUE(polygon == geometry.geom[1]);
+  ASSERT_TRUE(geometry.inner.empty());
+  ASSERT_EQ(1, geometry.outer.size());
+  ASSERT_TRUE(polygon == geometry.outer[0]);
+  ASSERT_EQ(2, geometry.cutouts.size());
+  ASSERT_TRUE(polygon == geometry.cutouts.at(12)[0]);
+  ASSERT_TRUE(geometry.cutouts.at(-3).empty());
+  ASSERT_TRUE(geometry.convexHull.outer().empty());
+
+  // Decoding into a used value replaces its geometry.
+  spill.get(0, &result);
+  ASSERT_EQ(2, result.geometry.cutouts.size());
+}
+
+// ____________________________________________________________________________
+static uint64_t hilbertIndexOf(const osm2rdf::geometry::Node& node) {
+  return osm2rdf::util::hilbertIndex(
+      osm2rdf::util::hilbertCell(node.x(), -180, 180),
+      osm2rdf::util::hilbertCell(node.y(), -90, 90));
+}
+
+// ____________________________________________________________________________
+static osm2rdf::geometry::Node nodeAt(double lon, double lat) {
+  return {lon, lat};
+}
+
+// ____________________________________________________________________________
+TEST(OSM_SegmentedSpill, sortSpatially) {
+  osm2rdf::config::Config config;
+  SegmentedSpill<SpatialNodeValue> spill{
+      config.getTempPath("TEST_OSM_SegmentedSpill", "sortSpatially")};
+  // Written by one thread into a single segment. Nodes sharing their location
+  // keep their order.
+  const size_t count = 1000;
+  for (size_t i = 0; i < count; ++i) {
+    const auto cell = static_cast<double>(i / 2);
+    spill.write(SpatialNodeValue(
+        i, nodeAt(std::fmod(cell * 37, 360) - 180,
+                  std::fmod(cell * 11, 180) - 90)));
+  }
+  spill.flush();
+  spill.sortSpatially();
+
+  ASSERT_EQ(count, spill.size());
+  std::vector<size_t> seen(count, 0);
+  SpatialNodeValue previous;
+  spill.get(0, &previous);
+  seen[std::get<0>(previous)]++;
+  for (size_t i = 1; i < count; ++i) {
+    SpatialNodeValue value;
+    spill.get(i, &value);
+    seen[std::get<0>(value)]++;
+    const auto previousKey = hilbertIndexOf(std::get<1>(previous));
+    const auto key = hilbertIndexOf(std::get<1>(value));
+    ASSERT_TRUE(previousKey <= key);
+    if (previousKey == key) {
+      ASSERT_LT(std::get<0>(previous), std::get<0>(value));
+    }
+    previous = value;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    ASSERT_EQ(1, seen[i]);
+  }
+}
+
+// ____________________________________________________________________________
+TEST(OSM_SegmentedSpill, sortSpatiallyMergesRuns) {
+  osm2rdf::config::Config config;
+  SegmentedSpill<SpatialNodeValue> spill{
+      config.getTempPath("TEST_OSM_SegmentedSpill", "sortSpatiallyMergesRuns")};
+  // More records than fit into one sort run.
+  const size_t count = 2500000;
+  for (size_t i = 0; i < count; ++i) {
+    const auto x = static_cast<double>((i * 7919) % 36000) / 100;
+    const auto y = static_cast<double>((i * 104729) % 18000) / 100;
+    spill.write(SpatialNodeValue(i, nodeAt(x - 180, y - 90)));
+  }
+  spill.flush();
+  const auto bytes = spill.bytes();
+  spill.sortSpatially();
+
+  ASSERT_EQ(count, spill.size());
+  ASSERT_EQ(bytes, spill.bytes());
+  std::vector<bool> seen(count, false);
+  uint64_t previousKey = 0;
+  for (size_t i = 0; i < count; ++i) {
+    SpatialNodeValue value;
+    spill.get(i, &value);
+    const auto key = hilbertIndexOf(std::get<1>(value));
+    ASSERT_TRUE(previousKey <= key);
+    ASSERT_FALSE(seen[std::get<0>(value)]);
+    seen[std::get<0>(value)] = true;
+    previousKey = key;
+  }
+}
+
+// ____________________________________________________________________________
+TEST(OSM_SegmentedSpill, sortSpatiallyWays) {
+  osm2rdf::config::Config config;
+  SegmentedSpill<SpatialWayValue> spill{
+      config.getTempPath("TEST_OSM_SegmentedSpill", "sortSpatiallyWays")};
+  // Ways are ordered by the centre of their envelope, their data is kept.
+  const std::vector<std::pair<double, double>> centres = {
+      {170, 80}, {-170, -80}, {-170, 80}, {170, -80}};
+  for (size_t i = 0; i < centres.size(); ++i) {
+    const auto& [x, y] = centres[i];
+    SpatialWayValue way;
+    std::get<0>(way) = {nodeAt(x - 1, y - 1), nodeAt(x + 1, y + 1)};
+    std::get<1>(way) = i;
+    std::get<3>(way) = {i, i + 1};
+    spill.write(way);
+  }
+  spill.flush();
+  spill.sortSpatially();
+
+  // Lower left, upper left, upper right and lower right quadrant.
+  const std::vector<uint64_t> expected = {1, 2, 0, 3};
+  ASSERT_EQ(expected.size(), spill.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    SpatialWayValue way;
+    spill.get(i, &way);
+    ASSERT_EQ(expected[i], std::get<1>(way));
+    const std::vector<uint64_t> nodeIds = {expected[i], expected[i] + 1};
+    ASSERT_EQ(nodeIds, std::get<3>(way));
+  }
+}
+
+}  // namespace osm2rdf::osm
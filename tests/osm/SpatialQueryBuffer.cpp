@@ -0,0 +1,119 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "osm2rdf/osm/SpatialQueryBuffer.h"
+
+#include <algorithm>
+#include <random>
+
+#include "gtest/gtest.h"
+
+namespace osm2rdf::osm {
+
+// ____________________________________________________________________________
+static std::vector<size_t> indices(const SpatialQueryBuffer& buffer) {
+  std::vector<size_t> result;
+  for (const auto& ref : buffer.refs) {
+    result.push_back(ref.second);
+  }
+  return result;
+}
+
+// ____________________________________________________________________________
+static void addRefs(SpatialQueryBuffer* buffer,
+                    const std::vector<size_t>& areas) {
+  for (const auto area : areas) {
+    buffer->refs.emplace_back(osm2rdf::geometry::Box{}, area);
+  }
+}
+
+// ____________________________________________________________________________
+TEST(OSM_SpatialQueryBuffer, uniqueRemovesDuplicatesAndSorts) {
+  SpatialQueryBuffer buffer;
+  buffer.clear(10);
+  addRefs(&buffer, {3, 7, 3, 0, 9, 7, 7});
+  buffer.unique();
+  ASSERT_EQ((std::vector<size_t>{9, 7, 3, 0}), indices(buffer));
+}
+
+// ____________________________________________________________________________
+TEST(OSM_SpatialQueryBuffer, uniqueKeepsAreasOfEarlierQueries) {
+  SpatialQueryBuffer buffer;
+  buffer.clear(10);
+  addRefs(&buffer, {1, 2, 2});
+  buffer.unique();
+  ASSERT_EQ((std::vector<size_t>{2, 1}), indices(buffer));
+
+  buffer.clear(10);
+  ASSERT_TRUE(buffer.refs.empty());
+  addRefs(&buffer, {2, 1, 5});
+  buffer.unique();
+  ASSERT_EQ((std::vector<size_t>{5, 2, 1}), indices(buffer));
+}
+
+// ____________________________________________________________________________
+TEST(OSM_SpatialQueryBuffer, uniqueClearsSeen) {
+  SpatialQueryBuffer buffer;
+  buffer.clear(200);
+  addRefs(&buffer, {1, 63, 64, 199, 64, 1});
+  buffer.unique();
+  ASSERT_EQ((std::vector<size_t>{199, 64, 63, 1}), indices(buffer));
+  ASSERT_EQ((std::vector<uint64_t>(4, 0)), buffer.seen);
+}
+
+// ____________________________________________________________________________
+TEST(OSM_SpatialQueryBuffer, uniqueSortsLargeResults) {
+  const size_t numAreas = 4 * SpatialQueryBuffer::INSERTION_SORT_MAX;
+  SpatialQueryBuffer buffer;
+  buffer.clear(numAreas);
+  std::vector<size_t> areas;
+  std::vector<size_t> expected;
+  for (size_t i = 0; i < numAreas; i += 2) {
+    areas.push_back((i * 7) % numAreas);
+    areas.push_back((i * 7) % numAreas);
+  }
+  std::mt19937 rng(42);
+  std::shuffle(areas.begin(), areas.end(), rng);
+  for (size_t i = numAreas; i-- > 0;) {
+    if (std::find(areas.begin(), areas.end(), i) != areas.end()) {
+      expected.push_back(i);
+    }
+  }
+  ASSERT_GT(expected.size(), numAreas / 4);
+  addRefs(&buffer, areas);
+  buffer.unique();
+  ASSERT_EQ(expected, indices(buffer));
+  ASSERT_EQ((std::vector<uint64_t>(buffer.seen.size(), 0)), buffer.seen);
+}
+
+// ____________________________________________________________________________
+TEST(OSM_SpatialQueryBuffer, clearResizesSeen) {
+  SpatialQueryBuffer buffer;
+  buffer.clear(64);
+  ASSERT_EQ(1, buffer.seen.size());
+  buffer.covers.emplace_back(SpatialAreaRefValue{}, 1);
+  buffer.clear(65);
+  ASSERT_EQ(2, buffer.seen.size());
+  ASSERT_TRUE(buffer.covers.empty());
+  addRefs(&buffer, {64, 6, 64});
+  buffer.unique();
+  ASSERT_EQ((std::vector<size_t>{64, 6}), indices(buffer));
+}
+
+}  // namespace osm2rdf::osm
@@ -0,0 +1,82 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/SpillFormat.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace osm2rdf::osm {
+
+// ____________________________________________________________________________
+TEST(OSM_SpillFormat, arrayIsAligned) {
+  std::vector<uint8_t> buffer;
+  SpillDataWriter writer{&buffer, 3};
+  const std::vector<uint8_t> bytes{1, 2, 3};
+  const std::vector<uint64_t> values{5, 6};
+  const auto first = writer.array(bytes);
+  const auto second = writer.array(values);
+  ASSERT_EQ(8, first.offset);
+  ASSERT_EQ(3, first.count);
+  ASSERT_EQ(16, second.offset);
+  ASSERT_EQ(2, second.count);
+
+  std::vector<uint8_t> file(3, 0);
+  file.insert(file.end(), buffer.begin(), buffer.end());
+  const SpillDataReader reader{file.data()};
+  std::vector<uint8_t> readBytes;
+  reader.array<uint8_t>(first, &readBytes);
+  std::vector<uint64_t> readValues;
+  reader.array<uint64_t>(second, &readValues);
+  ASSERT_EQ(bytes, readBytes);
+  ASSERT_EQ(values, readValues);
+}
+
+// ____________________________________________________________________________
+TEST(OSM_SpillFormat, multiPolygon) {
+  osm2rdf::geometry::Polygon square;
+  square.outer() = {{0, 0}, {4, 0}, {4, 4}, {0, 4}, {0, 0}};
+  square.inners().push_back({{1, 1}, {2, 1}, {2, 2}, {1, 1}});
+  square.inners().push_back({});
+  osm2rdf::geometry::Polygon triangle;
+  triangle.outer() = {{5, 5}, {6, 5}, {5, 6}, {5, 5}};
+  const osm2rdf::geometry::MultiPolygon multiPolygon{square, triangle};
+
+  std::vector<uint8_t> buffer;
+  SpillDataWriter writer{&buffer, 0};
+  const auto empty = writer.multiPolygon({});
+  const auto span = writer.multiPolygon(multiPolygon);
+  const auto polygonSpan = writer.polygon(triangle);
+  ASSERT_EQ(0, empty.count);
+  ASSERT_EQ(2, span.count);
+
+  const SpillDataReader reader{buffer.data()};
+  osm2rdf::geometry::MultiPolygon result{triangle};
+  reader.multiPolygon(empty, &result);
+  ASSERT_TRUE(result.empty());
+  reader.multiPolygon(span, &result);
+  ASSERT_EQ(2, result.size());
+  ASSERT_TRUE(square == result[0]);
+  ASSERT_TRUE(triangle == result[1]);
+  osm2rdf::geometry::Polygon polygon;
+  reader.polygon(polygonSpan, &polygon);
+  ASSERT_TRUE(triangle == polygon);
+}
+
+}  // namespace osm2rdf::osm
@@ -0,0 +1,126 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/TagFilter.h"
+
+#include "gtest/gtest.h"
+#include "osmium/builder/attr.hpp"
+#include "osmium/builder/osm_object_builder.hpp"
+
+namespace osm2rdf::osm {
+
+// ____________________________________________________________________________
+TEST(OSM_TagFilter, emptyAcceptsAll) {
+  osm2rdf::config::Config config;
+  osm2rdf::osm::TagFilter filter{config};
+  ASSERT_TRUE(filter.empty());
+
+  const size_t initial_buffer_size = 10000;
+  osmium::memory::Buffer osmiumBuffer{initial_buffer_size,
+                                      osmium::memory::Buffer::auto_grow::yes};
+  osmium::builder::add_node(osmiumBuffer, osmium::builder::attr::_id(42),
+                            osmium::builder::attr::_tag("city", "Freiburg"));
+  const auto& tags = osmiumBuffer.get<osmium::Node>(0).tags();
+
+  ASSERT_TRUE(filter.area(tags));
+  ASSERT_TRUE(filter.node(tags));
+  ASSERT_TRUE(filter.relation(tags));
+  ASSERT_TRUE(filter.way(tags));
+}
+
+// ____________________________________________________________________________
+TEST(OSM_TagFilter, includeKeyAndValue) {
+  osm2rdf::config::Config config;
+  config.includeTags.emplace_back("amenity");
+  config.includeTags.emplace_back("highway=path");
+  osm2rdf::osm::TagFilter filter{config};
+  ASSERT_FALSE(filter.empty());
+
+  const size_t initial_buffer_size = 10000;
+  osmium::memory::Buffer osmiumBuffer{initial_buffer_size,
+                                      osmium::memory::Buffer::auto_grow::yes};
+  osmium::builder::add_node(osmiumBuffer, osmium::builder::attr::_id(1),
+                            osmium::builder::attr::_tag("amenity", "bench"));
+  osmium::builder::add_node(osmiumBuffer, osmium::builder::attr::_id(2),
+                            osmium::builder::attr::_tag("highway", "path"));
+  osmium::builder::add_node(osmiumBuffer, osmium::builder::attr::_id(3),
+                            osmium::builder::attr::_tag("highway", "primary"));
+  osmium::builder::add_node(osmiumBuffer, osmium::builder::attr::_id(4),
+                            osmium::builder::attr::_tag("name", "amenity"));
+  std::vector<bool> result;
+  for (const auto& node : osmiumBuffer.select<osmium::Node>()) {
+    result.push_back(filter.node(node.tags()));
+  }
+  ASSERT_EQ((std::vector<bool>{true, true, false, false}), result);
+}
+
+// ____________________________________________________________________________
+TEST(OSM_TagFilter, excludeKeyAndValue) {
+  osm2rdf::config::Config config;
+  config.includeTags.emplace_back("amenity");
+  config.excludeTags.emplace_back("amenity=bench");
+  osm2rdf::osm::TagFilter filter{config};
+
+  const size_t initial_buffer_size = 10000;
+  osmium::memory::Buffer osmiumBuffer{initial_buffer_size,
+                                      osmium::memory::Buffer::auto_grow::yes};
+  osmium::builder::add_node(osmiumBuffer, osmium::builder::attr::_id(1),
+                            osmium::builder::attr::_tag("amenity", "bench"));
+  osmium::builder::add_node(osmiumBuffer, osmium::builder::attr::_id(2),
+                            osmium::builder::attr::_tag("amenity", "cafe"));
+  std::vector<bool> result;
+  for (const auto& node : osmiumBuffer.select<osmium::Node>()) {
+    result.push_back(filter.node(node.tags()));
+  }
+  ASSERT_EQ((std::vector<bool>{false, true}), result);
+}
+
+// ____________________________________________________________________________
+TEST(OSM_TagFilter, perType) {
+  osm2rdf::config::Config config;
+  config.includeTags.emplace_back("node/amenity");
+  config.excludeTags.emplace_back("way/highway");
+  // Unknown prefix, the slash is part of the key.
+  config.excludeTags.emplace_back("foo/bar");
+  osm2rdf::osm::TagFilter filter{config};
+
+  const size_t initial_buffer_size = 10000;
+  osmium::memory::Buffer osmiumBuffer{initial_buffer_size,
+                                      osmium::memory::Buffer::auto_grow::yes};
+  osmium::builder::add_node(osmiumBuffer, osmium::builder::attr::_id(1),
+                            osmium::builder::attr::_tag("highway", "path"));
+  osmium::builder::add_node(osmiumBuffer, osmium::builder::attr::_id(2),
+                            osmium::builder::attr::_tag("foo/bar", "baz"));
+  std::vector<const osmium::TagList*> tags;
+  for (const auto& node : osmiumBuffer.select<osmium::Node>()) {
+    tags.push_back(&node.tags());
+  }
+  const auto& highway = *tags[0];
+  const auto& fooBar = *tags[1];
+
+  // Include rule only for nodes
+  ASSERT_FALSE(filter.node(highway));
+  ASSERT_TRUE(filter.relation(highway));
+  ASSERT_TRUE(filter.area(highway));
+  // Exclude rule only for ways
+  ASSERT_FALSE(filter.way(highway));
+  ASSERT_FALSE(filter.way(fooBar));
+  ASSERT_FALSE(filter.relation(fooBar));
+}
+
+}  // namespace osm2rdf::osm
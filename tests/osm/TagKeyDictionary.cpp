@@ -0,0 +1,89 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/TagKeyDictionary.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace osm2rdf::osm {
+
+// ____________________________________________________________________________
+TEST(OSM_TagKeyDictionary, internAndFind) {
+  osm2rdf::osm::TagKeyDictionary dictionary;
+  ASSERT_EQ(osm2rdf::osm::TagKeyDictionary::NOT_FOUND,
+            dictionary.find("name"));
+
+  const auto nameId = dictionary.intern("name");
+  const auto cityId = dictionary.intern("city");
+  ASSERT_NE(nameId, cityId);
+  ASSERT_EQ(nameId, dictionary.intern("name"));
+  ASSERT_EQ(nameId, dictionary.find("name"));
+  ASSERT_EQ(cityId, dictionary.find("city"));
+  ASSERT_EQ("name", dictionary.key(nameId));
+  ASSERT_EQ("city", dictionary.key(cityId));
+}
+
+// ____________________________________________________________________________
+TEST(OSM_TagKeyDictionary, internParallel) {
+  osm2rdf::osm::TagKeyDictionary dictionary;
+  const size_t numKeys = 10000;
+  const size_t numRuns = 8;
+  std::vector<std::vector<osm2rdf::osm::TagKeyId>> ids(numRuns);
+#pragma omp parallel for
+  for (size_t run = 0; run < numRuns; ++run) {
+    for (size_t i = 0; i < numKeys; ++i) {
+      ids[run].push_back(dictionary.intern("key" + std::to_string(i)));
+    }
+  }
+  for (size_t run = 1; run < numRuns; ++run) {
+    ASSERT_EQ(ids[0], ids[run]);
+  }
+  for (size_t i = 0; i < numKeys; ++i) {
+    ASSERT_EQ("key" + std::to_string(i), dictionary.key(ids[0][i]));
+  }
+}
+
+// ____________________________________________________________________________
+TEST(OSM_TagKeyDictionary, internOverflow) {
+  osm2rdf::osm::TagKeyDictionary dictionary;
+  const size_t numKeys = osm2rdf::osm::TagKeyDictionary::CAPACITY;
+  std::vector<osm2rdf::osm::TagKeyId> ids;
+  ids.reserve(numKeys);
+  for (size_t i = 0; i < numKeys; ++i) {
+    ids.push_back(dictionary.intern("key" + std::to_string(i)));
+  }
+  // The last keys no longer fit into the table.
+  ASSERT_GT(ids.back(), osm2rdf::osm::TagKeyDictionary::NOT_FOUND);
+  ASSERT_EQ(osm2rdf::osm::TagKeyDictionary::NOT_FOUND,
+            dictionary.find("missing"));
+  for (size_t i = 0; i < numKeys; i += 997) {
+    const std::string key = "key" + std::to_string(i);
+    ASSERT_NE(osm2rdf::osm::TagKeyDictionary::NOT_FOUND, ids[i]);
+    ASSERT_EQ(ids[i], dictionary.intern(key));
+    ASSERT_EQ(ids[i], dictionary.find(key));
+    ASSERT_EQ(key, dictionary.key(ids[i]));
+  }
+  const std::string last = "key" + std::to_string(numKeys - 1);
+  ASSERT_EQ(ids.back(), dictionary.find(last));
+  ASSERT_EQ(last, dictionary.key(ids.back()));
+}
+
+}  // namespace osm2rdf::osm
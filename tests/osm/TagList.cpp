@@ -70,6 +70,25 @@ TEST(OSM_TagList, convertTagListWithSpaceInKey) {
   ASSERT_EQ("Freiburg", tl["name_of_city"]);
 }
 
+// ____________________________________________________________________________
+TEST(OSM_TagList, findAndCount) {
+  osm2rdf::osm::TagList tl;
+  ASSERT_TRUE(tl.empty());
+  tl["name"] = "Freiburg";
+  tl["city"] = "Freiburg";
+  tl["name"] = "Freiburg im Breisgau";
+
+  ASSERT_EQ(2, tl.size());
+  ASSERT_EQ(1, tl.count("name"));
+  ASSERT_EQ(0, tl.count("unknown-key-OSM_TagList"));
+  ASSERT_EQ(tl.end(), tl.find("unknown-key-OSM_TagList"));
+  ASSERT_EQ("name", tl.find("name")->key());
+  ASSERT_EQ("Freiburg im Breisgau", tl.at("name"));
+  ASSERT_THROW(tl.at("unknown-key-OSM_TagList"), std::out_of_range);
+  // Entries are sorted by key id.
+  ASSERT_LT(tl.begin()->keyId, (tl.begin() + 1)->keyId);
+}
+
 // ____________________________________________________________________________
 TEST(OSM_TagList, serializationBinary) {
   std::stringstream boostBuffer;
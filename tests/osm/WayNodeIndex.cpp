@@ -0,0 +1,89 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/WayNodeIndex.h"
+
+#include <filesystem>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "osmium/builder/attr.hpp"
+#include "osmium/builder/osm_object_builder.hpp"
+
+namespace osm2rdf::osm {
+
+// ____________________________________________________________________________
+void addWays(WayNodeIndex* index) {
+  const size_t initial_buffer_size = 10000;
+  osmium::memory::Buffer osmiumBuffer{initial_buffer_size,
+                                      osmium::memory::Buffer::auto_grow::yes};
+  // Unsorted way ids and node ids with large gaps.
+  osmium::builder::add_way(osmiumBuffer, osmium::builder::attr::_id(42),
+                           osmium::builder::attr::_nodes({1, 2, 3, 1}));
+  osmium::builder::add_way(
+      osmiumBuffer, osmium::builder::attr::_id(7),
+      osmium::builder::attr::_nodes({10000000000, 5, 10000000001}));
+  osmium::builder::add_way(osmiumBuffer, osmium::builder::attr::_id(8));
+  for (const auto& way : osmiumBuffer.select<osmium::Way>()) {
+    index->add(way.positive_id(), way.nodes());
+  }
+  index->finalize();
+}
+
+// ____________________________________________________________________________
+void checkWays(const WayNodeIndex& index) {
+  ASSERT_EQ(3, index.size());
+  const auto way42 = index.get(42);
+  ASSERT_EQ(4, way42.size());
+  ASSERT_EQ((std::vector<uint64_t>{1, 2, 3, 1}),
+            std::vector<uint64_t>(way42.begin(), way42.end()));
+  const auto way7 = index.get(7);
+  ASSERT_EQ(3, way7.size());
+  ASSERT_EQ((std::vector<uint64_t>{10000000000, 5, 10000000001}),
+            std::vector<uint64_t>(way7.begin(), way7.end()));
+  ASSERT_TRUE(index.get(8).empty());
+  ASSERT_TRUE(index.get(9).empty());
+  ASSERT_EQ(index.get(9).begin(), index.get(9).end());
+}
+
+// ____________________________________________________________________________
+TEST(OSM_WayNodeIndex, inMemory) {
+  WayNodeIndex index;
+  addWays(&index);
+  checkWays(index);
+}
+
+// ____________________________________________________________________________
+TEST(OSM_WayNodeIndex, spilled) {
+  WayNodeIndex index;
+  index.spillTo(std::filesystem::temp_directory_path() / "OSM_WayNodeIndex");
+  addWays(&index);
+  checkWays(index);
+}
+
+// ____________________________________________________________________________
+TEST(OSM_WayNodeIndex, empty) {
+  WayNodeIndex index;
+  index.spillTo(std::filesystem::temp_directory_path() / "OSM_WayNodeIndex");
+  index.finalize();
+  ASSERT_EQ(0, index.size());
+  ASSERT_EQ(0, index.dataSize());
+  ASSERT_TRUE(index.get(1).empty());
+}
+
+}  // namespace osm2rdf::osm
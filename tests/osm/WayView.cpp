@@ -0,0 +1,111 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/WayView.h"
+
+#include "boost/geometry.hpp"
+#include "gtest/gtest.h"
+#include "osm2rdf/osm/Way.h"
+#include "osmium/builder/attr.hpp"
+#include "osmium/builder/osm_object_builder.hpp"
+
+namespace osm2rdf::osm {
+
+// ____________________________________________________________________________
+TEST(OSM_WayView, FromWay) {
+  // Create osmium object
+  const size_t initial_buffer_size = 10000;
+  osmium::memory::Buffer buffer{initial_buffer_size,
+                                osmium::memory::Buffer::auto_grow::yes};
+  osmium::builder::add_way(buffer, osmium::builder::attr::_id(42),
+                           osmium::builder::attr::_nodes({
+                               {1, {48.0, 7.51}},
+                               {2, {48.1, 7.61}},
+                           }),
+                           osmium::builder::attr::_tag("city", "Freiburg"));
+
+  const auto& osmiumWay = buffer.get<osmium::Way>(0);
+  const osm2rdf::osm::WayView w{osmiumWay};
+  ASSERT_EQ(42, w.id());
+  ASSERT_FALSE(w.closed());
+
+  // Tags and node refs are not copied.
+  ASSERT_EQ(&osmiumWay.tags(), &w.tags());
+  ASSERT_EQ(&osmiumWay.nodes(), &w.nodes());
+  ASSERT_EQ(1, w.tags().size());
+  ASSERT_EQ(2, w.nodes().size());
+  ASSERT_EQ(1, w.nodes()[0].positive_ref());
+  ASSERT_EQ(2, w.nodes()[1].positive_ref());
+
+  const auto geom = w.geom();
+  ASSERT_EQ(2, geom.size());
+  ASSERT_DOUBLE_EQ(48.0, geom.at(0).x());
+  ASSERT_DOUBLE_EQ(7.51, geom.at(0).y());
+  ASSERT_DOUBLE_EQ(48.1, geom.at(1).x());
+  ASSERT_DOUBLE_EQ(7.61, geom.at(1).y());
+}
+
+// ____________________________________________________________________________
+TEST(OSM_WayView, FromWayWithDuplicateNodesAndClosed) {
+  // Create osmium object
+  const size_t initial_buffer_size = 10000;
+  osmium::memory::Buffer buffer{initial_buffer_size,
+                                osmium::memory::Buffer::auto_grow::yes};
+  osmium::builder::add_way(buffer, osmium::builder::attr::_id(42),
+                           osmium::builder::attr::_nodes({
+                               {1, {48.0, 7.51}},
+                               {2, {48.1, 7.61}},
+                               {2, {48.1, 7.61}},
+                               {3, {48.1, 7.51}},
+                               {1, {48.0, 7.51}},
+                           }));
+
+  const osm2rdf::osm::WayView w{buffer.get<osmium::Way>(0)};
+  ASSERT_TRUE(w.closed());
+  ASSERT_EQ(5, w.nodes().size());
+  ASSERT_EQ(4, w.geom().size());
+}
+
+// ____________________________________________________________________________
+TEST(OSM_WayView, sameGeometriesAsWay) {
+  // Create osmium object
+  const size_t initial_buffer_size = 10000;
+  osmium::memory::Buffer buffer{initial_buffer_size,
+                                osmium::memory::Buffer::auto_grow::yes};
+  osmium::builder::add_way(buffer, osmium::builder::attr::_id(42),
+                           osmium::builder::attr::_nodes({
+                               {1, {48.0, 7.51}},
+                               {2, {48.1, 7.61}},
+                               {3, {48.3, 7.55}},
+                               {4, {48.2, 7.40}},
+                           }));
+
+  const osm2rdf::osm::Way way{buffer.get<osmium::Way>(0)};
+  const osm2rdf::osm::WayView view{buffer.get<osmium::Way>(0)};
+  ASSERT_EQ(way.id(), view.id());
+  ASSERT_EQ(way.closed(), view.closed());
+  ASSERT_TRUE(boost::geometry::equals(way.geom(), view.geom()));
+  ASSERT_TRUE(boost::geometry::equals(way.envelope(), view.envelope()));
+  const auto convexHull = osm2rdf::osm::WayView::convexHull(view.geom());
+  ASSERT_TRUE(boost::geometry::equals(way.convexHull(), convexHull));
+  ASSERT_TRUE(boost::geometry::equals(
+      way.orientedBoundingBox(),
+      osm2rdf::osm::WayView::orientedBoundingBox(convexHull)));
+}
+
+}  // namespace osm2rdf::osm
@@ -0,0 +1,73 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/util/Hilbert.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace osm2rdf::util {
+
+// ____________________________________________________________________________
+TEST(UTIL_Hilbert, firstLevel) {
+  // The curve visits the quadrants lower left, upper left, upper right and
+  // lower right.
+  const uint32_t high = 1U << 31U;
+  ASSERT_EQ(0, hilbertIndex(0, 0) >> 62U);
+  ASSERT_EQ(1, hilbertIndex(0, high) >> 62U);
+  ASSERT_EQ(2, hilbertIndex(high, high) >> 62U);
+  ASSERT_EQ(3, hilbertIndex(high, 0) >> 62U);
+  ASSERT_EQ(0, hilbertIndex(0, 0));
+  ASSERT_EQ(UINT64_MAX, hilbertIndex(UINT32_MAX, 0));
+}
+
+// ____________________________________________________________________________
+TEST(UTIL_Hilbert, neighbours) {
+  // Consecutive indices belong to adjacent cells: walk the curve in the
+  // lowest 16x16 cells, which are visited first.
+  std::vector<std::pair<uint64_t, std::pair<uint32_t, uint32_t>>> cells;
+  for (uint32_t x = 0; x < 16; ++x) {
+    for (uint32_t y = 0; y < 16; ++y) {
+      cells.push_back({hilbertIndex(x, y), {x, y}});
+    }
+  }
+  std::sort(cells.begin(), cells.end());
+  for (size_t i = 0; i < cells.size(); ++i) {
+    ASSERT_EQ(i, cells[i].first);
+    if (i > 0) {
+      const auto& [x1, y1] = cells[i - 1].second;
+      const auto& [x2, y2] = cells[i].second;
+      const auto dx = x1 > x2 ? x1 - x2 : x2 - x1;
+      const auto dy = y1 > y2 ? y1 - y2 : y2 - y1;
+      ASSERT_EQ(1, dx + dy);
+    }
+  }
+}
+
+// ____________________________________________________________________________
+TEST(UTIL_Hilbert, cell) {
+  ASSERT_EQ(0, hilbertCell(-180, -180, 180));
+  ASSERT_EQ(0, hilbertCell(-200, -180, 180));
+  ASSERT_EQ(UINT32_MAX, hilbertCell(180, -180, 180));
+  ASSERT_EQ(UINT32_MAX, hilbertCell(200, -180, 180));
+  ASSERT_EQ(1U << 31U, hilbertCell(0, -180, 180) + 1);
+}
+
+}  // namespace osm2rdf::util
@@ -18,7 +18,9 @@
 
 #include "osm2rdf/util/Output.h"
 
+#include <fstream>
 #include <iostream>
+#include <sstream>
 
 #include "gtest/gtest.h"
 
@@ -231,4 +233,35 @@ TEST(UTIL_OutputMergeMode, MERGE) {
   ASSERT_FALSE(std::filesystem::exists(config.output));
 }
 
+// ____________________________________________________________________________
+TEST(UTIL_OutputMergeMode, emptyParts) {
+  for (const auto mode :
+       {OutputMergeMode::CONCATENATE, OutputMergeMode::MERGE}) {
+    osm2rdf::config::Config config;
+    config.output =
+        config.getTempPath("TEST_UTIL_OutputMergeMode", "emptyParts");
+    config.mergeOutput = mode;
+    config.outputCompress = false;
+    std::filesystem::create_directories(config.output);
+    std::filesystem::path output{config.output};
+    output /= "file";
+
+    // Empty prefix and first part, they must not drop the other parts.
+    osm2rdf::util::Output o{config, output, 3};
+    o.open();
+    o.write("b", 1);
+    o.write("c", 2);
+    o.flush();
+    o.close();
+
+    std::stringstream resultBuffer;
+    std::ifstream resultFile(output);
+    resultBuffer << resultFile.rdbuf();
+    ASSERT_EQ("bc", resultBuffer.str());
+    resultFile.close();
+
+    std::filesystem::remove_all(config.output);
+  }
+}
+
 }  // namespace osm2rdf::util
@@ -0,0 +1,103 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "osm2rdf/util/RankBitmap.h"
+
+#include "gtest/gtest.h"
+
+namespace osm2rdf::util {
+
+// ____________________________________________________________________________
+TEST(UTIL_RankBitmap, empty) {
+  RankBitmap bitmap;
+  bitmap.prepareRank();
+  ASSERT_EQ(0, bitmap.count());
+  ASSERT_FALSE(bitmap.test(0));
+  ASSERT_FALSE(bitmap.test(1000000));
+  ASSERT_EQ(0, bitmap.rank(1000000));
+}
+
+// ____________________________________________________________________________
+TEST(UTIL_RankBitmap, unprepared) {
+  RankBitmap empty;
+  ASSERT_EQ(0, empty.count());
+  ASSERT_EQ(0, empty.rank(0));
+  ASSERT_EQ(0, empty.rank(1000000));
+
+  RankBitmap bitmap;
+  bitmap.set(10);
+  bitmap.set(2000);
+  ASSERT_EQ(0, bitmap.count());
+  ASSERT_EQ(0, bitmap.rank(2000));
+  bitmap.prepareRank();
+  ASSERT_EQ(2, bitmap.count());
+  // set() invalidates the rank data again.
+  bitmap.set(5);
+  ASSERT_EQ(0, bitmap.count());
+  ASSERT_EQ(0, bitmap.rank(2000));
+}
+
+// ____________________________________________________________________________
+TEST(UTIL_RankBitmap, setAndTest) {
+  RankBitmap bitmap;
+  bitmap.set(0);
+  bitmap.set(63);
+  bitmap.set(64);
+  bitmap.set(100000);
+  ASSERT_TRUE(bitmap.test(0));
+  ASSERT_FALSE(bitmap.test(1));
+  ASSERT_TRUE(bitmap.test(63));
+  ASSERT_TRUE(bitmap.test(64));
+  ASSERT_FALSE(bitmap.test(65));
+  ASSERT_TRUE(bitmap.test(100000));
+  ASSERT_FALSE(bitmap.test(100001));
+  ASSERT_FALSE(bitmap.test(10000000));
+}
+
+// ____________________________________________________________________________
+TEST(UTIL_RankBitmap, rank) {
+  RankBitmap bitmap;
+  // Set every third bit across several blocks.
+  for (uint64_t i = 0; i < 5000; i += 3) {
+    bitmap.set(i);
+  }
+  bitmap.prepareRank();
+  ASSERT_EQ(1667, bitmap.count());
+  for (uint64_t i = 0; i < 5000; ++i) {
+    ASSERT_EQ((i + 2) / 3, bitmap.rank(i));
+  }
+  ASSERT_EQ(bitmap.count(), bitmap.rank(1000000));
+}
+
+// ____________________________________________________________________________
+TEST(UTIL_RankBitmap, setAfterPrepareRank) {
+  RankBitmap bitmap;
+  bitmap.set(10);
+  bitmap.prepareRank();
+  ASSERT_EQ(1, bitmap.count());
+  bitmap.set(2000);
+  bitmap.set(5);
+  bitmap.prepareRank();
+  ASSERT_EQ(3, bitmap.count());
+  ASSERT_EQ(0, bitmap.rank(5));
+  ASSERT_EQ(1, bitmap.rank(10));
+  ASSERT_EQ(2, bitmap.rank(2000));
+}
+
+}  // namespace osm2rdf::util
@@ -0,0 +1,53 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "osm2rdf/util/Span.h"
+
+#include "gtest/gtest.h"
+
+namespace osm2rdf::util {
+
+// ____________________________________________________________________________
+TEST(UTIL_Span, empty) {
+  Span<int> span;
+  ASSERT_TRUE(span.empty());
+  ASSERT_EQ(0, span.size());
+  ASSERT_EQ(span.begin(), span.end());
+}
+
+// ____________________________________________________________________________
+TEST(UTIL_Span, fromVector) {
+  const std::vector<int> values{1, 2, 3};
+  const Span<int> span{values};
+  ASSERT_EQ(3, span.size());
+  ASSERT_EQ(values.data(), span.data());
+  ASSERT_EQ(1, span.front());
+  ASSERT_EQ(2, span[1]);
+  ASSERT_EQ(3, span.back());
+}
+
+// ____________________________________________________________________________
+TEST(UTIL_Span, partOfVector) {
+  const std::vector<int> values{1, 2, 3, 4};
+  const Span<int> span{values.data() + 1, 2};
+  ASSERT_EQ(std::vector<int>({2, 3}),
+            std::vector<int>(span.begin(), span.end()));
+}
+
+}  // namespace osm2rdf::util